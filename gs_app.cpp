@@ -96,9 +96,17 @@ GS_Application::GS_Application()
     m_rcWindowClient.right  = 0;
     m_rcWindowClient.bottom = 0;
 
-    m_fFrameRate = GS_DEFAULT_FPS;
-    m_fFrameTime = 0.0f;
-    m_fWaitTime  = 0.0f;
+    m_fFrameRate   = GS_DEFAULT_FPS;
+    m_fFrameTime   = 0.0f;
+    m_fWaitTime    = 0.0f;
+    m_fRefreshTime = DEFAULT_TARGET_FRAME_TIME;
+
+    // Benchmark builds never show a window and render offscreen instead.
+#ifdef GS_BENCHMARK
+    m_bIsHeadless = TRUE;
+#else
+    m_bIsHeadless = FALSE;
+#endif
 }
 
 
@@ -175,8 +183,8 @@ BOOL GS_Application::Create(int nWidth, int nHeight, int nDepth, BOOL bIsWindowe
                 break;
         } // end switch(nDepth)
 
-        // Set the mode
-        m_bIsWindowed = bIsWindowed;
+        // Set the mode (a headless application always uses a hidden window).
+        m_bIsWindowed = (bIsWindowed || m_bIsHeadless);
 
         // Is it a fullscreen application?
         if( !m_bIsWindowed )
@@ -274,6 +282,11 @@ BOOL GS_Application::Create(int nWidth, int nHeight, int nDepth, BOOL bIsWindowe
         // Specify window style for windowed mode.
         m_dwWindowStyle = WS_OVERLAPPED | WS_CAPTION | WS_SYSMENU | WS_MINIMIZEBOX | WS_VISIBLE;
         m_dwWindowStyleEx = WS_EX_APPWINDOW;
+        // Keep the window hidden if running headless.
+        if (m_bIsHeadless)
+        {
+            m_dwWindowStyle &= ~WS_VISIBLE;
+        }
         // Determine the actual size the window has to be to have the required client size, taking
         // into account the style of the window as well as the window's menu in windowed mode.
         //////////////////////////////////////////////////////////////////////////////////////////
@@ -333,12 +346,15 @@ BOOL GS_Application::Create(int nWidth, int nHeight, int nDepth, BOOL bIsWindowe
         return FALSE;
     }
 
-    // Show the window and update it.
-    ShowWindow(m_hWnd, SW_SHOWNORMAL);
-    UpdateWindow(m_hWnd);
+    // Show the window and update it (unless running headless).
+    if (!m_bIsHeadless)
+    {
+        ShowWindow(m_hWnd, SW_SHOWNORMAL);
+        UpdateWindow(m_hWnd);
 
-    // Slightly higher priority.
-    SetForegroundWindow(m_hWnd);
+        // Slightly higher priority.
+        SetForegroundWindow(m_hWnd);
+    }
 
     /////////////////////////////////////////////////////////////////////////////////////////////
     //###########################################################################################
@@ -401,8 +417,13 @@ BOOL GS_Application::Create(int nWidth, int nHeight, int nDepth, BOOL bIsWindowe
         return FALSE;
     }
 
-    // Mark the beginning the first frame.
-    m_gsFrameTimer.MarkFrame();
+    // Determine the length of a display refresh, used to count frames that miss a vsync.
+    int nRefreshRate = GetDeviceCaps(m_hDC, VREFRESH);
+    m_fRefreshTime = (nRefreshRate > 1) ? (1000.0f / nRefreshRate) : DEFAULT_TARGET_FRAME_TIME;
+    m_gsFrameTimer.SetTargetFrameTime((m_fWaitTime > m_fRefreshTime) ? m_fWaitTime : m_fRefreshTime);
+
+    // Mark the beginning the first frame (the time spent loading is not counted as a frame).
+    m_gsFrameTimer.Reset();
 
     // Set flags to indicate application has been created successfully.
     m_bIsReady  = TRUE;
@@ -603,11 +624,22 @@ INT GS_Application::Run()
     // Recieve and process windows messages.
     while (WM_QUIT != msg.message)
     {
-        // Check if there is a message (without removing it from queue).
-        if (PeekMessage(&msg, NULL, 0, 0, PM_NOREMOVE))
+        // Check if the minimum time required by frame-rate has passed.
+        BOOL bFrame = m_bIsActive && m_bIsReady &&
+                      ((m_fFrameTime = m_gsFrameTimer.GetFrameTime()) >= m_fWaitTime);
+
+        if (bFrame)
+        {
+            // Mark the next frame to be measured before handling the messages, so the time
+            // spent on them is charged to the frame they affect.
+            m_gsFrameTimer.MarkFrame();
+            g_gsProfiler.MarkFrame();
+            g_gsProfiler.BeginSection("INPUT");
+        }
+
+        // Get and dispatch the messages in the queue (removing them from the queue).
+        while ((WM_QUIT != msg.message) && PeekMessage(&msg, NULL, 0, 0, PM_REMOVE))
         {
-            // If there was a message, get it (remove it from queue).
-            GetMessage(&msg, NULL, 0, 0);
             ///////////////////////////////////////////////////////////////////////////////////////
             //#####################################################################################
 #ifdef GS_ENABLE_ACCELERATORS
@@ -626,30 +658,28 @@ INT GS_Application::Run()
             //#####################################################################################
             ///////////////////////////////////////////////////////////////////////////////////////
         }
-        else
+
+        if (bFrame)
         {
-            // Render a frame during idle time.
-            if (m_bIsActive && m_bIsReady)
+            g_gsProfiler.EndSection();
+
+            // Run game loop once each frame, check if successfull.
+            if (WM_QUIT != msg.message)
             {
-                // Wait for the minimum time required by frame-rate.
-                if ((m_fFrameTime = m_gsFrameTimer.GetFrameTime()) >= m_fWaitTime)
+                g_gsProfiler.BeginSection("UPDATE");
+                if (TRUE != GameLoop())
                 {
-                    // Mark the next frame to be measured.
-                    m_gsFrameTimer.MarkFrame();
-                    // Run game loop once each frame, check if successfull.
-                    if (TRUE != GameLoop())
-                    {
-                        GS_Error::Report("GS_APP.CPP", 557, "Error running main game loop!");
-                        PostQuitMessage(0);
-                    }
+                    GS_Error::Report("GS_APP.CPP", 557, "Error running main game loop!");
+                    PostQuitMessage(0);
                 }
-            }
-            else if (!m_bIsActive)
-            {
-                // Wait for new messages.
-                WaitMessage();
+                g_gsProfiler.EndSection();
             }
         }
+        else if ((!m_bIsActive) && (WM_QUIT != msg.message))
+        {
+            // Wait for new messages.
+            WaitMessage();
+        }
     } // end while (WM_QUIT != msg.message...
 
     // Free all resources used by application.
@@ -744,8 +774,8 @@ LRESULT GS_Application::MsgProc(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lPar
                 GS_Error::Report("GS_APP.CPP", 652, "Unable to restore game!");
                 PostQuitMessage(0);
             }
-            // Mark the beginning of a new frame.
-            m_gsFrameTimer.MarkFrame();
+            // Mark the beginning of a new frame (the time spent inactive is not counted).
+            m_gsFrameTimer.Reset();
             // Set flag to indicate window IS active.
             m_bIsActive = TRUE;
         }
@@ -844,6 +874,9 @@ void GS_Application::SetFrameRate(float fFrameRate)
     {
         m_fWaitTime = 0.0f;
     }
+
+    // A capped frame rate longer than a display refresh becomes the new deadline.
+    m_gsFrameTimer.SetTargetFrameTime((m_fWaitTime > m_fRefreshTime) ? m_fWaitTime : m_fRefreshTime);
 }
 
 
@@ -910,9 +943,17 @@ GS_Application::GS_Application()
     memset(&m_rcWindowBounds, 0, sizeof(RECT));
     memset(&m_rcWindowClient, 0, sizeof(RECT));
 
-    m_fFrameRate = GS_DEFAULT_FPS;
-    m_fFrameTime = 0.0f;
-    m_fWaitTime  = 0.0f;
+    m_fFrameRate   = GS_DEFAULT_FPS;
+    m_fFrameTime   = 0.0f;
+    m_fWaitTime    = 0.0f;
+    m_fRefreshTime = DEFAULT_TARGET_FRAME_TIME;
+
+    // Benchmark builds never show a window and render offscreen instead.
+#ifdef GS_BENCHMARK
+    m_bIsHeadless = TRUE;
+#else
+    m_bIsHeadless = FALSE;
+#endif
 }
 
 GS_Application::~GS_Application()
@@ -961,6 +1002,12 @@ BOOL GS_Application::Create(int nWidth, int nHeight, int nDepth, BOOL bIsWindowe
     }
 #endif
 
+    // Headless runs are meant for machines without a sound device, so don't open one.
+    if (m_bIsHeadless)
+    {
+        SDL_setenv("SDL_AUDIODRIVER", "dummy", 0);
+    }
+
     // Initialize SDL
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_EVENTS) < 0)
     {
@@ -977,10 +1024,10 @@ BOOL GS_Application::Create(int nWidth, int nHeight, int nDepth, BOOL bIsWindowe
     m_nDisplayWidth  = (nWidth > 0) ? nWidth : GS_DEFAULT_WIDTH;
     m_nDisplayHeight = (nHeight > 0) ? nHeight : GS_DEFAULT_HEIGHT;
     m_nColorDepth    = (nDepth > 0) ? nDepth : GS_DEFAULT_DEPTH;
-    m_bIsWindowed    = bIsWindowed;
+    m_bIsWindowed    = (bIsWindowed || m_bIsHeadless);
 
     // Get desktop dimensions for fullscreen mode
-    if (!bIsWindowed)
+    if (!m_bIsWindowed)
     {
         SDL_DisplayMode dm;
         if (SDL_GetDesktopDisplayMode(0, &dm) == 0)
@@ -991,10 +1038,15 @@ BOOL GS_Application::Create(int nWidth, int nHeight, int nDepth, BOOL bIsWindowe
     }
 
     Uint32 flags = SDL_WINDOW_OPENGL | SDL_WINDOW_SHOWN;
-    if (!bIsWindowed)
+    if (!m_bIsWindowed)
     {
         flags |= SDL_WINDOW_FULLSCREEN_DESKTOP;
     }
+    if (m_bIsHeadless)
+    {
+        // The window only provides the OpenGL context, rendering goes to a framebuffer object.
+        flags = SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN;
+    }
 
     m_pWindow = SDL_CreateWindow("Game System OpenGL",
                                   SDL_WINDOWPOS_CENTERED,
@@ -1035,7 +1087,20 @@ BOOL GS_Application::Create(int nWidth, int nHeight, int nDepth, BOOL bIsWindowe
         return FALSE;
     }
 
-    m_gsFrameTimer.MarkFrame();
+    SDL_DisplayMode displayMode;
+    if ((SDL_GetCurrentDisplayMode(SDL_GetWindowDisplayIndex(m_pWindow), &displayMode) == 0) &&
+        (displayMode.refresh_rate > 0))
+    {
+        m_fRefreshTime = 1000.0f / displayMode.refresh_rate;
+    }
+    else
+    {
+        m_fRefreshTime = DEFAULT_TARGET_FRAME_TIME;
+    }
+    m_gsFrameTimer.SetTargetFrameTime((m_fWaitTime > m_fRefreshTime) ? m_fWaitTime : m_fRefreshTime);
+
+    // Start timing the first frame (the time spent loading is not counted as a frame).
+    m_gsFrameTimer.Reset();
     m_bIsReady  = TRUE;
     m_bIsActive = TRUE;
 
@@ -1107,6 +1172,19 @@ INT GS_Application::Run()
 
     while (running)
     {
+        // Check if the minimum time required by frame-rate has passed.
+        bool bFrame = m_bIsActive && m_bIsReady &&
+                      ((m_fFrameTime = m_gsFrameTimer.GetFrameTime()) >= m_fWaitTime);
+
+        if (bFrame)
+        {
+            // Mark the next frame before handling the events, so the time spent on them is
+            // charged to the frame they affect.
+            m_gsFrameTimer.MarkFrame();
+            g_gsProfiler.MarkFrame();
+            g_gsProfiler.BeginSection("INPUT");
+        }
+
         while (SDL_PollEvent(&event))
         {
             if (event.type == SDL_QUIT)
@@ -1128,7 +1206,7 @@ INT GS_Application::Run()
                     if (!m_bIsActive && m_bIsReady)
                     {
                         GameRestore();
-                        m_gsFrameTimer.MarkFrame();
+                        m_gsFrameTimer.Reset();
                         m_bIsActive = TRUE;
                     }
                 }
@@ -1296,22 +1374,22 @@ INT GS_Application::Run()
             }
         }
 
-        if (m_bIsActive && m_bIsReady)
+        if (bFrame)
         {
-            if ((m_fFrameTime = m_gsFrameTimer.GetFrameTime()) >= m_fWaitTime)
-            {
-                m_gsFrameTimer.MarkFrame();
-                if (TRUE != GameLoop())
-                {
-                    GS_Error::Report("GS_APP.CPP", 165, "Error running main game loop!");
-                    running = false;
-                }
-            }
-            else
+            g_gsProfiler.EndSection();
+
+            g_gsProfiler.BeginSection("UPDATE");
+            if (TRUE != GameLoop())
             {
-                // Small delay to prevent busy-waiting
-                SDL_Delay(1);
+                GS_Error::Report("GS_APP.CPP", 165, "Error running main game loop!");
+                running = false;
             }
+            g_gsProfiler.EndSection();
+        }
+        else if (m_bIsActive && m_bIsReady)
+        {
+            // Small delay to prevent busy-waiting
+            SDL_Delay(1);
         }
         else
         {
@@ -1360,6 +1438,9 @@ void GS_Application::SetFrameRate(float fFrameRate)
     {
         m_fWaitTime = 0.0f;
     }
+
+    // A capped frame rate longer than a display refresh becomes the new deadline.
+    m_gsFrameTimer.SetTargetFrameTime((m_fWaitTime > m_fRefreshTime) ? m_fWaitTime : m_fRefreshTime);
 }
 
 void GS_Application::ShowFrameRate()
@@ -1371,3 +1452,110 @@ void GS_Application::ShowFrameRate()
 }
 
 #endif // !GS_PLATFORM_WINDOWS
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Benchmark Methods (All Platforms) ///////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Application::RunBenchmark():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Replays a benchmark script instead of running the normal message loop. Every frame
+//          the scripted states are set, the scripted input is sent to MsgProc() and the game
+//          loop is run once with a fixed frame time, so that the session plays out the same
+//          way on every machine. The time each frame takes to update and render is reported
+//          per game state. Captured frames are compared with the reference images found in
+//          pszImageDir (or next to the script if NULL), or recorded as the reference images if
+//          bRecord is TRUE.
+// ---------------------------------------------------------------------------------------------
+// Returns: 0 if successful, 1 if not (or if a captured frame did not match its reference).
+//==============================================================================================
+
+INT GS_Application::RunBenchmark(const char* pszScript, const char* pszReport,
+                                 const char* pszImageDir, BOOL bRecord)
+{
+
+    GS_Benchmark* pBenchmark = new GS_Benchmark;
+    GS_Timer gsTimer;
+
+    // Load the script.
+    if ((!m_bIsReady) || (!pBenchmark->LoadScript(pszScript)))
+    {
+        delete pBenchmark;
+        this->Destroy();
+        return 1;
+    }
+
+    if (pszImageDir)
+    {
+        pBenchmark->SetImageDirectory(pszImageDir);
+    }
+
+    pBenchmark->SetRecord(bRecord);
+
+    // Use the same random numbers and game time every run.
+    srand(GS_BENCHMARK_SEED);
+    m_fFrameTime = GS_BENCHMARK_FRAME_TIME;
+
+    for (int nFrame = 0; (nFrame < pBenchmark->GetEndFrame()) && (m_bIsReady); nFrame++)
+    {
+        UINT        uMsg;
+        WPARAM      wParam;
+        const char* pszState;
+        int         nCapture;
+
+        // Put the game in the states set for this frame.
+        while ((pszState = pBenchmark->GetState(nFrame)) != NULL)
+        {
+            if (!this->SetBenchmarkState(pszState))
+            {
+                GS_Error::Report("GS_APP.CPP", 1500, "Unknown state in benchmark script!");
+            }
+        }
+
+        // Send the input for this frame.
+        while (pBenchmark->GetEvent(nFrame, &uMsg, &wParam))
+        {
+            this->MsgProc((HWND) this->GetWindow(), uMsg, wParam, 0);
+        }
+
+        // Determine the game state before the frame (it may change while rendering).
+        int nGameState = this->GetGameState();
+
+        g_gsProfiler.MarkFrame();
+        gsTimer.Reset();
+
+        // Run and time the game loop once.
+        g_gsProfiler.BeginSection("UPDATE");
+        if (TRUE != GameLoop())
+        {
+            GS_Error::Report("GS_APP.CPP", 1520, "Error running main game loop!");
+            break;
+        }
+        g_gsProfiler.EndSection();
+
+        float fFrameTime = gsTimer.GetTime();
+        pBenchmark->AddFrame(nGameState, this->GetGameStateName(nGameState), fFrameTime);
+
+        // Compare the rendered frame with the reference images captured on this frame.
+        while ((nCapture = pBenchmark->GetCapture(nFrame)) >= 0)
+        {
+            pBenchmark->CheckCapture(nCapture, this->GetDisplay(), m_nDisplayWidth,
+                                     m_nDisplayHeight, fFrameTime);
+        }
+    }
+
+    // Write the frame times of every game state and the results of the captures.
+    BOOL bResult = pBenchmark->WriteReport(pszReport) && (!pBenchmark->HasFailedCaptures());
+    delete pBenchmark;
+
+    // Free all resources used by application.
+    this->Destroy();
+
+    return (bResult ? 0 : 1);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
@@ -61,7 +61,9 @@
 //==============================================================================================
 // Include Game System (GS) header files.
 // ---------------------------------------------------------------------------------------------
+#include "gs_benchmark.h"
 #include "gs_error.h"
+#include "gs_profiler.h"
 #include "gs_timer.h"
 #include "gs_object.h"
 //==============================================================================================
@@ -89,6 +91,7 @@ private:
     BOOL m_bIsWindowed;       // Whether application is in windowed or fullscreen modes.
     BOOL m_bIsReady;          // Whether application has been successfully initialized.
     BOOL m_bIsPaused;         // Whether application is paused or not.
+    BOOL m_bIsHeadless;       // Whether application renders offscreen with a hidden window.
 
     int m_nDisplayWidth;      // Display width in pixels.
     int m_nDisplayHeight;     // Display height in pixels.
@@ -103,6 +106,7 @@ private:
     float         m_fFrameRate;   // Frame-rate of application.
     float         m_fFrameTime;   // Time it took to complete the last frame.
     float         m_fWaitTime;    // Time to wait between frames.
+    float         m_fRefreshTime; // Time between display refreshes (vsync interval).
 
 protected:
 
@@ -130,6 +134,24 @@ protected:
     {
         return;
     }
+    virtual int GetGameState()
+    {
+        return 0;
+    }
+    virtual const char* GetGameStateName(int nGameState)
+    {
+        (void)nGameState;
+        return "GAME";
+    }
+    virtual BOOL SetBenchmarkState(const char* pszState)
+    {
+        (void)pszState;
+        return FALSE;
+    }
+    virtual GS_OGLDisplay* GetDisplay()
+    {
+        return NULL;
+    }
 
 
 public:
@@ -142,6 +164,8 @@ public:
     void Destroy();
 
     INT Run();
+    INT RunBenchmark(const char* pszScript, const char* pszReport, const char* pszImageDir,
+                     BOOL bRecord = FALSE);
     virtual LRESULT MsgProc(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
 
     void SetFrameRate(float fFrameRate);
@@ -204,6 +228,10 @@ public:
     {
         return m_fFrameTime;
     }
+    GS_FrameTimer& GetFrameTimer()
+    {
+        return m_gsFrameTimer;
+    }
 
     void SetTitle(LPCTSTR lpString)
     {
@@ -230,6 +258,10 @@ public:
     {
         return m_bIsWindowed;
     }
+    BOOL IsHeadless()
+    {
+        return m_bIsHeadless;
+    }
 
     void Pause(BOOL bPause)
     {
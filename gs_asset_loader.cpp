@@ -0,0 +1,698 @@
+/*============================================================================================+
+ | Game System (GS) Library                                                                   |
+ |--------------------------------------------------------------------------------------------|
+ | FILES: gs_asset_loader.cpp, gs_asset_loader.h                                              |
+ |--------------------------------------------------------------------------------------------|
+ | CLASS: GS_AssetLoader                                                                      |
+ |--------------------------------------------------------------------------------------------|
+ | ABOUT: Decodes images and sound samples on a pool of worker threads. Assets are queued by  |
+ |        filename and decoded in parallel, after which GS_OGLTexture::Create() and           |
+ |        GS_SDLMixerSound::AddSample() pick up the decoded data by the same filename, so     |
+ |        only the texture upload and the sample registration are left for the main thread.   |
+ |--------------------------------------------------------------------------------------------|
+ |                                                                                    10/2026 |
+ +============================================================================================*/
+
+
+//==============================================================================================
+// Include Game System (GS) header files.
+// ---------------------------------------------------------------------------------------------
+#include "gs_asset_loader.h"
+#include "gs_profiler.h"
+#include "gs_ogl_texture.h"
+#if defined(GS_USE_SDL_SOUND)
+#include "gs_sdl_sound.h"
+#elif defined(GS_USE_SDL_MIXER)
+#include "gs_sdl_mixer_sound.h"
+#endif
+//==============================================================================================
+
+
+//==============================================================================================
+// Global variables.
+// ---------------------------------------------------------------------------------------------
+GS_AssetLoader g_gsAssetLoader;
+//==============================================================================================
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Constructor/Destructor Methods //////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_AssetLoader::GS_AssetLoader():
+// ---------------------------------------------------------------------------------------------
+// Purpose: The constructor, initializes class data when class object is created.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+GS_AssetLoader::GS_AssetLoader()
+{
+
+    m_nNumAssets = 0;
+
+    for (int nLoop = 0; nLoop < GS_ASSET_MAX_THREADS; nLoop++)
+    {
+        m_Threads[nLoop] = NULL;
+    }
+
+    m_nNumThreads = 0;
+    m_bIsRunning  = FALSE;
+
+    m_dStartTime  = 0.0;
+    m_dDecodeTime = 0.0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_AssetLoader::~GS_AssetLoader():
+// ---------------------------------------------------------------------------------------------
+// Purpose: The destructor, de-initializes class data when class object is destroyed.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+GS_AssetLoader::~GS_AssetLoader()
+{
+
+    this->Clear();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Helper Methods. /////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_AssetLoader::GetState():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Reads the state of an asset (the state is shared with the worker threads).
+// ---------------------------------------------------------------------------------------------
+// Returns: The state of the asset.
+//==============================================================================================
+
+int GS_AssetLoader::GetState(int nIndex)
+{
+
+#ifdef GS_PLATFORM_WINDOWS
+    return (int) InterlockedCompareExchange(&m_Assets[nIndex].nState, 0, 0);
+#else
+    return SDL_AtomicGet(&m_Assets[nIndex].nState);
+#endif
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_AssetLoader::SetState():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Sets the state of an asset, everything written to the asset before is visible to
+//          any thread that reads the new state.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_AssetLoader::SetState(int nIndex, int nState)
+{
+
+#ifdef GS_PLATFORM_WINDOWS
+    InterlockedExchange(&m_Assets[nIndex].nState, nState);
+#else
+    SDL_AtomicSet(&m_Assets[nIndex].nState, nState);
+#endif
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_AssetLoader::ChangeState():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Changes the state of an asset only if it still has the expected old state, so
+//          exactly one thread can claim a queued asset.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if the state was changed, FALSE if not.
+//==============================================================================================
+
+BOOL GS_AssetLoader::ChangeState(int nIndex, int nOldState, int nNewState)
+{
+
+#ifdef GS_PLATFORM_WINDOWS
+    return (InterlockedCompareExchange(&m_Assets[nIndex].nState, nNewState, nOldState) ==
+            nOldState);
+#else
+    return (SDL_AtomicCAS(&m_Assets[nIndex].nState, nOldState, nNewState) == SDL_TRUE);
+#endif
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_AssetLoader::AddAsset():
+// ---------------------------------------------------------------------------------------------
+// Purpose: ...
+// ---------------------------------------------------------------------------------------------
+// Returns: The index of the asset or -1 if failed.
+//==============================================================================================
+
+int GS_AssetLoader::AddAsset(const char* pszFilename, int nType, int nGroup)
+{
+
+    // Assets can't be added while they are being decoded.
+    if ((!pszFilename) || (m_bIsRunning))
+    {
+        return -1;
+    }
+
+    if ((m_nNumAssets >= GS_ASSET_MAX_ASSETS) || (strlen(pszFilename) >= _MAX_PATH))
+    {
+        GS_Error::Report("GS_ASSET_LOADER.CPP", 183, "Too many assets or filename too long!");
+        return -1;
+    }
+
+    GS_Asset* pAsset = &m_Assets[m_nNumAssets];
+
+    strcpy(pAsset->szFilename, pszFilename);
+    pAsset->nType         = nType;
+    pAsset->nGroup        = nGroup;
+    pAsset->pSample       = NULL;
+    pAsset->lSampleLength = 0;
+
+    this->SetState(m_nNumAssets, GS_ASSET_QUEUED);
+
+    return m_nNumAssets++;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_AssetLoader::FindAsset():
+// ---------------------------------------------------------------------------------------------
+// Purpose: ...
+// ---------------------------------------------------------------------------------------------
+// Returns: The index of the asset or -1 if it was not queued.
+//==============================================================================================
+
+int GS_AssetLoader::FindAsset(const char* pszFilename, int nType)
+{
+
+    if (!pszFilename)
+    {
+        return -1;
+    }
+
+    for (int nIndex = 0; nIndex < m_nNumAssets; nIndex++)
+    {
+        if ((m_Assets[nIndex].nType == nType) &&
+            (strcmp(m_Assets[nIndex].szFilename, pszFilename) == 0))
+        {
+            return nIndex;
+        }
+    }
+
+    return -1;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_AssetLoader::DecodeAsset():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Decodes an asset claimed by the calling thread. Only touches the asset itself, so
+//          any number of assets can be decoded at the same time.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_AssetLoader::DecodeAsset(int nIndex)
+{
+
+    GS_Asset* pAsset = &m_Assets[nIndex];
+    BOOL bResult = FALSE;
+
+    if (pAsset->nType == GS_ASSET_IMAGE)
+    {
+        // Decode the image file (from the pack if it is in there), unless the texture will be
+        // created from a compressed image the driver can use or an up to date texture cache
+        // file without it.
+        if ((!GS_OGLTexture::HasCompressed(pAsset->szFilename)) &&
+            (!GS_OGLTexture::IsCached(pAsset->szFilename)))
+        {
+            bResult = pAsset->gsImage.Load(pAsset->szFilename);
+        }
+    }
+#if defined(GS_USE_SDL_SOUND) || defined(GS_USE_SDL_MIXER)
+    else if (pAsset->nType == GS_ASSET_SAMPLE)
+    {
+        Uint8* pSample = NULL;
+        Uint32 uLength = 0;
+
+        // Decode the sample and convert it to the format of the sound device.
+#ifdef GS_USE_SDL_SOUND
+        bResult = GS_SDLSound::DecodeSample(pAsset->szFilename, &pSample, &uLength);
+#else
+        bResult = GS_SDLMixerSound::DecodeSample(pAsset->szFilename, &pSample, &uLength);
+#endif
+
+        pAsset->pSample       = (BYTE*) pSample;
+        pAsset->lSampleLength = uLength;
+    }
+#endif
+
+    // Publish the result.
+    this->SetState(nIndex, bResult ? GS_ASSET_READY : GS_ASSET_FAILED);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_AssetLoader::DecodeNextAsset():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Claims the next queued asset and decodes it.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if an asset was decoded, FALSE if there were no queued assets left.
+//==============================================================================================
+
+BOOL GS_AssetLoader::DecodeNextAsset()
+{
+
+    for (int nIndex = 0; nIndex < m_nNumAssets; nIndex++)
+    {
+        if (this->ChangeState(nIndex, GS_ASSET_QUEUED, GS_ASSET_DECODING))
+        {
+            this->DecodeAsset(nIndex);
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_AssetLoader::WaitForAsset():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Makes sure an asset has been decoded, decoding it on the calling thread if no
+//          worker has claimed it yet.
+// ---------------------------------------------------------------------------------------------
+// Returns: The state of the asset once it is no longer queued or being decoded.
+//==============================================================================================
+
+int GS_AssetLoader::WaitForAsset(int nIndex)
+{
+
+    // Decode the asset right away if no worker got to it yet.
+    if (this->ChangeState(nIndex, GS_ASSET_QUEUED, GS_ASSET_DECODING))
+    {
+        this->DecodeAsset(nIndex);
+    }
+
+    // Wait for the worker that is decoding the asset.
+    while (this->GetState(nIndex) == GS_ASSET_DECODING)
+    {
+#ifdef GS_PLATFORM_WINDOWS
+        Sleep(1);
+#else
+        SDL_Delay(1);
+#endif
+    }
+
+    return this->GetState(nIndex);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_AssetLoader::WorkerThread():
+// ---------------------------------------------------------------------------------------------
+// Purpose: The worker thread, decodes queued assets until there are none left.
+// ---------------------------------------------------------------------------------------------
+// Returns: 0.
+//==============================================================================================
+
+#ifdef GS_PLATFORM_WINDOWS
+DWORD WINAPI GS_AssetLoader::WorkerThread(LPVOID pParam)
+#else
+int GS_AssetLoader::WorkerThread(void* pParam)
+#endif
+{
+
+    GS_AssetLoader* pLoader = (GS_AssetLoader*) pParam;
+
+    while (pLoader->DecodeNextAsset())
+    {
+        // Keep decoding.
+    }
+
+    return 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Queue Methods. //////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_AssetLoader::AddImage():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Queues an image file to be decoded, GS_OGLTexture::Create() with the same filename
+//          uses the decoded image. Assets are decoded in the order they are queued in.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if failed.
+//==============================================================================================
+
+BOOL GS_AssetLoader::AddImage(const char* pszFilename, int nGroup)
+{
+
+    return (this->AddAsset(pszFilename, GS_ASSET_IMAGE, nGroup) >= 0);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_AssetLoader::AddSample():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Queues a WAV file to be decoded, GS_SDLMixerSound::AddSample() with the same
+//          filename uses the decoded sample. The sound system must be initialized before the
+//          loader is started, as samples are converted to the format of the sound device.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if failed.
+//==============================================================================================
+
+BOOL GS_AssetLoader::AddSample(const char* pszFilename, int nGroup)
+{
+
+    return (this->AddAsset(pszFilename, GS_ASSET_SAMPLE, nGroup) >= 0);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Start/Wait Methods. /////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_AssetLoader::Start():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Starts decoding the queued assets on worker threads. By default one worker is
+//          started per processor core other than the one running the main thread, which joins
+//          in when Wait() is called.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if failed.
+//==============================================================================================
+
+BOOL GS_AssetLoader::Start(int nNumThreads)
+{
+
+    if (m_bIsRunning)
+    {
+        return FALSE;
+    }
+
+    // Determine the number of workers from the number of processor cores.
+    if (nNumThreads <= 0)
+    {
+#ifdef GS_PLATFORM_WINDOWS
+        SYSTEM_INFO SystemInfo;
+        GetSystemInfo(&SystemInfo);
+        nNumThreads = (int) SystemInfo.dwNumberOfProcessors - 1;
+#else
+        nNumThreads = SDL_GetCPUCount() - 1;
+#endif
+    }
+
+    // There is no use in having more workers than assets.
+    if (nNumThreads > m_nNumAssets)
+    {
+        nNumThreads = m_nNumAssets;
+    }
+    if (nNumThreads > GS_ASSET_MAX_THREADS)
+    {
+        nNumThreads = GS_ASSET_MAX_THREADS;
+    }
+
+    // The workers check which compressed images the driver can use (see DecodeAsset()), which
+    // only the main thread can find out.
+    GS_OGLTexture::InitTextureSupport();
+
+    m_dStartTime  = g_gsProfiler.GetTime();
+    m_dDecodeTime = 0.0;
+    m_nNumThreads = 0;
+    m_bIsRunning  = TRUE;
+
+    // Start the workers (if a worker can't be started the others do its work).
+    for (int nLoop = 0; nLoop < nNumThreads; nLoop++)
+    {
+#ifdef GS_PLATFORM_WINDOWS
+        m_Threads[m_nNumThreads] = CreateThread(NULL, 0, WorkerThread, this, 0, NULL);
+#else
+        m_Threads[m_nNumThreads] = SDL_CreateThread(WorkerThread, "GS_AssetLoader", this);
+#endif
+        if (m_Threads[m_nNumThreads] != NULL)
+        {
+            m_nNumThreads++;
+        }
+    }
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_AssetLoader::Wait():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Helps the workers decode the remaining assets and waits until all are decoded.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_AssetLoader::Wait()
+{
+
+    if (!m_bIsRunning)
+    {
+        return;
+    }
+
+    // Decode on the main thread as well while there are assets left.
+    while (this->DecodeNextAsset())
+    {
+        // Keep decoding.
+    }
+
+    // Wait for the workers to finish their last asset.
+    for (int nLoop = 0; nLoop < m_nNumThreads; nLoop++)
+    {
+#ifdef GS_PLATFORM_WINDOWS
+        WaitForSingleObject(m_Threads[nLoop], INFINITE);
+        CloseHandle(m_Threads[nLoop]);
+#else
+        SDL_WaitThread(m_Threads[nLoop], NULL);
+#endif
+        m_Threads[nLoop] = NULL;
+    }
+
+    m_bIsRunning  = FALSE;
+    m_dDecodeTime = g_gsProfiler.GetTime() - m_dStartTime;
+
+#ifdef GS_DEBUG_MODE
+    char szMessage[128];
+    sprintf(szMessage, "Decoded %d assets in %.1f ms on %d threads\n", m_nNumAssets,
+            m_dDecodeTime, m_nNumThreads + 1);
+    GS_Platform::OutputDebugString(szMessage);
+#endif
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_AssetLoader::Clear():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Waits for the workers and frees every decoded asset that was not used.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_AssetLoader::Clear()
+{
+
+    this->Wait();
+
+    for (int nIndex = 0; nIndex < m_nNumAssets; nIndex++)
+    {
+        m_Assets[nIndex].gsImage.Destroy();
+
+#if defined(GS_USE_SDL_SOUND) || defined(GS_USE_SDL_MIXER)
+        if (m_Assets[nIndex].pSample != NULL)
+        {
+            SDL_free(m_Assets[nIndex].pSample);
+        }
+#endif
+        m_Assets[nIndex].pSample       = NULL;
+        m_Assets[nIndex].lSampleLength = 0;
+    }
+
+    m_nNumAssets = 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_AssetLoader::IsDone():
+// ---------------------------------------------------------------------------------------------
+// Purpose: ...
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if no assets are queued or being decoded, FALSE if not.
+//==============================================================================================
+
+BOOL GS_AssetLoader::IsDone()
+{
+
+    for (int nIndex = 0; nIndex < m_nNumAssets; nIndex++)
+    {
+        if (this->GetState(nIndex) < GS_ASSET_READY)
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_AssetLoader::IsGroupDone():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Checks without waiting whether the assets of a group have been decoded, so the
+//          main thread can pick them up while the workers carry on with the other groups.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if no asset of the group is queued or being decoded, FALSE if not.
+//==============================================================================================
+
+BOOL GS_AssetLoader::IsGroupDone(int nGroup)
+{
+
+    for (int nIndex = 0; nIndex < m_nNumAssets; nIndex++)
+    {
+        if ((m_Assets[nIndex].nGroup == nGroup) && (this->GetState(nIndex) < GS_ASSET_READY))
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Get Methods. ////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_AssetLoader::GetImage():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Hands out a decoded image (waiting for it if necessary). The caller takes over the
+//          image data and should Destroy() the image once it has been uploaded.
+// ---------------------------------------------------------------------------------------------
+// Returns: A pointer to the image or NULL if the image was not queued or failed to decode.
+//==============================================================================================
+
+GS_OGLImage* GS_AssetLoader::GetImage(const char* pszFilename)
+{
+
+    int nIndex = this->FindAsset(pszFilename, GS_ASSET_IMAGE);
+
+    if ((nIndex < 0) || (this->WaitForAsset(nIndex) != GS_ASSET_READY))
+    {
+        return NULL;
+    }
+
+    this->SetState(nIndex, GS_ASSET_TAKEN);
+
+    return &m_Assets[nIndex].gsImage;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_AssetLoader::TakeSample():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Hands out a decoded sample (waiting for it if necessary), the caller becomes the
+//          owner of the sample data (allocated with SDL_malloc).
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if the sample was not queued or failed to decode.
+//==============================================================================================
+
+BOOL GS_AssetLoader::TakeSample(const char* pszFilename, BYTE** ppSample, unsigned long* plLength)
+{
+
+    int nIndex = this->FindAsset(pszFilename, GS_ASSET_SAMPLE);
+
+    if ((nIndex < 0) || (this->WaitForAsset(nIndex) != GS_ASSET_READY))
+    {
+        return FALSE;
+    }
+
+    *ppSample = m_Assets[nIndex].pSample;
+    *plLength = m_Assets[nIndex].lSampleLength;
+
+    m_Assets[nIndex].pSample       = NULL;
+    m_Assets[nIndex].lSampleLength = 0;
+
+    this->SetState(nIndex, GS_ASSET_TAKEN);
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,153 @@
+/*============================================================================================+
+ | Game System (GS) Library                                                                   |
+ |--------------------------------------------------------------------------------------------|
+ | FILES: gs_asset_loader.cpp, gs_asset_loader.h                                              |
+ |--------------------------------------------------------------------------------------------|
+ | CLASS: GS_AssetLoader                                                                      |
+ |--------------------------------------------------------------------------------------------|
+ | ABOUT: Decodes images and sound samples on a pool of worker threads. Assets are queued by  |
+ |        filename and decoded in parallel, after which GS_OGLTexture::Create() and           |
+ |        GS_SDLMixerSound::AddSample() pick up the decoded data by the same filename, so     |
+ |        only the texture upload and the sample registration are left for the main thread.   |
+ |--------------------------------------------------------------------------------------------|
+ |                                                                                    10/2026 |
+ +============================================================================================*/
+
+#ifndef GS_ASSET_LOADER_H
+#define GS_ASSET_LOADER_H
+
+
+//==============================================================================================
+// Include platform abstraction header files.
+// ---------------------------------------------------------------------------------------------
+#include "gs_platform.h"
+//==============================================================================================
+
+//==============================================================================================
+// Include Game System (GS) header files.
+// ---------------------------------------------------------------------------------------------
+#include "gs_error.h"
+#include "gs_object.h"
+#include "gs_ogl_image.h"
+//==============================================================================================
+
+
+//==============================================================================================
+// Asset loader defines.
+// ---------------------------------------------------------------------------------------------
+#define GS_ASSET_MAX_ASSETS  64 // Maximum number of queued assets.
+#define GS_ASSET_MAX_THREADS 16 // Maximum number of worker threads.
+// ---------------------------------------------------------------------------------------------
+#define GS_ASSET_IMAGE  0 // Asset is an image (BMP, PCX or TGA).
+#define GS_ASSET_SAMPLE 1 // Asset is a sound sample (WAV).
+// ---------------------------------------------------------------------------------------------
+#define GS_ASSET_QUEUED   0 // Asset waits to be decoded.
+#define GS_ASSET_DECODING 1 // Asset is being decoded.
+#define GS_ASSET_READY    2 // Asset has been decoded.
+#define GS_ASSET_FAILED   3 // Asset could not be decoded (it will be loaded the normal way).
+#define GS_ASSET_TAKEN    4 // Decoded asset has been handed out.
+//==============================================================================================
+
+
+//==============================================================================================
+// Asset loader types and structures.
+// ---------------------------------------------------------------------------------------------
+#ifdef GS_PLATFORM_WINDOWS
+typedef volatile LONG GS_AtomicInt;
+typedef HANDLE        GS_ThreadHandle;
+#else
+typedef SDL_atomic_t  GS_AtomicInt;
+typedef SDL_Thread*   GS_ThreadHandle;
+#endif
+// ---------------------------------------------------------------------------------------------
+typedef struct GS_ASSET
+{
+    char          szFilename[_MAX_PATH]; // Filename used to load the asset.
+    int           nType;                 // GS_ASSET_IMAGE or GS_ASSET_SAMPLE.
+    int           nGroup;                // Group the asset belongs to (see IsGroupDone()).
+    GS_AtomicInt  nState;                // GS_ASSET_QUEUED, _DECODING, _READY, _FAILED or _TAKEN.
+    GS_OGLImage   gsImage;               // The decoded image.
+    BYTE*         pSample;               // The decoded sample (in the format of the sound device).
+    unsigned long lSampleLength;         // Length of the decoded sample in bytes.
+} GS_Asset;
+//==============================================================================================
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Class Definition. ///////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+class GS_AssetLoader : public GS_Object
+{
+
+private:
+
+    GS_Asset m_Assets[GS_ASSET_MAX_ASSETS]; // The queued assets.
+    int      m_nNumAssets;                  // Number of queued assets.
+
+    GS_ThreadHandle m_Threads[GS_ASSET_MAX_THREADS]; // The worker threads.
+    int             m_nNumThreads;                   // Number of worker threads started.
+    BOOL            m_bIsRunning;                    // Wether the worker threads are running.
+
+    double m_dStartTime;  // Time decoding started (in profiler time).
+    double m_dDecodeTime; // Time it took to decode all assets in milliseconds.
+
+    int  AddAsset(const char* pszFilename, int nType, int nGroup);
+    int  FindAsset(const char* pszFilename, int nType);
+    BOOL DecodeNextAsset();
+    void DecodeAsset(int nIndex);
+    int  WaitForAsset(int nIndex);
+
+    int  GetState(int nIndex);
+    void SetState(int nIndex, int nState);
+    BOOL ChangeState(int nIndex, int nOldState, int nNewState);
+
+#ifdef GS_PLATFORM_WINDOWS
+    static DWORD WINAPI WorkerThread(LPVOID pParam);
+#else
+    static int WorkerThread(void* pParam);
+#endif
+
+protected:
+
+    // No protected members.
+
+public:
+
+    GS_AssetLoader();
+    ~GS_AssetLoader();
+
+    BOOL AddImage(const char* pszFilename, int nGroup = 0);
+    BOOL AddSample(const char* pszFilename, int nGroup = 0);
+
+    BOOL Start(int nNumThreads = 0);
+    void Wait();
+    void Clear();
+
+    BOOL IsDone();
+    BOOL IsGroupDone(int nGroup);
+    int  GetNumThreads()
+    {
+        return m_nNumThreads;
+    }
+    double GetDecodeTime()
+    {
+        return m_dDecodeTime;
+    }
+
+    GS_OGLImage* GetImage(const char* pszFilename);
+    BOOL TakeSample(const char* pszFilename, BYTE** ppSample, unsigned long* plLength);
+};
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// The global asset loader checked by GS_OGLTexture and GS_SDLMixerSound before loading files.
+// ---------------------------------------------------------------------------------------------
+extern GS_AssetLoader g_gsAssetLoader;
+//==============================================================================================
+
+#endif
@@ -0,0 +1,249 @@
+/*============================================================================================+
+ | Game System (GS) Library                                                                   |
+ |--------------------------------------------------------------------------------------------|
+ | FILES: gs_audio_stats.cpp, gs_audio_stats.h                                                |
+ |--------------------------------------------------------------------------------------------|
+ | CLASS: GS_AudioStats                                                                       |
+ |--------------------------------------------------------------------------------------------|
+ | ABOUT: Performance counters of a sound backend.                                            |
+ |--------------------------------------------------------------------------------------------|
+ |                                                                                    10/2026 |
+ +============================================================================================*/
+
+
+//==============================================================================================
+// Include Game System (GS) header files.
+// ---------------------------------------------------------------------------------------------
+#include "gs_audio_stats.h"
+//==============================================================================================
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Constructor/Destructor Methods //////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_AudioStats::GS_AudioStats():
+// ---------------------------------------------------------------------------------------------
+// Purpose: The constructor, clears the counters.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+GS_AudioStats::GS_AudioStats() : m_gsHistogram(AUDIO_HISTOGRAM_MIN_TIME)
+{
+
+    SDL_AtomicSet(&m_nActiveVoices, 0);
+    SDL_AtomicSet(&m_nPeakVoices, 0);
+    SDL_AtomicSet(&m_nUnderruns, 0);
+    SDL_AtomicSet(&m_nDeviceUnderruns, 0);
+
+    m_dCountsPerMs = SDL_GetPerformanceFrequency() / 1000.0;
+    m_nFrames      = 0;
+    m_nFrequency   = 0;
+
+    m_n64LastMix     = 0;
+    m_n64LateMix     = 0;
+    m_nUnderrunsSeen = 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_AudioStats::~GS_AudioStats():
+// ---------------------------------------------------------------------------------------------
+// Purpose: The destructor, does nothing.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+GS_AudioStats::~GS_AudioStats()
+{
+
+    // Does nothing.
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Audio Thread Methods ////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_AudioStats::AddCallback():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Counts a mixing callback that took the given number of performance counter counts
+//          and left the given number of voices playing. May only be called by the audio thread,
+//          the only thread that changes the counters.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_AudioStats::AddCallback(Uint64 n64Counts, int nVoices)
+{
+
+    m_gsHistogram.Add((float) (n64Counts / m_dCountsPerMs));
+
+    SDL_AtomicSet(&m_nActiveVoices, nVoices);
+
+    if (nVoices > SDL_AtomicGet(&m_nPeakVoices))
+    {
+        SDL_AtomicSet(&m_nPeakVoices, nVoices);
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_AudioStats::CheckUnderrun():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Counts an underrun if the mix ending at the given performance counter comes more
+//          than two buffers after the last one (one buffer is being played while the next is
+//          mixed), meaning the device has played all it had and the audio thread was not given
+//          the time to mix the next buffer. May only be called by the audio thread, once per
+//          mix.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_AudioStats::CheckUnderrun(Uint64 n64Now)
+{
+
+    if ((m_n64LastMix != 0) && (n64Now - m_n64LastMix > m_n64LateMix))
+    {
+        SDL_AtomicAdd(&m_nUnderruns, 1);
+        SDL_AtomicAdd(&m_nDeviceUnderruns, 1);
+    }
+
+    m_n64LastMix = n64Now;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Game Thread Methods /////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_AudioStats::SetDevice():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Remembers the buffer size and sample rate of the device the callbacks are for, so
+//          the callback times can be compared with the length of a buffer, and starts counting
+//          the underruns of the device. Must be called before the device first calls back.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_AudioStats::SetDevice(int nFrames, int nFrequency)
+{
+
+    m_nFrames    = nFrames;
+    m_nFrequency = nFrequency;
+
+    SDL_AtomicSet(&m_nDeviceUnderruns, 0);
+
+    m_n64LastMix     = 0;
+    m_n64LateMix     = 2 * (Uint64) nFrames * SDL_GetPerformanceFrequency() / nFrequency;
+    m_nUnderrunsSeen = 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_AudioStats::HasUnderrunBurst():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Notes when the underruns counted since the last call happened and checks whether
+//          the last AUDIO_MAX_UNDERRUNS underruns of the device all happened within
+//          AUDIO_UNDERRUN_WINDOW milliseconds. Underruns spread over a long session (a few
+//          stalls of the whole system) are forgotten, only a device that keeps running dry
+//          needs a bigger buffer. Should be called once every frame, so an underrun is noted
+//          at most a frame late.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if the device underruns too often, FALSE if not.
+//==============================================================================================
+
+BOOL GS_AudioStats::HasUnderrunBurst()
+{
+
+    Uint32 uNow       = SDL_GetTicks();
+    int    nUnderruns = SDL_AtomicGet(&m_nDeviceUnderruns);
+
+    // Note the time of the underruns counted since the last frame.
+    while (m_nUnderrunsSeen < nUnderruns)
+    {
+        m_uUnderrunTicks[m_nUnderrunsSeen % AUDIO_MAX_UNDERRUNS] = uNow;
+        m_nUnderrunsSeen++;
+    }
+
+    if (m_nUnderrunsSeen < AUDIO_MAX_UNDERRUNS)
+    {
+        return FALSE;
+    }
+
+    // The oldest of the last AUDIO_MAX_UNDERRUNS underruns is the next to be overwritten.
+    return (uNow - m_uUnderrunTicks[m_nUnderrunsSeen % AUDIO_MAX_UNDERRUNS] <
+            AUDIO_UNDERRUN_WINDOW);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_AudioStats::WriteStats():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Writes the device, voice and underrun counters, the callback time percentiles and
+//          the non-empty histogram buckets to a text file.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if not.
+//==============================================================================================
+
+BOOL GS_AudioStats::WriteStats(const char* pszFilename, const char* pszBackend)
+{
+
+    GS_File gsFile;
+
+    // Open the file for writing.
+    if (!gsFile.Open(pszFilename, FILE_WRITE))
+    {
+        GS_Error::Report("GS_AUDIO_STATS.CPP", 222, "Failed to open audio statistics file!");
+        return FALSE;
+    }
+
+    float fBufferTime = (m_nFrequency > 0) ? m_nFrames * 1000.0f / m_nFrequency : 0.0f;
+
+    gsFile.WriteString("Backend:          %s\n", pszBackend);
+    gsFile.WriteString("Buffer:           %d frames at %d Hz (%0.2f ms)\n", m_nFrames,
+                       m_nFrequency, fBufferTime);
+    gsFile.WriteString("Callbacks:        %d\n", this->GetCallbacks());
+    gsFile.WriteString("Underruns:        %d\n", this->GetUnderruns());
+    gsFile.WriteString("Peak voices:      %d\n", this->GetPeakVoices());
+    gsFile.WriteString("p50:              %0.3f ms\n", this->GetPercentile(50.0f));
+    gsFile.WriteString("p95:              %0.3f ms\n", this->GetPercentile(95.0f));
+    gsFile.WriteString("p99:              %0.3f ms\n", this->GetPercentile(99.0f));
+    gsFile.WriteString("Max:              %0.3f ms\n", this->GetMaxTime());
+    gsFile.WriteString("\nHistogram (callbacks up to each limit):\n");
+
+    // Write the non-empty buckets.
+    m_gsHistogram.WriteBuckets(&gsFile, 3);
+
+    gsFile.Close();
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,117 @@
+/*============================================================================================+
+ | Game System (GS) Library                                                                   |
+ |--------------------------------------------------------------------------------------------|
+ | FILES: gs_audio_stats.cpp, gs_audio_stats.h                                                |
+ |--------------------------------------------------------------------------------------------|
+ | CLASS: GS_AudioStats                                                                       |
+ |--------------------------------------------------------------------------------------------|
+ | ABOUT: Performance counters of a sound backend. The audio thread counts the voices         |
+ |        playing, the time every mixing callback takes and the underruns, the game thread    |
+ |        reads them for display and writes them to a text file. Neither thread ever waits    |
+ |        for the other.                                                                      |
+ |--------------------------------------------------------------------------------------------|
+ |                                                                                    10/2026 |
+ +============================================================================================*/
+
+
+#ifndef GS_AUDIO_STATS_H
+#define GS_AUDIO_STATS_H
+
+
+//==============================================================================================
+// Include platform abstraction header files.
+// ---------------------------------------------------------------------------------------------
+#include "gs_platform.h"
+//==============================================================================================
+
+
+//==============================================================================================
+// Include Game System (GS) header files.
+// ---------------------------------------------------------------------------------------------
+#include "gs_error.h"
+#include "gs_file.h"
+#include "gs_histogram.h"
+//==============================================================================================
+
+
+//==============================================================================================
+// Include SDL2 header files.
+// ---------------------------------------------------------------------------------------------
+#include <SDL2/SDL.h>
+//==============================================================================================
+
+
+//==============================================================================================
+// Callback times are counted in a histogram the same way as frame times (see gs_histogram.h).
+// Bucket 0 holds callbacks shorter than AUDIO_HISTOGRAM_MIN_TIME milliseconds, the histogram
+// covers callbacks of up to about 150 ms, longer ones go into the last bucket.
+// ---------------------------------------------------------------------------------------------
+#define AUDIO_HISTOGRAM_MIN_TIME 0.01f
+//==============================================================================================
+
+
+//==============================================================================================
+// A mix more than two buffers after the last one is an underrun. An underrun now and then (the
+// window being dragged, another program starting) is put up with, the backends only raise the
+// buffer size after AUDIO_MAX_UNDERRUNS underruns within AUDIO_UNDERRUN_WINDOW milliseconds.
+// ---------------------------------------------------------------------------------------------
+#define AUDIO_MAX_UNDERRUNS   3
+#define AUDIO_UNDERRUN_WINDOW 10000
+//==============================================================================================
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Class Definition. ///////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+class GS_AudioStats
+{
+
+private:
+
+    GS_Histogram m_gsHistogram;      // Callback times (counted by the audio thread).
+    SDL_atomic_t m_nActiveVoices;    // Voices playing at the end of the last callback.
+    SDL_atomic_t m_nPeakVoices;      // The most voices playing at the end of a callback.
+    SDL_atomic_t m_nUnderruns;       // Underruns counted since the sound system was created.
+    SDL_atomic_t m_nDeviceUnderruns; // Underruns counted since the device was opened.
+
+    double m_dCountsPerMs; // Performance counter counts per millisecond.
+    int    m_nFrames;      // Size of the device buffer in sample frames (game thread).
+    int    m_nFrequency;   // Sample rate of the device (game thread).
+
+    Uint64 m_n64LastMix; // Performance counter at the end of the last mix (audio thread).
+    Uint64 m_n64LateMix; // Counts between two mixes after which the device has run dry.
+
+    Uint32 m_uUnderrunTicks[AUDIO_MAX_UNDERRUNS]; // When the last underruns were noticed (game
+                                                  // thread, in the order they were noticed).
+    int    m_nUnderrunsSeen;                      // Device underruns noticed by the game thread.
+
+public:
+
+    GS_AudioStats();
+    virtual ~GS_AudioStats();
+
+    // Audio thread methods.
+    void AddCallback(Uint64 n64Counts, int nVoices);
+    void CheckUnderrun(Uint64 n64Now);
+
+    // Game thread methods.
+    void SetDevice(int nFrames, int nFrequency);
+    BOOL HasUnderrunBurst();
+
+    int   GetActiveVoices()    { return SDL_AtomicGet(&m_nActiveVoices); }
+    int   GetPeakVoices()      { return SDL_AtomicGet(&m_nPeakVoices); }
+    int   GetUnderruns()       { return SDL_AtomicGet(&m_nUnderruns); }
+    int   GetDeviceUnderruns() { return SDL_AtomicGet(&m_nDeviceUnderruns); }
+    int   GetCallbacks()       { return m_gsHistogram.GetCount(); }
+    float GetMaxTime()         { return m_gsHistogram.GetMaxTime(); }
+    float GetPercentile(float fPercent) { return m_gsHistogram.GetPercentile(fPercent); }
+
+    BOOL WriteStats(const char* pszFilename, const char* pszBackend);
+};
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+#endif
@@ -0,0 +1,953 @@
+/*============================================================================================+
+ | Game System (GS) Library                                                                   |
+ |--------------------------------------------------------------------------------------------|
+ | FILES: gs_benchmark.cpp, gs_benchmark.h                                                    |
+ |--------------------------------------------------------------------------------------------|
+ | CLASS: GS_Benchmark                                                                        |
+ |--------------------------------------------------------------------------------------------|
+ | ABOUT: Scripted benchmark sessions. A script lists the keys to press on which frame, the   |
+ |        application replays it with a fixed frame time and the benchmark collects the time  |
+ |        of every frame per game screen, which is written to a report at the end. Frames can |
+ |        also be captured and compared with reference (golden) images.                       |
+ |--------------------------------------------------------------------------------------------|
+ |                                                                                    10/2026 |
+ +============================================================================================*/
+
+
+//==============================================================================================
+// Include Game System (GS) header files.
+// ---------------------------------------------------------------------------------------------
+#include "gs_benchmark.h"
+#include "gs_ogl_display.h"
+//==============================================================================================
+
+
+//==============================================================================================
+// Include standard C library header files.
+// ---------------------------------------------------------------------------------------------
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+//==============================================================================================
+
+
+//==============================================================================================
+// Number of frames a key is held down by the PRESS command.
+// ---------------------------------------------------------------------------------------------
+#define PRESS_FRAMES 2
+//==============================================================================================
+
+
+//==============================================================================================
+// Size of the header of an uncompressed TGA image.
+// ---------------------------------------------------------------------------------------------
+#define TGA_HEADER_SIZE 18
+//==============================================================================================
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Constructor/Destructor Methods //////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Benchmark::GS_Benchmark():
+// ---------------------------------------------------------------------------------------------
+// Purpose: The constructor, initializes class data when class object is created.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+GS_Benchmark::GS_Benchmark()
+{
+    m_nNumEvents  = 0;
+    m_nNextEvent  = 0;
+    m_nEndFrame   = 0;
+    m_nNumScreens = 0;
+
+    for (int nScreen = 0; nScreen < GS_BENCHMARK_MAX_SCREENS; nScreen++)
+    {
+        m_nScreenIDs[nScreen]     = 0;
+        m_pszScreenNames[nScreen] = NULL;
+        m_dScreenTotals[nScreen]  = 0.0;
+        m_gsScreenTimes[nScreen].SetTargetFrameTime(GS_BENCHMARK_FRAME_TIME);
+    }
+
+    m_nNumStates   = 0;
+    m_nNextState   = 0;
+    m_nNumCaptures = 0;
+    m_nNextCapture = 0;
+
+    strcpy(m_szImageDir, ".");
+    m_bRecord = FALSE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Benchmark::~GS_Benchmark():
+// ---------------------------------------------------------------------------------------------
+// Purpose: The destructor, de-initializes class data when class object is destroyed.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+GS_Benchmark::~GS_Benchmark()
+{
+    // Does nothing.
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Script Methods //////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Benchmark::GetKeyCode():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Converts a key name used in a script (ENTER, ESCAPE, SPACE, UP, DOWN, LEFT, RIGHT,
+//          BACK, TAB, DELETE or a single letter or digit) into a key code.
+// ---------------------------------------------------------------------------------------------
+// Returns: The GSK_ key code, or GSK_NONE if the name is not known.
+//==============================================================================================
+
+int GS_Benchmark::GetKeyCode(const char* pszKey)
+{
+
+    static const struct
+    {
+        const char* pszName;
+        int         nKeyCode;
+    } KeyNames[] =
+    {
+        { "ENTER",  GSK_ENTER  },
+        { "ESCAPE", GSK_ESCAPE },
+        { "SPACE",  GSK_SPACE  },
+        { "UP",     GSK_UP     },
+        { "DOWN",   GSK_DOWN   },
+        { "LEFT",   GSK_LEFT   },
+        { "RIGHT",  GSK_RIGHT  },
+        { "BACK",   GSK_BACK   },
+        { "TAB",    GSK_TAB    },
+        { "DELETE", GSK_DELETE }
+    };
+
+    // Is it a named key?
+    for (int nKey = 0; nKey < int(sizeof(KeyNames) / sizeof(KeyNames[0])); nKey++)
+    {
+        if (strcmp(pszKey, KeyNames[nKey].pszName) == 0)
+        {
+            return KeyNames[nKey].nKeyCode;
+        }
+    }
+
+    // Is it a single letter or digit (the key codes match the upper case characters)?
+    if ((strlen(pszKey) == 1) && (isalnum((unsigned char) pszKey[0])))
+    {
+        return toupper((unsigned char) pszKey[0]);
+    }
+
+    return GSK_NONE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Benchmark::AddEvent():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Adds an input event, keeping the events sorted by frame (events on the same frame
+//          stay in the order they were added).
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if there is no room for more events.
+//==============================================================================================
+
+BOOL GS_Benchmark::AddEvent(int nFrame, UINT uMsg, WPARAM wParam)
+{
+    if (m_nNumEvents >= GS_BENCHMARK_MAX_EVENTS)
+    {
+        return FALSE;
+    }
+
+    // Move later events up to make room for the new one.
+    int nEvent = m_nNumEvents;
+    while ((nEvent > 0) && (m_Events[nEvent - 1].nFrame > nFrame))
+    {
+        m_Events[nEvent] = m_Events[nEvent - 1];
+        nEvent--;
+    }
+
+    m_Events[nEvent].nFrame = nFrame;
+    m_Events[nEvent].uMsg   = uMsg;
+    m_Events[nEvent].wParam = wParam;
+
+    m_nNumEvents++;
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Benchmark::AddCommand():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Adds a STATE or CAPTURE command to the given list, keeping the list sorted by frame
+//          (commands on the same frame stay in the order they were added).
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if there is no room for more commands.
+//==============================================================================================
+
+BOOL GS_Benchmark::AddCommand(GS_BenchmarkCommand* pCommands, int* pnNumCommands, int nFrame,
+                              const char* pszName)
+{
+    if (*pnNumCommands >= GS_BENCHMARK_MAX_COMMANDS)
+    {
+        return FALSE;
+    }
+
+    // Move later commands up to make room for the new one.
+    int nCommand = *pnNumCommands;
+    while ((nCommand > 0) && (pCommands[nCommand - 1].nFrame > nFrame))
+    {
+        pCommands[nCommand] = pCommands[nCommand - 1];
+        nCommand--;
+    }
+
+    pCommands[nCommand].nFrame = nFrame;
+    strncpy(pCommands[nCommand].szName, pszName, GS_BENCHMARK_MAX_NAME - 1);
+    pCommands[nCommand].szName[GS_BENCHMARK_MAX_NAME - 1] = 0;
+
+    (*pnNumCommands)++;
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Benchmark::LoadScript():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Loads a benchmark script. Each line holds a frame number followed by a command:
+//
+//              <frame> PRESS <key>   Press a key and release it PRESS_FRAMES frames later.
+//              <frame> DOWN <key>    Press a key and hold it down.
+//              <frame> UP <key>      Release a key.
+//              <frame> STATE <name>  Put the game in a fixed state before the frame.
+//              <frame> CAPTURE <name> Compare the frame with the reference image <name>.tga.
+//              <frame> END           End the session.
+//
+//          Empty lines and lines starting with '#' are ignored. Without an END command the
+//          session ends one second after the last event.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if not.
+//==============================================================================================
+
+BOOL GS_Benchmark::LoadScript(const char* pszFilename)
+{
+
+    GS_File gsFile;
+
+    // Open the script file.
+    if (!gsFile.Open(pszFilename, FILE_READ))
+    {
+        GS_Error::Report("GS_BENCHMARK.CPP", 264, "Failed to open benchmark script!");
+        return FALSE;
+    }
+
+    // Read the whole script into memory.
+    unsigned long lLength = gsFile.GetLength();
+    char* pszScript = new char[lLength + 1];
+
+    if (gsFile.Read(pszScript, lLength) != lLength)
+    {
+        GS_Error::Report("GS_BENCHMARK.CPP", 274, "Failed to read benchmark script!");
+        delete [] pszScript;
+        return FALSE;
+    }
+
+    pszScript[lLength] = 0;
+    gsFile.Close();
+
+    // Reference images are kept next to the script unless set otherwise.
+    this->SetImageDirectory(pszFilename);
+    char* pszSeparator = strrchr(m_szImageDir, '/');
+    if ((!pszSeparator) || (strrchr(m_szImageDir, '\\') > pszSeparator))
+    {
+        pszSeparator = strrchr(m_szImageDir, '\\');
+    }
+    if (pszSeparator)
+    {
+        *pszSeparator = 0;
+    }
+    else
+    {
+        strcpy(m_szImageDir, ".");
+    }
+
+    m_nNumEvents   = 0;
+    m_nNextEvent   = 0;
+    m_nNumStates   = 0;
+    m_nNextState   = 0;
+    m_nNumCaptures = 0;
+    m_nNextCapture = 0;
+    m_nEndFrame    = -1;
+
+    BOOL bResult  = TRUE;
+    int  nLastFrame = 0;
+
+    // Go through the script one line at a time.
+    for (char* pszLine = strtok(pszScript, "\r\n"); pszLine; pszLine = strtok(NULL, "\r\n"))
+    {
+        int  nFrame = 0;
+        char szCommand[16] = {0};
+        char szKey[GS_BENCHMARK_MAX_NAME] = {0};
+
+        // Skip empty lines and comments.
+        while (isspace((unsigned char) *pszLine))
+        {
+            pszLine++;
+        }
+
+        if ((*pszLine == 0) || (*pszLine == '#'))
+        {
+            continue;
+        }
+
+        // Split the line into a frame number, a command and a key (or state or capture) name.
+        if (sscanf(pszLine, "%d %15s %31s", &nFrame, szCommand, szKey) < 2)
+        {
+            bResult = FALSE;
+            break;
+        }
+
+        for (char* pszChar = szCommand; *pszChar; pszChar++)
+        {
+            *pszChar = (char) toupper((unsigned char) *pszChar);
+        }
+
+        if (nFrame > nLastFrame)
+        {
+            nLastFrame = nFrame;
+        }
+
+        if (strcmp(szCommand, "END") == 0)
+        {
+            m_nEndFrame = nFrame;
+            continue;
+        }
+
+        // Capture names are used as file names, so they keep their case.
+        if (strcmp(szCommand, "CAPTURE") == 0)
+        {
+            bResult = (szKey[0] != 0) &&
+                      this->AddCommand(m_Captures, &m_nNumCaptures, nFrame, szKey);
+            if (!bResult)
+            {
+                break;
+            }
+            continue;
+        }
+
+        for (char* pszChar = szKey; *pszChar; pszChar++)
+        {
+            *pszChar = (char) toupper((unsigned char) *pszChar);
+        }
+
+        if (strcmp(szCommand, "STATE") == 0)
+        {
+            bResult = (szKey[0] != 0) &&
+                      this->AddCommand(m_States, &m_nNumStates, nFrame, szKey);
+            if (!bResult)
+            {
+                break;
+            }
+            continue;
+        }
+
+        int nKeyCode = this->GetKeyCode(szKey);
+
+        if (nKeyCode == GSK_NONE)
+        {
+            bResult = FALSE;
+            break;
+        }
+
+        // Arrow keys do not produce characters, all the other keys also send WM_CHAR.
+        BOOL bIsChar = ((nKeyCode < GSK_LEFT) || (nKeyCode > GSK_DOWN));
+
+        if ((strcmp(szCommand, "PRESS") == 0) || (strcmp(szCommand, "DOWN") == 0))
+        {
+            bResult = this->AddEvent(nFrame, WM_KEYDOWN, nKeyCode);
+
+            if (bResult && bIsChar)
+            {
+                bResult = this->AddEvent(nFrame, WM_CHAR, nKeyCode);
+            }
+        }
+
+        if (bResult && ((strcmp(szCommand, "PRESS") == 0) || (strcmp(szCommand, "UP") == 0)))
+        {
+            int nUpFrame = (szCommand[0] == 'P') ? (nFrame + PRESS_FRAMES) : nFrame;
+            bResult = this->AddEvent(nUpFrame, WM_KEYUP, nKeyCode);
+
+            if (nUpFrame > nLastFrame)
+            {
+                nLastFrame = nUpFrame;
+            }
+        }
+        else if (bResult && (strcmp(szCommand, "DOWN") != 0))
+        {
+            bResult = FALSE;
+        }
+
+        if (!bResult)
+        {
+            break;
+        }
+    }
+
+    delete [] pszScript;
+
+    if (!bResult)
+    {
+        GS_Error::Report("GS_BENCHMARK.CPP", 424, "Invalid command in benchmark script!");
+        return FALSE;
+    }
+
+    // End the session one second after the last event if there was no END command.
+    if (m_nEndFrame < 0)
+    {
+        m_nEndFrame = nLastFrame + int(1000.0f / GS_BENCHMARK_FRAME_TIME);
+    }
+
+    // Captures are skipped until their frame has been rendered and compared.
+    for (int nCapture = 0; nCapture < m_nNumCaptures; nCapture++)
+    {
+        m_CaptureResults[nCapture].nResult      = GS_BENCHMARK_CAPTURE_SKIP;
+        m_CaptureResults[nCapture].ulMismatched = 0;
+        m_CaptureResults[nCapture].nMaxDiff     = 0;
+        m_CaptureResults[nCapture].fFrameTime   = 0.0f;
+        m_CaptureResults[nCapture].ulDrawCalls    = 0;
+        m_CaptureResults[nCapture].ulTextureBinds = 0;
+        m_CaptureResults[nCapture].ulMatrixOps    = 0;
+        m_CaptureResults[nCapture].ulStateChanges = 0;
+        m_CaptureResults[nCapture].bIsOverBudget  = FALSE;
+    }
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Benchmark::GetEvent():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Gets the next input event to send on the given frame. Call repeatedly until it
+//          returns FALSE to get all the events for the frame.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if an event was returned, FALSE if there are no more events for the frame.
+//==============================================================================================
+
+BOOL GS_Benchmark::GetEvent(int nFrame, UINT* puMsg, WPARAM* pwParam)
+{
+    if ((m_nNextEvent >= m_nNumEvents) || (m_Events[m_nNextEvent].nFrame > nFrame))
+    {
+        return FALSE;
+    }
+
+    *puMsg   = m_Events[m_nNextEvent].uMsg;
+    *pwParam = m_Events[m_nNextEvent].wParam;
+
+    m_nNextEvent++;
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Benchmark::GetState():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Gets the next state to set before the given frame. Call repeatedly until it returns
+//          NULL to get all the states for the frame.
+// ---------------------------------------------------------------------------------------------
+// Returns: The name of the state, or NULL if there are no more states for the frame.
+//==============================================================================================
+
+const char* GS_Benchmark::GetState(int nFrame)
+{
+    if ((m_nNextState >= m_nNumStates) || (m_States[m_nNextState].nFrame > nFrame))
+    {
+        return NULL;
+    }
+
+    return m_States[m_nNextState++].szName;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Benchmark::GetCapture():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Gets the next capture to take after the given frame has been rendered. Call
+//          repeatedly until it returns -1 to get all the captures for the frame.
+// ---------------------------------------------------------------------------------------------
+// Returns: The index of the capture, or -1 if there are no more captures for the frame.
+//==============================================================================================
+
+int GS_Benchmark::GetCapture(int nFrame)
+{
+    if ((m_nNextCapture >= m_nNumCaptures) || (m_Captures[m_nNextCapture].nFrame > nFrame))
+    {
+        return -1;
+    }
+
+    return m_nNextCapture++;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Capture Methods /////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Benchmark::SetImageDirectory():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Sets the directory the reference images are read from and written to (by default
+//          the directory of the script).
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_Benchmark::SetImageDirectory(const char* pszDirectory)
+{
+    strncpy(m_szImageDir, pszDirectory, _MAX_PATH - 1);
+    m_szImageDir[_MAX_PATH - 1] = 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Benchmark::ReadImage():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Reads a reference image written by WriteImage(), an uncompressed 24 bit TGA with
+//          the origin at the bottom left, into RGB pixels.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if the file could not be read or has another format or
+//          size.
+//==============================================================================================
+
+BOOL GS_Benchmark::ReadImage(const char* pszFilename, unsigned char* pPixels, int nWidth,
+                             int nHeight)
+{
+
+    GS_File gsFile;
+    unsigned char Header[TGA_HEADER_SIZE];
+
+    if (!gsFile.Open(pszFilename, FILE_READ))
+    {
+        return FALSE;
+    }
+
+    unsigned long lSize = (unsigned long) nWidth * nHeight * 3;
+
+    if (gsFile.Read(Header, TGA_HEADER_SIZE) != TGA_HEADER_SIZE)
+    {
+        return FALSE;
+    }
+
+    // Is it an uncompressed 24 bit image of the right size?
+    if ((Header[2] != 2) || (Header[16] != 24) || (Header[17] & 0x20) ||
+        ((Header[12] | (Header[13] << 8)) != nWidth) ||
+        ((Header[14] | (Header[15] << 8)) != nHeight))
+    {
+        return FALSE;
+    }
+
+    // Skip the image identification field.
+    if (Header[0] > 0)
+    {
+        gsFile.SetPosition(TGA_HEADER_SIZE + Header[0]);
+    }
+
+    if (gsFile.Read(pPixels, lSize) != lSize)
+    {
+        return FALSE;
+    }
+
+    gsFile.Close();
+
+    // Convert from BGR to RGB.
+    for (unsigned long lPixel = 0; lPixel < lSize; lPixel += 3)
+    {
+        unsigned char ucBlue = pPixels[lPixel];
+        pPixels[lPixel]      = pPixels[lPixel + 2];
+        pPixels[lPixel + 2]  = ucBlue;
+    }
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Benchmark::WriteImage():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Writes RGB pixels (bottom row first, as read back from OpenGL) to an uncompressed
+//          24 bit TGA file.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if not.
+//==============================================================================================
+
+BOOL GS_Benchmark::WriteImage(const char* pszFilename, unsigned char* pPixels, int nWidth,
+                              int nHeight)
+{
+
+    GS_File gsFile;
+    unsigned char Header[TGA_HEADER_SIZE] = {0};
+
+    if (!gsFile.Open(pszFilename, FILE_WRITE))
+    {
+        GS_Error::Report("GS_BENCHMARK.CPP", 636, "Failed to write benchmark image!");
+        return FALSE;
+    }
+
+    Header[2]  = 2; // Uncompressed true color.
+    Header[12] = (unsigned char) (nWidth & 0xFF);
+    Header[13] = (unsigned char) (nWidth >> 8);
+    Header[14] = (unsigned char) (nHeight & 0xFF);
+    Header[15] = (unsigned char) (nHeight >> 8);
+    Header[16] = 24; // Bits per pixel, origin at the bottom left.
+
+    gsFile.Write(Header, TGA_HEADER_SIZE);
+
+    // Convert one row at a time from RGB to BGR.
+    unsigned char* pRow = new unsigned char[nWidth * 3];
+
+    for (int nRow = 0; nRow < nHeight; nRow++)
+    {
+        unsigned char* pSource = pPixels + (nRow * nWidth * 3);
+
+        for (int nCol = 0; nCol < nWidth * 3; nCol += 3)
+        {
+            pRow[nCol]     = pSource[nCol + 2];
+            pRow[nCol + 1] = pSource[nCol + 1];
+            pRow[nCol + 2] = pSource[nCol];
+        }
+
+        gsFile.Write(pRow, nWidth * 3);
+    }
+
+    delete [] pRow;
+
+    gsFile.Close();
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Benchmark::CheckCapture():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Reads back the frame that was just rendered and compares it with the reference
+//          image of the capture. A pixel matches if none of its color components differs by
+//          more than GS_BENCHMARK_TOLERANCE, the capture passes if no more than
+//          GS_BENCHMARK_MAX_MISMATCH percent of the pixels don't match. A failed frame is saved
+//          next to the reference as <name>_fail.tga. A missing reference fails the capture, only
+//          when recording (see SetRecord()) the frame is saved as the reference instead.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if the capture passed or a reference was recorded, FALSE if not.
+//==============================================================================================
+
+BOOL GS_Benchmark::CheckCapture(int nCapture, GS_OGLDisplay* pDisplay, int nWidth, int nHeight,
+                                float fFrameTime)
+{
+
+    if ((nCapture < 0) || (nCapture >= m_nNumCaptures) || (!pDisplay))
+    {
+        return FALSE;
+    }
+
+    GS_BenchmarkCapture* pResult = &m_CaptureResults[nCapture];
+    char szFilename[_MAX_PATH];
+
+    unsigned long lSize = (unsigned long) nWidth * nHeight * 3;
+    unsigned char* pFrame = new unsigned char[lSize];
+
+    pResult->fFrameTime = fFrameTime;
+
+    // Keep the render counters of the frame.
+    const GS_OGLRenderStats* pStats = pDisplay->GetRenderStats();
+    pResult->ulDrawCalls    = pStats->ulDrawCalls;
+    pResult->ulTextureBinds = pStats->ulTextureBinds;
+    pResult->ulMatrixOps    = pStats->ulMatrixOps;
+    pResult->ulStateChanges = pStats->ulStateChanges;
+    pResult->bIsOverBudget  = pDisplay->IsOverBudget(pStats);
+
+    // Read back the rendered frame.
+    if (!pDisplay->ReadPixels(pFrame, nWidth, nHeight))
+    {
+        GS_Error::Report("GS_BENCHMARK.CPP", 718, "Failed to read back benchmark frame!");
+        delete [] pFrame;
+        return FALSE;
+    }
+
+    sprintf(szFilename, "%s\\%s.tga", m_szImageDir, m_Captures[nCapture].szName);
+
+    // Make the frame the reference image when recording.
+    if (m_bRecord)
+    {
+        pResult->nResult = this->WriteImage(szFilename, pFrame, nWidth, nHeight) ?
+                           GS_BENCHMARK_CAPTURE_NEW : GS_BENCHMARK_CAPTURE_SKIP;
+        delete [] pFrame;
+        return (pResult->nResult == GS_BENCHMARK_CAPTURE_NEW);
+    }
+
+    unsigned char* pReference = new unsigned char[lSize];
+
+    // A capture without a reference image can't pass.
+    if (!this->ReadImage(szFilename, pReference, nWidth, nHeight))
+    {
+        pResult->nResult = GS_BENCHMARK_CAPTURE_MISSING;
+        delete [] pReference;
+        delete [] pFrame;
+        return FALSE;
+    }
+
+    // Compare the frame with the reference image.
+    pResult->ulMismatched = 0;
+    pResult->nMaxDiff     = 0;
+
+    for (unsigned long lPixel = 0; lPixel < lSize; lPixel += 3)
+    {
+        int nPixelDiff = 0;
+
+        for (int nComponent = 0; nComponent < 3; nComponent++)
+        {
+            int nDiff = abs(int(pFrame[lPixel + nComponent]) -
+                            int(pReference[lPixel + nComponent]));
+            if (nDiff > nPixelDiff)
+            {
+                nPixelDiff = nDiff;
+            }
+        }
+
+        if (nPixelDiff > GS_BENCHMARK_TOLERANCE)
+        {
+            pResult->ulMismatched++;
+        }
+
+        if (nPixelDiff > pResult->nMaxDiff)
+        {
+            pResult->nMaxDiff = nPixelDiff;
+        }
+    }
+
+    if ((pResult->ulMismatched * 100.0f) <= (GS_BENCHMARK_MAX_MISMATCH * (nWidth * nHeight)))
+    {
+        pResult->nResult = GS_BENCHMARK_CAPTURE_PASS;
+    }
+    else
+    {
+        pResult->nResult = GS_BENCHMARK_CAPTURE_FAIL;
+
+        // Keep the failed frame so it can be compared with the reference.
+        sprintf(szFilename, "%s\\%s_fail.tga", m_szImageDir, m_Captures[nCapture].szName);
+        this->WriteImage(szFilename, pFrame, nWidth, nHeight);
+    }
+
+    delete [] pReference;
+    delete [] pFrame;
+
+    return (pResult->nResult == GS_BENCHMARK_CAPTURE_PASS);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Benchmark::HasFailedCaptures():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Checks wether any capture did not match its reference image, had no reference
+//          image or was not taken.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if a capture failed, had no reference or was skipped, FALSE if not.
+//==============================================================================================
+
+BOOL GS_Benchmark::HasFailedCaptures()
+{
+    for (int nCapture = 0; nCapture < m_nNumCaptures; nCapture++)
+    {
+        if ((m_CaptureResults[nCapture].nResult == GS_BENCHMARK_CAPTURE_FAIL) ||
+            (m_CaptureResults[nCapture].nResult == GS_BENCHMARK_CAPTURE_SKIP) ||
+            (m_CaptureResults[nCapture].nResult == GS_BENCHMARK_CAPTURE_MISSING))
+        {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Report Methods //////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Benchmark::AddFrame():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Adds the time (in milliseconds) a frame took to the statistics of the game screen
+//          it was rendered on.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_Benchmark::AddFrame(int nScreen, const char* pszScreenName, float fFrameTime)
+{
+
+    // Find the screen (screens are reported in the order they were first seen).
+    int nIndex = 0;
+    while ((nIndex < m_nNumScreens) && (m_nScreenIDs[nIndex] != nScreen))
+    {
+        nIndex++;
+    }
+
+    if (nIndex >= m_nNumScreens)
+    {
+        if (m_nNumScreens >= GS_BENCHMARK_MAX_SCREENS)
+        {
+            return;
+        }
+
+        m_nScreenIDs[nIndex]     = nScreen;
+        m_pszScreenNames[nIndex] = pszScreenName;
+        m_nNumScreens++;
+    }
+
+    m_dScreenTotals[nIndex] += fFrameTime;
+    m_gsScreenTimes[nIndex].AddFrameTime(fFrameTime);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Benchmark::WriteReport():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Writes the number of frames, the mean, p50, p95, p99 and longest frame time and the
+//          number of missed 60Hz deadlines of every game screen, followed by the result, frame
+//          time and render counters of every capture, to a text file and to stdout.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if not.
+//==============================================================================================
+
+BOOL GS_Benchmark::WriteReport(const char* pszFilename)
+{
+
+    GS_File gsFile;
+    char szLine[256];
+
+    // Open the report file.
+    if (!gsFile.Open(pszFilename, FILE_WRITE))
+    {
+        GS_Error::Report("GS_BENCHMARK.CPP", 878, "Failed to open benchmark report!");
+        return FALSE;
+    }
+
+    sprintf(szLine, "%-16s %7s %8s %8s %8s %8s %8s %7s\n", "SCREEN", "FRAMES", "MEAN",
+            "P50", "P95", "P99", "MAX", "MISSED");
+    gsFile.WriteString("%s", szLine);
+    printf("%s", szLine);
+
+    unsigned long ulTotalFrames = 0;
+    double        dTotalTime    = 0.0;
+
+    for (int nScreen = 0; nScreen < m_nNumScreens; nScreen++)
+    {
+        GS_FrameTimer* pTimes  = &m_gsScreenTimes[nScreen];
+        unsigned long  ulFrames = pTimes->GetFramesRecorded();
+
+        sprintf(szLine, "%-16s %7lu %8.3f %8.3f %8.3f %8.3f %8.3f %7lu\n",
+                m_pszScreenNames[nScreen], ulFrames, m_dScreenTotals[nScreen] / ulFrames,
+                pTimes->GetPercentile(50.0f), pTimes->GetPercentile(95.0f),
+                pTimes->GetPercentile(99.0f), pTimes->GetMaxFrameTime(),
+                pTimes->GetMissedDeadlines());
+        gsFile.WriteString("%s", szLine);
+        printf("%s", szLine);
+
+        ulTotalFrames += ulFrames;
+        dTotalTime    += m_dScreenTotals[nScreen];
+    }
+
+    sprintf(szLine, "%-16s %7lu %8.3f\n", "TOTAL", ulTotalFrames,
+            (ulTotalFrames > 0) ? (dTotalTime / ulTotalFrames) : 0.0);
+    gsFile.WriteString("%s", szLine);
+    printf("%s", szLine);
+
+    // Add the results of the captures.
+    if (m_nNumCaptures > 0)
+    {
+        static const char* pszResults[] = { "PASS", "FAIL", "NEW", "SKIP", "MISSING" };
+
+        sprintf(szLine, "\n%-32s %7s %10s %7s %8s %6s %6s %6s %6s %6s\n", "CAPTURE", "RESULT",
+                "MISMATCHED", "MAXDIFF", "TIME", "DRAWS", "BINDS", "MATRIX", "STATE", "BUDGET");
+        gsFile.WriteString("%s", szLine);
+        printf("%s", szLine);
+
+        for (int nCapture = 0; nCapture < m_nNumCaptures; nCapture++)
+        {
+            GS_BenchmarkCapture* pResult = &m_CaptureResults[nCapture];
+
+            sprintf(szLine, "%-32s %7s %10lu %7d %8.3f %6lu %6lu %6lu %6lu %6s\n",
+                    m_Captures[nCapture].szName, pszResults[pResult->nResult],
+                    pResult->ulMismatched, pResult->nMaxDiff, pResult->fFrameTime,
+                    pResult->ulDrawCalls, pResult->ulTextureBinds, pResult->ulMatrixOps,
+                    pResult->ulStateChanges, pResult->bIsOverBudget ? "OVER" : "OK");
+            gsFile.WriteString("%s", szLine);
+            printf("%s", szLine);
+        }
+    }
+
+    gsFile.Close();
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,174 @@
+/*============================================================================================+
+ | Game System (GS) Library                                                                   |
+ |--------------------------------------------------------------------------------------------|
+ | FILES: gs_benchmark.cpp, gs_benchmark.h                                                    |
+ |--------------------------------------------------------------------------------------------|
+ | CLASS: GS_Benchmark                                                                        |
+ |--------------------------------------------------------------------------------------------|
+ | ABOUT: Scripted benchmark sessions. A script lists the keys to press on which frame, the   |
+ |        application replays it with a fixed frame time and the benchmark collects the time  |
+ |        of every frame per game screen, which is written to a report at the end. Frames can |
+ |        also be captured and compared with reference (golden) images.                       |
+ |--------------------------------------------------------------------------------------------|
+ |                                                                                    10/2026 |
+ +============================================================================================*/
+
+#ifndef GS_BENCHMARK_H
+#define GS_BENCHMARK_H
+
+
+//==============================================================================================
+// Include platform abstraction header files.
+// ---------------------------------------------------------------------------------------------
+#include "gs_platform.h"
+//==============================================================================================
+
+//==============================================================================================
+// Include Game System (GS) header files.
+// ---------------------------------------------------------------------------------------------
+#include "gs_error.h"
+#include "gs_file.h"
+#include "gs_keyboard.h"
+#include "gs_object.h"
+#include "gs_timer.h"
+//==============================================================================================
+
+
+//==============================================================================================
+// Benchmark defines.
+// ---------------------------------------------------------------------------------------------
+#define GS_BENCHMARK_MAX_EVENTS  4096 // Maximum number of input events in a script.
+#define GS_BENCHMARK_MAX_SCREENS 32   // Maximum number of game screens that can be reported.
+// ---------------------------------------------------------------------------------------------
+#define GS_BENCHMARK_FRAME_TIME  (1000.0f / 60.0f) // Game time that passes every frame.
+#define GS_BENCHMARK_SEED        1                 // Seed for random numbers (repeatable runs).
+// ---------------------------------------------------------------------------------------------
+#define GS_BENCHMARK_MAX_COMMANDS 256 // Maximum number of STATE or CAPTURE commands in a script.
+#define GS_BENCHMARK_MAX_NAME     32  // Maximum length of a state or capture name.
+// ---------------------------------------------------------------------------------------------
+#define GS_BENCHMARK_TOLERANCE    4     // Largest color difference of a matching pixel.
+#define GS_BENCHMARK_MAX_MISMATCH 0.1f  // Percentage of pixels allowed not to match.
+// ---------------------------------------------------------------------------------------------
+#define GS_BENCHMARK_CAPTURE_PASS    0 // Capture matches its reference image.
+#define GS_BENCHMARK_CAPTURE_FAIL    1 // Capture does not match its reference image.
+#define GS_BENCHMARK_CAPTURE_NEW     2 // Capture was recorded as the new reference image.
+#define GS_BENCHMARK_CAPTURE_SKIP    3 // Capture frame was never reached or could not be read.
+#define GS_BENCHMARK_CAPTURE_MISSING 4 // No reference image exists (and none was recorded).
+//==============================================================================================
+
+
+//==============================================================================================
+// Benchmark structures.
+// ---------------------------------------------------------------------------------------------
+typedef struct GS_BENCHMARK_EVENT
+{
+    int    nFrame; // The frame on which the event is sent.
+    UINT   uMsg;   // The message to send (WM_KEYDOWN, WM_KEYUP or WM_CHAR).
+    WPARAM wParam; // The key code.
+} GS_BenchmarkEvent;
+// ---------------------------------------------------------------------------------------------
+typedef struct GS_BENCHMARK_COMMAND
+{
+    int  nFrame;                         // The frame on which the command is carried out.
+    char szName[GS_BENCHMARK_MAX_NAME];  // The state to set or the name of the capture.
+} GS_BenchmarkCommand;
+// ---------------------------------------------------------------------------------------------
+typedef struct GS_BENCHMARK_CAPTURE
+{
+    int           nResult;      // GS_BENCHMARK_CAPTURE_PASS, _FAIL, _NEW, _SKIP or _MISSING.
+    unsigned long ulMismatched; // Number of pixels that did not match the reference.
+    int           nMaxDiff;     // Largest color difference found.
+    float         fFrameTime;   // Time it took to update and render the captured frame.
+    unsigned long ulDrawCalls;    // Render counters of the captured frame.
+    unsigned long ulTextureBinds;
+    unsigned long ulMatrixOps;
+    unsigned long ulStateChanges;
+    BOOL          bIsOverBudget;  // Wether any of the render counters exceeded its budget.
+} GS_BenchmarkCapture;
+//==============================================================================================
+
+
+//==============================================================================================
+// Forward declarations.
+// ---------------------------------------------------------------------------------------------
+class GS_OGLDisplay;
+//==============================================================================================
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Class Definition. ///////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+class GS_Benchmark : public GS_Object
+{
+
+private:
+
+    GS_BenchmarkEvent m_Events[GS_BENCHMARK_MAX_EVENTS]; // Input events sorted by frame.
+    int m_nNumEvents; // Number of events in the script.
+    int m_nNextEvent; // Index of the next event to send.
+    int m_nEndFrame;  // The frame on which the session ends.
+
+    int           m_nScreenIDs[GS_BENCHMARK_MAX_SCREENS];      // Screen identifiers.
+    const char*   m_pszScreenNames[GS_BENCHMARK_MAX_SCREENS];  // Screen names.
+    double        m_dScreenTotals[GS_BENCHMARK_MAX_SCREENS];   // Total time spent per screen.
+    GS_FrameTimer m_gsScreenTimes[GS_BENCHMARK_MAX_SCREENS];   // Frame times per screen.
+    int           m_nNumScreens;                               // Number of screens seen.
+
+    GS_BenchmarkCommand m_States[GS_BENCHMARK_MAX_COMMANDS];   // STATE commands by frame.
+    int m_nNumStates; // Number of STATE commands.
+    int m_nNextState; // Index of the next STATE command.
+
+    GS_BenchmarkCommand m_Captures[GS_BENCHMARK_MAX_COMMANDS];       // CAPTURE commands by frame.
+    GS_BenchmarkCapture m_CaptureResults[GS_BENCHMARK_MAX_COMMANDS]; // Result of each capture.
+    int m_nNumCaptures; // Number of CAPTURE commands.
+    int m_nNextCapture; // Index of the next CAPTURE command.
+
+    char m_szImageDir[_MAX_PATH]; // Directory holding the reference images.
+    BOOL m_bRecord;               // Wether captures are recorded as the reference images.
+
+    int  GetKeyCode(const char* pszKey);
+    BOOL AddEvent(int nFrame, UINT uMsg, WPARAM wParam);
+    BOOL AddCommand(GS_BenchmarkCommand* pCommands, int* pnNumCommands, int nFrame,
+                    const char* pszName);
+
+    BOOL ReadImage(const char* pszFilename, unsigned char* pPixels, int nWidth, int nHeight);
+    BOOL WriteImage(const char* pszFilename, unsigned char* pPixels, int nWidth, int nHeight);
+
+protected:
+
+    // No protected members.
+
+public:
+
+    GS_Benchmark();
+    ~GS_Benchmark();
+
+    BOOL LoadScript(const char* pszFilename);
+
+    int GetEndFrame()
+    {
+        return m_nEndFrame;
+    }
+    BOOL GetEvent(int nFrame, UINT* puMsg, WPARAM* pwParam);
+    const char* GetState(int nFrame);
+    int  GetCapture(int nFrame);
+
+    void SetImageDirectory(const char* pszDirectory);
+    void SetRecord(BOOL bRecord)
+    {
+        m_bRecord = bRecord;
+    }
+    BOOL CheckCapture(int nCapture, GS_OGLDisplay* pDisplay, int nWidth, int nHeight,
+                      float fFrameTime);
+    BOOL HasFailedCaptures();
+
+    void AddFrame(int nScreen, const char* pszScreenName, float fFrameTime);
+    BOOL WriteReport(const char* pszFilename);
+};
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+#endif
@@ -45,6 +45,8 @@ GS_Blocks::GS_Blocks() : GS_Application()
     m_GameSettings.bUseParticles = TRUE;
     m_GameSettings.nMusicVolume = 90;
     m_GameSettings.nEffectsVolume = 255;
+    m_GameSettings.nBufferFrames = AUDIO_BUFFER_FRAMES;
+    m_GameSettings.nMusicCrossfade = MUSIC_CROSSFADE;
 
     for (int nLoop = 0; nLoop < MAX_SCORES; nLoop++)
     {
@@ -57,6 +59,8 @@ GS_Blocks::GS_Blocks() : GS_Application()
     m_nGameProgress = 0;
     m_nOldGameProgress = 0;
 
+    m_nAssetGroups = 0;
+
     m_nGameLevel = 0;
     m_lGameScore = 0;
     m_nScoreIndex = 0;
@@ -230,8 +234,9 @@ BOOL GS_Blocks::GameInit()
     m_gsMouse.HideCursor(TRUE);
     // }
 
-    // Create the OpenGL display.
-    if (!m_gsDisplay.Create(this->GetDevice(), this->GetWidth(), this->GetHeight(), this->GetColorDepth()))
+    // Create the OpenGL display (rendering offscreen if running headless).
+    if (!m_gsDisplay.Create(this->GetDevice(), this->GetWidth(), this->GetHeight(), this->GetColorDepth(),
+                            this->IsHeadless()))
     {
         GS_Error::Report("GS_BLOCKS.CPP", 232, "Failed to create OpenGL display!");
         return FALSE;
@@ -255,6 +260,10 @@ BOOL GS_Blocks::GameInit()
         GS_Platform::OutputDebugString(szDebugMsg);
     }
 
+    // Open the sound device with the configured buffer size (the latency of the samples).
+    m_gsSound.SetBufferSize(m_GameSettings.nBufferFrames);
+    m_gsSound.SetMusicCrossfade(m_GameSettings.nMusicCrossfade);
+
     // Were we able to initialize the sound system?
     if (!m_gsSound.Initialize(GetWindow()))
     {
@@ -263,99 +272,48 @@ BOOL GS_Blocks::GameInit()
         return FALSE;
     }
 
-    // Create the background image for the game.
-    BOOL bResult = m_gsBackgroundSprite.Create("data/image_01.pcx");
-    // Set source rectangle to the display size.
-    m_gsBackgroundSprite.SetSourceRect(0, INTERNAL_RES_Y, INTERNAL_RES_X, 0);
-    // Postion the image at bottom left of screen.
-    m_gsBackgroundSprite.SetDestXY(0, 0);
-
-    // Were we successful?
-    if (FALSE == bResult)
+    // Load the game data from the pack if there is one (files not in the pack, or all files if
+    // there is no pack, are loaded from the "data" directory).
+    if (g_gsPack.Open("data.pak"))
     {
-        GS_Error::Report("GS_BLOCKS.CPP", 261, "Failed to load background image!");
+        GS_Platform::OutputDebugString("Loading game data from data.pak\n");
     }
 
-    // Create the sprite (unfiltered) used for the game title image.
-    bResult = m_gsTitleSprite.Create("data/image_02.tga", FALSE);
+    // Finish any loading still in progress (the display is being recreated).
+    g_gsAssetLoader.Clear();
 
-    // Were we successful?
-    if (FALSE == bResult)
-    {
-        GS_Error::Report("GS_BLOCKS.CPP", 269, "Failed to load title image!");
-    }
+    // Queue the images and samples of every asset group in the order the groups are needed and
+    // start decoding them in the background.
+    g_gsAssetLoader.AddImage("data/image_03.tga", ASSETS_INTRO);
 
-    // Create an unfiltered mipmap texture for the game font.
-    bResult = m_gsFontTexture.Create("data/image_03.tga", GS_MIPMAP, GL_NEAREST, GL_NEAREST);
+    char szFilename[_MAX_PATH];
 
-    // Were we successful?
-    if (FALSE == bResult)
+    for (int nSample = 1; nSample <= 14; nSample++)
     {
-        GS_Error::Report("GS_BLOCKS.CPP", 277, "Failed to load font image!");
+        sprintf(szFilename, "data/sound_%02d.wav", nSample);
+        g_gsAssetLoader.AddSample(szFilename, ASSETS_AUDIO);
     }
 
-    // Create the game font with 20 characters per line and 16x16 size per character.
-    bResult = m_gsGameFont.Create(m_gsFontTexture.GetID(), m_gsFontTexture.GetWidth(),
-                                  m_gsFontTexture.GetHeight(), 20, 16, 16);
+    g_gsAssetLoader.AddImage("data/image_05.tga", ASSETS_GAME);
+    g_gsAssetLoader.AddImage("data/image_06.tga", ASSETS_GAME);
+    g_gsAssetLoader.AddImage("data/image_01.pcx", ASSETS_TITLE);
+    g_gsAssetLoader.AddImage("data/image_02.tga", ASSETS_TITLE);
+    g_gsAssetLoader.AddImage("data/image_04.tga", ASSETS_TITLE);
 
-    // Were we successful?
-    if (FALSE == bResult)
-    {
-        GS_Error::Report("GS_BLOCKS.CPP", 286, "Failed to create game font!");
-    }
-
-    // Create a game menu using "image_04.tga" and the font texture created earlier.
-    bResult = m_gsGameMenu.Create("data/image_04.tga", m_gsFontTexture.GetID(),
-                                  m_gsFontTexture.GetWidth(), m_gsFontTexture.GetHeight(),
-                                  20, 16, 16);
-
-    // Were we successful?
-    if (FALSE == bResult)
-    {
-        GS_Error::Report("GS_BLOCKS.CPP", 296, "Failed to create game menu!");
-    }
+    g_gsAssetLoader.Start();
 
-    // Create block sprites and do not filter the texture.
-    bResult = m_gsBlockSpriteEx.Create("data/image_05.tga", 9, 9, 20, 20, FALSE);
+    // Load only what the game intro needs now, the other groups are loaded while the intro is
+    // showing and when the title screen starts (see UpdateAssets()).
+    m_nAssetGroups = 0;
+    this->LoadAssets(ASSETS_INTRO);
 
-    // Were we successful?
-    if (FALSE == bResult)
+    // Is the game already past the intro?
+    if (m_nGameProgress > GAME_INTRO)
     {
-        GS_Error::Report("GS_BLOCKS.CPP", 304, "Failed to load blocks image!");
+        // Load everything right away.
+        this->UpdateAssets(TRUE);
     }
 
-    // Create 48 particles using the "image_06.tga" image.
-    bResult = m_gsParticles.Create("data/image_06.tga", 48);
-
-    // Were we successful?
-    if (FALSE == bResult)
-    {
-        GS_Error::Report("GS_BLOCKS.CPP", 312, "Failed to load particle image!");
-    }
-
-    // Add music to list.
-    m_gsSound.AddMusic("data/music_01.mp3");
-    m_gsSound.AddMusic("data/music_02.mp3");
-
-    // Add samples to list.
-    m_gsSound.AddSample("data/sound_01.wav");
-    m_gsSound.AddSample("data/sound_02.wav");
-    m_gsSound.AddSample("data/sound_03.wav");
-    m_gsSound.AddSample("data/sound_04.wav");
-    m_gsSound.AddSample("data/sound_05.wav");
-    m_gsSound.AddSample("data/sound_06.wav");
-    m_gsSound.AddSample("data/sound_07.wav");
-    m_gsSound.AddSample("data/sound_08.wav");
-    m_gsSound.AddSample("data/sound_09.wav");
-    m_gsSound.AddSample("data/sound_10.wav");
-    m_gsSound.AddSample("data/sound_11.wav");
-    m_gsSound.AddSample("data/sound_12.wav");
-    m_gsSound.AddSample("data/sound_13.wav");
-    m_gsSound.AddSample("data/sound_14.wav");
-
-    // Set the master volume for all the sound effects.
-    m_gsSound.SetSampleMaster(m_GameSettings.nEffectsVolume);
-
     // Are we already busy playing the game?
     if ((m_nGameProgress >= PLAY_GAME) && (m_nGameProgress < GAME_OVER))
     {
@@ -399,9 +357,45 @@ BOOL GS_Blocks::GameShutdown()
     // Destroy the OpenGL display.
     m_gsDisplay.Destroy();
 
+    // Stop decoding assets (if the game is closed during the intro).
+    g_gsAssetLoader.Clear();
+
     // Shutdown the sound system.
     m_gsSound.Shutdown();
 
+    // Close the pack (after the sound system, music streams from it).
+    g_gsPack.Close();
+
+    char szTempString[_MAX_PATH] = {0};
+
+    // Determine the full pathname of the frame statistics file.
+    GetCurrentDirectory(_MAX_PATH, szTempString);
+    lstrcat(szTempString, "\\");
+    lstrcat(szTempString, FRAMES_FILE);
+
+    // Save the frame time percentiles and histogram.
+    this->GetFrameTimer().WriteStats(szTempString);
+
+    // Determine the full pathname of the audio statistics file.
+    GetCurrentDirectory(_MAX_PATH, szTempString);
+    lstrcat(szTempString, "\\");
+    lstrcat(szTempString, AUDIO_FILE);
+
+    // Save the voice counts, mixing time percentiles and underruns of the sound system.
+    m_gsSound.WriteStats(szTempString);
+
+    // Was the profiler recording?
+    if (g_gsProfiler.IsEnabled())
+    {
+        // Determine the full pathname of the trace file.
+        GetCurrentDirectory(_MAX_PATH, szTempString);
+        lstrcat(szTempString, "\\");
+        lstrcat(szTempString, PROFILE_FILE);
+
+        // Save the recorded frames as a trace file.
+        g_gsProfiler.ExportTrace(szTempString);
+    }
+
     return TRUE;
 }
 
@@ -434,7 +428,7 @@ BOOL GS_Blocks::GameRelease()
     // Reset the current modelview matrix.
     glLoadIdentity();
     // Swap buffers (double buffering) to display results.
-    SwapBuffers(GetDevice());
+    m_gsDisplay.EndRender(GetDevice());
 
     // Pause all sound.
     m_gsSound.Pause(TRUE);
@@ -486,6 +480,13 @@ BOOL GS_Blocks::GameRestore()
 BOOL GS_Blocks::GameLoop()
 {
 
+    // Load the asset groups decoded in the background during the game intro (except the title
+    // screen images), everything after the intro needs all of them.
+    this->UpdateAssets(m_nGameProgress != GAME_INTRO);
+
+    // Let the sound system recover from audio underruns.
+    m_gsSound.Update();
+
     // Run part of game depending on progress.
     switch (m_nGameProgress)
     {
@@ -544,6 +545,149 @@ BOOL GS_Blocks::GameLoop()
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
 
+//==============================================================================================
+// GS_Blocks::GetGameState():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Overrides the GetGameState() function of the base class, used by the benchmark to
+//          report frame times per game screen.
+// ---------------------------------------------------------------------------------------------
+// Returns: The current game progress.
+//==============================================================================================
+
+int GS_Blocks::GetGameState()
+{
+    return m_nGameProgress;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+//==============================================================================================
+// GS_Blocks::GetGameStateName():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Overrides the GetGameStateName() function of the base class.
+// ---------------------------------------------------------------------------------------------
+// Returns: The name of the specified game progress.
+//==============================================================================================
+
+const char* GS_Blocks::GetGameStateName(int nGameState)
+{
+    static const char* pszNames[] = { "GAME INTRO",   "TITLE INTRO", "TITLE SCREEN", "GAME OPTIONS",
+                                      "VIEW HISCORE", "NEW HISCORE", "MODE SELECT",  "LEVEL SELECT",
+                                      "PLAY GAME",    "PAUSE GAME",  "CLEAR LINES",  "LEVEL UP",
+                                      "END GAME",     "GAME OVER",   "QUIT GAME" };
+
+    if ((nGameState < GAME_INTRO) || (nGameState > QUIT_GAME))
+    {
+        return "UNKNOWN";
+    }
+
+    return pszNames[nGameState];
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+//==============================================================================================
+// GS_Blocks::SetBenchmarkState():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Overrides the SetBenchmarkState() function of the base class, puts the game in one
+//          of the fixed states used for reference images:
+//
+//          TITLE_SCREEN, GAME_OPTIONS, VIEW_HISCORE, MODE_SELECT, LEVEL_SELECT - the menus.
+//          EMPTY_BOARD - a new game at level 1.
+//          FULL_BOARD  - the play area filled up to the top rows, without any full lines.
+//          CLEAR_LINES - four full lines being cleared (followed by particle effects).
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if the state is known, FALSE if not.
+//==============================================================================================
+
+BOOL GS_Blocks::SetBenchmarkState(const char* pszState)
+{
+    static const struct
+    {
+        const char* pszName;
+        int         nGameProgress;
+    } MenuStates[] =
+    {
+        { "TITLE_SCREEN", TITLE_SCREEN },
+        { "GAME_OPTIONS", GAME_OPTIONS },
+        { "VIEW_HISCORE", VIEW_HISCORE },
+        { "MODE_SELECT",  MODE_SELECT  },
+        { "LEVEL_SELECT", LEVEL_SELECT }
+    };
+
+    // Leave the current section and any pause.
+    this->Pause(FALSE);
+    m_gsKeyboard.ClearBuffer();
+    m_gsController.ClearBuffer();
+    m_bIsInitialized = FALSE;
+
+    // Is it a menu (entered as if coming from the title screen)?
+    for (int nState = 0; nState < int(sizeof(MenuStates) / sizeof(MenuStates[0])); nState++)
+    {
+        if (strcmp(pszState, MenuStates[nState].pszName) == 0)
+        {
+            m_nOldGameProgress = (MenuStates[nState].nGameProgress == TITLE_SCREEN) ?
+                                 TITLE_INTRO : TITLE_SCREEN;
+            m_nGameProgress = MenuStates[nState].nGameProgress;
+            return TRUE;
+        }
+    }
+
+    if ((strcmp(pszState, "EMPTY_BOARD") != 0) && (strcmp(pszState, "FULL_BOARD") != 0) &&
+        (strcmp(pszState, "CLEAR_LINES") != 0))
+    {
+        return FALSE;
+    }
+
+    // Play at level 1 with no score.
+    m_nGameLevel = 1;
+    this->SetLevelProperties();
+    m_lGameScore = 0;
+    m_nLinesCleared = 0;
+    m_nTotalLinesCleared = 0;
+    m_gsParticles.SetNumParticles(0);
+
+    if (strcmp(pszState, "EMPTY_BOARD") == 0)
+    {
+        // Start a new game as if coming from the level select menu.
+        m_nOldGameProgress = LEVEL_SELECT;
+        m_nGameProgress = PLAY_GAME;
+    }
+    else if (strcmp(pszState, "FULL_BOARD") == 0)
+    {
+        // Keep playing, leaving room at the top for the active block.
+        this->FillPlayArea(0, AREA_ROWS - (BLOCK_ROWS + 2));
+        m_nOldGameProgress = PLAY_GAME;
+        m_nGameProgress = PLAY_GAME;
+    }
+    else
+    {
+        // Clear the four bottom lines.
+        this->FillPlayArea(4, 8);
+        m_nOldGameProgress = PLAY_GAME;
+        m_nGameProgress = CLEAR_LINES;
+    }
+
+    return TRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+//==============================================================================================
+// GS_Blocks::GetDisplay():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Overrides the GetDisplay() function of the base class.
+// ---------------------------------------------------------------------------------------------
+// Returns: The OpenGL display of the game.
+//==============================================================================================
+
+GS_OGLDisplay* GS_Blocks::GetDisplay()
+{
+    return &m_gsDisplay;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
 ////////////////////////////////////////////////////////////////////////////////////////////////
 // Message Handling ////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////
@@ -633,6 +777,18 @@ LRESULT GS_Blocks::MsgProc(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
                 }
             }
             break;
+        // User pressed 'o' or 'O'.
+        case 'O':
+        case 'o':
+            // Are we not entering a name into the hiscore table?
+            if (m_nGameProgress != NEW_HISCORE)
+            {
+                // Toggle the frame profiler (and its overlay) on or off.
+                g_gsProfiler.Enable(!g_gsProfiler.IsEnabled());
+                // Time the render stages on the GPU while the profiler is on.
+                m_gsDisplay.EnableGPUTiming(g_gsProfiler.IsEnabled());
+            }
+            break;
         // User pressed 'p' or 'P'.
         case 'P':
         case 'p':
@@ -917,7 +1073,7 @@ BOOL GS_Blocks::GameIntro()
     m_gsGameFont.Render();
 
     // Swap buffers to display results.
-    SwapBuffers(GetDevice());
+    m_gsDisplay.EndRender(GetDevice());
 
     /////////////////////////////////////////////////////////////////////////////////////////////
     // Do Final Cleanup /////////////////////////////////////////////////////////////////////////
@@ -928,6 +1084,13 @@ BOOL GS_Blocks::GameIntro()
     {
         // Remember where we've come from.
         m_nOldGameProgress = GAME_INTRO;
+        // Load the title screen images now rather than during the intro, where uploading them
+        // (and saving them to the texture cache) would make it stutter, and anything else that
+        // is still being decoded. The title screen needs all of them.
+        if (!this->IsAssetGroupLoaded(ASSETS_TITLE))
+        {
+            this->UpdateAssets(TRUE);
+        }
         // Is music not already playing?
         if (!m_gsSound.IsMusicPlaying(MUSIC_TITLE))
         {
@@ -1030,7 +1193,7 @@ BOOL GS_Blocks::TitleIntro()
     m_gsTitleSprite.Render();
 
     // Swap buffers to display results.
-    SwapBuffers(GetDevice());
+    m_gsDisplay.EndRender(GetDevice());
 
     /////////////////////////////////////////////////////////////////////////////////////////////
     // Do Final Cleanup /////////////////////////////////////////////////////////////////////////
@@ -1439,7 +1602,7 @@ BOOL GS_Blocks::TitleScreen()
     this->RenderFrameRate();
 
     // Swap buffers to display results.
-    SwapBuffers(GetDevice());
+    m_gsDisplay.EndRender(GetDevice());
 
     /////////////////////////////////////////////////////////////////////////////////////////////
     // Do Final Cleanup /////////////////////////////////////////////////////////////////////////
@@ -1820,7 +1983,7 @@ BOOL GS_Blocks::GameOptions()
     this->RenderFrameRate();
 
     // Swap buffers to display results.
-    SwapBuffers(GetDevice());
+    m_gsDisplay.EndRender(GetDevice());
 
     /////////////////////////////////////////////////////////////////////////////////////////////
     // Do Final Cleanup /////////////////////////////////////////////////////////////////////////
@@ -1980,7 +2143,7 @@ BOOL GS_Blocks::ViewHiscore()
     m_gsGameFont.Render();
 
     // Swap buffers to display results.
-    SwapBuffers(GetDevice());
+    m_gsDisplay.EndRender(GetDevice());
 
     /////////////////////////////////////////////////////////////////////////////////////////////
     // Do Final Cleanup /////////////////////////////////////////////////////////////////////////
@@ -2291,7 +2454,7 @@ BOOL GS_Blocks::NewHiscore()
     m_gsGameFont.SetModulateColor(1.0f, 1.0f, 1.0f, 1.0f);
 
     // Swap buffers to display results.
-    SwapBuffers(GetDevice());
+    m_gsDisplay.EndRender(GetDevice());
 
     /////////////////////////////////////////////////////////////////////////////////////////////
     // Do Final Cleanup /////////////////////////////////////////////////////////////////////////
@@ -2495,7 +2658,7 @@ BOOL GS_Blocks::ModeSelect()
     this->RenderFrameRate();
 
     // Swap buffers to display results.
-    SwapBuffers(GetDevice());
+    m_gsDisplay.EndRender(GetDevice());
 
     /////////////////////////////////////////////////////////////////////////////////////////////
     // Do Final Cleanup /////////////////////////////////////////////////////////////////////////
@@ -2706,7 +2869,7 @@ BOOL GS_Blocks::LevelSelect()
     this->RenderFrameRate();
 
     // Swap buffers to display results.
-    SwapBuffers(GetDevice());
+    m_gsDisplay.EndRender(GetDevice());
 
     /////////////////////////////////////////////////////////////////////////////////////////////
     // Do Final Cleanup /////////////////////////////////////////////////////////////////////////
@@ -2971,7 +3134,7 @@ BOOL GS_Blocks::PlayGame()
                 bIsBlockDropping = TRUE;
                 m_fInterval = 0.0f;
                 // Play appropriate sound.
-                m_gsSound.PlaySample(SAMPLE_DROP);
+                m_gsSound.PlaySample(SAMPLE_DROP, -1, this->GetBlockPanning());
             }
             else
             {
@@ -3105,7 +3268,7 @@ BOOL GS_Blocks::PlayGame()
                 // Move one place down.
                 m_nBlockRow--;
                 // Play appropriate sound.
-                m_gsSound.PlaySample(SAMPLE_MOVE);
+                m_gsSound.PlaySample(SAMPLE_MOVE, -1, this->GetBlockPanning());
             }
         }
         break;
@@ -3122,7 +3285,7 @@ BOOL GS_Blocks::PlayGame()
                     // Move one place left.
                     m_nBlockCol--;
                     // Play appropriate sound.
-                    m_gsSound.PlaySample(SAMPLE_MOVE);
+                    m_gsSound.PlaySample(SAMPLE_MOVE, -1, this->GetBlockPanning());
                 }
             }
         }
@@ -3134,7 +3297,7 @@ BOOL GS_Blocks::PlayGame()
                 // Move one place left.
                 m_nBlockCol--;
                 // Play appropriate sound.
-                m_gsSound.PlaySample(SAMPLE_MOVE);
+                m_gsSound.PlaySample(SAMPLE_MOVE, -1, this->GetBlockPanning());
             }
         }
         break;
@@ -3151,7 +3314,7 @@ BOOL GS_Blocks::PlayGame()
                     // Move one place right.
                     m_nBlockCol++;
                     // Play appropriate sound.
-                    m_gsSound.PlaySample(SAMPLE_MOVE);
+                    m_gsSound.PlaySample(SAMPLE_MOVE, -1, this->GetBlockPanning());
                 }
             }
         }
@@ -3163,7 +3326,7 @@ BOOL GS_Blocks::PlayGame()
                 // Move one place left.
                 m_nBlockCol++;
                 // Play appropriate sound.
-                m_gsSound.PlaySample(SAMPLE_MOVE);
+                m_gsSound.PlaySample(SAMPLE_MOVE, -1, this->GetBlockPanning());
             }
         }
         break;
@@ -3261,7 +3424,7 @@ BOOL GS_Blocks::PlayGame()
             // Block has stopped.
             bIsBlockStopped = TRUE;
             // Play appropriate sound.
-            m_gsSound.PlaySample(SAMPLE_PLACE);
+            m_gsSound.PlaySample(SAMPLE_PLACE, -1, this->GetBlockPanning());
         }
         // Do not adjust the display position.
         nMoveAdjust = 0;
@@ -3395,7 +3558,7 @@ BOOL GS_Blocks::PlayGame()
     this->RenderFrameRate();
 
     // Swap buffers to display results.
-    SwapBuffers(GetDevice());
+    m_gsDisplay.EndRender(GetDevice());
 
     /////////////////////////////////////////////////////////////////////////////////////////////
     // Do Final Cleanup /////////////////////////////////////////////////////////////////////////
@@ -3484,7 +3647,7 @@ BOOL GS_Blocks::PauseGame()
         m_gsGameFont.SetDestY(((INTERNAL_RES_Y - m_gsGameFont.GetTextHeight()) / 2) - 16);
         m_gsGameFont.Render();
         // Swap buffers to display results.
-        SwapBuffers(GetDevice());
+        m_gsDisplay.EndRender(GetDevice());
     }
     else
     {
@@ -3702,7 +3865,7 @@ BOOL GS_Blocks::ClearLines()
         // Display frame rate.
         this->RenderFrameRate();
         // Swap buffers to display results.
-        SwapBuffers(GetDevice());
+        m_gsDisplay.EndRender(GetDevice());
     }
 
     /////////////////////////////////////////////////////////////////////////////////////////////
@@ -3731,7 +3894,7 @@ BOOL GS_Blocks::ClearLines()
                         // Decrease the number of special elements.
                         m_nSpecialElements--;
                         // Play an appropriate sound effect.
-                        m_gsSound.PlaySample(SAMPLE_SPECIAL);
+                        m_gsSound.PlaySample(SAMPLE_SPECIAL, -1, this->PlayAreaColToPanning(nCols));
                     }
                 }
             }
@@ -3765,7 +3928,7 @@ BOOL GS_Blocks::ClearLines()
         {
             // Add to the game score and play the appropriate sound sample.
             m_lGameScore += (((SCORE_BASE * m_nGameLevel) + (SCORE_BASE * 4)) * 4);
-            m_gsSound.PlaySample(SAMPLE_BIG_BOOM, 255);
+            m_gsSound.PlaySample(SAMPLE_BIG_BOOM, 255, this->GetBlockPanning());
             // Start particle effects at the first row.
             this->RenderParticles(48, nLinesToClear[0]);
         }
@@ -3774,7 +3937,7 @@ BOOL GS_Blocks::ClearLines()
         {
             // Add to the game score and play the appropriate sound sample.
             m_lGameScore += (((SCORE_BASE * m_nGameLevel) + (SCORE_BASE * 3)) * 3);
-            m_gsSound.PlaySample(SAMPLE_BOOM, 255);
+            m_gsSound.PlaySample(SAMPLE_BOOM, 255, this->GetBlockPanning());
             // Start particle effects at the first row.
             this->RenderParticles(36, nLinesToClear[0]);
         }
@@ -3783,7 +3946,7 @@ BOOL GS_Blocks::ClearLines()
         {
             // Add to the game score and play the appropriate sound sample.
             m_lGameScore += (((SCORE_BASE * m_nGameLevel) + (SCORE_BASE * 2)) * 2);
-            m_gsSound.PlaySample(SAMPLE_BOOM, 205);
+            m_gsSound.PlaySample(SAMPLE_BOOM, 205, this->GetBlockPanning());
             // Start particle effects at the first row.
             this->RenderParticles(24, nLinesToClear[0]);
         }
@@ -3792,7 +3955,7 @@ BOOL GS_Blocks::ClearLines()
         {
             // Add to the game score and play the appropriate sound sample.
             m_lGameScore += (((SCORE_BASE * m_nGameLevel) + (SCORE_BASE * 1)) * 1);
-            m_gsSound.PlaySample(SAMPLE_BOOM, 155);
+            m_gsSound.PlaySample(SAMPLE_BOOM, 155, this->GetBlockPanning());
             // Start particle effects at the first row.
             this->RenderParticles(12, nLinesToClear[0]);
         }
@@ -3927,7 +4090,7 @@ BOOL GS_Blocks::LevelUp()
     m_gsGameFont.Render();
 
     // Swap buffers to display results.
-    SwapBuffers(GetDevice());
+    m_gsDisplay.EndRender(GetDevice());
 
     /////////////////////////////////////////////////////////////////////////////////////////////
     // Do Final Cleanup /////////////////////////////////////////////////////////////////////////
@@ -4171,7 +4334,7 @@ BOOL GS_Blocks::EndGame()
     this->RenderFrameRate();
 
     // Swap buffers to display results.
-    SwapBuffers(GetDevice());
+    m_gsDisplay.EndRender(GetDevice());
 
     /////////////////////////////////////////////////////////////////////////////////////////////
     // Do Final Cleanup /////////////////////////////////////////////////////////////////////////
@@ -4282,7 +4445,7 @@ BOOL GS_Blocks::EndGame()
        m_gsGameFont.Render();
 
        // Swap buffers to display results.
-       SwapBuffers(GetDevice());
+       m_gsDisplay.EndRender(GetDevice());
 
        /////////////////////////////////////////////////////////////////////////////////////////////
        // Do Final Cleanup /////////////////////////////////////////////////////////////////////////
@@ -4432,7 +4595,7 @@ BOOL GS_Blocks::GameOver()
     m_gsGameFont.Render();
 
     // Swap buffers to display results.
-    SwapBuffers(GetDevice());
+    m_gsDisplay.EndRender(GetDevice());
 
     /////////////////////////////////////////////////////////////////////////////////////////////
     // Do Final Cleanup /////////////////////////////////////////////////////////////////////////
@@ -4614,7 +4777,7 @@ BOOL GS_Blocks::QuitGame()
     m_gsGameFont.Render();
 
     // Swap buffers to display results.
-    SwapBuffers(GetDevice());
+    m_gsDisplay.EndRender(GetDevice());
 
     /////////////////////////////////////////////////////////////////////////////////////////////
     // Do Final Cleanup /////////////////////////////////////////////////////////////////////////
@@ -5476,7 +5639,7 @@ void GS_Blocks::TurnBlock(BOOL bTurnRight)
     else
     {
         // Play appropriate sound.
-        m_gsSound.PlaySample(SAMPLE_TURN);
+        m_gsSound.PlaySample(SAMPLE_TURN, -1, this->GetBlockPanning());
     }
 }
 
@@ -5493,6 +5656,8 @@ void GS_Blocks::TurnBlock(BOOL bTurnRight)
 void GS_Blocks::RenderBlock(int nDestX, int nDestY, int nBlockID, float fAlpha)
 {
 
+    GS_PROFILE_SCOPE("BLOCK");
+
     GameBlock TempBlock;
 
     // Select the block depending on the block ID.
@@ -5566,6 +5731,8 @@ void GS_Blocks::RenderBlock(int nDestX, int nDestY, int nBlockID, float fAlpha)
 void GS_Blocks::RenderBlock(int nDestX, int nDestY, GameBlock &TempBlock, float fAlpha)
 {
 
+    GS_PROFILE_SCOPE("BLOCK");
+
     // Set the alpha value to determine the transparency of the block.
     m_gsBlockSpriteEx.SetModulateColor(-1.0f, -1.0f, -1.0f, fAlpha);
 
@@ -5609,6 +5776,8 @@ void GS_Blocks::RenderBlock(int nDestX, int nDestY, GameBlock &TempBlock, float
 void GS_Blocks::RenderNextBlock(float fAlpha)
 {
 
+    GS_OGL_PROFILE_STAGE(m_gsDisplay, "NEXT BLOCK");
+
     // Determine the alpha component of the sprite (0.0f is transparent).
     m_gsBlockSpriteEx.SetModulateColor(-1.0f, -1.0f, -1.0f, fAlpha);
 
@@ -5668,6 +5837,37 @@ void GS_Blocks::ClearPlayArea()
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
 
+//==============================================================================================
+// GS_Blocks::FillPlayArea():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Fills the play area with a fixed pattern of all the block types. The bottom
+//          nFullRows rows are completely filled, the rows above them up to nRows have one empty
+//          element each (so they can't be cleared) and the rest of the play area is empty.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing
+//==============================================================================================
+
+void GS_Blocks::FillPlayArea(int nFullRows, int nRows)
+{
+
+    this->ClearPlayArea();
+
+    for (int nRow = 0; (nRow < nRows) && (nRow < AREA_ROWS); nRow++)
+    {
+        for (int nCol = 0; nCol < AREA_COLS; nCol++)
+        {
+            // Leave a different element empty in every row that should not be full.
+            if ((nRow >= nFullRows) && (nCol == ((nRow * 5) % AREA_COLS)))
+            {
+                continue;
+            }
+            m_PlayArea[nRow][nCol] = ((nRow + nCol) % BLOCK_TYPES) + 1;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
 //==============================================================================================
 // GS_Blocks::FindPlayAreaRowToClear():
 // ---------------------------------------------------------------------------------------------
@@ -5763,6 +5963,38 @@ int GS_Blocks::PlayAreaRowToY(int nRow)
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
 
+int GS_Blocks::PlayAreaColToPanning(int nCol, int nNumCols)
+{
+
+    // Pan by the center of the columns, left of the play area to the left and right of it to
+    // the right (the center of the play area is 128).
+    int nPanning = 128 + ((2 * nCol + nNumCols - AREA_COLS) * AUDIO_PAN_SPREAD) /
+                         (AREA_COLS - 1);
+
+    // Blocks may stick out of the play area with their empty columns.
+    if (nPanning < 128 - AUDIO_PAN_SPREAD)
+    {
+        nPanning = 128 - AUDIO_PAN_SPREAD;
+    }
+    if (nPanning > 128 + AUDIO_PAN_SPREAD)
+    {
+        nPanning = 128 + AUDIO_PAN_SPREAD;
+    }
+
+    return nPanning;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+int GS_Blocks::GetBlockPanning()
+{
+
+    // Sounds of the active block come from where it is in the play area.
+    return this->PlayAreaColToPanning(m_nBlockCol, BLOCK_COLS);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
 //==============================================================================================
 // GS_Blocks::RenderPlayAreaElement():
 // ---------------------------------------------------------------------------------------------
@@ -5806,6 +6038,8 @@ void GS_Blocks::RenderPlayAreaElement(int nCol, int nRow, float fAlpha)
 void GS_Blocks::RenderPlayArea(float fAlpha)
 {
 
+    GS_OGL_PROFILE_STAGE(m_gsDisplay, "PLAY AREA");
+
     // Determine the alpha component of the sprite (0.0f is transparent).
     m_gsBlockSpriteEx.SetModulateColor(-1.0f, -1.0f, -1.0f, fAlpha);
 
@@ -5849,6 +6083,8 @@ void GS_Blocks::RenderPlayArea(float fAlpha)
 void GS_Blocks::RenderBackground(float fAlpha)
 {
 
+    GS_OGL_PROFILE_STAGE(m_gsDisplay, "BACKGROUND");
+
     // Set the alpha value to determine the transparency of the background.
     m_gsBackgroundSprite.SetModulateColor(-1.0f, -1.0f, -1.0f, fAlpha);
 
@@ -5876,6 +6112,8 @@ void GS_Blocks::RenderBackground(float fAlpha)
 void GS_Blocks::RenderGameStats(float fAlpha)
 {
 
+    GS_OGL_PROFILE_STAGE(m_gsDisplay, "GAME STATS");
+
     // Set the modulate color for all the headings.
     m_gsGameFont.SetModulateColor(1.0f, 1.0f, 1.0f, fAlpha);
 
@@ -5977,6 +6215,8 @@ void GS_Blocks::RenderGameStats(float fAlpha)
 void GS_Blocks::RenderFrameRate(float fAlpha)
 {
 
+    GS_OGL_PROFILE_STAGE(m_gsDisplay, "OVERLAY");
+
     // Set the transparency of the font (0.0f is totally transparent).
     m_gsGameFont.SetModulateColor(-1.0f, -1.0f, -1.0f, fAlpha);
 
@@ -5991,6 +6231,155 @@ void GS_Blocks::RenderFrameRate(float fAlpha)
         // Reset the alpha value (transparency) of the font.
         m_gsGameFont.SetModulateColor(-1.0f, -1.0f, -1.0f, 1.0f);
     }
+
+    // Is the profiler recording?
+    if (g_gsProfiler.IsEnabled())
+    {
+        this->RenderProfiler(fAlpha);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+//==============================================================================================
+// GS_Blocks::RenderProfiler():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Displays the average time spent in each profiled section at the top left of the
+//          screen, indented according to the nesting of the sections.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_Blocks::RenderProfiler(float fAlpha)
+{
+
+    // Get the most recently completed frame.
+    const GS_ProfileFrame* pFrame = g_gsProfiler.GetFrame(0);
+
+    // Has a frame been recorded yet?
+    if (!pFrame)
+    {
+        return;
+    }
+
+    // Set the transparency of the font (0.0f is totally transparent).
+    m_gsGameFont.SetModulateColor(-1.0f, -1.0f, -1.0f, fAlpha);
+    // Use a smaller font so that all the sections fit on screen.
+    m_gsGameFont.SetScaleXY(0.5f, 0.5f);
+
+    int nDestY = INTERNAL_RES_Y - 24;
+
+    // Display the average frame time (in milliseconds).
+    m_gsGameFont.SetText("FRAME     %6.2f", g_gsProfiler.GetAverageFrameTime());
+    m_gsGameFont.SetDestXY(16, nDestY);
+    m_gsGameFont.Render();
+
+    // Display the frame time percentiles and the number of missed vsync deadlines.
+    GS_FrameTimer& gsFrameTimer = this->GetFrameTimer();
+    nDestY -= 10;
+    m_gsGameFont.SetText("P50 %5.1f P95 %5.1f P99 %5.1f", gsFrameTimer.GetPercentile(50.0f),
+                         gsFrameTimer.GetPercentile(95.0f), gsFrameTimer.GetPercentile(99.0f));
+    m_gsGameFont.SetDestXY(16, nDestY);
+    m_gsGameFont.Render();
+    nDestY -= 10;
+    m_gsGameFont.SetText("MAX %5.1f MISSED %lu", gsFrameTimer.GetMaxFrameTime(),
+                         gsFrameTimer.GetMissedDeadlines());
+    m_gsGameFont.SetDestXY(16, nDestY);
+    m_gsGameFont.Render();
+
+    // Display the voices playing (and the most that have), the mixing time percentiles and
+    // the number of audio underruns. SDL_mixer only lets its post mix work be timed, not the
+    // mixing itself.
+    nDestY -= 10;
+    m_gsGameFont.SetText("VOICES %d PEAK %d UNDERRUNS %d", m_gsSound.GetActiveVoices(),
+                         m_gsSound.GetPeakVoices(), m_gsSound.GetTotalUnderruns());
+    m_gsGameFont.SetDestXY(16, nDestY);
+    m_gsGameFont.Render();
+    nDestY -= 10;
+#ifdef GS_USE_SDL_MIXER
+    m_gsGameFont.SetText("POST MIX P50 %5.2f P99 %5.2f", m_gsSound.GetMixTime(50.0f),
+                         m_gsSound.GetMixTime(99.0f));
+#else
+    m_gsGameFont.SetText("MIX P50 %5.2f P99 %5.2f", m_gsSound.GetMixTime(50.0f),
+                         m_gsSound.GetMixTime(99.0f));
+#endif
+    m_gsGameFont.SetDestXY(16, nDestY);
+    m_gsGameFont.Render();
+
+    // Display the render counters of the last frame, highlighted if over budget.
+    const GS_OGLRenderStats* pStats = m_gsDisplay.GetRenderStats();
+    GS_OGLColor gsFontColor;
+    m_gsGameFont.GetModulateColor(&gsFontColor);
+    if (m_gsDisplay.IsOverBudget())
+    {
+        m_gsGameFont.SetModulateColor(m_gsSelectColor.fRed, m_gsSelectColor.fGreen,
+                                      m_gsSelectColor.fBlue, fAlpha);
+    }
+    nDestY -= 10;
+    m_gsGameFont.SetText("DRAWS %lu VERTS %lu BINDS %lu", pStats->ulDrawCalls,
+                         pStats->ulVertices, pStats->ulTextureBinds);
+    m_gsGameFont.SetDestXY(16, nDestY);
+    m_gsGameFont.Render();
+    nDestY -= 10;
+    m_gsGameFont.SetText("MATRIX %lu STATE %lu OVER %lu", pStats->ulMatrixOps,
+                         pStats->ulStateChanges, m_gsDisplay.GetFramesOverBudget());
+    m_gsGameFont.SetDestXY(16, nDestY);
+    m_gsGameFont.Render();
+    m_gsGameFont.SetModulateColor(gsFontColor);
+
+    // Go through all the sections of the frame.
+    for (int nSection = 0; nSection < pFrame->nNumSections; nSection++)
+    {
+        const GS_ProfileSection* pSection = &pFrame->Sections[nSection];
+
+        // Was a section with the same name already displayed?
+        BOOL bIsDuplicate = FALSE;
+        for (int nPrev = 0; nPrev < nSection; nPrev++)
+        {
+            if (strcmp(pFrame->Sections[nPrev].pszName, pSection->pszName) == 0)
+            {
+                bIsDuplicate = TRUE;
+                break;
+            }
+        }
+
+        if (bIsDuplicate)
+        {
+            continue;
+        }
+
+        nDestY -= 10;
+
+        // Display the average section time, indented by the depth of the section.
+        m_gsGameFont.SetText("%*s%-*s%6.2f", pSection->nDepth, "", 10 - pSection->nDepth,
+                             pSection->pszName, g_gsProfiler.GetAverageSectionTime(pSection->pszName));
+        m_gsGameFont.SetDestXY(16, nDestY);
+        m_gsGameFont.Render();
+    }
+
+    // Display the smoothed GPU time of each render stage (if timer queries are available).
+    if (m_gsDisplay.IsGPUTimingEnabled())
+    {
+        nDestY -= 20;
+        m_gsGameFont.SetText("GPU");
+        m_gsGameFont.SetDestXY(16, nDestY);
+        m_gsGameFont.Render();
+
+        for (int nStage = 0; nStage < m_gsDisplay.GetGPUStageCount(); nStage++)
+        {
+            const GS_OGLGPUStage* pStage = m_gsDisplay.GetGPUStage(nStage);
+
+            nDestY -= 10;
+            m_gsGameFont.SetText("%*s%-*s%6.2f", pStage->nDepth, "", 10 - pStage->nDepth,
+                                 pStage->pszName, pStage->fTime);
+            m_gsGameFont.SetDestXY(16, nDestY);
+            m_gsGameFont.Render();
+        }
+    }
+
+    // Reset the font scale and transparency.
+    m_gsGameFont.SetScaleXY(1.0f, 1.0f);
+    m_gsGameFont.SetModulateColor(-1.0f, -1.0f, -1.0f, 1.0f);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
@@ -6006,6 +6395,8 @@ void GS_Blocks::RenderFrameRate(float fAlpha)
 void GS_Blocks::RenderParticles(int nNumParticles, int nAreaRow, int nAreaCol)
 {
 
+    GS_OGL_PROFILE_STAGE(m_gsDisplay, "PARTICLES");
+
     // Is particle effects disabled?
     if (!m_GameSettings.bUseParticles)
     {
@@ -6147,6 +6538,213 @@ void GS_Blocks::RenderParticles(int nNumParticles, int nAreaRow, int nAreaCol)
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
 
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Asset Methods ///////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+//==============================================================================================
+// GS_Blocks::LoadAssets():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Creates the textures, sprites, music and samples of an asset group. The images and
+//          samples are taken from the asset loader, waiting for any still being decoded.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_Blocks::LoadAssets(int nGroup)
+{
+
+    BOOL bResult;
+
+    switch (nGroup)
+    {
+    case ASSETS_INTRO:
+        // Create an unfiltered mipmap texture for the game font.
+        bResult = m_gsFontTexture.Create("data/image_03.tga", GS_MIPMAP, GL_NEAREST, GL_NEAREST);
+
+        // Were we successful?
+        if (FALSE == bResult)
+        {
+            GS_Error::Report("GS_BLOCKS.CPP", 277, "Failed to load font image!");
+        }
+
+        // Create the game font with 20 characters per line and 16x16 size per character.
+        bResult = m_gsGameFont.Create(m_gsFontTexture.GetID(), m_gsFontTexture.GetWidth(),
+                                      m_gsFontTexture.GetHeight(), 20, 16, 16);
+
+        // Were we successful?
+        if (FALSE == bResult)
+        {
+            GS_Error::Report("GS_BLOCKS.CPP", 286, "Failed to create game font!");
+        }
+        break;
+
+    case ASSETS_TITLE:
+        // Create the background image for the game.
+        bResult = m_gsBackgroundSprite.Create("data/image_01.pcx");
+        // Set source rectangle to the display size.
+        m_gsBackgroundSprite.SetSourceRect(0, INTERNAL_RES_Y, INTERNAL_RES_X, 0);
+        // Postion the image at bottom left of screen.
+        m_gsBackgroundSprite.SetDestXY(0, 0);
+
+        // Were we successful?
+        if (FALSE == bResult)
+        {
+            GS_Error::Report("GS_BLOCKS.CPP", 261, "Failed to load background image!");
+        }
+
+        // Create the sprite (unfiltered) used for the game title image.
+        bResult = m_gsTitleSprite.Create("data/image_02.tga", FALSE);
+
+        // Were we successful?
+        if (FALSE == bResult)
+        {
+            GS_Error::Report("GS_BLOCKS.CPP", 269, "Failed to load title image!");
+        }
+
+        // Create a game menu using "image_04.tga" and the font texture created earlier.
+        bResult = m_gsGameMenu.Create("data/image_04.tga", m_gsFontTexture.GetID(),
+                                      m_gsFontTexture.GetWidth(), m_gsFontTexture.GetHeight(),
+                                      20, 16, 16);
+
+        // Were we successful?
+        if (FALSE == bResult)
+        {
+            GS_Error::Report("GS_BLOCKS.CPP", 296, "Failed to create game menu!");
+        }
+        break;
+
+    case ASSETS_AUDIO:
+        // Add music to list.
+        m_gsSound.AddMusic("data/music_01.mp3");
+        m_gsSound.AddMusic("data/music_02.mp3");
+
+        // Add samples to list (in the order of the SAMPLE_ defines, loaded in parallel).
+        {
+            const char* pszSamples[] = {
+                "data/sound_01.wav", "data/sound_02.wav", "data/sound_03.wav",
+                "data/sound_04.wav", "data/sound_05.wav", "data/sound_06.wav",
+                "data/sound_07.wav", "data/sound_08.wav", "data/sound_09.wav",
+                "data/sound_10.wav", "data/sound_11.wav", "data/sound_12.wav",
+                "data/sound_13.wav", "data/sound_14.wav"
+            };
+
+            m_gsSound.AddSamples(pszSamples, sizeof(pszSamples) / sizeof(pszSamples[0]));
+        }
+
+        // Moves and turns repeat as fast as keys are pressed, so they only get a couple of
+        // voices and may be stolen. Speech plays once at a time and other samples never steal it.
+        m_gsSound.SetSampleVoices(SAMPLE_MOVE, 2, 64);
+        m_gsSound.SetSampleVoices(SAMPLE_TURN, 2, 64);
+        m_gsSound.SetSampleVoices(SAMPLE_OPTION, 2, 96);
+        m_gsSound.SetSampleVoices(SAMPLE_SELECT, 2, 96);
+        m_gsSound.SetSampleVoices(SAMPLE_DROP, 2);
+        m_gsSound.SetSampleVoices(SAMPLE_PLACE, 2);
+        m_gsSound.SetSampleVoices(SAMPLE_BOOM, 4, 192);
+        m_gsSound.SetSampleVoices(SAMPLE_BIG_BOOM, 4, 192);
+        m_gsSound.SetSampleVoices(SAMPLE_SPECIAL, 4, 192);
+        m_gsSound.SetSampleVoices(SAMPLE_GOOD_LUCK, 1, 255);
+        m_gsSound.SetSampleVoices(SAMPLE_WELL_DONE, 1, 255);
+        m_gsSound.SetSampleVoices(SAMPLE_FANTASTIC, 1, 255);
+        m_gsSound.SetSampleVoices(SAMPLE_GAME_OVER, 1, 255);
+        m_gsSound.SetSampleVoices(SAMPLE_GOOD_SCORE, 1, 255);
+
+        // Set the master volume for all the sound effects.
+        m_gsSound.SetSampleMaster(m_GameSettings.nEffectsVolume);
+        break;
+
+    case ASSETS_GAME:
+        // Create block sprites and do not filter the texture.
+        bResult = m_gsBlockSpriteEx.Create("data/image_05.tga", 9, 9, 20, 20, FALSE);
+
+        // Were we successful?
+        if (FALSE == bResult)
+        {
+            GS_Error::Report("GS_BLOCKS.CPP", 304, "Failed to load blocks image!");
+        }
+
+        // Create 48 particles using the "image_06.tga" image.
+        bResult = m_gsParticles.Create("data/image_06.tga", 48);
+
+        // Were we successful?
+        if (FALSE == bResult)
+        {
+            GS_Error::Report("GS_BLOCKS.CPP", 312, "Failed to load particle image!");
+        }
+        break;
+    } // end switch
+
+    // The groups are loaded in order.
+    m_nAssetGroups = nGroup + 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+//==============================================================================================
+// GS_Blocks::UpdateAssets():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Loads the next asset group once the asset loader has decoded it, at most one group
+//          per frame so the intro keeps running smoothly. The title screen images are large and
+//          left for when the title screen starts. If bWait is TRUE all remaining groups are
+//          loaded right away, waiting for them to be decoded.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_Blocks::UpdateAssets(BOOL bWait)
+{
+
+    // Have all asset groups been loaded already?
+    if (m_nAssetGroups >= ASSET_GROUPS)
+    {
+        return;
+    }
+
+    while (m_nAssetGroups < ASSET_GROUPS)
+    {
+        // Leave the next group for a later frame if it is still being decoded, or for the start
+        // of the title screen if it is the title screen images.
+        if ((!bWait) && ((m_nAssetGroups == ASSETS_TITLE) ||
+                         (!g_gsAssetLoader.IsGroupDone(m_nAssetGroups))))
+        {
+            return;
+        }
+
+        this->LoadAssets(m_nAssetGroups);
+
+        if (!bWait)
+        {
+            break;
+        }
+    }
+
+    // Have all asset groups been loaded now?
+    if (m_nAssetGroups >= ASSET_GROUPS)
+    {
+        // Stop the decoding threads and free any decoded assets that were not used.
+        g_gsAssetLoader.Clear();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+//==============================================================================================
+// GS_Blocks::IsAssetGroupLoaded():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Checks whether an asset group has been loaded (the groups are loaded in order).
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if the textures, sprites and sounds of the asset group have been created,
+//          FALSE if not.
+//==============================================================================================
+
+BOOL GS_Blocks::IsAssetGroupLoaded(int nGroup)
+{
+
+    return (nGroup < m_nAssetGroups);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
 ////////////////////////////////////////////////////////////////////////////////////////////////
 // Load/Save Methods ///////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////
@@ -6250,6 +6848,26 @@ BOOL GS_Blocks::LoadSettings()
         m_GameSettings.nEffectsVolume = 255;
     }
 
+    nResult = gsIniFile.ReadInt("Sound", "BufferFrames", -1);
+    if (nResult >= 0)
+    {
+        m_GameSettings.nBufferFrames = nResult;
+    }
+    else
+    {
+        m_GameSettings.nBufferFrames = AUDIO_BUFFER_FRAMES;
+    }
+
+    nResult = gsIniFile.ReadInt("Sound", "MusicCrossfade", -1);
+    if (nResult >= 0)
+    {
+        m_GameSettings.nMusicCrossfade = nResult;
+    }
+    else
+    {
+        m_GameSettings.nMusicCrossfade = MUSIC_CROSSFADE;
+    }
+
     // Close the INI file.
     gsIniFile.Close();
 
@@ -6296,6 +6914,8 @@ BOOL GS_Blocks::SaveSettings()
     // Write sound settings.
     gsIniFile.WriteInt("Sound", "MusicVolume", m_GameSettings.nMusicVolume);
     gsIniFile.WriteInt("Sound", "EffectsVolume", m_GameSettings.nEffectsVolume);
+    gsIniFile.WriteInt("Sound", "BufferFrames", m_GameSettings.nBufferFrames);
+    gsIniFile.WriteInt("Sound", "MusicCrossfade", m_GameSettings.nMusicCrossfade);
 
     // Close the INI file.
     gsIniFile.Close();
@@ -33,6 +33,9 @@
 // ---------------------------------------------------------------------------------------------
 #define SETTINGS_FILE "settings.dat"
 #define HISCORES_FILE "hiscores.dat"
+#define PROFILE_FILE  "profile.json"
+#define FRAMES_FILE   "framestats.txt"
+#define AUDIO_FILE    "audiostats.txt"
 // ---------------------------------------------------------------------------------------------
 #define INTERNAL_RES_X 640
 #define INTERNAL_RES_Y 480
@@ -55,11 +58,21 @@
 // ---------------------------------------------------------------------------------------------
 #define MAX_SCORES 10
 // ---------------------------------------------------------------------------------------------
+#define AUDIO_BUFFER_FRAMES 512 // Low latency, so the moves are heard when they're made.
+#define AUDIO_PAN_SPREAD 80     // How far sounds are panned from the center at the edges.
+#define MUSIC_CROSSFADE 1000    // Milliseconds the music crossfades over between screens.
+// ---------------------------------------------------------------------------------------------
 #define MAX_LEVEL 9
 // ---------------------------------------------------------------------------------------------
 #define MAX_SPECIAL_ELEMENTS 5
 #define SPECIAL_ELEMENT 9
 // ---------------------------------------------------------------------------------------------
+#define ASSETS_INTRO 0 // Font (all the game intro needs).
+#define ASSETS_AUDIO 1 // Music and samples.
+#define ASSETS_GAME 2  // Block and particle images.
+#define ASSETS_TITLE 3 // Background, title and menu images (loaded when the title screen starts).
+#define ASSET_GROUPS 4
+
 #define MUSIC_TITLE 0
 #define MUSIC_GAME 1
 // ---------------------------------------------------------------------------------------------
@@ -108,6 +121,8 @@ typedef struct GAMESETTINGS
     BOOL bUseParticles;  // Wether we should use particle effects or not.
     int nMusicVolume;    // The volume of the music.
     int nEffectsVolume;  // The volume of the sound effects.
+    int nBufferFrames;   // The size of the audio buffer in sample frames (the latency).
+    int nMusicCrossfade; // The time music crossfades over in milliseconds (0 for none).
 } GameSettings;
 // ---------------------------------------------------------------------------------------------
 typedef struct GAMESCORE
@@ -154,6 +169,8 @@ private:
     int m_nGameProgress;    // Keeps track of the game progress.
     int m_nOldGameProgress; // Keeps track of the game progress.
 
+    int m_nAssetGroups; // Number of asset groups loaded (they are loaded in order).
+
     int m_nGameLevel;  // Keeps track of the game level.
     long m_lGameScore; // Keeps track of the game score.
     int m_nScoreIndex; // Keeps track of the last score.
@@ -214,6 +231,10 @@ protected:
     BOOL GameRestore();
     BOOL GameLoop();
     void OnChangeMode();
+    int GetGameState();
+    const char* GetGameStateName(int nGameState);
+    BOOL SetBenchmarkState(const char* pszState);
+    GS_OGLDisplay* GetDisplay();
 
 public:
     // The constuctor and destructor.
@@ -253,10 +274,13 @@ public:
 
     // Methods for manipulating the play area.
     void ClearPlayArea();
+    void FillPlayArea(int nFullRows, int nRows);
     int FindPlayAreaRowToClear();
     void ClearPlayAreaRow(int nRowToClear);
     int PlayAreaColToX(int nCol);
     int PlayAreaRowToY(int nRow);
+    int PlayAreaColToPanning(int nCol, int nNumCols = 1);
+    int GetBlockPanning();
     void RenderPlayAreaElement(int nRow, int nCol, float fAlpha = 1.0f);
     void RenderPlayArea(float fAlpha = 1.0f);
 
@@ -264,8 +288,14 @@ public:
     void RenderBackground(float fAlpha = 1.0f);
     void RenderGameStats(float fAlpha = 1.0f);
     void RenderFrameRate(float fAlpha = 1.0f);
+    void RenderProfiler(float fAlpha = 1.0f);
     void RenderParticles(int nNumParticles = 0, int nAreaRow = -1, int nAreaCol = -1);
 
+    // Methods for loading the assets in groups while the game intro is showing.
+    void LoadAssets(int nGroup);
+    void UpdateAssets(BOOL bWait = FALSE);
+    BOOL IsAssetGroupLoaded(int nGroup);
+
     // Methods for loading and saving data.
     BOOL LoadSettings();
     BOOL SaveSettings();
@@ -46,6 +46,17 @@ GS_File::GS_File()
     }
 
     m_bIsOpened = FALSE;
+
+#ifdef GS_PLATFORM_WINDOWS
+    m_MappingHandle = NULL;
+#endif
+    m_pMappedData     = NULL;
+    m_lMappedSize     = 0;
+    m_bIsMappedCopy   = FALSE;
+
+    m_pReadBuffer   = NULL;
+    m_pReadPosition = NULL;
+    m_pReadEnd      = NULL;
 }
 
 
@@ -64,6 +75,13 @@ GS_File::~GS_File()
 {
 
     this->Close();
+
+    // Free the read buffer.
+    if (m_pReadBuffer != NULL)
+    {
+        delete [] m_pReadBuffer;
+    }
+    m_pReadBuffer = NULL;
 }
 
 
@@ -166,6 +184,11 @@ BOOL GS_File::Open(const char* pszFilename, FILE_MODE_FLAGS FileMode)
         m_FileHandle = CreateFile(szFullname, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS,
                                   FILE_ATTRIBUTE_NORMAL, NULL);
         break;
+    // If map-mode is specified, open an existing file for reading (others may read it too).
+    case FILE_MAP:
+        m_FileHandle = CreateFile(szFullname, GENERIC_READ, FILE_SHARE_READ, NULL,
+                                  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        break;
     // Exit if no valid mode was specified.
     default:
         return FALSE;
@@ -176,12 +199,21 @@ BOOL GS_File::Open(const char* pszFilename, FILE_MODE_FLAGS FileMode)
     {
         return FALSE;
     }
+
+    m_FileMode = FileMode;
+    m_bIsOpened = TRUE;
 #else
+    // Exit if no valid mode was specified.
+    if ((FileMode != FILE_READ) && (FileMode != FILE_WRITE) && (FileMode != FILE_MAP))
+    {
+        return FALSE;
+    }
+
     // Normalize the path
     GS_Platform::NormalizePath(szFullname);
     
     // Open file using standard C functions
-    const char* mode = (FileMode == FILE_READ) ? "rb" : "wb";
+    const char* mode = (FileMode == FILE_WRITE) ? "wb" : "rb";
     m_FileHandle = fopen(szFullname, mode);
     
     if (!m_FileHandle)
@@ -193,6 +225,27 @@ BOOL GS_File::Open(const char* pszFilename, FILE_MODE_FLAGS FileMode)
     m_bIsOpened = TRUE;
 #endif
 
+    // Map the contents of the file into memory if map-mode was specified.
+    if ((FileMode == FILE_MAP) && (!this->Map()))
+    {
+        this->Close();
+        return FALSE;
+    }
+
+    // Allocate the buffer for reading ahead if read-mode was specified (it is kept for the
+    // next file opened with this object).
+    if ((FileMode == FILE_READ) && (m_pReadBuffer == NULL))
+    {
+        m_pReadBuffer = new BYTE[FILE_BUFFER_SIZE];
+    }
+
+    // Start with an empty read buffer.
+    if (FileMode == FILE_READ)
+    {
+        m_pReadPosition = m_pReadBuffer;
+        m_pReadEnd      = m_pReadBuffer;
+    }
+
     return TRUE;
 }
 
@@ -210,6 +263,14 @@ BOOL GS_File::Open(const char* pszFilename, FILE_MODE_FLAGS FileMode)
 
 void GS_File::Close()
 {
+
+    // Release the contents of a mapped file.
+    this->Unmap();
+
+    // Discard any bytes left in the read buffer.
+    m_pReadPosition = NULL;
+    m_pReadEnd      = NULL;
+
 #ifdef GS_PLATFORM_WINDOWS
     if (m_FileHandle != INVALID_HANDLE_VALUE)
     {
@@ -231,6 +292,140 @@ void GS_File::Close()
 ////////////////////////////////////////////////////////////////////////////////////////////////
 
 
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Memory Mapping Methods. /////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_File::Map():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Maps the entire contents of the opened file into (read only) memory, so they can
+//          be accessed through GetData() without copying. If the file can't be mapped it is
+//          read into memory instead.
+// ---------------------------------------------------------------------------------------------
+// Returns: True if successfull, FALSE if failed.
+//==============================================================================================
+
+BOOL GS_File::Map()
+{
+
+    // Release any previously mapped contents.
+    this->Unmap();
+
+    // Get the size of the file, an empty file can't be mapped.
+    m_lMappedSize = this->GetLength();
+
+    if (m_lMappedSize == 0)
+    {
+        return FALSE;
+    }
+
+#ifdef GS_PLATFORM_WINDOWS
+    // Create a read only mapping object for the whole file.
+    m_MappingHandle = CreateFileMapping(m_FileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+
+    if (m_MappingHandle != NULL)
+    {
+        // Map a view of the entire file.
+        m_pMappedData = (BYTE*) MapViewOfFile(m_MappingHandle, FILE_MAP_READ, 0, 0, 0);
+
+        if (m_pMappedData == NULL)
+        {
+            CloseHandle(m_MappingHandle);
+            m_MappingHandle = NULL;
+        }
+    }
+#else
+    // Map the whole file, pages are read in from disk the first time they are accessed.
+    void* pMapping = mmap(NULL, m_lMappedSize, PROT_READ, MAP_PRIVATE, fileno(m_FileHandle), 0);
+
+    if (pMapping != MAP_FAILED)
+    {
+        m_pMappedData = (BYTE*) pMapping;
+    }
+#endif
+
+    // Read the file into memory if it could not be mapped.
+    if (m_pMappedData == NULL)
+    {
+        BYTE* pCopy = new BYTE[m_lMappedSize];
+
+        if ((pCopy == NULL) || (!this->SetPosition(0)) ||
+            (this->Read(pCopy, m_lMappedSize) != m_lMappedSize))
+        {
+            GS_Error::Report("GS_FILE.CPP", 329, "Failed to map file into memory!");
+            if (pCopy != NULL)
+            {
+                delete [] pCopy;
+            }
+            m_lMappedSize = 0;
+            return FALSE;
+        }
+
+        m_pMappedData   = pCopy;
+        m_bIsMappedCopy = TRUE;
+    }
+
+    // The whole file can be read straight from memory.
+    m_pReadPosition = m_pMappedData;
+    m_pReadEnd      = m_pMappedData + m_lMappedSize;
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_File::Unmap():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Releases the contents of a mapped file, any pointers returned by GetData() become
+//          invalid.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_File::Unmap()
+{
+
+    if (m_pMappedData != NULL)
+    {
+        if (m_bIsMappedCopy)
+        {
+            delete [] m_pMappedData;
+        }
+        else
+        {
+#ifdef GS_PLATFORM_WINDOWS
+            UnmapViewOfFile(m_pMappedData);
+#else
+            munmap(m_pMappedData, m_lMappedSize);
+#endif
+        }
+    }
+
+#ifdef GS_PLATFORM_WINDOWS
+    if (m_MappingHandle != NULL)
+    {
+        CloseHandle(m_MappingHandle);
+    }
+    m_MappingHandle = NULL;
+#endif
+
+    m_pMappedData     = NULL;
+    m_lMappedSize     = 0;
+    m_bIsMappedCopy   = FALSE;
+
+    m_pReadPosition = NULL;
+    m_pReadEnd      = NULL;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
 ////////////////////////////////////////////////////////////////////////////////////////////////
 // File-state Methods. //////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////
@@ -348,6 +543,12 @@ unsigned long GS_File::GetLength()
         return 0;
     }
 
+    // The size of a mapped file is already known.
+    if (m_pMappedData != NULL)
+    {
+        return m_lMappedSize;
+    }
+
 #ifdef GS_PLATFORM_WINDOWS
     // Save the current file position.
     unsigned long lOldPos = SetFilePointer(m_FileHandle, 0, NULL, FILE_CURRENT);
@@ -391,6 +592,53 @@ unsigned long GS_File::GetLength()
 ////////////////////////////////////////////////////////////////////////////////////////////////
 
 
+//==============================================================================================
+// GS_File::GetModifiedTime():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Gets the time the opened file was last written to, in seconds. Only meant to tell
+//          wether a file has changed, the epoch differs between platforms.
+// ---------------------------------------------------------------------------------------------
+// Returns: The time the file was last modified, or 0 if file has not been opened.
+//==============================================================================================
+
+unsigned long GS_File::GetModifiedTime()
+{
+
+    // Exit if the file has not been opened.
+    if (!m_bIsOpened)
+    {
+        return 0;
+    }
+
+#ifdef GS_PLATFORM_WINDOWS
+    FILETIME ftLastWrite;
+
+    if (!GetFileTime(m_FileHandle, NULL, NULL, &ftLastWrite))
+    {
+        return 0;
+    }
+
+    // Convert from 100 nanosecond intervals to seconds.
+    ULONGLONG ullTime = (((ULONGLONG) ftLastWrite.dwHighDateTime) << 32) |
+                        ftLastWrite.dwLowDateTime;
+
+    return (unsigned long) (ullTime / 10000000);
+#else
+    struct stat FileStat;
+
+    if (fstat(fileno(m_FileHandle), &FileStat) != 0)
+    {
+        return 0;
+    }
+
+    return (unsigned long) FileStat.st_mtime;
+#endif
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
 //==============================================================================================
 // GS_File::GetPosition():
 // ---------------------------------------------------------------------------------------------
@@ -408,10 +656,18 @@ unsigned long GS_File::GetPosition()
         return 0;
     }
 
+    if (m_pMappedData != NULL)
+    {
+        return (unsigned long)(m_pReadPosition - m_pMappedData);
+    }
+
+    // The bytes still in the read buffer have not been read yet.
+    unsigned long lBuffered = (unsigned long)(m_pReadEnd - m_pReadPosition);
+
 #ifdef GS_PLATFORM_WINDOWS
-    return(SetFilePointer(m_FileHandle, 0, NULL, FILE_CURRENT));
+    return(SetFilePointer(m_FileHandle, 0, NULL, FILE_CURRENT) - lBuffered);
 #else
-    return (unsigned long)ftell(m_FileHandle);
+    return (unsigned long)ftell(m_FileHandle) - lBuffered;
 #endif
 }
 
@@ -437,6 +693,20 @@ BOOL GS_File::SetPosition(unsigned long lPosition)
         return FALSE;
     }
 
+    if (m_pMappedData != NULL)
+    {
+        if (lPosition > m_lMappedSize)
+        {
+            return FALSE;
+        }
+        m_pReadPosition = m_pMappedData + lPosition;
+        return TRUE;
+    }
+
+    // Discard the read buffer, it will be filled from the new position.
+    m_pReadPosition = m_pReadBuffer;
+    m_pReadEnd      = m_pReadBuffer;
+
 #ifdef GS_PLATFORM_WINDOWS
     return(SetFilePointer(m_FileHandle, lPosition, NULL, FILE_BEGIN) != 0xFFFFFFFF);
 #else
@@ -454,43 +724,81 @@ BOOL GS_File::SetPosition(unsigned long lPosition)
 
 
 //==============================================================================================
-// GS_File::GetByte():
+// GS_File::FillBuffer():
 // ---------------------------------------------------------------------------------------------
-// Purpose: ...
+// Purpose: Reads the next block of the file into the read buffer (read-mode only, a mapped
+//          file is in memory already).
 // ---------------------------------------------------------------------------------------------
-// Returns: The byte read or FILE_READ_FAILED if failed.
+// Returns: TRUE if any bytes were read, FALSE at the end of the file or if failed.
 //==============================================================================================
 
-unsigned long GS_File::GetByte()
+BOOL GS_File::FillBuffer()
 {
 
-    // Exit if the file has not been opened.
-    if (!m_bIsOpened)
+    // Exit if the file is not being read through the read buffer.
+    if ((!m_bIsOpened) || (m_pReadBuffer == NULL) || (m_pMappedData != NULL))
     {
-        return FILE_READ_FAILED;
+        return FALSE;
     }
 
-    char cByte;
-    
+    unsigned long lBytesRead = 0;
+
 #ifdef GS_PLATFORM_WINDOWS
-    unsigned long lBytesRead;
-    if (!ReadFile(m_FileHandle, &cByte, 1, &lBytesRead, NULL))
+    if (!ReadFile(m_FileHandle, m_pReadBuffer, FILE_BUFFER_SIZE, &lBytesRead, NULL))
+    {
+        GS_Error::Report("GS_FILE.CPP", 702, "Failed to read from file!");
+        lBytesRead = 0;
+    }
+#else
+    lBytesRead = (unsigned long) fread(m_pReadBuffer, 1, FILE_BUFFER_SIZE, m_FileHandle);
+#endif
+
+    m_pReadPosition = m_pReadBuffer;
+    m_pReadEnd      = m_pReadBuffer + lBytesRead;
+
+    return (lBytesRead > 0);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_File::ReadByte():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Refills the read buffer for GetByte() and PeekByte() once it has run empty.
+// ---------------------------------------------------------------------------------------------
+// Returns: The byte read or FILE_READ_FAILED if failed.
+//==============================================================================================
+
+unsigned long GS_File::ReadByte(BOOL bAdvance)
+{
+
+    // Exit if the file has not been opened.
+    if (!m_bIsOpened)
     {
-        GS_Error::Report("GS_FILE.CPP", 398, "Failed to read from file!");
         return FILE_READ_FAILED;
     }
-    if (lBytesRead == 1)
+
+    // Any bytes left in memory?
+    if ((m_pReadPosition < m_pReadEnd) || (this->FillBuffer()))
     {
+        char cByte = (char) *m_pReadPosition;
+
+        if (bAdvance)
+        {
+            m_pReadPosition++;
+        }
+
         return ((unsigned long) cByte);
     }
-#else
-    if (fread(&cByte, 1, 1, m_FileHandle) == 1)
+
+    // Only report reading past the end of the file, peeking at it is fine.
+    if (bAdvance)
     {
-        return ((unsigned long) cByte);
+        GS_Error::Report("GS_FILE.CPP", 407, "Failed to read byte from file!");
     }
-#endif
 
-    GS_Error::Report("GS_FILE.CPP", 407, "Failed to read byte from file!");
     return FILE_READ_FAILED;
 }
 
@@ -520,19 +828,73 @@ unsigned long GS_File::Read(void* pBuffer, unsigned long lByteCount)
         return 0;
     }
 
-#ifdef GS_PLATFORM_WINDOWS
-    unsigned long lBytesRead;
-    if (ReadFile(m_FileHandle, pBuffer, lByteCount, &lBytesRead, NULL))
+    unsigned long lBytesCopied = 0;
+
+    // Copy the bytes that are in memory already (read buffer or mapped file) first.
+    if (m_pReadPosition < m_pReadEnd)
     {
-        return lBytesRead;
+        lBytesCopied = (unsigned long)(m_pReadEnd - m_pReadPosition);
+        if (lBytesCopied > lByteCount)
+        {
+            lBytesCopied = lByteCount;
+        }
+        memcpy(pBuffer, m_pReadPosition, lBytesCopied);
+        m_pReadPosition += lBytesCopied;
     }
-#else
-    size_t bytesRead = fread(pBuffer, 1, lByteCount, m_FileHandle);
-    if (bytesRead > 0)
+
+    // Are we done, or is there nothing more to read from a mapped file?
+    if ((lBytesCopied == lByteCount) || ((m_pMappedData != NULL) && (lBytesCopied > 0)))
+    {
+        return lBytesCopied;
+    }
+    if (m_pMappedData != NULL)
     {
-        return (unsigned long)bytesRead;
+        GS_Error::Report("GS_FILE.CPP", 732, "Failed to read from file!");
+        return FILE_READ_FAILED;
+    }
+
+    BYTE* pDest = (BYTE*) pBuffer + lBytesCopied;
+    unsigned long lBytesLeft = lByteCount - lBytesCopied;
+
+    // Read small amounts through the read buffer.
+    if ((m_pReadBuffer != NULL) && (lBytesLeft < FILE_BUFFER_SIZE))
+    {
+        if (this->FillBuffer())
+        {
+            unsigned long lBytesBuffered = (unsigned long)(m_pReadEnd - m_pReadPosition);
+            if (lBytesLeft > lBytesBuffered)
+            {
+                lBytesLeft = lBytesBuffered;
+            }
+            memcpy(pDest, m_pReadPosition, lBytesLeft);
+            m_pReadPosition += lBytesLeft;
+            return lBytesCopied + lBytesLeft;
+        }
     }
+    else
+    {
+        // Read large amounts straight into the destination.
+#ifdef GS_PLATFORM_WINDOWS
+        unsigned long lBytesRead;
+        if ((ReadFile(m_FileHandle, pDest, lBytesLeft, &lBytesRead, NULL)) &&
+            (lBytesCopied + lBytesRead > 0))
+        {
+            return lBytesCopied + lBytesRead;
+        }
+#else
+        size_t bytesRead = fread(pDest, 1, lBytesLeft, m_FileHandle);
+        if (lBytesCopied + bytesRead > 0)
+        {
+            return lBytesCopied + (unsigned long)bytesRead;
+        }
 #endif
+    }
+
+    // Return what was copied from the read buffer if the end of the file was reached.
+    if (lBytesCopied > 0)
+    {
+        return lBytesCopied;
+    }
 
     GS_Error::Report("GS_FILE.CPP", 443, "Failed to read from file!");
     return FILE_READ_FAILED;
@@ -564,49 +926,28 @@ unsigned long GS_File::ReadString(char* pBuffer, int nMaxLength)
     // Read string one character at a time.
     while (nIndex < nMaxLength)
     {
-#ifdef GS_PLATFORM_WINDOWS
-        unsigned long lBytesRead;
-        // Read a single character from the file.
-        if (ReadFile(m_FileHandle, &cChar, 1, &lBytesRead, NULL))
+        // Refill the read buffer once it has run empty (a mapped file is in memory already).
+        if ((m_pReadPosition >= m_pReadEnd) && (!this->FillBuffer()))
         {
-            // If character was read succesfully.
-            if (lBytesRead == 1)
-            {
-#else
-        // Read a single character from the file.
-        if (fread(&cChar, 1, 1, m_FileHandle) == 1)
+            break;
+        }
+        // Read a single character.
+        cChar = (char) *m_pReadPosition++;
+        // End string at the end of a line.
+        pBuffer[nIndex] = ((cChar == 10) ? (char)0 : cChar);
+        // Move to next character.
+        nIndex++;
+        // If the end of the line was reached, return the number of characters read.
+        if (cChar == 10)
         {
-#endif
-                // End string at the end of a line.
-                pBuffer[nIndex] = ((cChar == 10) ? (char)0 : cChar);
-                // Move to next character.
-                nIndex++;
-                // If the end of the line was reached, return the number of characters read.
-                if (cChar == 10)
-                {
-                    return strlen(pBuffer);
-                }
-                // If the end of the line was not reached and the maximum number of characters
-                // have been read, return fail code.
-                if (nIndex >= nMaxLength)
-                {
-                    return FILE_READ_FAILED;
-                }
-#ifdef GS_PLATFORM_WINDOWS
-            }
-            else
-            {
-                GS_Error::Report("GS_FILE.CPP", 493, "Failed to read from file!");
-                return FILE_READ_FAILED;
-            }
-#endif
+            return strlen(pBuffer);
         }
-#ifndef GS_PLATFORM_WINDOWS
-        else
+        // If the end of the line was not reached and the maximum number of characters
+        // have been read, return fail code.
+        if (nIndex >= nMaxLength)
         {
-            break;
+            return FILE_READ_FAILED;
         }
-#endif
     }
 
     GS_Error::Report("GS_FILE.CPP", 499, "Failed to read from file!");
@@ -617,6 +958,83 @@ unsigned long GS_File::ReadString(char* pBuffer, int nMaxLength)
 ////////////////////////////////////////////////////////////////////////////////////////////////
 
 
+//==============================================================================================
+// GS_File::ReadLine():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Reads a line of text without the line ending ("\n" or "\r\n"). The line is
+//          searched for in the read buffer (or mapped file) and copied in blocks, the part of
+//          a line that doesn't fit in the buffer (nMaxLength includes the terminator) is
+//          skipped.
+// ---------------------------------------------------------------------------------------------
+// Returns: The length of the line or FILE_READ_FAILED at the end of the file.
+//==============================================================================================
+
+unsigned long GS_File::ReadLine(char* pBuffer, int nMaxLength)
+{
+
+    // Exit if the file has not been opened or there is no room for the line.
+    if ((!m_bIsOpened) || (!pBuffer) || (nMaxLength <= 0))
+    {
+        return FILE_READ_FAILED;
+    }
+
+    unsigned long lLength = 0;
+    unsigned long lMaxLength = (unsigned long)(nMaxLength - 1);
+    BOOL bIsLine = FALSE;
+
+    for (;;)
+    {
+        // Refill the read buffer once it has run empty (a mapped file is in memory already).
+        if ((m_pReadPosition >= m_pReadEnd) && (!this->FillBuffer()))
+        {
+            break;
+        }
+
+        bIsLine = TRUE;
+
+        // Look for the end of the line in the bytes that are in memory.
+        const BYTE* pEndOfLine = (const BYTE*) memchr(m_pReadPosition, 10,
+                                 m_pReadEnd - m_pReadPosition);
+        const BYTE* pStop = (pEndOfLine != NULL) ? pEndOfLine : m_pReadEnd;
+
+        // Copy as much of the line as fits.
+        unsigned long lCopy = (unsigned long)(pStop - m_pReadPosition);
+        if (lCopy > lMaxLength - lLength)
+        {
+            lCopy = lMaxLength - lLength;
+        }
+        memcpy(pBuffer + lLength, m_pReadPosition, lCopy);
+        lLength += lCopy;
+
+        // Was the end of the line found?
+        if (pEndOfLine != NULL)
+        {
+            m_pReadPosition = pEndOfLine + 1;
+            break;
+        }
+        m_pReadPosition = m_pReadEnd;
+    }
+
+    // Strip the carriage return of a "\r\n" line ending.
+    if ((lLength > 0) && (pBuffer[lLength-1] == 13))
+    {
+        lLength--;
+    }
+    pBuffer[lLength] = 0;
+
+    // Was there nothing left to read?
+    if (!bIsLine)
+    {
+        return FILE_READ_FAILED;
+    }
+
+    return lLength;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
 ////////////////////////////////////////////////////////////////////////////////////////////////
 // File Write Methods. /////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////////////
@@ -37,6 +37,15 @@
 #include "gs_platform.h"
 //==============================================================================================
 
+#ifndef GS_PLATFORM_WINDOWS
+//==============================================================================================
+// Include POSIX header files (memory mapped files).
+// ---------------------------------------------------------------------------------------------
+#include <sys/mman.h>
+#include <sys/stat.h>
+//==============================================================================================
+#endif
+
 
 //==============================================================================================
 // Error code defines.
@@ -46,13 +55,21 @@
 //==============================================================================================
 
 
+//==============================================================================================
+// File buffer defines.
+// ---------------------------------------------------------------------------------------------
+#define FILE_BUFFER_SIZE 4096 // Number of bytes read ahead at a time in read-mode.
+//==============================================================================================
+
+
 //==============================================================================================
 // File mode flags declaration.
 // ---------------------------------------------------------------------------------------------
 typedef enum
 {
-    FILE_READ, // Read from an existing file.
-    FILE_WRITE // Write to a new file.
+    FILE_READ,  // Read from an existing file.
+    FILE_WRITE, // Write to a new file.
+    FILE_MAP    // Map an existing file into memory for reading.
 } FILE_MODE_FLAGS;
 //==============================================================================================
 
@@ -79,6 +96,23 @@ private:
 
     BOOL m_bIsOpened;
 
+#ifdef GS_PLATFORM_WINDOWS
+    HANDLE m_MappingHandle;  // The file mapping object of a mapped file.
+#endif
+    BYTE* m_pMappedData;     // The contents of a mapped file (NULL if not mapped).
+    unsigned long m_lMappedSize;     // The size of the mapped file in bytes.
+    BOOL  m_bIsMappedCopy;   // Wether the file was read into memory because it couldn't be mapped.
+
+    BYTE* m_pReadBuffer;         // Bytes read ahead in read-mode (NULL until first opened).
+    const BYTE* m_pReadPosition; // Next unread byte in the read buffer or mapped file.
+    const BYTE* m_pReadEnd;      // End of the unread bytes in the read buffer or mapped file.
+
+    BOOL Map();
+    void Unmap();
+
+    BOOL FillBuffer();
+    unsigned long ReadByte(BOOL bAdvance);
+
 protected:
 
     // No protected members.
@@ -95,17 +129,45 @@ public:
     void Close();
 
     BOOL IsOpen();
+    BOOL IsMapped()
+    {
+        return (m_pMappedData != NULL);
+    }
     BOOL IsEndOfFile();
     BOOL Exists(const char* pszFilename);
 
     FILE_MODE_FLAGS GetMode();
     unsigned long GetLength();
+    unsigned long GetModifiedTime();
     unsigned long GetPosition();
     BOOL SetPosition(unsigned long lPosition);
 
-    unsigned long GetByte();
+    const BYTE* GetData()
+    {
+        return m_pMappedData;
+    }
+
+    unsigned long GetByte()
+    {
+        // Take the byte straight from the read buffer or mapped file if it's there.
+        if (m_pReadPosition < m_pReadEnd)
+        {
+            return ((unsigned long)(char) *m_pReadPosition++);
+        }
+        return this->ReadByte(TRUE);
+    }
+    unsigned long PeekByte()
+    {
+        // Same as GetByte(), but the byte will be read again by the next read.
+        if (m_pReadPosition < m_pReadEnd)
+        {
+            return ((unsigned long)(char) *m_pReadPosition);
+        }
+        return this->ReadByte(FALSE);
+    }
     unsigned long Read(void* pBuffer, unsigned long lByteCount);
     unsigned long ReadString(char* pBuffer, int nMaxLength);
+    unsigned long ReadLine(char* pBuffer, int nMaxLength);
 
     BOOL PutByte(unsigned short sByte);
     unsigned long Write(void* pBuffer, unsigned long lByteCount);
@@ -40,6 +40,8 @@ GS_FmodSound::GS_FmodSound() {
 
     m_nStreamIndex    = -1;
     m_nStreamChannel = -1;
+
+    m_nBufferFrames = 0;
 }
 
 
@@ -105,6 +107,11 @@ BOOL GS_FmodSound::Initialize(HWND hWnd, BOOL bNoSound) {
         // Autodetect the output mode and select default sound driver.
         FSOUND_SetOutput(-1);
         FSOUND_SetDriver(0);
+        // Use the requested buffer size (FMOD takes it in milliseconds, must be set before
+        // initializing).
+        if (m_nBufferFrames > 0) {
+            FSOUND_SetBufferSize((m_nBufferFrames * 1000 + 44099) / 44100);
+            }
         // Try initializing the default device, at 44100hz with 64 channels.
         if (!FSOUND_Init(44100, 64, FSOUND_INIT_USEDEFAULTMIDISYNTH)) {
             GS_Error::Report("GS_FMOD_SOUND.CPP", 110, FMOD_ErrorString(FSOUND_GetError()));
@@ -1339,6 +1346,10 @@ BOOL GS_FmodSound::AddSample(const char* pszFilename) {
         return FALSE;
         }
 
+    // Limit the voices the sample may play on at once.
+    FSOUND_Sample_SetMaxPlaybacks(pSample, GS_SAMPLE_DEFAULT_VOICES);
+    FSOUND_Sample_SetDefaults(pSample, -1, -1, -1, GS_SAMPLE_DEFAULT_PRIORITY);
+
     // Add sample to list.
     m_gsSampleList.AddItem(pSample);
 
@@ -1350,6 +1361,31 @@ BOOL GS_FmodSound::AddSample(const char* pszFilename) {
 ////////////////////////////////////////////////////////////////////////////////////////////////
 
 
+//==============================================================================================
+// GS_FmodSound::AddSamples():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Loads a number of sound samples and adds them to the sample list in the order they
+//          are given (FMOD converts them itself, so they are simply loaded one by one).
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if all samples were added, FALSE if not.
+//==============================================================================================
+
+BOOL GS_FmodSound::AddSamples(const char** ppszFilenames, int nNumFiles) {
+
+    BOOL bResult = TRUE;
+
+    for (int nLoop = 0; nLoop < nNumFiles; nLoop++) {
+        bResult = this->AddSample(ppszFilenames[nLoop]) && bResult;
+        }
+
+    return bResult;
+
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
 //==============================================================================================
 // GS_FmodSound::RemoveSample():
 // ---------------------------------------------------------------------------------------------
@@ -1437,9 +1473,11 @@ int GS_FmodSound::GetNumSamples() {
 //==============================================================================================
 // GS_FmodSound::PlaySample():
 // ---------------------------------------------------------------------------------------------
-// Purpose: ...
+// Purpose: Plays a sample on a voice of its own, the volume and panning only apply to this
+//          voice (the sample defaults are used if not given).
 // ---------------------------------------------------------------------------------------------
-// Returns: The channel handle for the stream, -1 if failed.
+// Returns: The channel handle of the voice, -1 if failed (or all voices are busy with more
+//          important samples).
 //==============================================================================================
 
 int GS_FmodSound::PlaySample(int nIndex, int nVolume, int nPanning) {
@@ -1450,29 +1488,32 @@ int GS_FmodSound::PlaySample(int nIndex, int nVolume, int nPanning) {
         }
 
     // Is the index within bounds?
-    if ((nIndex >= 0) && (nIndex < m_gsSampleList.GetNumItems())) {
-        // Have the user specified a valid volume?
-        if (nVolume >= 0) {
-            // Set the sample volume.
-            this->SetSampleVolume(nIndex, nVolume);
-            }
-        // Have the user specified a valid panning?
-        if (nPanning >= 0) {
-            // Set the sample panning.
-            this->SetSamplePanning(nIndex, nPanning);
-            }
-        // Play the sample in the list specified by the index.
-        int nSampleChannel = FSOUND_PlaySound(FSOUND_FREE, m_gsSampleList[nIndex]);
-        // Was playing sample successful?
-        if (-1 != nSampleChannel) {
-            return nSampleChannel;
-            }
+    if ((nIndex < 0) || (nIndex >= m_gsSampleList.GetNumItems())) {
+        // Report error if could not play sample.
+        GS_Error::Report("GS_FMOD_SOUND.CPP", 1466, "Failed to play sample!");
+        return -1;
         }
 
-    // Report error if could not play sample.
-    GS_Error::Report("GS_FMOD_SOUND.CPP", 1466, "Failed to play sample!");
+    // Start the sample paused so the voice can be set up before it is heard.
+    int nSampleChannel = FSOUND_PlaySoundEx(FSOUND_FREE, m_gsSampleList[nIndex], NULL, TRUE);
 
-    return -1;
+    // Was playing sample successful (FMOD drops it if no voice can be stolen for it)?
+    if (-1 == nSampleChannel) {
+        return -1;
+        }
+
+    // Have the user specified a valid volume?
+    if (nVolume >= 0) {
+        FSOUND_SetVolume(nSampleChannel, (nVolume > 255) ? 255 : nVolume);
+        }
+    // Have the user specified a valid panning?
+    if (nPanning >= 0) {
+        FSOUND_SetPan(nSampleChannel, (nPanning > 255) ? 255 : nPanning);
+        }
+
+    FSOUND_SetPaused(nSampleChannel, FALSE);
+
+    return nSampleChannel;
 }
 
 
@@ -1822,6 +1863,39 @@ int GS_FmodSound::GetSamplePanning(int nIndex) {
 ////////////////////////////////////////////////////////////////////////////////////////////////
 
 
+//==============================================================================================
+// GS_FmodSound::SetSampleVoices():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Sets how many voices a sample may play on at once and the priority of its voices
+//          (0-255, the higher the more important).
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successfull, FALSE if not.
+//==============================================================================================
+
+BOOL GS_FmodSound::SetSampleVoices(int nIndex, int nMaxVoices, int nPriority) {
+
+    // Exit if sound not initialized.
+    if (!m_bIsReady) {
+        return FALSE;
+        }
+
+    // Is the index within bounds?
+    if ((nIndex < 0) || (nIndex >= m_gsSampleList.GetNumItems())) {
+        return FALSE;
+        }
+
+    // Limit the voices the sample may play on at once.
+    if (!FSOUND_Sample_SetMaxPlaybacks(m_gsSampleList[nIndex], (nMaxVoices < 1) ? 1 : nMaxVoices)) {
+        return FALSE;
+        }
+
+    return this->SetSamplePriority(nIndex, nPriority);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
 //==============================================================================================
 // GS_FmodSound::SetSamplePriority():
 // ---------------------------------------------------------------------------------------------
@@ -30,6 +30,14 @@
 //==============================================================================================
 
 
+//==============================================================================================
+// Voice defines (a voice is a channel playing a sample, FMOD manages the channels itself).
+// ---------------------------------------------------------------------------------------------
+#define GS_SAMPLE_DEFAULT_VOICES   4   // Voices a sample may play on at once unless changed.
+#define GS_SAMPLE_DEFAULT_PRIORITY 128 // Priority of a sample unless changed (0-255, highest).
+//==============================================================================================
+
+
 //==============================================================================================
 // Include Game System (GS) header files.
 // ---------------------------------------------------------------------------------------------
@@ -61,6 +69,8 @@ private:
     int m_nStreamIndex;  // Index of currently playing stream.
     int m_nStreamChannel;// Handle of channels used by stream.
 
+    int m_nBufferFrames; // Size of the mixing buffer in sample frames (0 for FMOD's default).
+
 protected:
 
     // ...
@@ -89,6 +99,60 @@ public:
         return m_nMasterVolume;
     }
 
+    void SetBufferSize(int nFrames)
+    {
+        m_nBufferFrames = nFrames;
+    }
+    int  GetBufferSize()
+    {
+        return m_nBufferFrames;
+    }
+    int  GetFrequency()
+    {
+        return 44100;
+    }
+    int  GetUnderruns()
+    {
+        return 0;
+    }
+    void SetMusicCrossfade(int nMilliseconds)
+    {
+        // FMOD switches music at once.
+        (void)nMilliseconds;
+    }
+    int  GetMusicCrossfade()
+    {
+        return 0;
+    }
+    void Update()
+    {
+        // FMOD manages its own buffers.
+    }
+
+    // FMOD mixes on its own thread, there is nothing to count.
+    int   GetActiveVoices()
+    {
+        return 0;
+    }
+    int   GetPeakVoices()
+    {
+        return 0;
+    }
+    int   GetTotalUnderruns()
+    {
+        return 0;
+    }
+    float GetMixTime(float fPercent)
+    {
+        (void)fPercent;
+        return 0.0f;
+    }
+    BOOL  WriteStats(const char* pszFilename)
+    {
+        (void)pszFilename;
+        return FALSE;
+    }
+
     BOOL  AddMusic(const char* pszFilename);
     BOOL  RemoveMusic(int nIndex);
     BOOL  ClearMusicList();
@@ -123,6 +187,7 @@ public:
     int  GetStreamVolume();
 
     BOOL AddSample(const char* pszFilename);
+    BOOL AddSamples(const char** ppszFilenames, int nNumFiles);
     BOOL RemoveSample(int nIndex);
     BOOL ClearSampleList();
     int  GetNumSamples();
@@ -141,6 +206,28 @@ public:
     BOOL SetSamplePriority(int nIndex, int nPriority);
     void SetSamplePriority(int nPriority);
     int  GetSamplePriority(int nIndex);
+    BOOL SetSampleVoices(int nIndex, int nMaxVoices, int nPriority = GS_SAMPLE_DEFAULT_PRIORITY);
+
+    BOOL IsVoicePlaying(int nVoice)
+    {
+        return this->IsChannelPlaying(nVoice);
+    }
+    BOOL StopVoice(int nVoice)
+    {
+        return this->StopChannel(nVoice);
+    }
+    BOOL SetVoiceVolume(int nVoice, int nVolume)
+    {
+        return this->SetChannelVolume(nVoice, nVolume);
+    }
+    BOOL SetVoicePanning(int nVoice, int nPanning)
+    {
+        return this->SetChannelPanning(nVoice, nPanning);
+    }
+    int  GetNumVoices()
+    {
+        return m_bIsReady ? FSOUND_GetChannelsPlaying() : 0;
+    }
 
     BOOL StopChannel(int nChannel);
     BOOL StopAllChannels();
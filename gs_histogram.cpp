@@ -0,0 +1,260 @@
+/*============================================================================================+
+ | Game System (GS) Library                                                                   |
+ |--------------------------------------------------------------------------------------------|
+ | FILES: gs_histogram.cpp, gs_histogram.h                                                    |
+ |--------------------------------------------------------------------------------------------|
+ | CLASS: GS_Histogram                                                                        |
+ |--------------------------------------------------------------------------------------------|
+ | ABOUT: Log-scale histogram of times.                                                       |
+ |--------------------------------------------------------------------------------------------|
+ |                                                                                    10/2026 |
+ +============================================================================================*/
+
+
+//==============================================================================================
+// Include Game System (GS) header files.
+// ---------------------------------------------------------------------------------------------
+#include "gs_histogram.h"
+//==============================================================================================
+
+
+//==============================================================================================
+// Include standard C library header files.
+// ---------------------------------------------------------------------------------------------
+#include <math.h>
+//==============================================================================================
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Constructor/Destructor Methods //////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Histogram::GS_Histogram():
+// ---------------------------------------------------------------------------------------------
+// Purpose: The constructor, clears the histogram. Times shorter than fMinTime milliseconds
+//          all go into the first bucket.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+GS_Histogram::GS_Histogram(float fMinTime)
+{
+
+    m_fMinTime = fMinTime;
+
+    this->Reset();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Histogram::~GS_Histogram():
+// ---------------------------------------------------------------------------------------------
+// Purpose: The destructor, does nothing.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+GS_Histogram::~GS_Histogram()
+{
+
+    // Does nothing.
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Writer Thread Methods ///////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Histogram::Reset():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Clears the histogram and the longest time.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_Histogram::Reset()
+{
+
+    for (int nBucket = 0; nBucket < HISTOGRAM_BUCKETS; nBucket++)
+    {
+        SDL_AtomicSet(&m_nBuckets[nBucket], 0);
+    }
+
+    SDL_AtomicSet(&m_nCount, 0);
+    SDL_AtomicSet(&m_nMaxTime, 0);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Histogram::Add():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Counts a time (in milliseconds). Only one thread may add times.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_Histogram::Add(float fTime)
+{
+
+    int nTime = (int) SDL_min(fTime * 1000.0f, 2.0e9f);
+
+    SDL_AtomicAdd(&m_nBuckets[this->GetBucket(fTime)], 1);
+    SDL_AtomicAdd(&m_nCount, 1);
+
+    // Keep track of the longest time.
+    if (nTime > SDL_AtomicGet(&m_nMaxTime))
+    {
+        SDL_AtomicSet(&m_nMaxTime, nTime);
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Reader Methods //////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Histogram::GetPercentile():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Determines the time that the given percentage (0 to 100) of times were within,
+//          e.g. GetPercentile(99.0f) is the 99th percentile. The value is the upper limit of
+//          the bucket it falls in, so it may be up to one bucket width too high, but never
+//          higher than the longest time.
+// ---------------------------------------------------------------------------------------------
+// Returns: The time in milliseconds, or 0.0f if no times have been counted.
+//==============================================================================================
+
+float GS_Histogram::GetPercentile(float fPercent)
+{
+
+    int nCount = this->GetCount();
+
+    if (nCount == 0)
+    {
+        return 0.0f;
+    }
+
+    // The writer may keep counting, so the buckets may add up to a few more times.
+    double dWanted  = double(nCount) * fPercent / 100.0;
+    int    nCounted = 0;
+
+    // Go through the buckets until enough times have been counted.
+    for (int nBucket = 0; nBucket < HISTOGRAM_BUCKETS; nBucket++)
+    {
+        nCounted += SDL_AtomicGet(&m_nBuckets[nBucket]);
+
+        if ((nCounted > 0) && (double(nCounted) >= dWanted))
+        {
+            return SDL_min(this->GetBucketLimit(nBucket), this->GetMaxTime());
+        }
+    }
+
+    return this->GetMaxTime();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Histogram::WriteBuckets():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Writes the non-empty buckets to a text file, one line per bucket with its upper
+//          limit (written with nDecimals decimals) and the number of times counted in it.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_Histogram::WriteBuckets(GS_File* pFile, int nDecimals)
+{
+
+    for (int nBucket = 0; nBucket < HISTOGRAM_BUCKETS; nBucket++)
+    {
+        int nCount = SDL_AtomicGet(&m_nBuckets[nBucket]);
+
+        if (nCount > 0)
+        {
+            if (nBucket == HISTOGRAM_BUCKETS - 1)
+            {
+                pFile->WriteString("    >=%8.*f ms: %d\n", nDecimals,
+                                   this->GetBucketLimit(nBucket - 1), nCount);
+            }
+            else
+            {
+                pFile->WriteString("    < %8.*f ms: %d\n", nDecimals,
+                                   this->GetBucketLimit(nBucket), nCount);
+            }
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Helper Methods //////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Histogram::GetBucket():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Determines which bucket a time should be counted in.
+// ---------------------------------------------------------------------------------------------
+// Returns: The index of the bucket.
+//==============================================================================================
+
+int GS_Histogram::GetBucket(float fTime)
+{
+
+    // Is the time shorter than the first log bucket?
+    if (fTime < m_fMinTime)
+    {
+        return 0;
+    }
+
+    // Determine the bucket from the number of octaves above the minimum time.
+    int nBucket = 1 + int(log(fTime / m_fMinTime) / log(2.0) * HISTOGRAM_BUCKETS_PER_OCTAVE);
+
+    // Put very long times in the last bucket.
+    return SDL_min(nBucket, HISTOGRAM_BUCKETS - 1);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Histogram::GetBucketLimit():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Determines the upper limit of the times counted in a bucket.
+// ---------------------------------------------------------------------------------------------
+// Returns: The upper limit in milliseconds.
+//==============================================================================================
+
+float GS_Histogram::GetBucketLimit(int nBucket)
+{
+
+    return float(m_fMinTime * pow(2.0, double(nBucket) / HISTOGRAM_BUCKETS_PER_OCTAVE));
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,91 @@
+/*============================================================================================+
+ | Game System (GS) Library                                                                   |
+ |--------------------------------------------------------------------------------------------|
+ | FILES: gs_histogram.cpp, gs_histogram.h                                                    |
+ |--------------------------------------------------------------------------------------------|
+ | CLASS: GS_Histogram                                                                        |
+ |--------------------------------------------------------------------------------------------|
+ | ABOUT: Log-scale histogram of times (in milliseconds), used for the frame times of         |
+ |        GS_FrameTimer and the mixing callback times of GS_AudioStats. One thread adds the   |
+ |        times, any thread can read the percentiles without a lock.                          |
+ |--------------------------------------------------------------------------------------------|
+ |                                                                                    10/2026 |
+ +============================================================================================*/
+
+
+#ifndef GS_HISTOGRAM_H
+#define GS_HISTOGRAM_H
+
+
+//==============================================================================================
+// Include platform abstraction header files.
+// ---------------------------------------------------------------------------------------------
+#include "gs_platform.h"
+//==============================================================================================
+
+
+//==============================================================================================
+// Include Game System (GS) header files.
+// ---------------------------------------------------------------------------------------------
+#include "gs_file.h"
+//==============================================================================================
+
+
+//==============================================================================================
+// Include SDL2 header files.
+// ---------------------------------------------------------------------------------------------
+#include <SDL2/SDL.h>
+//==============================================================================================
+
+
+//==============================================================================================
+// Bucket 0 holds times shorter than the minimum time of the histogram, after which each
+// doubling of the time is split into HISTOGRAM_BUCKETS_PER_OCTAVE buckets (about 9% wide
+// each). With 112 buckets the histogram covers times of up to about 15000 times the minimum
+// time, anything longer goes into the last bucket.
+// ---------------------------------------------------------------------------------------------
+#define HISTOGRAM_BUCKETS            112
+#define HISTOGRAM_BUCKETS_PER_OCTAVE 8
+//==============================================================================================
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Class Definition. ///////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+class GS_Histogram
+{
+
+private:
+
+    SDL_atomic_t m_nBuckets[HISTOGRAM_BUCKETS]; // Times counted per bucket.
+    SDL_atomic_t m_nCount;                      // Number of times counted.
+    SDL_atomic_t m_nMaxTime;                    // The longest time (in microseconds).
+
+    float m_fMinTime; // Upper limit of bucket 0 (in milliseconds).
+
+    int   GetBucket(float fTime);
+    float GetBucketLimit(int nBucket);
+
+public:
+
+    GS_Histogram(float fMinTime);
+    virtual ~GS_Histogram();
+
+    // Writer thread methods.
+    void Reset();
+    void Add(float fTime);
+
+    // Reader methods (any thread).
+    int   GetCount()   { return SDL_AtomicGet(&m_nCount); }
+    float GetMaxTime() { return SDL_AtomicGet(&m_nMaxTime) / 1000.0f; }
+    float GetPercentile(float fPercent);
+
+    void WriteBuckets(GS_File* pFile, int nDecimals);
+};
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+#endif
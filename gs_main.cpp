@@ -21,6 +21,36 @@ extern GS_Application* g_pGSApp;
 // ---------------------------------------------------------------------------------------------
 
 
+#ifdef GS_BENCHMARK
+//==============================================================================================
+// RunBenchmark():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Entry point of benchmark builds, replays the script given on the command line.
+//          Usage: [-r] <script> [report] [image directory], where -r records the captured
+//          frames as the reference images instead of comparing them.
+// ---------------------------------------------------------------------------------------------
+// Returns: 0 if successful, 1 if not.
+//==============================================================================================
+
+static int RunBenchmark(int argc, char* argv[])
+{
+    BOOL bRecord = (argc > 1) && (strcmp(argv[1], "-r") == 0);
+    int  nArg    = bRecord ? 2 : 1;
+
+    if (argc <= nArg)
+    {
+        printf("Usage: %s [-r] <script> [report] [image directory]\n", argv[0]);
+        return 1;
+    }
+
+    const char* pszReport   = (argc > nArg + 1) ? argv[nArg + 1] : "benchmark.txt";
+    const char* pszImageDir = (argc > nArg + 2) ? argv[nArg + 2] : NULL;
+
+    return g_pGSApp->RunBenchmark(argv[nArg], pszReport, pszImageDir, bRecord);
+}
+#endif
+
+
 #ifdef GS_PLATFORM_WINDOWS
 //==============================================================================================
 // WinMain():
@@ -41,8 +71,13 @@ int APIENTRY WinMain(HINSTANCE, HINSTANCE, LPSTR, int)
         return 0;
     }
 
+#ifdef GS_BENCHMARK
+    // Replay the benchmark script.
+    return RunBenchmark(__argc, __argv);
+#else
     // Run the application.
     return g_pGSApp->Run();
+#endif
 }
 #else
 //==============================================================================================
@@ -67,8 +102,13 @@ int main(int argc, char* argv[])
         return 0;
     }
 
+#ifdef GS_BENCHMARK
+    // Replay the benchmark script.
+    return RunBenchmark(argc, argv);
+#else
     // Run the application.
     return g_pGSApp->Run();
+#endif
 }
 #endif
 
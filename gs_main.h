@@ -44,11 +44,15 @@
 // Include Game System (GS) header files.
 // ---------------------------------------------------------------------------------------------
 #include "gs_app.h"
+#include "gs_asset_loader.h"
+#include "gs_benchmark.h"
 #include "gs_error.h"
 #include "gs_file.h"
 #include "gs_ini_file.h"
 #include "gs_keyboard.h"
 #include "gs_mouse.h"
+#include "gs_pack.h"
+#include "gs_profiler.h"
 #include "gs_timer.h"
 #include "gs_ogl_collide.h"
 #include "gs_ogl_display.h"
@@ -62,7 +66,9 @@
 #include "gs_ogl_texture.h"
 #include "gs_sdl_controller.h"
 
-#ifdef GS_USE_SDL_MIXER
+#if defined(GS_USE_SDL_SOUND)
+#include "gs_sdl_sound.h"
+#elif defined(GS_USE_SDL_MIXER)
 #include "gs_sdl_mixer_sound.h"
 #else
 #include "gs_fmod_sound.h"
@@ -18,6 +18,13 @@
 //==============================================================================================
 
 
+//==============================================================================================
+// Global render counters declared in the gs_ogl_display.h file.
+// ---------------------------------------------------------------------------------------------
+GS_OGLRenderStats g_gsRenderStats;
+// ---------------------------------------------------------------------------------------------
+
+
 ////////////////////////////////////////////////////////////////////////////////////////////////
 // Constructor/Destructor Methods //////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////
@@ -44,6 +51,42 @@ GS_OGLDisplay::GS_OGLDisplay()
 
     m_bIsReady = FALSE;
 
+    m_bIsOffscreen      = FALSE;
+    m_glFramebuffer     = 0;
+    m_glColorBuffer     = 0;
+    m_glDepthBuffer     = 0;
+    m_glOffscreenWidth  = 0;
+    m_glOffscreenHeight = 0;
+
+    m_glDeleteFramebuffers  = NULL;
+    m_glDeleteRenderbuffers = NULL;
+    m_glBindFramebuffer     = NULL;
+
+    m_bIsGPUTimingSupported = FALSE;
+    m_bIsGPUTimingEnabled   = FALSE;
+
+    m_glGenQueries          = NULL;
+    m_glDeleteQueries       = NULL;
+    m_glQueryCounter        = NULL;
+    m_glGetQueryObjectiv    = NULL;
+    m_glGetQueryObjectui64v = NULL;
+
+    memset(m_GPUFrames, 0, sizeof(m_GPUFrames));
+    m_nGPUFrame     = 0;
+    m_nGPUReadFrame = 0;
+    m_nGPUDepth     = 0;
+    m_nNumGPUStages = 0;
+
+    memset(&m_RenderStats, 0, sizeof(m_RenderStats));
+    m_RenderBudget.ulDrawCalls    = GS_OGL_BUDGET_DRAW_CALLS;
+    m_RenderBudget.ulVertices     = GS_OGL_BUDGET_VERTICES;
+    m_RenderBudget.ulTextureBinds = GS_OGL_BUDGET_TEXTURE_BINDS;
+    m_RenderBudget.ulMatrixOps    = GS_OGL_BUDGET_MATRIX_OPS;
+    m_RenderBudget.ulStateChanges = GS_OGL_BUDGET_STATE_CHANGES;
+    m_ulFramesOverBudget = 0;
+
+    memset(&g_gsRenderStats, 0, sizeof(g_gsRenderStats));
+
     g_fRenderModX = 0.0f;
     g_fRenderModY = 0.0f;
     g_fScaleFactorX = 1.0f;
@@ -86,9 +129,10 @@ GS_OGLDisplay::~GS_OGLDisplay()
 //==============================================================================================
 
 #ifdef GS_PLATFORM_WINDOWS
-BOOL GS_OGLDisplay::Create(HDC& hDC, int nWidth, int nHeight, int nDepth)
+BOOL GS_OGLDisplay::Create(HDC& hDC, int nWidth, int nHeight, int nDepth, BOOL bOffscreen)
 #else
-BOOL GS_OGLDisplay::Create(SDL_Window* pWindow, int nWidth, int nHeight, int nDepth)
+BOOL GS_OGLDisplay::Create(SDL_Window* pWindow, int nWidth, int nHeight, int nDepth,
+                           BOOL bOffscreen)
 #endif
 {
     (void)nDepth; // Depth handled by SDL/OpenGL automatically
@@ -190,6 +234,14 @@ BOOL GS_OGLDisplay::Create(SDL_Window* pWindow, int nWidth, int nHeight, int nDe
     // Display has been successfully created.
     m_bIsReady = TRUE;
 
+    // Should we render to an offscreen framebuffer instead of the window?
+    if ((bOffscreen) && (!this->CreateOffscreen(nWidth, nHeight)))
+    {
+        this->Destroy();
+        GS_Error::Report("GS_OGL_DISPLAY.CPP", 204, "Failed to create offscreen framebuffer!");
+        return FALSE;
+    }
+
     // Set the perspective of the OpenGL screen.
     this->SetViewport(nWidth, nHeight, 45.0f);
 
@@ -213,6 +265,9 @@ BOOL GS_OGLDisplay::Create(SDL_Window* pWindow, int nWidth, int nHeight, int nDe
     // Really nice perspective calculations.
     glHint(GL_PERSPECTIVE_CORRECTION_HINT, GL_NICEST);
 
+    // Check for timer queries (GPU timing is simply unavailable without them).
+    m_bIsGPUTimingSupported = this->InitGPUTiming();
+
     return TRUE;
 }
 
@@ -235,6 +290,10 @@ GLvoid GS_OGLDisplay::Destroy()
         return;
     }
 
+    // Delete the timer queries and framebuffer while the rendering context is still current.
+    this->ShutdownGPUTiming();
+    this->DestroyOffscreen();
+
 #ifdef GS_PLATFORM_WINDOWS
     if (m_hRC)
     {
@@ -408,12 +467,15 @@ GLvoid GS_OGLDisplay::EnableDepthTesting(BOOL bEnable, GLenum glType)
     {
         // Enable depth testing and set type.
         glEnable(GL_DEPTH_TEST);
+        GS_OGLDisplay::CountStateChanges();
         glDepthFunc(glType);
+        GS_OGLDisplay::CountStateChanges();
     }
     else
     {
         // Disable depth testing.
         glDisable(GL_DEPTH_TEST);
+        GS_OGLDisplay::CountStateChanges();
     }
 }
 
@@ -437,12 +499,15 @@ GLvoid GS_OGLDisplay::EnableBlending(BOOL bEnable, GLenum glSourceFactor, GLenum
     {
         // Set type of blending and enable it.
         glBlendFunc(glSourceFactor, glDestFactor);
+        GS_OGLDisplay::CountStateChanges();
         glEnable(GL_BLEND);
+        GS_OGLDisplay::CountStateChanges();
     }
     else
     {
         // Disable blending.
         glDisable(GL_BLEND);
+        GS_OGLDisplay::CountStateChanges();
     }
 }
 
@@ -466,12 +531,15 @@ GLvoid GS_OGLDisplay::EnableLighting(BOOL bEnable, GLenum glLightNum)
     {
         // Enable lighting and set type.
         glEnable(GL_LIGHTING);
+        GS_OGLDisplay::CountStateChanges();
         glEnable(glLightNum);
+        GS_OGLDisplay::CountStateChanges();
     }
     else
     {
         // Disable lighting.
         glDisable(GL_LIGHTING);
+        GS_OGLDisplay::CountStateChanges();
     }
 }
 
@@ -578,14 +646,17 @@ GLvoid GS_OGLDisplay::BeginRender()
 
     // Clear screen and depth buffer.
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    GS_OGLDisplay::CountDrawCall(0);
 
     // Reset the current modelview matrix.
     glLoadIdentity();
+    GS_OGLDisplay::CountMatrixOps();
 
     // The gluLookAt function creates a viewing matrix derived from an eye point (i.e. where
     // we're looking from (0,0,5)), a reference point indicating the center of the scene (i.e.
     // where we're looking at (0,0,0)), and an up vector (0,1,0).
     gluLookAt(0,0,5,0,0,0,0,1,0);
+    GS_OGLDisplay::CountMatrixOps();
 }
 
 
@@ -607,6 +678,15 @@ GLvoid GS_OGLDisplay::EndRender(HDC& hDC)
     {
         return;
     }
+    this->EndGPUFrame();
+    this->EndRenderStats();
+    GS_PROFILE_SCOPE("SWAP");
+    // Nothing is shown when rendering offscreen, wait for the frame to complete instead.
+    if (m_bIsOffscreen)
+    {
+        glFinish();
+        return;
+    }
     SwapBuffers(hDC);
 }
 #else
@@ -616,6 +696,15 @@ GLvoid GS_OGLDisplay::EndRender(SDL_Window* pWindow)
     {
         return;
     }
+    this->EndGPUFrame();
+    this->EndRenderStats();
+    GS_PROFILE_SCOPE("SWAP");
+    // Nothing is shown when rendering offscreen, wait for the frame to complete instead.
+    if (m_bIsOffscreen)
+    {
+        glFinish();
+        return;
+    }
     SDL_GL_SwapWindow(pWindow);
 }
 #endif
@@ -651,6 +740,7 @@ BOOL GS_OGLDisplay::BeginRender2D(HWND& hWnd)
     if (glIsEnabled(GL_DEPTH_TEST) == GL_TRUE)
     {
         glDisable(GL_DEPTH_TEST);
+        GS_OGLDisplay::CountStateChanges();
         m_bIsDepthTestEnabled = TRUE;
     }
     else
@@ -662,6 +752,7 @@ BOOL GS_OGLDisplay::BeginRender2D(HWND& hWnd)
     if (glIsEnabled(GL_LIGHTING) == GL_TRUE)
     {
         glDisable(GL_LIGHTING);
+        GS_OGLDisplay::CountStateChanges();
         m_bIsLightingEnabled = TRUE;
     }
     else
@@ -670,8 +761,11 @@ BOOL GS_OGLDisplay::BeginRender2D(HWND& hWnd)
     }
 
     glMatrixMode(GL_PROJECTION); // Select the projection matrix.
+    GS_OGLDisplay::CountMatrixOps();
     glPushMatrix();              // Store the projection matrix.
+    GS_OGLDisplay::CountMatrixOps();
     glLoadIdentity();            // Reset the projection matrix.
+    GS_OGLDisplay::CountMatrixOps();
 
     // Set up an ortho screen with the same dimensions as the client area of the current
     // window and with a depth large enough to rotate the entire screen around either
@@ -680,15 +774,19 @@ BOOL GS_OGLDisplay::BeginRender2D(HWND& hWnd)
     {
         glOrtho(0,ClientRect.right,0,ClientRect.bottom,-((ClientRect.right-ClientRect.left)/2),
                 ((ClientRect.right-ClientRect.left)/2));
+        GS_OGLDisplay::CountMatrixOps();
     }
     else
     {
         glOrtho(0,ClientRect.right,0,ClientRect.bottom,-((ClientRect.top-ClientRect.bottom)/2),
                 ((ClientRect.top-ClientRect.bottom)/2));
+        GS_OGLDisplay::CountMatrixOps();
     }
 
     glMatrixMode(GL_MODELVIEW); // Select the modelview matrix.
+    GS_OGLDisplay::CountMatrixOps();
     glPushMatrix();             // Store the modelview matrix.
+    GS_OGLDisplay::CountMatrixOps();
 
     return TRUE;
 }
@@ -708,10 +806,14 @@ BOOL GS_OGLDisplay::BeginRender2D(HWND& hWnd)
 BOOL GS_OGLDisplay::EndRender2D()
 {
     glMatrixMode(GL_PROJECTION);
+    GS_OGLDisplay::CountMatrixOps();
     glPopMatrix();
+    GS_OGLDisplay::CountMatrixOps();
     
     glMatrixMode(GL_MODELVIEW);
+    GS_OGLDisplay::CountMatrixOps();
     glPopMatrix();
+    GS_OGLDisplay::CountMatrixOps();
     
     return TRUE;
 }
@@ -733,6 +835,7 @@ BOOL GS_OGLDisplay::BeginRender2D(void* pWindow)
     if (glIsEnabled(GL_DEPTH_TEST) == GL_TRUE)
     {
         glDisable(GL_DEPTH_TEST);
+        GS_OGLDisplay::CountStateChanges();
         m_bIsDepthTestEnabled = TRUE;
     }
     else
@@ -744,6 +847,7 @@ BOOL GS_OGLDisplay::BeginRender2D(void* pWindow)
     if (glIsEnabled(GL_LIGHTING) == GL_TRUE)
     {
         glDisable(GL_LIGHTING);
+        GS_OGLDisplay::CountStateChanges();
         m_bIsLightingEnabled = TRUE;
     }
     else
@@ -752,8 +856,11 @@ BOOL GS_OGLDisplay::BeginRender2D(void* pWindow)
     }
 
     glMatrixMode(GL_PROJECTION); // Select the projection matrix.
+    GS_OGLDisplay::CountMatrixOps();
     glPushMatrix();              // Store the projection matrix.
+    GS_OGLDisplay::CountMatrixOps();
     glLoadIdentity();            // Reset the projection matrix.
+    GS_OGLDisplay::CountMatrixOps();
 
     // Set up an ortho screen with the same dimensions as the client area of the current
     // window and with a depth large enough to rotate the entire screen around either
@@ -762,16 +869,653 @@ BOOL GS_OGLDisplay::BeginRender2D(void* pWindow)
     {
         glOrtho(0,ClientRect.right,0,ClientRect.bottom,-((ClientRect.right-ClientRect.left)/2),
                 ((ClientRect.right-ClientRect.left)/2));
+        GS_OGLDisplay::CountMatrixOps();
     }
     else
     {
         glOrtho(0,ClientRect.right,0,ClientRect.bottom,-((ClientRect.top-ClientRect.bottom)/2),
                 ((ClientRect.top-ClientRect.bottom)/2));
+        GS_OGLDisplay::CountMatrixOps();
     }
 
     glMatrixMode(GL_MODELVIEW); // Select the modelview matrix.
+    GS_OGLDisplay::CountMatrixOps();
     glPushMatrix();             // Store the modelview matrix.
+    GS_OGLDisplay::CountMatrixOps();
     
     return TRUE;
 }
 #endif
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_OGLDisplay::ReadPixels():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Reads back the RGB pixels of the last rendered frame, starting at the bottom left
+//          corner, into a buffer of glWidth * glHeight * 3 bytes. Only the offscreen
+//          framebuffer keeps its contents after EndRender(), when rendering to a window this
+//          must be called before EndRender().
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successfull, FALSE if not.
+//==============================================================================================
+
+BOOL GS_OGLDisplay::ReadPixels(GLubyte* pPixels, GLsizei glWidth, GLsizei glHeight)
+{
+    if ((!m_bIsReady) || (!pPixels))
+    {
+        return FALSE;
+    }
+
+    // Rows are tightly packed.
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+    // The framebuffer object only has one color buffer, a window reads its back buffer.
+    if (!m_bIsOffscreen)
+    {
+        glReadBuffer(GL_BACK);
+    }
+
+    // Clear errors left by earlier calls, so only the read back itself is checked.
+    while (glGetError() != GL_NO_ERROR)
+    {
+        // Nothing to do.
+    }
+
+    glReadPixels(0, 0, glWidth, glHeight, GL_RGB, GL_UNSIGNED_BYTE, pPixels);
+
+    return (glGetError() == GL_NO_ERROR);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Extension Methods ///////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_OGLDisplay::IsSupported():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Checks if the OpenGL version of the current context is at least the specified
+//          version, or else if the specified extension is available (a major version of 0 only
+//          checks the extension, NULL only checks the version).
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if supported, FALSE if not (or if there is no current context).
+//==============================================================================================
+
+BOOL GS_OGLDisplay::IsSupported(int nMajor, int nMinor, const char* pszExtension)
+{
+
+    int nVersionMajor = 0;
+    int nVersionMinor = 0;
+
+    // Get the OpenGL version and the list of supported extensions.
+    const char* pszVersion    = (const char*) glGetString(GL_VERSION);
+    const char* pszExtensions = (const char*) glGetString(GL_EXTENSIONS);
+
+    if (pszVersion)
+    {
+        sscanf(pszVersion, "%d.%d", &nVersionMajor, &nVersionMinor);
+    }
+
+    // Is it part of the core version?
+    if ((nMajor > 0) &&
+        ((nVersionMajor > nMajor) || ((nVersionMajor == nMajor) && (nVersionMinor >= nMinor))))
+    {
+        return TRUE;
+    }
+
+    // Is it available as an extension?
+    return ((pszExtension) && (pszExtensions) && (strstr(pszExtensions, pszExtension)));
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_OGLDisplay::GetGLProcAddress():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Gets the address of an OpenGL extension function.
+// ---------------------------------------------------------------------------------------------
+// Returns: The address of the function, or NULL if it is not available.
+//==============================================================================================
+
+void* GS_OGLDisplay::GetGLProcAddress(const char* pszName)
+{
+#ifdef GS_PLATFORM_WINDOWS
+    return (void*) wglGetProcAddress(pszName);
+#else
+    return SDL_GL_GetProcAddress(pszName);
+#endif
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GetFBOProcAddress():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Gets the address of a framebuffer object function, either the core version or the
+//          version from EXT_framebuffer_object (which has the same parameters).
+// ---------------------------------------------------------------------------------------------
+// Returns: The address of the function, or NULL if it is not available.
+//==============================================================================================
+
+static void* GetFBOProcAddress(const char* pszName, BOOL bUseEXT)
+{
+    char szName[64];
+
+    sprintf(szName, "%s%s", pszName, bUseEXT ? "EXT" : "");
+
+    return GS_OGLDisplay::GetGLProcAddress(szName);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_OGLDisplay::CreateOffscreen():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Creates a framebuffer object with a color and a depth renderbuffer and binds it, so
+//          that everything is rendered offscreen (for benchmarks on machines without a display).
+//          Uses OpenGL 3.0 framebuffers, or EXT_framebuffer_object on older drivers.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if not.
+//==============================================================================================
+
+BOOL GS_OGLDisplay::CreateOffscreen(GLsizei glWidth, GLsizei glHeight)
+{
+    // Use the core functions if available, otherwise fall back on the EXT versions.
+    BOOL bUseEXT = (GetGLProcAddress("glGenFramebuffers") == NULL);
+
+    GS_PFNGLGENFRAMEBUFFERSPROC glGenFramebuffers =
+        (GS_PFNGLGENFRAMEBUFFERSPROC) GetFBOProcAddress("glGenFramebuffers", bUseEXT);
+    GS_PFNGLCHECKFRAMEBUFFERSTATUSPROC glCheckFramebufferStatus =
+        (GS_PFNGLCHECKFRAMEBUFFERSTATUSPROC) GetFBOProcAddress("glCheckFramebufferStatus", bUseEXT);
+    GS_PFNGLGENRENDERBUFFERSPROC glGenRenderbuffers =
+        (GS_PFNGLGENRENDERBUFFERSPROC) GetFBOProcAddress("glGenRenderbuffers", bUseEXT);
+    GS_PFNGLBINDRENDERBUFFERPROC glBindRenderbuffer =
+        (GS_PFNGLBINDRENDERBUFFERPROC) GetFBOProcAddress("glBindRenderbuffer", bUseEXT);
+    GS_PFNGLRENDERBUFFERSTORAGEPROC glRenderbufferStorage =
+        (GS_PFNGLRENDERBUFFERSTORAGEPROC) GetFBOProcAddress("glRenderbufferStorage", bUseEXT);
+    GS_PFNGLFRAMEBUFFERRENDERBUFFERPROC glFramebufferRenderbuffer =
+        (GS_PFNGLFRAMEBUFFERRENDERBUFFERPROC) GetFBOProcAddress("glFramebufferRenderbuffer",
+                                                               bUseEXT);
+
+    m_glDeleteFramebuffers  =
+        (GS_PFNGLDELETEFRAMEBUFFERSPROC) GetFBOProcAddress("glDeleteFramebuffers", bUseEXT);
+    m_glDeleteRenderbuffers =
+        (GS_PFNGLDELETERENDERBUFFERSPROC) GetFBOProcAddress("glDeleteRenderbuffers", bUseEXT);
+    m_glBindFramebuffer     =
+        (GS_PFNGLBINDFRAMEBUFFERPROC) GetFBOProcAddress("glBindFramebuffer", bUseEXT);
+
+    // Are framebuffer objects supported at all?
+    if ((!glGenFramebuffers) || (!glCheckFramebufferStatus) || (!glGenRenderbuffers) ||
+        (!glBindRenderbuffer) || (!glRenderbufferStorage) || (!glFramebufferRenderbuffer) ||
+        (!m_glDeleteFramebuffers) || (!m_glDeleteRenderbuffers) || (!m_glBindFramebuffer))
+    {
+        return FALSE;
+    }
+
+    // Create the color and depth buffers.
+    glGenRenderbuffers(1, &m_glColorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_glColorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, glWidth, glHeight);
+
+    glGenRenderbuffers(1, &m_glDepthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_glDepthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, glWidth, glHeight);
+
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    // Create the framebuffer and attach the buffers to it.
+    glGenFramebuffers(1, &m_glFramebuffer);
+    m_glBindFramebuffer(GL_FRAMEBUFFER, m_glFramebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER,
+                              m_glColorBuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER,
+                              m_glDepthBuffer);
+
+    m_bIsOffscreen      = TRUE;
+    m_glOffscreenWidth  = glWidth;
+    m_glOffscreenHeight = glHeight;
+
+    // Can we render to the framebuffer?
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        this->DestroyOffscreen();
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_OGLDisplay::DestroyOffscreen():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Deletes the offscreen framebuffer (if any) and renders to the window again.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_OGLDisplay::DestroyOffscreen()
+{
+    if (!m_bIsOffscreen)
+    {
+        return;
+    }
+
+    m_glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    m_glDeleteFramebuffers(1, &m_glFramebuffer);
+    m_glDeleteRenderbuffers(1, &m_glColorBuffer);
+    m_glDeleteRenderbuffers(1, &m_glDepthBuffer);
+
+    m_glFramebuffer     = 0;
+    m_glColorBuffer     = 0;
+    m_glDepthBuffer     = 0;
+    m_glOffscreenWidth  = 0;
+    m_glOffscreenHeight = 0;
+
+    m_bIsOffscreen = FALSE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// GPU Timing Methods //////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+
+//==============================================================================================
+// GS_OGLDisplay::InitGPUTiming():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Checks for OpenGL 3.3 or ARB_timer_query, loads the query functions and creates the
+//          timestamp queries for all the frames that can be in flight.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if timer queries are supported, FALSE if not.
+//==============================================================================================
+
+BOOL GS_OGLDisplay::InitGPUTiming()
+{
+
+    // Are timestamp queries part of the core version or available as an extension?
+    if (!GS_OGLDisplay::IsSupported(3, 3, "GL_ARB_timer_query"))
+    {
+        return FALSE;
+    }
+
+    // Get the addresses of the query functions.
+    m_glGenQueries          = (GS_PFNGLGENQUERIESPROC) GetGLProcAddress("glGenQueries");
+    m_glDeleteQueries       = (GS_PFNGLDELETEQUERIESPROC) GetGLProcAddress("glDeleteQueries");
+    m_glQueryCounter        = (GS_PFNGLQUERYCOUNTERPROC) GetGLProcAddress("glQueryCounter");
+    m_glGetQueryObjectiv    = (GS_PFNGLGETQUERYOBJECTIVPROC) GetGLProcAddress("glGetQueryObjectiv");
+    m_glGetQueryObjectui64v =
+        (GS_PFNGLGETQUERYOBJECTUI64VPROC) GetGLProcAddress("glGetQueryObjectui64v");
+
+    if ((!m_glGenQueries) || (!m_glDeleteQueries) || (!m_glQueryCounter) ||
+        (!m_glGetQueryObjectiv) || (!m_glGetQueryObjectui64v))
+    {
+        return FALSE;
+    }
+
+    // Create the queries for every frame in the ring.
+    for (int nFrame = 0; nFrame < GS_OGL_GPU_FRAMES; nFrame++)
+    {
+        m_glGenQueries(GS_OGL_GPU_MAX_STAGES, m_GPUFrames[nFrame].glBeginQueries);
+        m_glGenQueries(GS_OGL_GPU_MAX_STAGES, m_GPUFrames[nFrame].glEndQueries);
+        m_GPUFrames[nFrame].bIsPending = FALSE;
+        m_GPUFrames[nFrame].nNumStages = 0;
+    }
+
+    m_nGPUFrame     = 0;
+    m_nGPUReadFrame = 0;
+    m_nGPUDepth     = 0;
+    m_nNumGPUStages = 0;
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_OGLDisplay::ShutdownGPUTiming():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Deletes the timestamp queries.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_OGLDisplay::ShutdownGPUTiming()
+{
+    if (m_bIsGPUTimingSupported)
+    {
+        for (int nFrame = 0; nFrame < GS_OGL_GPU_FRAMES; nFrame++)
+        {
+            m_glDeleteQueries(GS_OGL_GPU_MAX_STAGES, m_GPUFrames[nFrame].glBeginQueries);
+            m_glDeleteQueries(GS_OGL_GPU_MAX_STAGES, m_GPUFrames[nFrame].glEndQueries);
+        }
+    }
+
+    memset(m_GPUFrames, 0, sizeof(m_GPUFrames));
+
+    m_bIsGPUTimingSupported = FALSE;
+    m_bIsGPUTimingEnabled   = FALSE;
+    m_nNumGPUStages         = 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_OGLDisplay::EnableGPUTiming():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Starts or stops timing the render stages on the GPU. Has no effect if timer queries
+//          are not supported.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+GLvoid GS_OGLDisplay::EnableGPUTiming(BOOL bEnable)
+{
+    if ((!m_bIsGPUTimingSupported) || (bEnable == m_bIsGPUTimingEnabled))
+    {
+        return;
+    }
+
+    // Forget any frames still in flight and the previous results.
+    for (int nFrame = 0; nFrame < GS_OGL_GPU_FRAMES; nFrame++)
+    {
+        m_GPUFrames[nFrame].bIsPending = FALSE;
+        m_GPUFrames[nFrame].nNumStages = 0;
+    }
+
+    m_nGPUFrame     = 0;
+    m_nGPUReadFrame = 0;
+    m_nGPUDepth     = 0;
+    m_nNumGPUStages = 0;
+
+    m_bIsGPUTimingEnabled = bEnable;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_OGLDisplay::BeginStage():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Records a GPU timestamp at the start of a named render stage. Stages can be nested
+//          and every call must be matched by a call to EndStage().
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+GLvoid GS_OGLDisplay::BeginStage(const char* pszName)
+{
+    if (!m_bIsGPUTimingEnabled)
+    {
+        return;
+    }
+
+    GS_OGLGPUFrame* pFrame = &m_GPUFrames[m_nGPUFrame];
+    int nStage = -1;
+
+    // Is there room for the stage (the frame is still pending if the ring is full)?
+    if ((!pFrame->bIsPending) && (pFrame->nNumStages < GS_OGL_GPU_MAX_STAGES) &&
+        (m_nGPUDepth < GS_OGL_GPU_MAX_DEPTH))
+    {
+        nStage = pFrame->nNumStages++;
+        pFrame->pszNames[nStage] = pszName;
+        pFrame->nDepths[nStage]  = m_nGPUDepth;
+        pFrame->glLastQuery      = pFrame->glBeginQueries[nStage];
+        m_glQueryCounter(pFrame->glBeginQueries[nStage], GL_TIMESTAMP);
+    }
+
+    // Remember which stage to end (-1 if it was not recorded) so nesting stays balanced.
+    if (m_nGPUDepth < GS_OGL_GPU_MAX_DEPTH)
+    {
+        m_nGPUOpenStages[m_nGPUDepth] = nStage;
+    }
+
+    m_nGPUDepth++;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_OGLDisplay::EndStage():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Records a GPU timestamp at the end of the most recently begun render stage.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+GLvoid GS_OGLDisplay::EndStage()
+{
+    if ((!m_bIsGPUTimingEnabled) || (m_nGPUDepth <= 0))
+    {
+        return;
+    }
+
+    m_nGPUDepth--;
+
+    if (m_nGPUDepth >= GS_OGL_GPU_MAX_DEPTH)
+    {
+        return;
+    }
+
+    int nStage = m_nGPUOpenStages[m_nGPUDepth];
+
+    // Was the stage recorded?
+    if (nStage >= 0)
+    {
+        GS_OGLGPUFrame* pFrame = &m_GPUFrames[m_nGPUFrame];
+        pFrame->glLastQuery = pFrame->glEndQueries[nStage];
+        m_glQueryCounter(pFrame->glEndQueries[nStage], GL_TIMESTAMP);
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_OGLDisplay::EndGPUFrame():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Marks the queries of the current frame as in flight, moves on to the next frame in
+//          the ring and reads back the results of any earlier frames that have completed.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_OGLDisplay::EndGPUFrame()
+{
+    if (!m_bIsGPUTimingEnabled)
+    {
+        return;
+    }
+
+    GS_OGLGPUFrame* pFrame = &m_GPUFrames[m_nGPUFrame];
+
+    // Were any stages recorded during the frame?
+    if ((!pFrame->bIsPending) && (pFrame->nNumStages > 0))
+    {
+        pFrame->bIsPending = TRUE;
+        m_nGPUFrame = (m_nGPUFrame + 1) % GS_OGL_GPU_FRAMES;
+    }
+
+    // Stages left open at the end of a frame can not be ended in the next one.
+    m_nGPUDepth = 0;
+
+    this->ReadGPUFrames();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_OGLDisplay::ReadGPUFrames():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Reads back the timestamps of the frames in flight, oldest first, stopping at the
+//          first frame whose results are not available yet (so it never waits for the GPU).
+//          The time of each stage is smoothed over a number of frames.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_OGLDisplay::ReadGPUFrames()
+{
+    while (m_GPUFrames[m_nGPUReadFrame].bIsPending)
+    {
+        GS_OGLGPUFrame* pFrame = &m_GPUFrames[m_nGPUReadFrame];
+        GLint glAvailable = 0;
+
+        // Has the GPU reached the last timestamp of the frame yet?
+        m_glGetQueryObjectiv(pFrame->glLastQuery, GL_QUERY_RESULT_AVAILABLE, &glAvailable);
+
+        if (!glAvailable)
+        {
+            break;
+        }
+
+        for (int nStage = 0; nStage < pFrame->nNumStages; nStage++)
+        {
+            GS_GLuint64 glBeginTime = 0;
+            GS_GLuint64 glEndTime   = 0;
+
+            m_glGetQueryObjectui64v(pFrame->glBeginQueries[nStage], GL_QUERY_RESULT, &glBeginTime);
+            m_glGetQueryObjectui64v(pFrame->glEndQueries[nStage], GL_QUERY_RESULT, &glEndTime);
+
+            // Convert nanoseconds to milliseconds.
+            float fTime = 0.0f;
+            if (glEndTime > glBeginTime)
+            {
+                fTime = float(double(glEndTime - glBeginTime) / 1000000.0);
+            }
+
+            // Find the results of the stage with the same name.
+            int nResult = 0;
+            while ((nResult < m_nNumGPUStages) &&
+                   (strcmp(m_GPUStages[nResult].pszName, pFrame->pszNames[nStage]) != 0))
+            {
+                nResult++;
+            }
+
+            if (nResult < m_nNumGPUStages)
+            {
+                // Smooth the time of the stage so that it can be read on screen.
+                m_GPUStages[nResult].fTime += (fTime - m_GPUStages[nResult].fTime) * 0.1f;
+            }
+            else if (m_nNumGPUStages < GS_OGL_GPU_MAX_STAGES)
+            {
+                // Add the results of a stage seen for the first time.
+                m_GPUStages[m_nNumGPUStages].pszName = pFrame->pszNames[nStage];
+                m_GPUStages[m_nNumGPUStages].nDepth  = pFrame->nDepths[nStage];
+                m_GPUStages[m_nNumGPUStages].fTime   = fTime;
+                m_nNumGPUStages++;
+            }
+        }
+
+        // The queries of the frame can now be used again.
+        pFrame->bIsPending = FALSE;
+        pFrame->nNumStages = 0;
+
+        m_nGPUReadFrame = (m_nGPUReadFrame + 1) % GS_OGL_GPU_FRAMES;
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_OGLDisplay::GetGPUStage():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Gets the smoothed GPU time of a render stage, in the order stages were first seen.
+// ---------------------------------------------------------------------------------------------
+// Returns: A pointer to the stage results, or NULL if the index is out of range.
+//==============================================================================================
+
+const GS_OGLGPUStage* GS_OGLDisplay::GetGPUStage(int nStage)
+{
+    if ((nStage < 0) || (nStage >= m_nNumGPUStages))
+    {
+        return NULL;
+    }
+
+    return &m_GPUStages[nStage];
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Render Counter Methods //////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_OGLDisplay::EndRenderStats():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Keeps the render counters of the frame that just ended, checks them against the
+//          budget and resets the counters for the next frame.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_OGLDisplay::EndRenderStats()
+{
+    m_RenderStats = g_gsRenderStats;
+    memset(&g_gsRenderStats, 0, sizeof(g_gsRenderStats));
+
+    if (this->IsOverBudget())
+    {
+        m_ulFramesOverBudget++;
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_OGLDisplay::IsOverBudget():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Checks the given render counters (or those of the last frame if NULL) against the
+//          render budget.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if any counter exceeds its budget, FALSE if not.
+//==============================================================================================
+
+BOOL GS_OGLDisplay::IsOverBudget(const GS_OGLRenderStats* pStats)
+{
+    if (!pStats)
+    {
+        pStats = &m_RenderStats;
+    }
+
+    return ((pStats->ulDrawCalls    > m_RenderBudget.ulDrawCalls)    ||
+            (pStats->ulVertices     > m_RenderBudget.ulVertices)     ||
+            (pStats->ulTextureBinds > m_RenderBudget.ulTextureBinds) ||
+            (pStats->ulMatrixOps    > m_RenderBudget.ulMatrixOps)    ||
+            (pStats->ulStateChanges > m_RenderBudget.ulStateChanges));
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
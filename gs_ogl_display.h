@@ -39,6 +39,7 @@
 // ---------------------------------------------------------------------------------------------
 #include "gs_error.h"
 #include "gs_object.h"
+#include "gs_profiler.h"
 //==============================================================================================
 
 
@@ -54,6 +55,105 @@ extern float g_fScaleFactorY;
 // ---------------------------------------------------------------------------------------------
 
 
+//==============================================================================================
+// Render counters. Every GS_OGL render path (the display itself, sprites, fonts, menus, maps
+// and particles) counts each OpenGL call it makes in g_gsRenderStats, through the
+// GS_OGLDisplay::Count methods called right after the call. The display takes the totals and
+// resets them at the end of every frame.
+// ---------------------------------------------------------------------------------------------
+typedef struct GS_OGL_RENDER_STATS
+{
+    unsigned long ulDrawCalls;    // Number of glBegin()/glEnd() pairs and glClear() calls.
+    unsigned long ulVertices;     // Number of vertices drawn.
+    unsigned long ulTextureBinds; // Number of glBindTexture() calls.
+    unsigned long ulMatrixOps;    // Number of matrix mode, load, push, pop and transform calls.
+    unsigned long ulStateChanges; // Number of enable/disable, blend, depth and scissor calls.
+} GS_OGLRenderStats;
+// ---------------------------------------------------------------------------------------------
+extern GS_OGLRenderStats g_gsRenderStats; // Counters of the frame being rendered.
+// ---------------------------------------------------------------------------------------------
+#define GS_OGL_BUDGET_DRAW_CALLS    600  // Default budgets per frame, a frame exceeding any of
+#define GS_OGL_BUDGET_VERTICES      2400 // them is counted as over budget.
+#define GS_OGL_BUDGET_TEXTURE_BINDS 1200
+#define GS_OGL_BUDGET_MATRIX_OPS    4000
+#define GS_OGL_BUDGET_STATE_CHANGES 200
+//==============================================================================================
+
+
+//==============================================================================================
+// GPU timer query defines. Each render stage records a GL timestamp when it begins and ends.
+// The queries of a frame are only read back GS_OGL_GPU_FRAMES frames later (or as soon as they
+// are available after that), so reading the results never stalls the pipeline.
+// ---------------------------------------------------------------------------------------------
+#define GS_OGL_GPU_FRAMES     4  // Number of frames of queries in flight.
+#define GS_OGL_GPU_MAX_STAGES 16 // Maximum number of timed stages per frame.
+#define GS_OGL_GPU_MAX_DEPTH  8  // Maximum nesting depth of timed stages.
+// ---------------------------------------------------------------------------------------------
+#ifndef GL_QUERY_RESULT
+#define GL_QUERY_RESULT           0x8866
+#define GL_QUERY_RESULT_AVAILABLE 0x8867
+#endif
+#ifndef GL_TIMESTAMP
+#define GL_TIMESTAMP              0x8E28
+#endif
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+// ---------------------------------------------------------------------------------------------
+#ifndef GL_FRAMEBUFFER
+#define GL_FRAMEBUFFER            0x8D40
+#define GL_RENDERBUFFER           0x8D41
+#define GL_COLOR_ATTACHMENT0      0x8CE0
+#define GL_DEPTH_ATTACHMENT       0x8D00
+#define GL_FRAMEBUFFER_COMPLETE   0x8CD5
+#endif
+#ifndef GL_DEPTH_COMPONENT24
+#define GL_DEPTH_COMPONENT24      0x81A6
+#endif
+// ---------------------------------------------------------------------------------------------
+typedef unsigned long long GS_GLuint64;
+typedef void (APIENTRY* GS_PFNGLGENQUERIESPROC)(GLsizei n, GLuint* ids);
+typedef void (APIENTRY* GS_PFNGLDELETEQUERIESPROC)(GLsizei n, const GLuint* ids);
+typedef void (APIENTRY* GS_PFNGLQUERYCOUNTERPROC)(GLuint id, GLenum target);
+typedef void (APIENTRY* GS_PFNGLGETQUERYOBJECTIVPROC)(GLuint id, GLenum pname, GLint* params);
+typedef void (APIENTRY* GS_PFNGLGETQUERYOBJECTUI64VPROC)(GLuint id, GLenum pname, GS_GLuint64* params);
+typedef void (APIENTRY* GS_PFNGLGENFRAMEBUFFERSPROC)(GLsizei n, GLuint* ids);
+typedef void (APIENTRY* GS_PFNGLDELETEFRAMEBUFFERSPROC)(GLsizei n, const GLuint* ids);
+typedef void (APIENTRY* GS_PFNGLBINDFRAMEBUFFERPROC)(GLenum target, GLuint id);
+typedef GLenum (APIENTRY* GS_PFNGLCHECKFRAMEBUFFERSTATUSPROC)(GLenum target);
+typedef void (APIENTRY* GS_PFNGLGENRENDERBUFFERSPROC)(GLsizei n, GLuint* ids);
+typedef void (APIENTRY* GS_PFNGLDELETERENDERBUFFERSPROC)(GLsizei n, const GLuint* ids);
+typedef void (APIENTRY* GS_PFNGLBINDRENDERBUFFERPROC)(GLenum target, GLuint id);
+typedef void (APIENTRY* GS_PFNGLRENDERBUFFERSTORAGEPROC)(GLenum target, GLenum format,
+                                                         GLsizei width, GLsizei height);
+typedef void (APIENTRY* GS_PFNGLFRAMEBUFFERRENDERBUFFERPROC)(GLenum target, GLenum attachment,
+                                                             GLenum rbtarget, GLuint id);
+//==============================================================================================
+
+
+//==============================================================================================
+// GPU timing structures.
+// ---------------------------------------------------------------------------------------------
+typedef struct GS_OGL_GPU_FRAME
+{
+    BOOL        bIsPending;   // Whether the queries have been issued but not yet read back.
+    int         nNumStages;   // Number of stages recorded during the frame.
+    const char* pszNames[GS_OGL_GPU_MAX_STAGES]; // Names of the stages.
+    int         nDepths[GS_OGL_GPU_MAX_STAGES];  // Nesting depths of the stages.
+    GLuint      glBeginQueries[GS_OGL_GPU_MAX_STAGES]; // Timestamps taken when the stages began.
+    GLuint      glEndQueries[GS_OGL_GPU_MAX_STAGES];   // Timestamps taken when the stages ended.
+    GLuint      glLastQuery;  // The query issued last, all others are done when it is done.
+} GS_OGLGPUFrame;
+// ---------------------------------------------------------------------------------------------
+typedef struct GS_OGL_GPU_STAGE
+{
+    const char* pszName; // Name of the stage.
+    int         nDepth;  // Nesting depth of the stage (0 is top level).
+    float       fTime;   // Smoothed GPU time of the stage in milliseconds.
+} GS_OGLGPUStage;
+//==============================================================================================
+
+
 ////////////////////////////////////////////////////////////////////////////////////////////////
 // Class Definition. ///////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////
@@ -79,6 +179,50 @@ private:
 
     BOOL m_bIsReady;      // Wether OpenGL display is ready or not.
 
+    BOOL   m_bIsOffscreen;     // Wether rendering goes to an offscreen framebuffer.
+    GLuint m_glFramebuffer;    // The offscreen framebuffer object.
+    GLuint m_glColorBuffer;    // The color renderbuffer of the offscreen framebuffer.
+    GLuint m_glDepthBuffer;    // The depth renderbuffer of the offscreen framebuffer.
+    GLsizei m_glOffscreenWidth;  // Width of the offscreen framebuffer.
+    GLsizei m_glOffscreenHeight; // Height of the offscreen framebuffer.
+
+    GS_PFNGLDELETEFRAMEBUFFERSPROC  m_glDeleteFramebuffers;
+    GS_PFNGLDELETERENDERBUFFERSPROC m_glDeleteRenderbuffers;
+    GS_PFNGLBINDFRAMEBUFFERPROC     m_glBindFramebuffer;
+
+    BOOL m_bIsGPUTimingSupported; // Wether timestamp queries (ARB_timer_query) are available.
+    BOOL m_bIsGPUTimingEnabled;   // Wether render stages are being timed on the GPU.
+
+    GS_PFNGLGENQUERIESPROC          m_glGenQueries;
+    GS_PFNGLDELETEQUERIESPROC       m_glDeleteQueries;
+    GS_PFNGLQUERYCOUNTERPROC        m_glQueryCounter;
+    GS_PFNGLGETQUERYOBJECTIVPROC    m_glGetQueryObjectiv;
+    GS_PFNGLGETQUERYOBJECTUI64VPROC m_glGetQueryObjectui64v;
+
+    GS_OGLGPUFrame m_GPUFrames[GS_OGL_GPU_FRAMES]; // Ring of frames with queries in flight.
+    int m_nGPUFrame;     // Index of the frame currently being recorded.
+    int m_nGPUReadFrame; // Index of the oldest frame waiting to be read back.
+
+    int m_nGPUOpenStages[GS_OGL_GPU_MAX_DEPTH]; // Indices of the stages not yet ended.
+    int m_nGPUDepth;                            // Current nesting depth.
+
+    GS_OGLGPUStage m_GPUStages[GS_OGL_GPU_MAX_STAGES]; // Results of the stages read back.
+    int m_nNumGPUStages;                               // Number of stages with results.
+
+    GS_OGLRenderStats m_RenderStats;  // Render counters of the last completed frame.
+    GS_OGLRenderStats m_RenderBudget; // Render counter budgets per frame.
+    unsigned long m_ulFramesOverBudget; // Number of frames that exceeded the budget.
+
+    void EndRenderStats();
+
+    BOOL CreateOffscreen(GLsizei glWidth, GLsizei glHeight);
+    void DestroyOffscreen();
+
+    BOOL InitGPUTiming();
+    void ShutdownGPUTiming();
+    void EndGPUFrame();
+    void ReadGPUFrames();
+
 protected:
 
     // No protected members.
@@ -89,9 +233,10 @@ public:
     ~GS_OGLDisplay();
 
 #ifdef GS_PLATFORM_WINDOWS
-    BOOL Create(HDC& hDC, int nWidth, int nHeight, int nDepth);
+    BOOL Create(HDC& hDC, int nWidth, int nHeight, int nDepth, BOOL bOffscreen = FALSE);
 #else
-    BOOL Create(SDL_Window* pWindow, int nWidth, int nHeight, int nDepth);
+    BOOL Create(SDL_Window* pWindow, int nWidth, int nHeight, int nDepth,
+                BOOL bOffscreen = FALSE);
 #endif
     GLvoid Destroy();
 
@@ -128,10 +273,57 @@ public:
     BOOL   EndRender2D();
 #endif
 
+    BOOL ReadPixels(GLubyte* pPixels, GLsizei glWidth, GLsizei glHeight);
+
     BOOL IsReady()
     {
         return m_bIsReady;
     }
+    BOOL IsOffscreen()
+    {
+        return m_bIsOffscreen;
+    }
+
+    GLvoid EnableGPUTiming(BOOL bEnable = TRUE);
+    BOOL IsGPUTimingSupported()
+    {
+        return m_bIsGPUTimingSupported;
+    }
+    BOOL IsGPUTimingEnabled()
+    {
+        return m_bIsGPUTimingEnabled;
+    }
+
+    GLvoid BeginStage(const char* pszName);
+    GLvoid EndStage();
+
+    int GetGPUStageCount()
+    {
+        return m_nNumGPUStages;
+    }
+    const GS_OGLGPUStage* GetGPUStage(int nStage);
+
+    const GS_OGLRenderStats* GetRenderStats()
+    {
+        return &m_RenderStats;
+    }
+    const GS_OGLRenderStats* GetRenderBudget()
+    {
+        return &m_RenderBudget;
+    }
+    void SetRenderBudget(const GS_OGLRenderStats* pBudget)
+    {
+        m_RenderBudget = *pBudget;
+    }
+    BOOL IsOverBudget(const GS_OGLRenderStats* pStats = NULL);
+    unsigned long GetFramesOverBudget()
+    {
+        return m_ulFramesOverBudget;
+    }
+    void ResetFramesOverBudget()
+    {
+        m_ulFramesOverBudget = 0;
+    }
 
     BOOL IsAliasingEnabled()
     {
@@ -191,9 +383,71 @@ public:
         g_fRenderModX = fRenderModX;
         g_fRenderModY = fRenderModY;
     }
+
+    // Static functions for counting the OpenGL calls of the current frame
+    static void CountDrawCall(unsigned long ulVertices)
+    {
+        g_gsRenderStats.ulDrawCalls++;
+        g_gsRenderStats.ulVertices += ulVertices;
+    }
+    static void CountTextureBinds(unsigned long ulBinds = 1)
+    {
+        g_gsRenderStats.ulTextureBinds += ulBinds;
+    }
+    static void CountMatrixOps(unsigned long ulMatrixOps = 1)
+    {
+        g_gsRenderStats.ulMatrixOps += ulMatrixOps;
+    }
+    static void CountStateChanges(unsigned long ulStateChanges = 1)
+    {
+        g_gsRenderStats.ulStateChanges += ulStateChanges;
+    }
+
+    // Static functions for checking the capabilities of the current OpenGL context
+    static BOOL  IsSupported(int nMajor, int nMinor, const char* pszExtension = NULL);
+    static void* GetGLProcAddress(const char* pszName);
+};
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Class Definition. ///////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+class GS_OGLStageScope
+{
+
+private:
+
+    GS_OGLDisplay* m_pDisplay;
+
+public:
+
+    GS_OGLStageScope(GS_OGLDisplay& gsDisplay, const char* pszName)
+    {
+        m_pDisplay = &gsDisplay;
+        m_pDisplay->BeginStage(pszName);
+    }
+    ~GS_OGLStageScope()
+    {
+        m_pDisplay->EndStage();
+    }
 };
 
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
 
+
+//==============================================================================================
+// Macro for timing the remainder of the current scope as a named render stage, both on the CPU
+// (using the profiler) and on the GPU (using timer queries).
+// ---------------------------------------------------------------------------------------------
+#define GS_OGL_PROFILE_STAGE(display, name) \
+    GS_PROFILE_SCOPE(name); \
+    GS_OGLStageScope GS_PROFILE_JOIN(gsStageScope, __LINE__)(display, name)
+//==============================================================================================
+
 #endif
@@ -42,6 +42,8 @@ GS_OGLImage::GS_OGLImage()
     m_nImageSize   = 0;
 
     m_bHasAlpha = FALSE;
+
+    m_pFileData = NULL;
 }
 
 
@@ -60,6 +62,88 @@ GS_OGLImage::~GS_OGLImage()
 {
 
     this->Destroy();
+    this->FreeFileData();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Helper Methods To Read Image Files //////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_OGLImage::ReadFileData():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Gets the contents of an image file. If the file is in the global pack a pointer
+//          into the (mapped) pack is returned, otherwise the file is read into memory.
+// ---------------------------------------------------------------------------------------------
+// Returns: A pointer to the file contents or NULL if failed, call FreeFileData() when done.
+//==============================================================================================
+
+const BYTE* GS_OGLImage::ReadFileData(const char* pszFilename, unsigned long* plSize)
+{
+
+    // Do we have a valid filename?
+    if (!pszFilename)
+    {
+        return NULL;
+    }
+
+    const BYTE* pData = NULL;
+
+    // Use the contents straight from the pack if the file is in there.
+    if (g_gsPack.Find(pszFilename, &pData, plSize))
+    {
+        return pData;
+    }
+
+    GS_File gsFile;
+
+    // Try to open the image file.
+    if (!gsFile.Open(pszFilename, FILE_READ))
+    {
+        return NULL;
+    }
+
+    *plSize = gsFile.GetLength();
+
+    // Allocate enough memory for the contents of the file.
+    m_pFileData = new BYTE [*plSize + 1];
+
+    // Were we able to allocate memory and read the entire file?
+    if ((!m_pFileData) || ((*plSize > 0) && (gsFile.Read(m_pFileData, *plSize) != *plSize)))
+    {
+        this->FreeFileData();
+        return NULL;
+    }
+
+    return m_pFileData;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_OGLImage::FreeFileData():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Releases the file contents read by ReadFileData() (contents in the pack are left
+//          alone).
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_OGLImage::FreeFileData()
+{
+
+    if (m_pFileData != NULL)
+    {
+        delete [] m_pFileData;
+    }
+    m_pFileData = NULL;
 }
 
 
@@ -74,34 +158,27 @@ GS_OGLImage::~GS_OGLImage()
 //==============================================================================================
 // GS_OGLImage::LoadUncompressedTGA():
 // ---------------------------------------------------------------------------------------------
-// Purpose: ...
+// Purpose: Loads uncompressed TGA image data, pData points to the data following the 12 byte
+//          TGA header.
 // ---------------------------------------------------------------------------------------------
 // Returns: TRUE if successful, FALSE if failed.
 //==============================================================================================
 
-BOOL GS_OGLImage::LoadUncompressedTGA(FILE* pFile)
+BOOL GS_OGLImage::LoadUncompressedTGA(const BYTE* pData, unsigned long lSize)
 {
 
-    // Variable for holding the TGA header.
-    BYTE TGAHeader[6] = { 0,0,0,0,0,0 };
-
-    // Read TGA header.
-    if (fread(TGAHeader, sizeof(TGAHeader), 1, pFile) == 0)
+    // Is there enough data for the rest of the TGA header?
+    if (lSize < 6)
     {
-        // Is file still open?
-        if (pFile != NULL)
-        {
-            fclose(pFile);
-        }
         return FALSE;
     }
 
     // Determine the image width (highbyte * 256 + lowbyte).
-    m_nImageWidth  = TGAHeader[1] * 256 + TGAHeader[0];
+    m_nImageWidth  = pData[1] * 256 + pData[0];
     // Determine the image height (highbyte * 256 + lowbyte).
-    m_nImageHeight = TGAHeader[3] * 256 + TGAHeader[2];
+    m_nImageHeight = pData[3] * 256 + pData[2];
     // Determine the color size of the image in bytes.
-    m_nColorBytes  = TGAHeader[4] / 8;
+    m_nColorBytes  = pData[4] / 8;
     // Determine if the image has an alpha component.
     m_bHasAlpha    = (m_nColorBytes==4);
 
@@ -111,17 +188,20 @@ BOOL GS_OGLImage::LoadUncompressedTGA(FILE* pFile)
     {
         // Clear image data and attributes.
         this->Destroy();
-        // Is file still open?
-        if (pFile != NULL)
-        {
-            fclose(pFile);
-        }
         return FALSE;
     }
 
     // Compute the total amount of memory needed to store the image data.
     m_nImageSize = (m_nColorBytes * m_nImageWidth * m_nImageHeight);
 
+    // Is there enough data for the entire image?
+    if (lSize - 6 < (unsigned long)m_nImageSize)
+    {
+        // Clear image data and attributes.
+        this->Destroy();
+        return FALSE;
+    }
+
     // Does image exist already?
     if (m_pImage != NULL)
     {
@@ -138,26 +218,11 @@ BOOL GS_OGLImage::LoadUncompressedTGA(FILE* pFile)
     {
         // Clear image data and attributes.
         this->Destroy();
-        // Is file still open?
-        if (pFile != NULL)
-        {
-            fclose(pFile);
-        }
         return FALSE;
     }
 
-    // Were we able to read the TGA image data?
-    if (fread(m_pImage, 1, m_nImageSize, pFile) != (unsigned)m_nImageSize)
-    {
-        // Clear image data and attributes.
-        this->Destroy();
-        // Is file still open?
-        if (pFile != NULL)
-        {
-            fclose(pFile);
-        }
-        return FALSE;
-    }
+    // Copy the TGA image data.
+    memcpy(m_pImage, pData + 6, m_nImageSize);
 
     // Swap bytes to the correct color format (BGR -> RGB).
     for (int nSwap = 0; nSwap < m_nImageSize; nSwap += m_nColorBytes)
@@ -165,9 +230,6 @@ BOOL GS_OGLImage::LoadUncompressedTGA(FILE* pFile)
         m_pImage[nSwap] ^= m_pImage[nSwap+2] ^= m_pImage[nSwap] ^= m_pImage[nSwap+2];
     }
 
-    // Close the TGA file.
-    fclose(pFile);
-
     return TRUE;
 }
 
@@ -178,34 +240,27 @@ BOOL GS_OGLImage::LoadUncompressedTGA(FILE* pFile)
 //==============================================================================================
 // GS_OGLImage::LoadCompressedTGA():
 // ---------------------------------------------------------------------------------------------
-// Purpose: ...
+// Purpose: Loads RLE compressed TGA image data, pData points to the data following the 12
+//          byte TGA header.
 // ---------------------------------------------------------------------------------------------
 // Returns: TRUE if successful, FALSE if failed.
 //==============================================================================================
 
-BOOL GS_OGLImage::LoadCompressedTGA(FILE* pFile)
+BOOL GS_OGLImage::LoadCompressedTGA(const BYTE* pData, unsigned long lSize)
 {
 
-    // Variable for holding the TGA header.
-    BYTE TGAHeader[6] = { 0,0,0,0,0,0 };
-
-    // Read the TGA header.
-    if (fread(TGAHeader, sizeof(TGAHeader), 1, pFile) == 0)
+    // Is there enough data for the rest of the TGA header?
+    if (lSize < 6)
     {
-        // Is file still open?
-        if (pFile != NULL)
-        {
-            fclose(pFile);
-        }
         return FALSE;
     }
 
     // Determine the image width (highbyte * 256 + lowbyte).
-    m_nImageWidth  = TGAHeader[1] * 256 + TGAHeader[0];
+    m_nImageWidth  = pData[1] * 256 + pData[0];
     // Determine the image height (highbyte * 256 + lowbyte).
-    m_nImageHeight = TGAHeader[3] * 256 + TGAHeader[2];
+    m_nImageHeight = pData[3] * 256 + pData[2];
     // Determine the color size of the image in bytes.
-    m_nColorBytes  = TGAHeader[4] / 8;
+    m_nColorBytes  = pData[4] / 8;
     // Determine the alpha component.
     m_bHasAlpha    = (m_nColorBytes==4);
 
@@ -215,11 +270,6 @@ BOOL GS_OGLImage::LoadCompressedTGA(FILE* pFile)
     {
         // Clear image data and attributes.
         this->Destroy();
-        // Is file still open?
-        if (pFile != NULL)
-        {
-            fclose(pFile);
-        }
         return FALSE;
     }
 
@@ -242,11 +292,6 @@ BOOL GS_OGLImage::LoadCompressedTGA(FILE* pFile)
     {
         // Clear image data and attributes.
         this->Destroy();
-        // Is file still open?
-        if (pFile != NULL)
-        {
-            fclose(pFile);
-        }
         return FALSE;
     }
 
@@ -254,154 +299,112 @@ BOOL GS_OGLImage::LoadCompressedTGA(FILE* pFile)
     unsigned int nCurrentPixel = 0; // Current pixel being read.
     unsigned int nCurrentByte  = 0; // Current byte.
 
-    // Allocate enough memory for the color of a single pixel.
-    BYTE* pColorBuffer = new BYTE [m_nColorBytes];
-
-    // Were we able to allocate memory?
-    if (!pColorBuffer)
-    {
-        // Clear image data and attributes.
-        this->Destroy();
-        // Is file still open?
-        if (pFile != NULL)
-        {
-            fclose(pFile);
-        }
-        return FALSE;
-    }
+    const BYTE* pCurrent = pData + 6;     // Current position in the compressed data.
+    const BYTE* pEnd     = pData + lSize; // End of the compressed data.
 
     do
     {
-        BYTE ucChunkHeader = 0; // Storage for "chunk" header.
-
-        // Read in the chunk header.
-        if (fread(&ucChunkHeader, sizeof(BYTE), 1, pFile) == 0)
+        // Is there a chunk header left to read?
+        if (pCurrent >= pEnd)
         {
             // Clear image data and attributes.
             this->Destroy();
-            // Is file still open?
-            if (pFile != NULL)
-            {
-                fclose(pFile);
-            }
             return FALSE;
         }
 
+        // Read in the chunk header.
+        unsigned int nChunkHeader = *pCurrent++;
+
         // If the header is < 128, it means the that is the number of RAW color packets minus one.
-        if (ucChunkHeader < 128)
+        if (nChunkHeader < 128)
         {
             // Add 1 to get number of following color values.
-            ucChunkHeader++;
-            // Read RAW color values.
-            for (short sLoop = 0; sLoop < ucChunkHeader; sLoop++)
+            nChunkHeader++;
+            // Make sure all the RAW color values are there and that they fit in the image.
+            if (((unsigned long)(pEnd - pCurrent) < nChunkHeader * m_nColorBytes) ||
+                (nCurrentPixel + nChunkHeader > nPixelCount))
             {
-                // Try to read 1 pixel.
-                if (fread(pColorBuffer, 1, m_nColorBytes, pFile) != (unsigned)m_nColorBytes)
-                {
-                    // Clear image data and attributes.
-                    this->Destroy();
-                    // De-allocate memory for color data.
-                    delete [] pColorBuffer;
-                    // Is file still open?
-                    if (pFile != NULL)
-                    {
-                        fclose(pFile);
-                    }
-                    return FALSE;
-                }
-                // Write to memory and flip the R and B color values around in the process.
-                m_pImage[nCurrentByte]   = pColorBuffer[2];
-                m_pImage[nCurrentByte+1] = pColorBuffer[1];
-                m_pImage[nCurrentByte+2] = pColorBuffer[0];
-                // If it's a 32-bit image.
-                if (m_nColorBytes == 4)
+                // Clear image data and attributes.
+                this->Destroy();
+                return FALSE;
+            }
+            // Read RAW color values, flipping the R and B color values around in the process.
+            BYTE* pDest = m_pImage + nCurrentByte;
+            if (m_nColorBytes == 4)
+            {
+                for (unsigned int nLoop = 0; nLoop < nChunkHeader; nLoop++)
                 {
-                    // Copy the 4th byte.
-                    m_pImage[nCurrentByte+3] = pColorBuffer[3];
+                    pDest[0] = pCurrent[2];
+                    pDest[1] = pCurrent[1];
+                    pDest[2] = pCurrent[0];
+                    pDest[3] = pCurrent[3];
+                    pCurrent += 4;
+                    pDest    += 4;
                 }
-                // Increase the current byte by the number of bytes per pixel.
-                nCurrentByte += m_nColorBytes;
-                // Increase current pixel by 1.
-                nCurrentPixel++;
-                // Make sure we haven't read too many pixels.
-                if (nCurrentPixel > nPixelCount)
+            }
+            else
+            {
+                for (unsigned int nLoop = 0; nLoop < nChunkHeader; nLoop++)
                 {
-                    // Clear image data and attributes.
-                    this->Destroy();
-                    // De-allocate memory for color data.
-                    delete [] pColorBuffer;
-                    // Is file still open?
-                    if (pFile != NULL)
-                    {
-                        fclose(pFile);
-                    }
-                    return FALSE;
+                    pDest[0] = pCurrent[2];
+                    pDest[1] = pCurrent[1];
+                    pDest[2] = pCurrent[0];
+                    pCurrent += 3;
+                    pDest    += 3;
                 }
             }
+            // Increase the current byte and pixel by the number of pixels read.
+            nCurrentByte  += nChunkHeader * m_nColorBytes;
+            nCurrentPixel += nChunkHeader;
         }
-        // ucChunkHeader > 128 RLE data, next color reapeated ucChunkHeader - 127 times.
+        // nChunkHeader > 128 RLE data, next color reapeated nChunkHeader - 127 times.
         else
         {
-            // Subteact 127 to get rid of the ID bit.
-            ucChunkHeader -= (unsigned char)127;
-            // Read a single RLE color value.
-            if (fread(pColorBuffer, 1, m_nColorBytes, pFile) != (unsigned)m_nColorBytes)
+            // Subtract 127 to get rid of the ID bit.
+            nChunkHeader -= 127;
+            // Make sure the RLE color value is there and that the run fits in the image.
+            if (((unsigned long)(pEnd - pCurrent) < (unsigned long)m_nColorBytes) ||
+                (nCurrentPixel + nChunkHeader > nPixelCount))
             {
                 // Clear image data and attributes.
                 this->Destroy();
-                // De-allocate memory for color data.
-                delete [] pColorBuffer;
-                // Is file still open?
-                if (pFile != NULL)
-                {
-                    fclose(pFile);
-                }
                 return FALSE;
             }
-            // Write RLE the color value to memory as many times as required.
-            for (short sLoop = 0; sLoop < ucChunkHeader; sLoop++)
+            // Write the first pixel, flipping the R and B color values around in the process.
+            BYTE* pDest = m_pImage + nCurrentByte;
+            pDest[0] = pCurrent[2];
+            pDest[1] = pCurrent[1];
+            pDest[2] = pCurrent[0];
+            // If TGA images is 32 bpp.
+            if (m_nColorBytes == 4)
             {
-                // Write to memory and flip the R and B color values around in the process.
-                m_pImage[nCurrentByte]   = pColorBuffer[2];
-                m_pImage[nCurrentByte+1] = pColorBuffer[1];
-                m_pImage[nCurrentByte+2] = pColorBuffer[0];
-                // If TGA images is 32 bpp.
-                if (m_nColorBytes == 4)
-                {
-                    // Copy 4th byte
-                    m_pImage[nCurrentByte+3] = pColorBuffer[3];
-                }
-                // Increase current byte by the number of bytes per pixel.
-                nCurrentByte += m_nColorBytes;
-                // Increase pixel count by 1
-                nCurrentPixel++;
-                // Make sure we havent written too many pixels.
-                if (nCurrentPixel > nPixelCount)
-                {
-                    // Clear image data and attributes.
-                    this->Destroy();
-                    // De-allocate memory for color data.
-                    delete [] pColorBuffer;
-                    // Is file still open?
-                    if (pFile != NULL)
-                    {
-                        fclose(pFile);
-                    }
-                    return FALSE;
-                }
+                // Copy 4th byte
+                pDest[3] = pCurrent[3];
+            }
+            // Fill the rest of the run by repeatedly copying the part already written, which
+            // doubles in size with every copy.
+            unsigned int nRunBytes = nChunkHeader * m_nColorBytes;
+            unsigned int nWritten  = m_nColorBytes;
+            while (nWritten < nRunBytes)
+            {
+                unsigned int nCopy = (nWritten < nRunBytes - nWritten) ? nWritten :
+                                     nRunBytes - nWritten;
+                memcpy(pDest + nWritten, pDest, nCopy);
+                nWritten += nCopy;
             }
+            // Increase the current byte and pixel by the length of the run.
+            nCurrentByte  += nRunBytes;
+            nCurrentPixel += nChunkHeader;
+            // Move on to the next chunk header.
+            pCurrent += m_nColorBytes;
         }
         // Loop while there are still pixels left.
     }
     while(nCurrentPixel < nPixelCount);
 
-    // Close the TGA file.
-    fclose(pFile);
-
     return TRUE;
 }
 
-
 ////////////////////////////////////////////////////////////////////////////////////////////////
 
 
@@ -491,12 +494,46 @@ void GS_OGLImage::Destroy()
 //==============================================================================================
 // GS_OGLImage::Load():
 // ---------------------------------------------------------------------------------------------
-// Purpose: ...
+// Purpose: Loads a TGA, PCX or BMP image file (from the global pack if it is in there).
 // ---------------------------------------------------------------------------------------------
 // Returns: TRUE if successful, FALSE if failed.
 //==============================================================================================
 
 BOOL GS_OGLImage::Load(const char* pszFilename)
+{
+
+    unsigned long lSize = 0;
+
+    // Get the contents of the image file.
+    const BYTE* pData = this->ReadFileData(pszFilename, &lSize);
+
+    if (!pData)
+    {
+        return FALSE;
+    }
+
+    // Load the image from the file contents.
+    BOOL bResult = this->Load(pszFilename, pData, lSize);
+
+    this->FreeFileData();
+
+    return bResult;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_OGLImage::Load():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Loads an image from the contents of an image file in memory, the filename is only
+//          used to determine the image format.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if failed.
+//==============================================================================================
+
+BOOL GS_OGLImage::Load(const char* pszFilename, const BYTE* pData, unsigned long lSize)
 {
 
     // Check if valid filename.
@@ -512,33 +549,33 @@ BOOL GS_OGLImage::Load(const char* pszFilename)
     if (toupper(pszFilename[nLength-3])=='T' && toupper(pszFilename[nLength-2])=='G' &&
             toupper(pszFilename[nLength-1])=='A')
     {
-        // Load the tga picture file.
-        return this->LoadTGA(pszFilename);
+        // Load the tga picture.
+        return this->LoadTGA(pData, lSize);
     }
     else if (toupper(pszFilename[nLength-3])=='P' && toupper(pszFilename[nLength-2])=='C' &&
              toupper(pszFilename[nLength-1])=='X')
     {
-        // Load the pcx picture file.
-        return this->LoadPCX(pszFilename);
+        // Load the pcx picture.
+        return this->LoadPCX(pData, lSize);
     }
     else if (toupper(pszFilename[nLength-3])=='B' && toupper(pszFilename[nLength-2])=='M' &&
              toupper(pszFilename[nLength-1])=='P')
     {
-        // Load the bmp picture file.
-        return this->LoadBMP(pszFilename);
+        // Load the bmp picture.
+        return this->LoadBMP(pData, lSize);
     }
     else
     {
         // Unknown file format try loading it anyway.
-        if (this->LoadBMP(pszFilename))
+        if (this->LoadBMP(pData, lSize))
         {
             return TRUE;
         }
-        if (this->LoadPCX(pszFilename))
+        if (this->LoadPCX(pData, lSize))
         {
             return TRUE;
         }
-        if (this->LoadTGA(pszFilename))
+        if (this->LoadTGA(pData, lSize))
         {
             return TRUE;
         }
@@ -563,17 +600,40 @@ BOOL GS_OGLImage::Load(const char* pszFilename)
 BOOL GS_OGLImage::LoadBMP(const char* pszFilename)
 {
 
-    // Do we have a valid filename?
-    if (!pszFilename)
+    unsigned long lSize = 0;
+
+    // Get the contents of the bitmap file.
+    const BYTE* pData = this->ReadFileData(pszFilename, &lSize);
+
+    if (!pData)
     {
         return FALSE;
     }
 
-    // Try to open the bitmap file.
-    FILE* pFile = fopen(pszFilename, "rb");
+    BOOL bResult = this->LoadBMP(pData, lSize);
+
+    this->FreeFileData();
+
+    return bResult;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_OGLImage::LoadBMP():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Loads a 24-bit or 32-bit bitmap from the contents of a BMP file in memory.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if failed.
+//==============================================================================================
+
+BOOL GS_OGLImage::LoadBMP(const BYTE* pData, unsigned long lSize)
+{
 
-    // Were we able to open the bitmap file?
-    if (!pFile)
+    // Is there enough data for both bitmap headers?
+    if ((!pData) || (lSize < sizeof(BITMAPFILEHEADER) + sizeof(BITMAPINFOHEADER)))
     {
         return FALSE;
     }
@@ -581,48 +641,28 @@ BOOL GS_OGLImage::LoadBMP(const char* pszFilename)
     BITMAPFILEHEADER BitmapHeader;
 
     // Read the header of the bitmap file.
-    if (!fread(&BitmapHeader, sizeof(BITMAPFILEHEADER), 1, pFile))
-    {
-        // Is file still open?
-        if (pFile != NULL)
-        {
-            fclose(pFile);
-        }
-        return FALSE;
-    }
+    memcpy(&BitmapHeader, pData, sizeof(BITMAPFILEHEADER));
 
     // Check the type field to make sure we have a valid bitmap file.
     if (memcmp(&BitmapHeader.bfType, "BM", 2))
     {
-        // Is file still open?
-        if (pFile != NULL)
-        {
-            fclose(pFile);
-        }
         return FALSE;
     }
 
     BITMAPINFOHEADER HeaderInfo;
 
     // Read the information header of the bitmap file.
-    if (!fread(&HeaderInfo, sizeof(BITMAPINFOHEADER), 1, pFile))
+    memcpy(&HeaderInfo, pData + sizeof(BITMAPFILEHEADER), sizeof(BITMAPINFOHEADER));
+
+    // We only support 24-bit and 32-bit bitmaps so make sure that's what we have.
+    if ((HeaderInfo.biBitCount!=24) && (HeaderInfo.biBitCount!=32))
     {
-        // Is file still open?
-        if (pFile != NULL)
-        {
-            fclose(pFile);
-        }
         return FALSE;
     }
 
-    // We only support 24-bit and 32-bit bitmaps so make sure that's what we have.
-    if ((HeaderInfo.biBitCount!=24) && (HeaderInfo.biBitCount!=32))
+    // We only support bottom-up bitmaps.
+    if ((HeaderInfo.biWidth <= 0) || (HeaderInfo.biHeight <= 0))
     {
-        // Is file still open?
-        if (pFile != NULL)
-        {
-            fclose(pFile);
-        }
         return FALSE;
     }
 
@@ -639,30 +679,6 @@ BOOL GS_OGLImage::LoadBMP(const char* pszFilename)
     // Set image size for allocating memory.
     m_nImageSize = m_nImageWidth * m_nImageHeight * m_nColorBytes;
 
-    // Does image exist already?
-    if (m_pImage != NULL)
-    {
-        // De-allocate memory for image data.
-        delete []m_pImage;
-    }
-    m_pImage = NULL;
-
-    // Allocate enough space for the image data.
-    m_pImage = new BYTE [m_nImageSize];
-
-    // Were we able to allocate memory?
-    if (!m_pImage)
-    {
-        // Clear image data and attributes.
-        this->Destroy();
-        // Is file still open?
-        if (pFile != NULL)
-        {
-            fclose(pFile);
-        }
-        return FALSE;
-    }
-
     // Set stride - The stride is the TRUE number of bytes in a line of pixels. Windows makes
     // all the bitmaps DWORD aligned (divisible evenly by 4), so if you bitmap say was 103x103
     // pixels, Windows would add 1 "padding byte" to it so in memory it would be 104x103 pixels.
@@ -676,58 +692,46 @@ BOOL GS_OGLImage::LoadBMP(const char* pszFilename)
         nBitmapStride++;
     }
 
-    // Bytes per line (number of bytes in a scan line).
+    // Bytes per line (number of bytes in a scan line). We do NOT want to copy the padding
+    // bytes, remember that Windows adds padding bytes to ensure all bitmaps are DWORD aligned.
     unsigned int nBytesPerLine = HeaderInfo.biWidth * (HeaderInfo.biBitCount / 8);
 
-    // Calculate how many "padding" bytes there are. We do NOT want to read in the padding bytes.
-    // Remember that Windows adds padding bytes to ensure all bitmaps are DWORD aligned.
-    unsigned int nPaddingBytes = nBitmapStride - nBytesPerLine;
+    // Make sure all the scan lines are there (the last one may be without padding).
+    if ((BitmapHeader.bfOffBits > lSize) || (lSize - BitmapHeader.bfOffBits <
+            (unsigned long)nBitmapStride * (m_nImageHeight - 1) + nBytesPerLine))
+    {
+        return FALSE;
+    }
+
+    // Does image exist already?
+    if (m_pImage != NULL)
+    {
+        // De-allocate memory for image data.
+        delete []m_pImage;
+    }
+    m_pImage = NULL;
 
-    // Jump to the location where the pixel data is stored.
-    if (fseek(pFile, BitmapHeader.bfOffBits, SEEK_SET))
+    // Allocate enough space for the image data.
+    m_pImage = new BYTE [m_nImageSize];
+
+    // Were we able to allocate memory?
+    if (!m_pImage)
     {
         // Clear image data and attributes.
         this->Destroy();
-        // Is file still open?
-        if (pFile != NULL)
-        {
-            fclose(pFile);
-        }
         return FALSE;
     }
 
+    // Jump to the location where the pixel data is stored.
+    const BYTE* pPixels = pData + BitmapHeader.bfOffBits;
+
     // Loop over all the scan lines (all the rows of pixels in the image).
     for (int y = 0; y < HeaderInfo.biHeight; y++)
     {
-        // Read the precise number of bytes that the scan line requires into the image.
-        if (!fread(m_pImage + (nBitmapStride * y), nBytesPerLine, 1, pFile))
-        {
-            // Clear image data and attributes.
-            this->Destroy();
-            // Is file still open?
-            if (pFile != NULL)
-            {
-                fclose(pFile);
-            }
-            return FALSE;
-        }
-        // Skip over any padding bytes.
-        if (fseek(pFile, nPaddingBytes, SEEK_CUR))
-        {
-            // Clear image data and attributes.
-            this->Destroy();
-            // Is file still open?
-            if (pFile != NULL)
-            {
-                fclose(pFile);
-            }
-            return FALSE;
-        }
+        // Copy the precise number of bytes that the scan line requires into the image.
+        memcpy(m_pImage + (nBytesPerLine * y), pPixels + (nBitmapStride * y), nBytesPerLine);
     }
 
-    // Close the BMP file.
-    fclose(pFile);
-
     BYTE temp;
 
     // Convert image data from BGR to RGB color format.
@@ -756,72 +760,63 @@ BOOL GS_OGLImage::LoadBMP(const char* pszFilename)
 BOOL GS_OGLImage::LoadPCX(const char* pszFilename)
 {
 
-    // Open the PCX file for reading.
-    FILE* pFile = fopen(pszFilename,"rb");
+    unsigned long lSize = 0;
+
+    // Get the contents of the PCX file.
+    const BYTE* pData = this->ReadFileData(pszFilename, &lSize);
 
-    // Were we able to open the file?
-    if (!pFile)
+    if (!pData)
     {
         return FALSE;
     }
 
-    // Creata an array to hold palette.
-    BYTE Palette[768];
+    BOOL bResult = this->LoadPCX(pData, lSize);
+
+    this->FreeFileData();
+
+    return bResult;
+}
+
 
-    // Go to the end of the file (where the palette is located).
-    fseek(pFile, -769, SEEK_END);
+////////////////////////////////////////////////////////////////////////////////////////////////
 
-    // Read value to see wether it's the palette.
-    int nCurrentValue = fgetc(pFile);
 
-    // Are we at the palette?
-    if (nCurrentValue != 12)
+//==============================================================================================
+// GS_OGLImage::LoadPCX():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Loads an 8-bit RLE encoded image from the contents of a PCX file in memory.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if failed.
+//==============================================================================================
+
+BOOL GS_OGLImage::LoadPCX(const BYTE* pData, unsigned long lSize)
+{
+
+    // Is there enough data for the header and the palette?
+    if ((!pData) || (lSize < sizeof(GS_PCXHeader) + 769))
     {
-        // Is file still open?
-        if (pFile != NULL)
-        {
-            fclose(pFile);
-        }
         return FALSE;
     }
 
-    // Were we able to read the entire palette?
-    if (!fread(Palette, 1, 768, pFile))
+    // Are we at the palette (located at the end of the file)?
+    if (pData[lSize-769] != 12)
     {
-        // Is file still open?
-        if (pFile != NULL)
-        {
-            fclose(pFile);
-        }
         return FALSE;
     }
 
-    // Return to the beginning of the file.
-    fseek(pFile, 0, SEEK_SET);
+    // The palette follows right after.
+    const BYTE* Palette = pData + lSize - 768;
 
     // Structure to hold PCX header.
     GS_PCXHeader gsPCXHeader;
 
-    // Were we able to read the entire header?
-    if (!fread(&gsPCXHeader, sizeof(GS_PCXHeader), 1, pFile))
-    {
-        // Is file still open?
-        if (pFile != NULL)
-        {
-            fclose(pFile);
-        }
-        return FALSE;
-    }
+    // Read the header from the beginning of the file.
+    memcpy(&gsPCXHeader, pData, sizeof(GS_PCXHeader));
 
     // Make sure the file we have is a PCX file.
     if ((gsPCXHeader.cManufacturer != 10) || (gsPCXHeader.cVersion != 5) ||
             (gsPCXHeader.cEncoding != 1))
     {
-        // Is file still open?
-        if (pFile != NULL)
-        {
-            fclose(pFile);
-        }
         return FALSE;
     }
 
@@ -854,102 +849,119 @@ BOOL GS_OGLImage::LoadPCX(const char* pszFilename)
     {
         // Clear image data and attributes.
         this->Destroy();
-        // Is file still open?
-        if (pFile != NULL)
-        {
-            fclose(pFile);
-        }
         return FALSE;
     }
 
-    /* Varialble to hold postion in file.
-    // int nPosition = 0;
-
-    // Run through the image.
-    while (nPosition < m_nImageSize) {
-       // Get the current character.
-       nCurrentValue = fgetc(pFile);
-       // Is it a status byte (i.e. RLE encoded)?
-       if (nCurrentValue >= 0xc0) {
-          // Get the repeat length.
-          int nRepeatLength = 0x3f & nCurrentValue;
-          // Get the next character in the file.
-          nCurrentValue = fgetc(pFile);
-          // Repeat it the number of times.
-          for (int nLoop = 0; nLoop < nRepeatLength; nLoop++) {
-             // Write the pixel to the image data.
-             m_pImage[nPosition]   = Palette[nCurrentValue*3];
-             m_pImage[nPosition+1] = Palette[nCurrentValue*3+1];
-             m_pImage[nPosition+2] = Palette[nCurrentValue*3+2];
-             // Move forward to the next pixel.
-             nPosition += m_nColorBytes;
-            }
-          }
-       else {
-          // Write the pixel to the image data.
-          m_pImage[nPosition]   = Palette[nCurrentValue*3];
-          m_pImage[nPosition+1] = Palette[nCurrentValue*3+1];
-          m_pImage[nPosition+2] = Palette[nCurrentValue*3+2];
-          // Move forward to the next pixel.
-          nPosition += m_nColorBytes;
-          }
-       } */
-
-    // Varialble to hold postion in file.
-    int nPosition;
-
-    // Run through the entire image from bottom to top and left to right thereby flipping
-    // the image vertically (otherwise the image will be the wrong side up).
+    // Number of bytes in each scan line of RLE data (at least the image width, lines are
+    // padded to an even number of bytes).
+    int nBytesPerLine = gsPCXHeader.wBytesPerLine;
+
+    if (nBytesPerLine < m_nImageWidth)
+    {
+        // Clear image data and attributes.
+        this->Destroy();
+        return FALSE;
+    }
+
+    // Allocate a buffer to hold the palette indices of one scan line.
+    BYTE* pLine = new BYTE [nBytesPerLine];
+
+    // Build a table that turns a palette index straight into an RGB pixel. The color is
+    // stored in the first three bytes, so a pixel is written with a single four byte copy.
+    DWORD PaletteRGB[256];
+
+    for (int nIndex = 0; nIndex < 256; nIndex++)
+    {
+        PaletteRGB[nIndex] = 0;
+        memcpy(&PaletteRGB[nIndex], &Palette[nIndex*3], 3);
+    }
+
+    const BYTE* pCurrent = pData + sizeof(GS_PCXHeader); // Current position in the RLE data.
+    const BYTE* pEnd     = pData + lSize - 769;          // End of the RLE data.
+
+    int  nRunLength = 0; // Number of pixels left in the current run.
+    BYTE RunValue   = 0; // Palette index repeated by the current run.
+
+    // Run through the entire image from bottom to top thereby flipping the image vertically
+    // (otherwise the image will be the wrong side up).
     for (long y = m_nImageHeight-1; y >= 0; y--)
     {
-        for (long x = 0; x < m_nImageWidth; x++)
+        int x = 0;
+
+        // Decode the RLE data of the scan line into palette indices.
+        while (x < nBytesPerLine)
         {
-            // Get the current character.
-            nCurrentValue = fgetc(pFile);
+            // Is there a run left to write (runs may carry on into the next line)?
+            if (nRunLength > 0)
+            {
+                int nCount = (nRunLength < nBytesPerLine - x) ? nRunLength : nBytesPerLine - x;
+                // Write the whole run at once.
+                memset(pLine + x, RunValue, nCount);
+                x          += nCount;
+                nRunLength -= nCount;
+                continue;
+            }
+
+            // Make sure we haven't run out of data.
+            if (pCurrent >= pEnd)
+            {
+                // Clear image data and attributes.
+                delete []pLine;
+                this->Destroy();
+                return FALSE;
+            }
+
             // Is it a status byte (i.e. RLE encoded)?
-            if (nCurrentValue >= 0xc0)
+            if (*pCurrent >= 0xc0)
             {
                 // Get the repeat length.
-                int nRepeatLength = 0x3f & nCurrentValue;
-                // Get the next character in the file.
-                nCurrentValue = fgetc(pFile);
-                // Repeat it the number of times.
-                for (int nLoop = 0; nLoop < nRepeatLength; nLoop++)
+                nRunLength = 0x3f & *pCurrent++;
+                // Make sure we haven't run out of data.
+                if (pCurrent >= pEnd)
                 {
-                    // Determine the position of the current pixel.
-                    nPosition = (((m_nImageWidth * y) + x) * m_nColorBytes);
-                    // Write the pixel to the image data.
-                    m_pImage[nPosition]   = Palette[nCurrentValue*3];
-                    m_pImage[nPosition+1] = Palette[nCurrentValue*3+1];
-                    m_pImage[nPosition+2] = Palette[nCurrentValue*3+2];
-                    // Is horizontal value equal to image width?
-                    if (x >= m_nImageWidth)
-                    {
-                        // Reset to start of row.
-                        x = 0;
-                        // Start a new row.
-                        y--;
-                    }
-                    // Next value in row.
-                    x++;
+                    // Clear image data and attributes.
+                    delete []pLine;
+                    this->Destroy();
+                    return FALSE;
                 }
-                // Adjust value.
-                x--;
+                // Get the index to repeat.
+                RunValue = *pCurrent++;
             }
             else
             {
-                // Determine the position of the current pixel.
-                nPosition = (((m_nImageWidth * y) + x) * m_nColorBytes);
-                // Write the pixel to the image data.
-                m_pImage[nPosition]   = Palette[nCurrentValue*3];
-                m_pImage[nPosition+1] = Palette[nCurrentValue*3+1];
-                m_pImage[nPosition+2] = Palette[nCurrentValue*3+2];
+                // Copy all the literal indices that follow in one go.
+                const BYTE* pLiteral = pCurrent;
+                const BYTE* pLimit   = pCurrent + (nBytesPerLine - x);
+
+                if (pLimit > pEnd)
+                {
+                    pLimit = pEnd;
+                }
+
+                while ((pCurrent < pLimit) && (*pCurrent < 0xc0))
+                {
+                    pCurrent++;
+                }
+
+                memcpy(pLine + x, pLiteral, pCurrent - pLiteral);
+                x += (int)(pCurrent - pLiteral);
             }
         }
+
+        // Convert the palette indices of the line to RGB pixels. Each copy writes one byte
+        // into the next pixel, which is written next, so the last pixel only copies three.
+        BYTE* pDest = m_pImage + (m_nImageWidth * y * m_nColorBytes);
+
+        for (x = 0; x < m_nImageWidth - 1; x++)
+        {
+            memcpy(pDest, &PaletteRGB[pLine[x]], 4);
+            pDest += 3;
+        }
+        memcpy(pDest, &PaletteRGB[pLine[x]], 3);
     }
 
-    // Close the PCX file.
-    fclose(pFile);
+    // Free the scan line buffer.
+    delete []pLine;
 
     return TRUE;
 }
@@ -969,29 +981,42 @@ BOOL GS_OGLImage::LoadPCX(const char* pszFilename)
 BOOL GS_OGLImage::LoadTGA(const char* pszFilename)
 {
 
-    // Pointer to TGA image file.
-    FILE* pFile;
+    unsigned long lSize = 0;
 
-    // Open the TGA file for reading.
-    pFile = fopen(pszFilename, "rb");
+    // Get the contents of the TGA file.
+    const BYTE* pData = this->ReadFileData(pszFilename, &lSize);
 
-    // Were we able to open the file?
-    if (pFile == NULL)
+    if (!pData)
     {
         return FALSE;
     }
 
-    // Variable to store TGA header.
-    BYTE TGAHeader[12] = { 0,0,0,0,0,0,0,0,0,0,0,0 };
+    BOOL bResult = this->LoadTGA(pData, lSize);
+
+    this->FreeFileData();
+
+    return bResult;
+}
+
 
-    // Attempt to read 12 byte header from file.
-    if (fread(TGAHeader, sizeof(TGAHeader), 1, pFile) == 0)
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_OGLImage::LoadTGA():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Loads an uncompressed or RLE compressed 24-bit or 32-bit image from the contents
+//          of a TGA file in memory.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if failed.
+//==============================================================================================
+
+BOOL GS_OGLImage::LoadTGA(const BYTE* pData, unsigned long lSize)
+{
+
+    // Is there enough data for the 12 byte header?
+    if ((!pData) || (lSize < 12))
     {
-        // Is file still open?
-        if (pFile != NULL)
-        {
-            fclose(pFile);
-        }
         return FALSE;
     }
 
@@ -999,28 +1024,22 @@ BOOL GS_OGLImage::LoadTGA(const char* pszFilename)
     BYTE CompressedTGA[12]   = { 0,0,10,0,0,0,0,0,0,0,0,0 }; // Compressed TGA header.
 
     // See if header matches the predefined header of an uncompressed TGA image.
-    if (memcmp(UncompressedTGA, TGAHeader, sizeof(TGAHeader)) == 0)
+    if (memcmp(UncompressedTGA, pData, sizeof(UncompressedTGA)) == 0)
     {
         // If so, jump to uncompressed TGA loading code.
-        LoadUncompressedTGA(pFile);
+        return this->LoadUncompressedTGA(pData + 12, lSize - 12);
     }
     // See if header matches the predefined header of an RLE compressed TGA image.
-    else if(memcmp(CompressedTGA, TGAHeader, sizeof(TGAHeader)) == 0)
+    else if(memcmp(CompressedTGA, pData, sizeof(CompressedTGA)) == 0)
     {
         // If so, jump to compressed TGA loading code.
-        LoadCompressedTGA(pFile);
-    }
-    // If header matches neither type.
-    else
-    {
-        fclose(pFile);
-        return FALSE;
+        return this->LoadCompressedTGA(pData + 12, lSize - 12);
     }
 
-    return TRUE;
+    // Header matches neither type.
+    return FALSE;
 }
 
-
 ////////////////////////////////////////////////////////////////////////////////////////////////
 
 
@@ -34,8 +34,10 @@
 // Include Game System (GS) header files.
 // ---------------------------------------------------------------------------------------------
 #include "gs_error.h"
+#include "gs_file.h"
 #include "gs_object.h"
 #include "gs_ogl_color.h"
+#include "gs_pack.h"
 //==============================================================================================
 
 
@@ -104,6 +106,8 @@ private:
 
     BOOL m_bHasAlpha;    // Whether the image has an alpha component.
 
+    BYTE* m_pFileData;   // Contents of the image file being loaded (if not in the pack).
+
     // Determine wether certain coordinates fall within the image area.
     BOOL InImage(int x, int y) const
     {
@@ -116,8 +120,11 @@ private:
         return (((y * m_nImageWidth) + x) * m_nColorBytes);
     };
 
-    BOOL LoadUncompressedTGA(FILE *pFile);
-    BOOL LoadCompressedTGA(FILE *pFile);
+    const BYTE* ReadFileData(const char* pszFilename, unsigned long* plSize);
+    void FreeFileData();
+
+    BOOL LoadUncompressedTGA(const BYTE* pData, unsigned long lSize);
+    BOOL LoadCompressedTGA(const BYTE* pData, unsigned long lSize);
 
 protected:
 
@@ -136,6 +143,11 @@ public:
     BOOL LoadPCX(const char* pszFilename);
     BOOL LoadTGA(const char* pszFilename);
 
+    BOOL Load(const char* pszFilename, const BYTE* pData, unsigned long lSize);
+    BOOL LoadBMP(const BYTE* pData, unsigned long lSize);
+    BOOL LoadPCX(const BYTE* pData, unsigned long lSize);
+    BOOL LoadTGA(const BYTE* pData, unsigned long lSize);
+
     void        SetPixel(int x, int y, GS_OGLColor gsColor);
     GS_OGLColor GetPixel(int x, int y);
 
@@ -15,6 +15,7 @@
 // Include Game System (GS) header files.
 // ---------------------------------------------------------------------------------------------
 #include "gs_ogl_map.h"
+#include "gs_ogl_display.h"
 //==============================================================================================
 
 
@@ -34,13 +35,10 @@
 GS_OGLMap::GS_OGLMap()
 {
 
-    for (int nRows = 0; nRows < MAX_MAP_ROWS; nRows++)
-    {
-        for (int nCols = 0; nCols < MAX_MAP_COLS; nCols++)
-        {
-            m_nMap[nRows][nCols] = -1;
-        }
-    }
+    m_szTileset[0] = '\0';
+
+    m_pTiles        = NULL;
+    m_nNumChunkCols = 0;
     m_nNumCols = 0;
     m_nNumRows = 0;
 
@@ -82,6 +80,9 @@ GS_OGLMap::~GS_OGLMap()
 {
 
     this->Destroy();
+
+    // The map may have been loaded without ever being created.
+    this->AllocateTiles(0, 0);
 }
 
 
@@ -115,6 +116,16 @@ BOOL GS_OGLMap::Create(const char* pszPathname, int nTotalTiles, int nTilesPerLi
         return FALSE;
     }
 
+    // Remember the tile image so it can be referenced by binary maps.
+    if (strlen(pszPathname) < GS_MAP_MAX_NAME)
+    {
+        strcpy(m_szTileset, pszPathname);
+    }
+    else
+    {
+        m_szTileset[0] = '\0';
+    }
+
     // Assign tile width and height.
     m_nTileWidth  = nTileWidth;
     m_nTileHeight = nTileHeight;
@@ -147,6 +158,9 @@ BOOL GS_OGLMap::Create(GLuint glTexture, int nWidth, int nHeight, int nTotalTile
         return FALSE;
     }
 
+    // There is no tile image to reference when the texture is passed in.
+    m_szTileset[0] = '\0';
+
     // Assign tile width and height.
     m_nTileWidth  = nTileWidth;
     m_nTileHeight = nTileHeight;
@@ -178,15 +192,9 @@ void GS_OGLMap::Destroy()
 
     m_gsTileSprites.Destroy();
 
-    for (int nRows = 0; nRows < MAX_MAP_ROWS; nRows++)
-    {
-        for (int nCols = 0; nCols < MAX_MAP_COLS; nCols++)
-        {
-            m_nMap[nRows][nCols] = -1;
-        }
-    }
-    m_nNumCols = 0;
-    m_nNumRows = 0;
+    m_szTileset[0] = '\0';
+
+    this->AllocateTiles(0, 0);
 
     m_rcClipBox.left   = 0;
     m_rcClipBox.top    = 0;
@@ -247,38 +255,72 @@ BOOL GS_OGLMap::Render(int nMapCoordX, int nMapCoordY, HWND hWnd)
         (m_rcClipBox.right - m_rcClipBox.left) * g_fScaleFactorX + g_fRenderModX,
         (m_rcClipBox.top - m_rcClipBox.bottom) * g_fScaleFactorY + g_fRenderModY
     );
+    GS_OGLDisplay::CountStateChanges();
 
     // Enable the scissor box.
     glEnable(GL_SCISSOR_TEST);
+    GS_OGLDisplay::CountStateChanges();
 
     /////////////////////////////////////////////////////////////////////////////////////////////
     // Render the map. //////////////////////////////////////////////////////////////////////////
     /////////////////////////////////////////////////////////////////////////////////////////////
 
-    // For every element of the map.
-    for (int nRow = 0; nRow < m_nNumRows; nRow++)
+    // For every chunk of the map.
+    for (int nChunkRow = 0; nChunkRow < m_nNumRows; nChunkRow += MAP_CHUNK_SIZE)
     {
-        for (int nCol = 0; nCol < m_nNumCols; nCol++)
+        // Skip the chunks that are completely above or below the clip box.
+        int nChunkY = m_rcClipBox.bottom + nMapCoordY + (m_nTileHeight * nChunkRow);
+        if ((nChunkY >= m_rcClipBox.top) ||
+            (nChunkY + (m_nTileHeight * MAP_CHUNK_SIZE) <= m_rcClipBox.bottom))
+        {
+            continue;
+        }
+
+        int nEndRow = (nChunkRow + MAP_CHUNK_SIZE < m_nNumRows) ? nChunkRow + MAP_CHUNK_SIZE :
+                                                                  m_nNumRows;
+
+        for (int nChunkCol = 0; nChunkCol < m_nNumCols; nChunkCol += MAP_CHUNK_SIZE)
         {
-            // Is the map element visible?
-            if (m_nMap[nRow][nCol] != m_nClearTileID)
+            // Skip the chunks that are completely left or right of the clip box.
+            int nChunkX = m_rcClipBox.left + nMapCoordX + (m_nTileWidth * nChunkCol);
+            if ((nChunkX >= m_rcClipBox.right) ||
+                (nChunkX + (m_nTileWidth * MAP_CHUNK_SIZE) <= m_rcClipBox.left))
             {
-                // Set the tile image depending on the map.
-                m_gsTileSprites.SetFrame(m_nMap[nRow][nCol]);
-                // Determine the x and y coordinates at which to render the tile image.
-                int nDestX = m_rcClipBox.left   + nMapCoordX + (m_nTileWidth  * nCol);
-                int nDestY = m_rcClipBox.bottom + nMapCoordY + (m_nTileHeight * nRow);
-                // Does the tile overlap the clip box area?
-                if ((nDestX > m_rcClipBox.left   -  m_nTileWidth) &&
-                        (nDestX < m_rcClipBox.right) &&
-                        (nDestY > m_rcClipBox.bottom - m_nTileHeight) &&
-                        (nDestY < m_rcClipBox.top))
+                continue;
+            }
+
+            int nEndCol = (nChunkCol + MAP_CHUNK_SIZE < m_nNumCols) ? nChunkCol + MAP_CHUNK_SIZE :
+                                                                      m_nNumCols;
+
+            // For every element of the chunk.
+            for (int nRow = nChunkRow; nRow < nEndRow; nRow++)
+            {
+                const WORD* pTile = this->GetTile(nRow, nChunkCol);
+
+                for (int nCol = nChunkCol; nCol < nEndCol; nCol++, pTile++)
                 {
-                    // Set the tile coordinates.
-                    m_gsTileSprites.SetDestX(nDestX);
-                    m_gsTileSprites.SetDestY(nDestY);
-                    // Render the tile.
-                    m_gsTileSprites.Render(hWnd);
+                    int nTileID = (*pTile == GS_MAP_NO_TILE) ? -1 : *pTile;
+                    // Is the map element visible?
+                    if (nTileID != m_nClearTileID)
+                    {
+                        // Set the tile image depending on the map.
+                        m_gsTileSprites.SetFrame(nTileID);
+                        // Determine the x and y coordinates at which to render the tile image.
+                        int nDestX = m_rcClipBox.left   + nMapCoordX + (m_nTileWidth  * nCol);
+                        int nDestY = m_rcClipBox.bottom + nMapCoordY + (m_nTileHeight * nRow);
+                        // Does the tile overlap the clip box area?
+                        if ((nDestX > m_rcClipBox.left   -  m_nTileWidth) &&
+                                (nDestX < m_rcClipBox.right) &&
+                                (nDestY > m_rcClipBox.bottom - m_nTileHeight) &&
+                                (nDestY < m_rcClipBox.top))
+                        {
+                            // Set the tile coordinates.
+                            m_gsTileSprites.SetDestX(nDestX);
+                            m_gsTileSprites.SetDestY(nDestY);
+                            // Render the tile.
+                            m_gsTileSprites.Render(hWnd);
+                        }
+                    }
                 }
             }
         }
@@ -290,6 +332,7 @@ BOOL GS_OGLMap::Render(int nMapCoordX, int nMapCoordY, HWND hWnd)
 
     // Disable the scissor box.
     glDisable(GL_SCISSOR_TEST);
+    GS_OGLDisplay::CountStateChanges();
 
     return TRUE;
 }
@@ -576,12 +619,56 @@ int GS_OGLMap::GetClipBoxHeight()
 ////////////////////////////////////////////////////////////////////////////////////////////////
 
 
+//==============================================================================================
+// GS_OGLMap::AllocateTiles():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Frees the current tiles and allocates the tiles for a map of the specified size,
+//          rounded up to whole chunks, with all tiles set to -1. A size of 0 frees the tiles.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_OGLMap::AllocateTiles(int nNumRows, int nNumCols)
+{
+
+    if (m_pTiles)
+    {
+        delete [] m_pTiles;
+        m_pTiles = NULL;
+    }
+
+    m_nNumChunkCols = 0;
+    m_nNumCols      = 0;
+    m_nNumRows      = 0;
+
+    if ((nNumRows <= 0) || (nNumCols <= 0))
+    {
+        return;
+    }
+
+    int nNumChunkRows = (nNumRows + MAP_CHUNK_MASK) >> MAP_CHUNK_SHIFT;
+    m_nNumChunkCols   = (nNumCols + MAP_CHUNK_MASK) >> MAP_CHUNK_SHIFT;
+
+    size_t nNumTiles = (size_t) nNumChunkRows * m_nNumChunkCols * MAP_CHUNK_TILES;
+
+    // Every byte of GS_MAP_NO_TILE is 0xFF, so the tiles can be cleared with memset().
+    m_pTiles = new WORD [nNumTiles];
+    memset(m_pTiles, 0xFF, nNumTiles * sizeof(WORD));
+
+    m_nNumCols = nNumCols;
+    m_nNumRows = nNumRows;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
 //==============================================================================================
 // GS_OGLMap::LoadMap():
 // ---------------------------------------------------------------------------------------------
 // Purpose: ...
 // ---------------------------------------------------------------------------------------------
-// Details: Maps can have a total of 61 different elements. Characters '0' - '9' represents the
+// Details: Text maps can have a total of 61 different elements. Characters '0' - '9' represents the
 //          elements 0 - 9, 'A' - 'Z' represents the elements 10 - 35 and 'a' - 'z' represents
 //          the elements 36 - 61.
 // ---------------------------------------------------------------------------------------------
@@ -605,15 +692,8 @@ BOOL GS_OGLMap::LoadMap(const char* pszPathname, int nNumRows, int nNumCols)
         return FALSE;
     }
 
-    // Make sure map is not too large.
-    if (nNumRows > MAX_MAP_ROWS)
-    {
-        nNumRows =  MAX_MAP_ROWS;
-    }
-    if (nNumCols > MAX_MAP_COLS)
-    {
-        nNumCols =  MAX_MAP_COLS;
-    }
+    // Allocate the tiles for a map of the specified size.
+    this->AllocateTiles(nNumRows, nNumCols);
 
     // Read all the values from the file into the map array.
     for (int nRows = nNumRows - 1; nRows >= 0; nRows--)
@@ -632,30 +712,26 @@ BOOL GS_OGLMap::LoadMap(const char* pszPathname, int nNumRows, int nNumCols)
             if ((nTemp >= 48) && (nTemp <= 57))
             {
                 // 0 - 9 is 0 - 9.
-                m_nMap[nRows][nCols] = nTemp - 48;
+                *this->GetTile(nRows, nCols) = (WORD) (nTemp - 48);
             }
             else if ((nTemp >= 65) && (nTemp <= 90))
             {
                 // A - Z is 10 to 35.
-                m_nMap[nRows][nCols] = nTemp - 55;
+                *this->GetTile(nRows, nCols) = (WORD) (nTemp - 55);
             }
             else if ((nTemp >= 97) && (nTemp <= 122))
             {
                 // a - z is 36 to 61.
-                m_nMap[nRows][nCols] = nTemp - 61;
+                *this->GetTile(nRows, nCols) = (WORD) (nTemp - 61);
             }
             else
             {
                 // Unrecognised value.
-                m_nMap[nRows][nCols] = -1;
+                *this->GetTile(nRows, nCols) = GS_MAP_NO_TILE;
             }
         }
     }
 
-    // Save map dimensions.
-    m_nNumCols = nNumCols;
-    m_nNumRows = nNumRows;
-
     // Close the map file.
     gsMapFile.Close();
 
@@ -696,20 +772,21 @@ BOOL GS_OGLMap::SaveMap(const char* pszPathname)
     {
         for (int nCols = 0; nCols < m_nNumCols; nCols++)
         {
+            WORD wTileID = *this->GetTile(nRows, nCols);
             // Write numbers 0 - 9 as characters '0' - '9'.
-            if ((m_nMap[nRows][nCols] >= 0) && (m_nMap[nRows][nCols] <= 9))
+            if (wTileID <= 9)
             {
-                gsMapFile.PutByte((unsigned short)(m_nMap[nRows][nCols] + 48));
+                gsMapFile.PutByte((unsigned short)(wTileID + 48));
             }
             // Write numbers 10 - 35 as characters 'A' - 'Z'.
-            else if ((m_nMap[nRows][nCols] >= 10) && (m_nMap[nRows][nCols] <= 35))
+            else if ((wTileID >= 10) && (wTileID <= 35))
             {
-                gsMapFile.PutByte((unsigned short)(m_nMap[nRows][nCols] + 55));
+                gsMapFile.PutByte((unsigned short)(wTileID + 55));
             }
             // Write numbers 36 - 61 as characters 'a' - 'z'.
-            else if ((m_nMap[nRows][nCols] >= 36) && (m_nMap[nRows][nCols] <= 61))
+            else if ((wTileID >= 36) && (wTileID <= 61))
             {
-                gsMapFile.PutByte((unsigned short)(m_nMap[nRows][nCols] + 61));
+                gsMapFile.PutByte((unsigned short)(wTileID + 61));
             }
             else
             {
@@ -735,6 +812,356 @@ BOOL GS_OGLMap::SaveMap(const char* pszPathname)
 ////////////////////////////////////////////////////////////////////////////////////////////////
 
 
+//==============================================================================================
+// GS_OGLMap::LoadBinaryMap():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Loads a map saved by SaveBinaryMap(). The file is mapped into memory and the tiles
+//          are decoded straight from the mapping into the map. If the map has not been
+//          created yet, the tile sprites are created from the tileset named in the file.
+// ---------------------------------------------------------------------------------------------
+// Details: The map has a single layer, so only the first layer of the file is loaded.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if failed.
+//==============================================================================================
+
+BOOL GS_OGLMap::LoadBinaryMap(const char* pszPathname, BOOL bFiltered, BOOL bMipmap)
+{
+
+    // Do we have a valid filename?
+    if (NULL == pszPathname)
+    {
+        return FALSE;
+    }
+
+    GS_File gsMapFile;
+
+    // Were we able to map the file into memory?
+    if (FALSE == gsMapFile.Open(pszPathname, FILE_MAP))
+    {
+        return FALSE;
+    }
+
+    const BYTE*   pData = gsMapFile.GetData();
+    unsigned long lSize = gsMapFile.GetLength();
+
+    const GS_MapHeader* pHeader = (const GS_MapHeader*) pData;
+
+    // Is this a binary map of the version we know with at least one layer, and not so large
+    // that a crafted header makes us allocate gigabytes for it?
+    if ((lSize < sizeof(GS_MapHeader) + sizeof(unsigned int)) ||
+        (memcmp(pHeader->szMagic, GS_MAP_MAGIC, 4) != 0) ||
+        (pHeader->uVersion != GS_MAP_VERSION) || (pHeader->uNumLayers == 0) ||
+        (pHeader->uNumRows == 0) || (pHeader->uNumRows > GS_MAP_MAX_SIZE) ||
+        (pHeader->uNumCols == 0) || (pHeader->uNumCols > GS_MAP_MAX_SIZE) ||
+        (pHeader->uNumLayers > GS_MAP_MAX_TILES / (pHeader->uNumRows * pHeader->uNumCols)) ||
+        (memchr(pHeader->szTileset, 0, GS_MAP_MAX_NAME) == NULL))
+    {
+        GS_Error::Report("GS_OGL_MAP.CPP", 858, "Invalid or unsupported map file!");
+        gsMapFile.Close();
+        return FALSE;
+    }
+
+    unsigned int uLayerSize = 0;
+
+    // Get the size of the first layer (which follows the header).
+    memcpy(&uLayerSize, pData + sizeof(GS_MapHeader), sizeof(unsigned int));
+
+    // Does the layer lie within the file and does it hold all the tiles?
+    if ((uLayerSize > lSize - sizeof(GS_MapHeader) - sizeof(unsigned int)) ||
+        (!this->DecodeLayer(pData + sizeof(GS_MapHeader) + sizeof(unsigned int), uLayerSize,
+                            (pHeader->uFlags & GS_MAP_COMPRESSED) != 0,
+                            (int) pHeader->uNumRows, (int) pHeader->uNumCols)))
+    {
+        GS_Error::Report("GS_OGL_MAP.CPP", 874, "Corrupt map layer!");
+        gsMapFile.Close();
+        return FALSE;
+    }
+
+    // Create the tile sprites from the tileset if the map has not been created yet.
+    if ((!m_bIsReady) && (pHeader->szTileset[0] != '\0'))
+    {
+        if (!this->Create(pHeader->szTileset, (int) pHeader->uTotalTiles,
+                          (int) pHeader->uTilesPerLine, (int) pHeader->uTileWidth,
+                          (int) pHeader->uTileHeight, bFiltered, bMipmap))
+        {
+            gsMapFile.Close();
+            return FALSE;
+        }
+    }
+
+    // Close the map file.
+    gsMapFile.Close();
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_OGLMap::SaveBinaryMap():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Saves the map in the binary map format (see GS_MapHeader) with 16-bit tile IDs,
+//          run length encoding the tiles if requested. The tile size and the tileset are
+//          saved along with the tiles so the map can be loaded without any other information.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if failed.
+//==============================================================================================
+
+BOOL GS_OGLMap::SaveBinaryMap(const char* pszPathname, BOOL bCompress)
+{
+
+    // Do we have a valid filename and a map to save (that LoadBinaryMap() would load)?
+    if ((NULL == pszPathname) || (m_nNumRows <= 0) || (m_nNumCols <= 0) ||
+        (m_nNumRows > GS_MAP_MAX_SIZE) || (m_nNumCols > GS_MAP_MAX_SIZE))
+    {
+        return FALSE;
+    }
+
+    unsigned long lNumTiles = (unsigned long) m_nNumRows * m_nNumCols;
+
+    // Allocate the tiles and the worst case size of the encoded tiles.
+    WORD* pTiles = new WORD [lNumTiles];
+    BYTE* pData  = new BYTE [lNumTiles * 2 * sizeof(WORD)];
+
+    WORD* pTile = pTiles;
+
+    // Gather the tiles row by row, bottom row first.
+    for (int nRows = 0; nRows < m_nNumRows; nRows++)
+    {
+        for (int nCols = 0; nCols < m_nNumCols; nCols += MAP_CHUNK_SIZE)
+        {
+            // Copy the part of the row that lies within this chunk.
+            int nCount = (nCols + MAP_CHUNK_SIZE < m_nNumCols) ? MAP_CHUNK_SIZE :
+                                                                 m_nNumCols - nCols;
+            memcpy(pTile, this->GetTile(nRows, nCols), nCount * sizeof(WORD));
+            pTile += nCount;
+        }
+    }
+
+    GS_MapHeader MapHeader;
+
+    memset(&MapHeader, 0, sizeof(GS_MapHeader));
+    memcpy(MapHeader.szMagic, GS_MAP_MAGIC, 4);
+    MapHeader.uVersion      = GS_MAP_VERSION;
+    MapHeader.uFlags        = bCompress ? GS_MAP_COMPRESSED : 0;
+    MapHeader.uNumRows      = m_nNumRows;
+    MapHeader.uNumCols      = m_nNumCols;
+    MapHeader.uNumLayers    = 1;
+    MapHeader.uTileWidth    = m_nTileWidth;
+    MapHeader.uTileHeight   = m_nTileHeight;
+    MapHeader.uTotalTiles   = m_bIsReady ? this->GetTotalTiles() : 0;
+    MapHeader.uTilesPerLine = m_bIsReady ? this->GetTilesPerLine() : 0;
+    strcpy(MapHeader.szTileset, m_szTileset);
+
+    unsigned int uLayerSize = lNumTiles * sizeof(WORD);
+
+    // Encode the tiles or store them as they are.
+    if (bCompress)
+    {
+        uLayerSize = GS_OGLMap::EncodeLayer(pTiles, lNumTiles, pData);
+    }
+    else
+    {
+        memcpy(pData, pTiles, uLayerSize);
+    }
+
+    GS_File gsMapFile;
+    BOOL bResult = FALSE;
+
+    // Write the header, the layer size and the layer.
+    if (gsMapFile.Open(pszPathname, FILE_WRITE))
+    {
+        bResult = (gsMapFile.Write(&MapHeader, sizeof(GS_MapHeader)) == sizeof(GS_MapHeader)) &&
+                  (gsMapFile.Write(&uLayerSize, sizeof(unsigned int)) == sizeof(unsigned int)) &&
+                  (gsMapFile.Write(pData, uLayerSize) == uLayerSize);
+        gsMapFile.Close();
+    }
+
+    delete [] pTiles;
+    delete [] pData;
+
+    return bResult;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_OGLMap::DecodeLayer():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Stores the tiles of a binary map layer in the map, decoding the packets of a
+//          compressed layer as it goes. The map is left empty if the layer is invalid.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if the layer is too short or has invalid packets.
+//==============================================================================================
+
+BOOL GS_OGLMap::DecodeLayer(const BYTE* pData, unsigned long lSize, BOOL bCompressed,
+                            int nNumRows, int nNumCols)
+{
+
+    const WORD*   pWords    = (const WORD*) pData;
+    unsigned long lNumWords = lSize / sizeof(WORD);
+    unsigned long lNumTiles = (unsigned long) nNumRows * nNumCols;
+
+    unsigned long lWord = 0;
+    unsigned long lTile = 0;
+
+    int nRow = 0;
+    int nCol = 0;
+
+    // Is the layer too small to hold the tiles (even with the longest runs)?
+    if ((bCompressed ? ((lNumTiles + GS_MAP_RUN - 1) / GS_MAP_RUN) * 2 : lNumTiles) > lNumWords)
+    {
+        this->AllocateTiles(0, 0);
+        return FALSE;
+    }
+
+    // Allocate the tiles for a map of the size of the layer.
+    this->AllocateTiles(nNumRows, nNumCols);
+
+    while (lTile < lNumTiles)
+    {
+        // An uncompressed layer is read as one long packet of literal tiles.
+        unsigned long lCount = lNumTiles;
+        BOOL bRun = FALSE;
+
+        if (bCompressed)
+        {
+            if (lWord >= lNumWords)
+            {
+                this->AllocateTiles(0, 0);
+                return FALSE;
+            }
+            bRun   = (pWords[lWord] & GS_MAP_RUN) != 0;
+            lCount = (pWords[lWord] & ~GS_MAP_RUN) + 1;
+            lWord++;
+        }
+
+        // Make sure the packet neither runs past the layer nor past the map.
+        if ((lCount > lNumTiles - lTile) || ((bRun ? 1 : lCount) > lNumWords - lWord))
+        {
+            this->AllocateTiles(0, 0);
+            return FALSE;
+        }
+
+        for (unsigned long lIndex = 0; lIndex < lCount; lIndex++)
+        {
+            WORD wTileID = bRun ? pWords[lWord] : pWords[lWord + lIndex];
+
+            *this->GetTile(nRow, nCol) = wTileID;
+
+            // Move on to the next row at the end of this one.
+            if (++nCol == nNumCols)
+            {
+                nCol = 0;
+                nRow++;
+            }
+        }
+
+        lWord += bRun ? 1 : lCount;
+        lTile += lCount;
+    }
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_OGLMap::EncodeLayer():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Run length encodes the tiles of a layer. Repeats of three or more tiles are stored
+//          as runs, everything else as literal tiles. The data buffer must be able to hold
+//          twice the size of the tiles (the worst case).
+// ---------------------------------------------------------------------------------------------
+// Returns: The size of the encoded layer in bytes.
+//==============================================================================================
+
+unsigned long GS_OGLMap::EncodeLayer(WORD* pTiles, unsigned long lNumTiles, BYTE* pData)
+{
+
+    WORD* pWords = (WORD*) pData;
+
+    unsigned long lWord  = 0;
+    unsigned long lTile  = 0;
+    unsigned long lStart = 0; // First tile that has not been written.
+
+    while (lStart < lNumTiles)
+    {
+        unsigned long lRun = 0;
+
+        // Count how many times the current tile repeats.
+        if (lTile < lNumTiles)
+        {
+            lRun = 1;
+            while ((lTile + lRun < lNumTiles) && (pTiles[lTile + lRun] == pTiles[lTile]) &&
+                   (lRun < GS_MAP_RUN))
+            {
+                lRun++;
+            }
+
+            // Short repeats are collected as literal tiles.
+            if (lRun < 3)
+            {
+                lTile += lRun;
+                continue;
+            }
+        }
+
+        // Write the literal tiles collected so far.
+        while (lStart < lTile)
+        {
+            unsigned long lCount = lTile - lStart;
+            if (lCount > GS_MAP_RUN)
+            {
+                lCount = GS_MAP_RUN;
+            }
+            pWords[lWord++] = (WORD) (lCount - 1);
+            memcpy(&pWords[lWord], &pTiles[lStart], lCount * sizeof(WORD));
+            lWord  += lCount;
+            lStart += lCount;
+        }
+
+        // Write the run.
+        if (lRun > 0)
+        {
+            pWords[lWord++] = (WORD) (GS_MAP_RUN | (lRun - 1));
+            pWords[lWord++] = pTiles[lTile];
+            lTile += lRun;
+            lStart = lTile;
+        }
+    }
+
+    return lWord * sizeof(WORD);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_OGLMap::GetTileset():
+// ---------------------------------------------------------------------------------------------
+// Purpose: ...
+// ---------------------------------------------------------------------------------------------
+// Returns: The filename of the tile image or an empty string if not known.
+//==============================================================================================
+
+const char* GS_OGLMap::GetTileset()
+{
+
+    return m_szTileset;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
 //==============================================================================================
 // GS_OGLMap::SetMapX():
 // ---------------------------------------------------------------------------------------------
@@ -1044,7 +1471,9 @@ void GS_OGLMap::SetTileID(int nRow, int nCol, int nNewTileID)
 
     if ((nRow >= 0) && (nRow < m_nNumRows) && (nCol >= 0) && (nCol < m_nNumCols))
     {
-        m_nMap[nRow][nCol] = nNewTileID;
+        // Tile IDs that can't be stored in 16 bits are stored as -1.
+        *this->GetTile(nRow, nCol) = ((nNewTileID < 0) || (nNewTileID >= GS_MAP_NO_TILE)) ?
+                                     GS_MAP_NO_TILE : (WORD) nNewTileID;
     }
 }
 
@@ -1062,7 +1491,8 @@ int GS_OGLMap::GetTileID(int nRow, int nCol)
 
     if ((nRow >= 0) && (nRow < m_nNumRows) && (nCol >= 0) && (nCol < m_nNumCols))
     {
-        return m_nMap[nRow][nCol];
+        WORD wTileID = *this->GetTile(nRow, nCol);
+        return (wTileID == GS_MAP_NO_TILE) ? -1 : wTileID;
     }
 
     return -1;
@@ -1084,9 +1514,9 @@ void GS_OGLMap::ReplaceTileID(int nOldTileID, int nNewTileID)
     {
         for (int nCols = 0; nCols < m_nNumCols; nCols++)
         {
-            if (m_nMap[nRows][nCols] == nOldTileID)
+            if (this->GetTileID(nRows, nCols) == nOldTileID)
             {
-                m_nMap[nRows][nCols] = nNewTileID;
+                this->SetTileID(nRows, nCols, nNewTileID);
             }
         }
     }
@@ -1237,7 +1667,7 @@ int GS_OGLMap::MapToID(int nCoordX, int nCoordY)
     }
 
     // Return the tile ID at the specified coordinates.
-    return(m_nMap[nRow][nCol]);
+    return this->GetTileID(nRow, nCol);
 }
 
 
@@ -56,8 +56,43 @@
 //==============================================================================================
 // Defines.
 // ---------------------------------------------------------------------------------------------
-#define MAX_MAP_COLS 128
-#define MAX_MAP_ROWS 128
+#define MAP_CHUNK_SHIFT 4                                 // Log2 of the chunk width/height.
+#define MAP_CHUNK_SIZE  (1 << MAP_CHUNK_SHIFT)            // Chunk width/height in tiles.
+#define MAP_CHUNK_MASK  (MAP_CHUNK_SIZE - 1)              // Row/column within a chunk.
+#define MAP_CHUNK_TILES (MAP_CHUNK_SIZE * MAP_CHUNK_SIZE) // Number of tiles in a chunk.
+// ---------------------------------------------------------------------------------------------
+#define GS_MAP_MAGIC      "GSMP" // Identifies a binary map file.
+#define GS_MAP_VERSION    1      // Version of the binary map format.
+#define GS_MAP_MAX_NAME   64     // Maximum length of the tileset name (including terminator).
+#define GS_MAP_MAX_SIZE   4096   // Maximum width/height of a binary map in tiles.
+#define GS_MAP_MAX_TILES  (GS_MAP_MAX_SIZE * GS_MAP_MAX_SIZE) // Maximum rows x columns x layers.
+#define GS_MAP_COMPRESSED 0x0001 // Flag set when the layers are run length encoded.
+#define GS_MAP_NO_TILE    0xFFFF // Tile ID stored for empty cells (-1 in the map).
+#define GS_MAP_RUN        0x8000 // Set in a packet header for a run, clear for literal tiles.
+//==============================================================================================
+
+
+//==============================================================================================
+// Binary map structures (all values are stored little endian). The header is followed by the
+// layers, each stored as its size in bytes (unsigned int) followed by the tile IDs (WORD) of
+// the layer row by row, starting with the bottom row. A compressed layer is made up of packets
+// starting with a WORD: if GS_MAP_RUN is set, the next WORD is repeated (header & 0x7FFF) + 1
+// times, otherwise (header + 1) literal WORDs follow.
+// ---------------------------------------------------------------------------------------------
+typedef struct GS_MAP_HEADER
+{
+    char         szMagic[4];    // GS_MAP_MAGIC (not zero terminated).
+    unsigned int uVersion;      // GS_MAP_VERSION.
+    unsigned int uFlags;        // GS_MAP_COMPRESSED or 0.
+    unsigned int uNumRows;      // Map height in tiles.
+    unsigned int uNumCols;      // Map width in tiles.
+    unsigned int uNumLayers;    // Number of layers stored in the file.
+    unsigned int uTileWidth;    // Tile width in pixels.
+    unsigned int uTileHeight;   // Tile height in pixels.
+    unsigned int uTotalTiles;   // Number of tiles in the tileset.
+    unsigned int uTilesPerLine; // Number of tiles per line of the tileset image.
+    char         szTileset[GS_MAP_MAX_NAME]; // Tileset image filename (empty if none).
+} GS_MapHeader;
 //==============================================================================================
 
 
@@ -93,7 +128,11 @@ private:
 
     GS_OGLSpriteEx m_gsTileSprites; // Sprite object to hold tile images.
 
-    int m_nMap[MAX_MAP_ROWS][MAX_MAP_COLS]; // Map array to hold tile IDs.
+    char m_szTileset[GS_MAP_MAX_NAME]; // Filename of the tile image (empty if unknown).
+
+    WORD* m_pTiles;      // Tile IDs (GS_MAP_NO_TILE for -1) stored chunk by chunk, every chunk
+                         // holding MAP_CHUNK_SIZE x MAP_CHUNK_SIZE tiles row by row.
+    int m_nNumChunkCols; // Number of chunks across the map.
     int m_nNumCols;
     int m_nNumRows;
 
@@ -114,6 +153,20 @@ private:
 
     BOOL m_bIsReady; // Wether we are ready to render or not.
 
+    void AllocateTiles(int nNumRows, int nNumCols);
+
+    WORD* GetTile(int nRow, int nCol)
+    {
+        // Find the chunk first and then the tile within the chunk.
+        return m_pTiles + ((((size_t) (nRow >> MAP_CHUNK_SHIFT) * m_nNumChunkCols +
+                             (nCol >> MAP_CHUNK_SHIFT)) * MAP_CHUNK_TILES) +
+                           ((nRow & MAP_CHUNK_MASK) << MAP_CHUNK_SHIFT) + (nCol & MAP_CHUNK_MASK));
+    }
+
+    BOOL DecodeLayer(const BYTE* pData, unsigned long lSize, BOOL bCompressed,
+                     int nNumRows, int nNumCols);
+    static unsigned long EncodeLayer(WORD* pTiles, unsigned long lNumTiles, BYTE* pData);
+
 protected:
 
     // ...
@@ -156,6 +209,11 @@ public:
     BOOL LoadMap(const char* pszPathname, int nNumRows, int nNumCols);
     BOOL SaveMap(const char* pszPathname = NULL);
 
+    BOOL LoadBinaryMap(const char* pszPathname, BOOL bFiltered = FALSE, BOOL bMipmap = TRUE);
+    BOOL SaveBinaryMap(const char* pszPathname, BOOL bCompress = TRUE);
+
+    const char* GetTileset();
+
     void SetMapX(int nDestX);
     void SetMapY(int nDestY);
     int  GetMapX();
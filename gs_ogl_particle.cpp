@@ -15,6 +15,7 @@
 // Include Game System (GS) header files.
 // ---------------------------------------------------------------------------------------------
 #include "gs_ogl_particle.h"
+#include "gs_ogl_display.h"
 //==============================================================================================
 
 
@@ -325,6 +326,7 @@ BOOL GS_OGLParticle::BeginRender(HWND hWnd)
     if (glIsEnabled(GL_DEPTH_TEST) == GL_TRUE)
     {
         glDisable(GL_DEPTH_TEST);
+        GS_OGLDisplay::CountStateChanges();
         m_bDepthTestEnabled = TRUE;
     }
     else
@@ -336,6 +338,7 @@ BOOL GS_OGLParticle::BeginRender(HWND hWnd)
     if (glIsEnabled(GL_LIGHTING) == GL_TRUE)
     {
         glDisable(GL_LIGHTING);
+        GS_OGLDisplay::CountStateChanges();
         m_bLightingEnabled = TRUE;
     }
     else
@@ -344,8 +347,11 @@ BOOL GS_OGLParticle::BeginRender(HWND hWnd)
     }
 
     glMatrixMode(GL_PROJECTION); // Select the projection matrix.
+    GS_OGLDisplay::CountMatrixOps();
     glPushMatrix();              // Store the projection matrix.
+    GS_OGLDisplay::CountMatrixOps();
     glLoadIdentity();            // Reset the projection matrix.
+    GS_OGLDisplay::CountMatrixOps();
 
     // Set up an ortho screen with the same dimensions as the client area of the current
     // window and with a depth large enough to rotate the entire screen around either
@@ -354,15 +360,19 @@ BOOL GS_OGLParticle::BeginRender(HWND hWnd)
     {
         glOrtho(0,ClientRect.right,0,ClientRect.bottom,-((ClientRect.right-ClientRect.left)/2),
                 ((ClientRect.right-ClientRect.left)/2));
+        GS_OGLDisplay::CountMatrixOps();
     }
     else
     {
         glOrtho(0,ClientRect.right,0,ClientRect.bottom,-((ClientRect.top-ClientRect.bottom)/2),
                 ((ClientRect.top-ClientRect.bottom)/2));
+        GS_OGLDisplay::CountMatrixOps();
     }
 
     glMatrixMode(GL_MODELVIEW); // Select the modelview matrix.
+    GS_OGLDisplay::CountMatrixOps();
     glPushMatrix();             // Store the modelview matrix.
+    GS_OGLDisplay::CountMatrixOps();
 
     return TRUE;
 }
@@ -383,20 +393,26 @@ void GS_OGLParticle::EndRender()
 {
 
     glMatrixMode(GL_PROJECTION); // Select the projection matrix.
+    GS_OGLDisplay::CountMatrixOps();
     glPopMatrix();               // Restore the old projection matrix.
+    GS_OGLDisplay::CountMatrixOps();
     glMatrixMode(GL_MODELVIEW);  // Select the modelview matrix.
+    GS_OGLDisplay::CountMatrixOps();
     glPopMatrix();               // Restore the old modelview matrix.
+    GS_OGLDisplay::CountMatrixOps();
 
     // Was depth testing enabled?
     if (m_bDepthTestEnabled == TRUE)
     {
         glEnable(GL_DEPTH_TEST);
+        GS_OGLDisplay::CountStateChanges();
     }
 
     // Was lighting enabled?
     if (m_bLightingEnabled == TRUE)
     {
         glEnable(GL_LIGHTING);
+        GS_OGLDisplay::CountStateChanges();
     }
 }
 
@@ -439,11 +455,14 @@ BOOL GS_OGLParticle::Render(HWND hWnd)
         glGetIntegerv(GL_BLEND_DST, &gliDstFactor);
         // Disable blending.
         glDisable(GL_BLEND);
+        GS_OGLDisplay::CountStateChanges();
     }
 
     // Setup blending for particles.
     glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+    GS_OGLDisplay::CountStateChanges();
     glEnable(GL_BLEND);
+    GS_OGLDisplay::CountStateChanges();
 
     // For each particle.
     for (int nLoop = 0; nLoop < m_nNumParticles; nLoop++)
@@ -454,9 +473,11 @@ BOOL GS_OGLParticle::Render(HWND hWnd)
         {
             // Reset the modelview matrix.
             glLoadIdentity();
+            GS_OGLDisplay::CountMatrixOps();
 
             // Select the particle texture.
             glBindTexture(GL_TEXTURE_2D, m_gluTexture);
+            GS_OGLDisplay::CountTextureBinds();
 
             // Draw particle in a different hue or transparency depending on the alpha factor.
             glColor4f(m_gsParticles[nLoop].glfR, m_gsParticles[nLoop].glfG,
@@ -476,11 +497,15 @@ BOOL GS_OGLParticle::Render(HWND hWnd)
                 (m_gsParticles[nLoop].gliDestY * g_fScaleFactorX) + fHalfHeight + g_fRenderModY,
                 0
             );
+            GS_OGLDisplay::CountMatrixOps();
 
             // Rotate the particle on the X, Y and Z-axis.
             glRotatef(m_gsParticles[nLoop].glfRotateX, 1.0f, 0.0f, 0.0f);
+            GS_OGLDisplay::CountMatrixOps();
             glRotatef(m_gsParticles[nLoop].glfRotateY, 0.0f, 1.0f, 0.0f);
+            GS_OGLDisplay::CountMatrixOps();
             glRotatef(m_gsParticles[nLoop].glfRotateZ, 0.0f, 0.0f, 1.0f);
+            GS_OGLDisplay::CountMatrixOps();
 
             // Start drawing a quad. In order for the particle to be rotated correctly, the
             // particle has to/ be drawn from a center point outwards. If the center of the
@@ -503,9 +528,11 @@ BOOL GS_OGLParticle::Render(HWND hWnd)
             glTexCoord2f(0.0f, 1.0f);
             glVertex2f(-fHalfWidth,  fHalfHeight);
             glEnd();
+            GS_OGLDisplay::CountDrawCall(4);
 
             // Unselect the particle texture.
             glBindTexture(GL_TEXTURE_2D, 0);  // Use 0 instead of NULL
+            GS_OGLDisplay::CountTextureBinds();
         }
     }
 
@@ -515,13 +542,16 @@ BOOL GS_OGLParticle::Render(HWND hWnd)
 
     // Disable particle blending.
     glDisable(GL_BLEND);
+    GS_OGLDisplay::CountStateChanges();
 
     // Was blending enabled originally?
     if (glbIsBlendingEnabled)
     {
         // Restore and enable original blending;
         glBlendFunc(gliSrcFactor, gliDstFactor);
+        GS_OGLDisplay::CountStateChanges();
         glEnable(GL_BLEND);
+        GS_OGLDisplay::CountStateChanges();
     }
 
     // Reset display after 2D rendering.
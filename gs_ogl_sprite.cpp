@@ -15,6 +15,7 @@
 // Include Game System (GS) header files.
 // ---------------------------------------------------------------------------------------------
 #include "gs_ogl_sprite.h"
+#include "gs_ogl_display.h"
 //==============================================================================================
 
 
@@ -328,6 +329,7 @@ BOOL GS_OGLSprite::BeginRender(HWND hWnd)
     if (glIsEnabled(GL_DEPTH_TEST) == GL_TRUE)
     {
         glDisable(GL_DEPTH_TEST);
+        GS_OGLDisplay::CountStateChanges();
         m_bDepthTestEnabled = TRUE;
     }
     else
@@ -339,6 +341,7 @@ BOOL GS_OGLSprite::BeginRender(HWND hWnd)
     if (glIsEnabled(GL_LIGHTING) == GL_TRUE)
     {
         glDisable(GL_LIGHTING);
+        GS_OGLDisplay::CountStateChanges();
         m_bLightingEnabled = TRUE;
     }
     else
@@ -347,8 +350,11 @@ BOOL GS_OGLSprite::BeginRender(HWND hWnd)
     }
 
     glMatrixMode(GL_PROJECTION); // Select the projection matrix.
+    GS_OGLDisplay::CountMatrixOps();
     glPushMatrix();              // Store the projection matrix.
+    GS_OGLDisplay::CountMatrixOps();
     glLoadIdentity();            // Reset the projection matrix.
+    GS_OGLDisplay::CountMatrixOps();
 
     // Set up an ortho screen with the same dimensions as the client area of the current
     // window and with a depth large enough to rotate the entire screen around either
@@ -357,15 +363,19 @@ BOOL GS_OGLSprite::BeginRender(HWND hWnd)
     {
         glOrtho(0,ClientRect.right,0,ClientRect.bottom,-((ClientRect.right-ClientRect.left)/2),
                 ((ClientRect.right-ClientRect.left)/2));
+        GS_OGLDisplay::CountMatrixOps();
     }
     else
     {
         glOrtho(0,ClientRect.right,0,ClientRect.bottom,-((ClientRect.top-ClientRect.bottom)/2),
                 ((ClientRect.top-ClientRect.bottom)/2));
+        GS_OGLDisplay::CountMatrixOps();
     }
 
     glMatrixMode(GL_MODELVIEW); // Select the modelview matrix.
+    GS_OGLDisplay::CountMatrixOps();
     glPushMatrix();             // Store the modelview matrix.
+    GS_OGLDisplay::CountMatrixOps();
 
     return TRUE;
 }
@@ -386,20 +396,26 @@ void GS_OGLSprite::EndRender()
 {
 
     glMatrixMode(GL_PROJECTION); // Select the projection matrix.
+    GS_OGLDisplay::CountMatrixOps();
     glPopMatrix();               // Restore the old projection matrix.
+    GS_OGLDisplay::CountMatrixOps();
     glMatrixMode(GL_MODELVIEW);  // Select the modelview matrix.
+    GS_OGLDisplay::CountMatrixOps();
     glPopMatrix();               // Restore the old modelview matrix.
+    GS_OGLDisplay::CountMatrixOps();
 
     // Was depth testing enabled?
     if (m_bDepthTestEnabled == TRUE)
     {
         glEnable(GL_DEPTH_TEST);
+        GS_OGLDisplay::CountStateChanges();
     }
 
     // Was lighting enabled?
     if (m_bLightingEnabled == TRUE)
     {
         glEnable(GL_LIGHTING);
+        GS_OGLDisplay::CountStateChanges();
     }
 }
 
@@ -438,6 +454,7 @@ BOOL GS_OGLSprite::Render(HWND hWnd)
 
     // Reset the modelview matrix.
     glLoadIdentity();
+    GS_OGLDisplay::CountMatrixOps();
 
     // Draw sprite in a different hue or even with transparency depending on the alpha factor.
     glColor4f
@@ -450,6 +467,7 @@ BOOL GS_OGLSprite::Render(HWND hWnd)
 
     // Select the sprite texture.
     glBindTexture(GL_TEXTURE_2D, m_gluTexture);
+    GS_OGLDisplay::CountTextureBinds();
 
     // Set default rotation point in the center of the source rectangle
     int nRotationPointX = (float((m_SourceRect.right-m_SourceRect.left))/2);
@@ -475,11 +493,15 @@ BOOL GS_OGLSprite::Render(HWND hWnd)
 
     // Position the sprite (note that the sprite will be drawn around the rotation point).
     glTranslated(glfDestX + g_fRenderModX + fVertexWidth1, glfDestY + g_fRenderModY + fVertexHeight1, 0);
+    GS_OGLDisplay::CountMatrixOps();
 
     // Rotate the sprite on the X, Y and Z-axis.
     glRotatef(m_glfRotateX, 1.0f, 0.0f, 0.0f);
+    GS_OGLDisplay::CountMatrixOps();
     glRotatef(m_glfRotateY, 0.0f, 1.0f, 0.0f);
+    GS_OGLDisplay::CountMatrixOps();
     glRotatef(m_glfRotateZ, 0.0f, 0.0f, 1.0f);
+    GS_OGLDisplay::CountMatrixOps();
 
     // Determine the sprite dimensions as a factor of one, taking into account the coordinates
     // of the source rectangle as well as how far the sprite is scrolled on the x- or y-axis.
@@ -509,9 +531,11 @@ BOOL GS_OGLSprite::Render(HWND hWnd)
     glVertex2f(-fVertexWidth1,  fVertexHeight2);
 
     glEnd();
+    GS_OGLDisplay::CountDrawCall(4);
 
     // Unselect the sprite texture.
     glBindTexture(GL_TEXTURE_2D, 0);  // Use 0 instead of NULL
+    GS_OGLDisplay::CountTextureBinds();
 
     // Reset the color for other textures to white.
     glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
@@ -578,9 +602,11 @@ BOOL GS_OGLSprite::RenderTiles(RECT rcTileArea, BOOL bWrapAround, HWND hWnd)
             rcTileArea.right - rcTileArea.left,
             rcTileArea.top - rcTileArea.bottom
         );
+        GS_OGLDisplay::CountStateChanges();
 
         // Enable the scissor box.
         glEnable(GL_SCISSOR_TEST);
+        GS_OGLDisplay::CountStateChanges();
     }
 
     // Draw sprite in a different hue or even with transparency depending on the alpha factor.
@@ -594,6 +620,7 @@ BOOL GS_OGLSprite::RenderTiles(RECT rcTileArea, BOOL bWrapAround, HWND hWnd)
 
     // Select the sprite texture.
     glBindTexture(GL_TEXTURE_2D, m_gluTexture);
+    GS_OGLDisplay::CountTextureBinds();
 
     // Determine the scaled sprite dimensions and divide by two to take into account that the
     // sprite is drawn from the center outwards.
@@ -607,16 +634,21 @@ BOOL GS_OGLSprite::RenderTiles(RECT rcTileArea, BOOL bWrapAround, HWND hWnd)
         {
             // Reset the modelview matrix.
             glLoadIdentity();
+            GS_OGLDisplay::CountMatrixOps();
 
             // Position the sprite (the coordinates (0,0) is the bottom left corner of the screen).
             // Because the sprite is actually positioned from the center, some adjustments have to
             // be made for the sprite to be postioned by the bottom left corner.
             glTranslated(nDestX + g_fRenderModX + fHalfWidth, nDestY + g_fRenderModY + fHalfHeight, 0);
+            GS_OGLDisplay::CountMatrixOps();
 
             // Rotate the sprite on the X, Y and Z-axis.
             glRotatef(m_glfRotateX, 1.0f, 0.0f, 0.0f);
+            GS_OGLDisplay::CountMatrixOps();
             glRotatef(m_glfRotateY, 0.0f, 1.0f, 0.0f);
+            GS_OGLDisplay::CountMatrixOps();
             glRotatef(m_glfRotateZ, 0.0f, 0.0f, 1.0f);
+            GS_OGLDisplay::CountMatrixOps();
 
             // Determine the sprite dimensions as a factor of one, taking into account the coords
             // of the source rectangle as well as how far the sprite is scrolled.
@@ -650,11 +682,13 @@ BOOL GS_OGLSprite::RenderTiles(RECT rcTileArea, BOOL bWrapAround, HWND hWnd)
             glVertex2f(-fHalfWidth,  fHalfHeight);
 
             glEnd();
+            GS_OGLDisplay::CountDrawCall(4);
         }
     }
 
     // Unselect the sprite texture.
     glBindTexture(GL_TEXTURE_2D, 0);  // Use 0 instead of NULL
+    GS_OGLDisplay::CountTextureBinds();
 
     // Reset the color for other textures to white.
     glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
@@ -664,6 +698,7 @@ BOOL GS_OGLSprite::RenderTiles(RECT rcTileArea, BOOL bWrapAround, HWND hWnd)
     {
         // Disable the scissor box.
         glDisable(GL_SCISSOR_TEST);
+        GS_OGLDisplay::CountStateChanges();
     }
 
     // Reset display after 2D rendering.
@@ -710,6 +745,7 @@ BOOL GS_OGLSprite::RenderTargets(int nNumTargets, GS_RenderTarget* pgsTargets, H
 
     // Select the sprite texture.
     glBindTexture(GL_TEXTURE_2D, m_gluTexture);
+    GS_OGLDisplay::CountTextureBinds();
 
     // Start rendering multipile objects.
     for (int nLoop = 0; nLoop < nNumTargets; nLoop++)
@@ -729,6 +765,7 @@ BOOL GS_OGLSprite::RenderTargets(int nNumTargets, GS_RenderTarget* pgsTargets, H
 
         // Reset the modelview matrix.
         glLoadIdentity();
+        GS_OGLDisplay::CountMatrixOps();
 
         // Draw sprite in a different hue or even with transparency depending on the alpha factor.
         glColor4f(pgsTargets[nLoop].fRed, pgsTargets[nLoop].fGreen, pgsTargets[nLoop].fBlue,
@@ -743,11 +780,15 @@ BOOL GS_OGLSprite::RenderTargets(int nNumTargets, GS_RenderTarget* pgsTargets, H
         // Because the sprite is actually positioned from the center, some adjustments have to
         // be made for the sprite to be postioned by the bottom left corner.
         glTranslated(glfDestX + g_fRenderModX + fHalfWidth, glfDestY + g_fRenderModY + fHalfHeight, 0);
+        GS_OGLDisplay::CountMatrixOps();
 
         // Rotate the sprite on the X, Y and Z-axis.
         glRotatef(pgsTargets[nLoop].fRotateX, 1.0f, 0.0f, 0.0f);
+        GS_OGLDisplay::CountMatrixOps();
         glRotatef(pgsTargets[nLoop].fRotateY, 0.0f, 1.0f, 0.0f);
+        GS_OGLDisplay::CountMatrixOps();
         glRotatef(pgsTargets[nLoop].fRotateZ, 0.0f, 0.0f, 1.0f);
+        GS_OGLDisplay::CountMatrixOps();
 
         // Determine the sprite dimensions as a factor of one, taking into account the coordinates
         // of the source rectangle as well as how far the sprite is scrolled on the x- or y-axis.
@@ -780,10 +821,12 @@ BOOL GS_OGLSprite::RenderTargets(int nNumTargets, GS_RenderTarget* pgsTargets, H
         glTexCoord2f(fLeft,  fTop   );
         glVertex2f(-fHalfWidth,  fHalfHeight);
         glEnd();
+        GS_OGLDisplay::CountDrawCall(4);
     }
 
     // Unselect the sprite texture.
     glBindTexture(GL_TEXTURE_2D, 0);  // Use 0 instead of NULL
+    GS_OGLDisplay::CountTextureBinds();
 
     // Reset the color for other textures to white.
     glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
@@ -15,6 +15,32 @@
 // Include Game System (GS) header files.
 // ---------------------------------------------------------------------------------------------
 #include "gs_ogl_texture.h"
+#include "gs_ogl_display.h"
+#include "gs_asset_loader.h"
+//==============================================================================================
+
+
+//==============================================================================================
+// Include standard C library header files.
+// ---------------------------------------------------------------------------------------------
+#include <stdio.h>
+//==============================================================================================
+
+
+//==============================================================================================
+// Global variables.
+// ---------------------------------------------------------------------------------------------
+static char g_szCacheDirectory[_MAX_PATH] = GS_TEXCACHE_DIRECTORY; // Empty if cache disabled.
+// ---------------------------------------------------------------------------------------------
+static int  g_nMipmapSupport = -1;    // How mipmaps are built (-1 until a context is current).
+static BOOL g_bNonPowerOfTwo = FALSE; // Can textures of any size be uploaded as they are?
+static GLint g_glMaxTextureSize = 0;  // Largest width or height of a texture.
+// ---------------------------------------------------------------------------------------------
+static BOOL g_bS3TC = FALSE;          // Can S3TC (DXT) compressed images be uploaded?
+static BOOL g_bETC2 = FALSE;          // Can ETC2 compressed images be uploaded?
+// ---------------------------------------------------------------------------------------------
+static GS_PFNGLGENERATEMIPMAPPROC      g_glGenerateMipmap      = NULL;
+static GS_PFNGLCOMPRESSEDTEXIMAGE2DPROC g_glCompressedTexImage2D = NULL;
 //==============================================================================================
 
 
@@ -88,18 +114,39 @@ BOOL GS_OGLTexture::Create(const char* pszFilename, GS_TextureType gsTextureType
         this->Destroy();
     }
 
-    // Load the texture image from file (BMP, PCX or TGA).
-    if (!m_gsImage.Load(pszFilename))
+    // Create the texture from a compressed image next to the image if the driver supports it,
+    // or else straight from the texture cache if it is up to date.
+    if ((this->LoadCompressed(pszFilename, gsTextureType)) ||
+        (this->LoadCache(pszFilename, gsTextureType)))
     {
-        GS_Error::Report("GS_OGL_TEXTURE.CPP", 88, "Failed to load texture image!");
-        return FALSE;
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, glMinFilter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, glMagFilter);
+
+        m_gsTextureInfo.bIsReady = TRUE;
+
+        return TRUE;
+    }
+
+    // Use the texture image if it has already been decoded by the asset loader, otherwise
+    // load the texture image from file (BMP, PCX or TGA).
+    GS_OGLImage* pImage = g_gsAssetLoader.GetImage(pszFilename);
+
+    if (!pImage)
+    {
+        if (!m_gsImage.Load(pszFilename))
+        {
+            GS_Error::Report("GS_OGL_TEXTURE.CPP", 88, "Failed to load texture image!");
+            return FALSE;
+        }
+
+        pImage = &m_gsImage;
     }
 
     // Save the texture image attributes.
-    m_gsTextureInfo.nWidth    = m_gsImage.GetWidth();
-    m_gsTextureInfo.nHeight   = m_gsImage.GetHeight();
-    m_gsTextureInfo.nBpp      = m_gsImage.GetColorBytes();
-    m_gsTextureInfo.bHasAlpha = m_gsImage.HasAlpha();
+    m_gsTextureInfo.nWidth    = pImage->GetWidth();
+    m_gsTextureInfo.nHeight   = pImage->GetHeight();
+    m_gsTextureInfo.nBpp      = pImage->GetColorBytes();
+    m_gsTextureInfo.bHasAlpha = pImage->HasAlpha();
 
     // Generate an OpenGL texture ID for one texture.
     glGenTextures(1, &m_gsTextureInfo.glID);
@@ -138,7 +185,7 @@ BOOL GS_OGLTexture::Create(const char* pszFilename, GS_TextureType gsTextureType
         // bytes, and finally... a pointer that tells OpenGL where to get the actual texture data.
         glTexImage2D(GL_TEXTURE_2D, 0, m_gsTextureInfo.nBpp, m_gsTextureInfo.nWidth,
                      m_gsTextureInfo.nHeight, 0, m_gsTextureInfo.glFormat, GL_UNSIGNED_BYTE,
-                     m_gsImage.GetData());
+                     pImage->GetData());
     }
     else
     {
@@ -147,18 +194,14 @@ BOOL GS_OGLTexture::Create(const char* pszFilename, GS_TextureType gsTextureType
         // draw a mipmapped texture to the screen OpenGL will select the BEST looking texture from
         // the ones it built (texture with the most detail) and draw it to the screen instead of
         // resizing the original image (which causes detail loss).
-
-        // Unlike with the glTexImage2D() function where textures are limited to a width and
-        // height of 64*64,128*128 or 256*256 the gluBuild2DMipmaps() function has no such limits
-        // and you can use any size image you want since OpenGL will automatically size it to the
-        // proper width and height.
-        gluBuild2DMipmaps(GL_TEXTURE_2D, m_gsTextureInfo.nBpp, m_gsTextureInfo.nWidth,
-                          m_gsTextureInfo.nHeight, m_gsTextureInfo.glFormat, GL_UNSIGNED_BYTE,
-                          m_gsImage.GetData());
+        this->BuildMipmaps(pImage->GetData());
     }
 
     // Free all memory allocated to the texture image.
-    m_gsImage.Destroy();
+    pImage->Destroy();
+
+    // Save the texture so it doesn't have to be decoded and built again next time.
+    this->SaveCache(pszFilename, gsTextureType);
 
     // Texture was successfully created.
     m_gsTextureInfo.bIsReady = TRUE;
@@ -170,6 +213,134 @@ BOOL GS_OGLTexture::Create(const char* pszFilename, GS_TextureType gsTextureType
 ////////////////////////////////////////////////////////////////////////////////////////////////
 
 
+//==============================================================================================
+// GS_OGLTexture::BuildMipmaps():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Uploads the image data to the bound texture and builds all of its mipmap levels.
+// ---------------------------------------------------------------------------------------------
+// Details: If the driver can build the mipmaps itself only the first level is uploaded and the
+//          driver builds the rest, which is much faster than doing it in software. Otherwise
+//          (or if the image is too large, or isn't a power of two and the driver can't handle
+//          that) gluBuild2DMipmaps() is used, which rescales the image to a size the driver can
+//          handle before building the levels.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_OGLTexture::BuildMipmaps(const void* pData)
+{
+
+    int nWidth  = m_gsTextureInfo.nWidth;
+    int nHeight = m_gsTextureInfo.nHeight;
+
+    GS_OGLTexture::InitTextureSupport();
+
+    // Can the image be uploaded as it is?
+    BOOL bPowerOfTwo = (((nWidth & (nWidth - 1)) == 0) && ((nHeight & (nHeight - 1)) == 0));
+
+    if ((g_nMipmapSupport > GS_MIPMAP_GLU) && ((bPowerOfTwo) || (g_bNonPowerOfTwo)) &&
+        (nWidth <= g_glMaxTextureSize) && (nHeight <= g_glMaxTextureSize))
+    {
+        if (g_nMipmapSupport == GS_MIPMAP_PARAMETER)
+        {
+            glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_TRUE);
+        }
+
+        glTexImage2D(GL_TEXTURE_2D, 0, m_gsTextureInfo.nBpp, nWidth, nHeight, 0,
+                     m_gsTextureInfo.glFormat, GL_UNSIGNED_BYTE, pData);
+
+        if (g_nMipmapSupport == GS_MIPMAP_FUNCTION)
+        {
+            g_glGenerateMipmap(GL_TEXTURE_2D);
+        }
+
+        return;
+    }
+
+    // Unlike with the glTexImage2D() function where textures are limited to a width and
+    // height of 64*64,128*128 or 256*256 the gluBuild2DMipmaps() function has no such limits
+    // and you can use any size image you want since OpenGL will automatically size it to the
+    // proper width and height.
+    gluBuild2DMipmaps(GL_TEXTURE_2D, m_gsTextureInfo.nBpp, nWidth, nHeight,
+                      m_gsTextureInfo.glFormat, GL_UNSIGNED_BYTE, pData);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_OGLTexture::InitTextureSupport():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Finds out how the current OpenGL context can build mipmaps, if it can handle
+//          textures that aren't a power of two in size and which compressed formats it can
+//          upload. Only done once, when the first texture that needs to know is created, or
+//          when GS_AssetLoader starts (before its workers call HasCompressed()).
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_OGLTexture::InitTextureSupport()
+{
+
+    // Have we already checked, or is there no context to check yet?
+    if ((g_nMipmapSupport >= 0) || (!glGetString(GL_VERSION)))
+    {
+        return;
+    }
+
+    g_bNonPowerOfTwo = GS_OGLDisplay::IsSupported(2, 0, "GL_ARB_texture_non_power_of_two");
+
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &g_glMaxTextureSize);
+
+    // Prefer glGenerateMipmap() (core since GL 3.0), then the older EXT version of it, then
+    // the GL_GENERATE_MIPMAP texture parameter (core since GL 1.4) and finally GLU.
+    if (GS_OGLDisplay::IsSupported(3, 0, "GL_ARB_framebuffer_object"))
+    {
+        g_glGenerateMipmap =
+            (GS_PFNGLGENERATEMIPMAPPROC) GS_OGLDisplay::GetGLProcAddress("glGenerateMipmap");
+    }
+    else if (GS_OGLDisplay::IsSupported(3, 0, "GL_EXT_framebuffer_object"))
+    {
+        g_glGenerateMipmap =
+            (GS_PFNGLGENERATEMIPMAPPROC) GS_OGLDisplay::GetGLProcAddress("glGenerateMipmapEXT");
+    }
+
+    if (g_glGenerateMipmap)
+    {
+        g_nMipmapSupport = GS_MIPMAP_FUNCTION;
+    }
+    else if (GS_OGLDisplay::IsSupported(1, 4, "GL_SGIS_generate_mipmap"))
+    {
+        g_nMipmapSupport = GS_MIPMAP_PARAMETER;
+    }
+    else
+    {
+        g_nMipmapSupport = GS_MIPMAP_GLU;
+    }
+
+    // Compressed images are uploaded with glCompressedTexImage2D() (core since GL 1.3). S3TC is
+    // only ever an extension, ETC2 is core since GL 4.3.
+    if (GS_OGLDisplay::IsSupported(1, 3, "GL_ARB_texture_compression"))
+    {
+        g_glCompressedTexImage2D = (GS_PFNGLCOMPRESSEDTEXIMAGE2DPROC)
+            GS_OGLDisplay::GetGLProcAddress("glCompressedTexImage2D");
+
+        if (!g_glCompressedTexImage2D)
+        {
+            g_glCompressedTexImage2D = (GS_PFNGLCOMPRESSEDTEXIMAGE2DPROC)
+                GS_OGLDisplay::GetGLProcAddress("glCompressedTexImage2DARB");
+        }
+    }
+
+    g_bS3TC = GS_OGLDisplay::IsSupported(0, 0, "GL_EXT_texture_compression_s3tc");
+    g_bETC2 = GS_OGLDisplay::IsSupported(4, 3, "GL_ARB_ES3_compatibility");
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
 //==============================================================================================
 // GS_OGLTexture::CreateFromBMP():
 // ---------------------------------------------------------------------------------------------
@@ -325,4 +496,797 @@ void GS_OGLTexture::Destroy()
 }
 
 
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Compressed Texture Methods //////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_OGLTexture::HasCompressed():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Checks if there is a compressed image (KTX or DDS) next to an image that the driver
+//          can upload, in which case the image doesn't need to be decoded. Can be called from
+//          any thread once InitTextureSupport() has been called on the main thread.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if there is a compressed image the driver can use, FALSE if not.
+//==============================================================================================
+
+BOOL GS_OGLTexture::HasCompressed(const char* pszFilename)
+{
+
+    GS_File gsFile;
+    unsigned long lSize = 0;
+
+    const BYTE* pData = GS_OGLTexture::FindCompressed(&gsFile, pszFilename, &lSize);
+
+    GLenum glFormat   = 0;
+    int    nWidth     = 0;
+    int    nHeight    = 0;
+    int    nNumLevels = 1;
+    BOOL   bIsKTX     = FALSE;
+
+    return ((pData) && (GS_OGLTexture::ReadCompressedHeader(&pData, &lSize, &glFormat, &nWidth,
+                                                            &nHeight, &nNumLevels, &bIsKTX)) &&
+            (GS_OGLTexture::CanUploadCompressed(glFormat, nWidth, nHeight)));
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_OGLTexture::FindCompressed():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Finds the compressed image of an image, which has the same filename with the
+//          extension replaced by GS_KTX_EXTENSION or GS_DDS_EXTENSION (in that order). The
+//          image in the pack is used if there is one, otherwise the file is mapped into memory
+//          until the file object is closed.
+// ---------------------------------------------------------------------------------------------
+// Returns: A pointer to the contents of the compressed image or NULL if there is none.
+//==============================================================================================
+
+const BYTE* GS_OGLTexture::FindCompressed(GS_File* pgsFile, const char* pszFilename,
+                                          unsigned long* plSize)
+{
+
+    static const char* pszExtensions[] = { GS_KTX_EXTENSION, GS_DDS_EXTENSION };
+
+    char szName[_MAX_PATH];
+
+    if (!pszFilename)
+    {
+        return NULL;
+    }
+
+    // Find where the extension of the image starts (if it has one).
+    size_t nLength = strlen(pszFilename);
+    const char* pszExtension = strrchr(pszFilename, '.');
+
+    if ((pszExtension) && (!strpbrk(pszExtension, "/\\:")))
+    {
+        nLength = pszExtension - pszFilename;
+    }
+
+    for (int nIndex = 0; nIndex < 2; nIndex++)
+    {
+        if (nLength + strlen(pszExtensions[nIndex]) >= _MAX_PATH)
+        {
+            return NULL;
+        }
+
+        memcpy(szName, pszFilename, nLength);
+        strcpy(szName + nLength, pszExtensions[nIndex]);
+
+        const BYTE* pData = NULL;
+
+        if (g_gsPack.Find(szName, &pData, plSize))
+        {
+            return pData;
+        }
+
+        if (pgsFile->Open(szName, FILE_MAP))
+        {
+            *plSize = pgsFile->GetLength();
+            return pgsFile->GetData();
+        }
+    }
+
+    return NULL;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_OGLTexture::LoadCompressed():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Creates the texture from the compressed image of an image, uploading the levels
+//          straight from the file (or the pack). Supports S3TC (DXT1, DXT3 and DXT5) images in
+//          DDS or KTX files and ETC2 images in KTX files. Mipmaps are not built for compressed
+//          images, only the levels stored in the file are used.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if there is no compressed image or the driver can't use
+//          it (in which case the image itself should be used).
+//==============================================================================================
+
+BOOL GS_OGLTexture::LoadCompressed(const char* pszFilename, GS_TextureType gsTextureType)
+{
+
+    GS_File gsFile;
+    unsigned long lSize = 0;
+
+    const BYTE* pData = GS_OGLTexture::FindCompressed(&gsFile, pszFilename, &lSize);
+
+    if (!pData)
+    {
+        return FALSE;
+    }
+
+    GS_OGLTexture::InitTextureSupport();
+
+    GLenum glFormat   = 0;
+    int    nWidth     = 0;
+    int    nHeight    = 0;
+    int    nNumLevels = 1;
+    BOOL   bIsKTX     = FALSE;
+
+    // Can the driver upload the format and the size of the image as it is?
+    if ((!GS_OGLTexture::ReadCompressedHeader(&pData, &lSize, &glFormat, &nWidth, &nHeight,
+                                              &nNumLevels, &bIsKTX)) ||
+        (!GS_OGLTexture::CanUploadCompressed(glFormat, nWidth, nHeight)))
+    {
+        return FALSE;
+    }
+
+    BOOL bHasAlpha  = TRUE;
+    int  nBlockSize = GS_OGLTexture::GetBlockSize(glFormat, &bHasAlpha);
+
+    // A 2D texture only uses the first level.
+    if (gsTextureType != GS_MIPMAP)
+    {
+        nNumLevels = 1;
+    }
+
+    const BYTE*   pLevels[GS_TEXCACHE_MAX_LEVELS];
+    unsigned long lLevelSizes[GS_TEXCACHE_MAX_LEVELS];
+    int           nLevel = 0;
+
+    // Make sure every level lies within the file (it may have been cut short), there are no
+    // levels after the 1x1 level.
+    for (nLevel = 0; (nLevel < nNumLevels) && (nLevel < GS_TEXCACHE_MAX_LEVELS); nLevel++)
+    {
+        int nLevelWidth  = (nWidth >> nLevel) ? (nWidth >> nLevel) : 1;
+        int nLevelHeight = (nHeight >> nLevel) ? (nHeight >> nLevel) : 1;
+
+        if ((nLevel > 0) && ((nWidth >> (nLevel - 1)) <= 1) && ((nHeight >> (nLevel - 1)) <= 1))
+        {
+            break;
+        }
+
+        lLevelSizes[nLevel] = ((nLevelWidth + 3) / 4) * ((nLevelHeight + 3) / 4) * nBlockSize;
+
+        // Every level of a KTX file is preceded by its size and padded to 4 bytes.
+        if (bIsKTX)
+        {
+            unsigned int uImageSize = 0;
+
+            if (lSize < 4)
+            {
+                return FALSE;
+            }
+
+            memcpy(&uImageSize, pData, 4);
+
+            if (uImageSize != lLevelSizes[nLevel])
+            {
+                return FALSE;
+            }
+
+            pData += 4;
+            lSize -= 4;
+        }
+
+        unsigned long lPaddedSize = (bIsKTX) ? ((lLevelSizes[nLevel] + 3) & ~3) :
+                                    lLevelSizes[nLevel];
+
+        if (lSize < lLevelSizes[nLevel])
+        {
+            return FALSE;
+        }
+
+        pLevels[nLevel] = pData;
+
+        pData += (lSize < lPaddedSize) ? lSize : lPaddedSize;
+        lSize -= (lSize < lPaddedSize) ? lSize : lPaddedSize;
+    }
+
+    nNumLevels = nLevel;
+
+    // Save the texture image attributes.
+    m_gsTextureInfo.nWidth        = nWidth;
+    m_gsTextureInfo.nHeight       = nHeight;
+    m_gsTextureInfo.nBpp          = (bHasAlpha) ? 4 : 3;
+    m_gsTextureInfo.glFormat      = (bHasAlpha) ? GL_RGBA : GL_RGB;
+    m_gsTextureInfo.bHasAlpha     = bHasAlpha;
+    m_gsTextureInfo.bIsCompressed = TRUE;
+
+    // Clear errors left by earlier calls, so only the upload itself is checked below.
+    while (glGetError() != GL_NO_ERROR)
+    {
+        // Nothing to do.
+    }
+
+    // Generate an OpenGL texture ID and bind the texture ID to the texture.
+    glGenTextures(1, &m_gsTextureInfo.glID);
+    glBindTexture(GL_TEXTURE_2D, m_gsTextureInfo.glID);
+
+    for (nLevel = 0; nLevel < nNumLevels; nLevel++)
+    {
+        int nLevelWidth  = (nWidth >> nLevel) ? (nWidth >> nLevel) : 1;
+        int nLevelHeight = (nHeight >> nLevel) ? (nHeight >> nLevel) : 1;
+
+        g_glCompressedTexImage2D(GL_TEXTURE_2D, nLevel, glFormat, nLevelWidth, nLevelHeight, 0,
+                                 lLevelSizes[nLevel], pLevels[nLevel]);
+    }
+
+    // Only use the levels there are, so the texture is complete without the smaller ones.
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, nNumLevels - 1);
+
+    // Did the driver accept the image after all?
+    if (glGetError() != GL_NO_ERROR)
+    {
+        glDeleteTextures(1, &m_gsTextureInfo.glID);
+        ZeroMemory(&m_gsTextureInfo, sizeof(GS_TextureInfo));
+        return FALSE;
+    }
+
+    gsFile.Close();
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_OGLTexture::ReadCompressedHeader():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Reads the format, size and number of levels from the header of a compressed image
+//          (KTX or DDS) and moves the data pointer and size past the header, to the first
+//          level. Can be called from any thread.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if the image holds a single compressed 2D image, FALSE if not.
+//==============================================================================================
+
+BOOL GS_OGLTexture::ReadCompressedHeader(const BYTE** ppData, unsigned long* plSize,
+                                         GLenum* pglFormat, int* pnWidth, int* pnHeight,
+                                         int* pnNumLevels, BOOL* pbIsKTX)
+{
+
+    static const BYTE KTXIdentifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB,
+                                            '\r', '\n', 0x1A, '\n' };
+
+    const BYTE*   pData = *ppData;
+    unsigned long lSize = *plSize;
+
+    const GS_KTXHeader* pKTXHeader = (const GS_KTXHeader*) pData;
+    const GS_DDSHeader* pDDSHeader = (const GS_DDSHeader*) (pData + 4);
+
+    *pglFormat   = 0;
+    *pnNumLevels = 1;
+    *pbIsKTX     = FALSE;
+
+    if ((lSize >= sizeof(GS_KTXHeader)) &&
+        (memcmp(pKTXHeader->Identifier, KTXIdentifier, 12) == 0))
+    {
+        // Only a single compressed 2D image in native byte order is supported.
+        if ((pKTXHeader->uEndianness != 0x04030201) || (pKTXHeader->uGLType != 0) ||
+            (pKTXHeader->uPixelDepth != 0) || (pKTXHeader->uNumArrayElements != 0) ||
+            (pKTXHeader->uNumFaces != 1) ||
+            (lSize - sizeof(GS_KTXHeader) < pKTXHeader->uBytesOfKeyValueData))
+        {
+            return FALSE;
+        }
+
+        *pglFormat   = pKTXHeader->uGLInternalFormat;
+        *pnWidth     = pKTXHeader->uPixelWidth;
+        *pnHeight    = pKTXHeader->uPixelHeight;
+        *pnNumLevels = (pKTXHeader->uNumMipmapLevels > 1) ? pKTXHeader->uNumMipmapLevels : 1;
+        *pbIsKTX     = TRUE;
+
+        *ppData = pData + sizeof(GS_KTXHeader) + pKTXHeader->uBytesOfKeyValueData;
+        *plSize = lSize - (sizeof(GS_KTXHeader) + pKTXHeader->uBytesOfKeyValueData);
+    }
+    else if ((lSize >= 4 + sizeof(GS_DDSHeader)) && (memcmp(pData, GS_DDS_MAGIC, 4) == 0))
+    {
+        // Only a single compressed 2D image is supported (no cube maps, volume textures or
+        // DX10 formats).
+        if ((pDDSHeader->uSize != sizeof(GS_DDSHeader)) ||
+            (!(pDDSHeader->uFormatFlags & GS_DDS_FOURCC)) || (pDDSHeader->uCaps[1] != 0))
+        {
+            return FALSE;
+        }
+
+        if (memcmp(&pDDSHeader->uFourCC, "DXT1", 4) == 0)
+        {
+            *pglFormat = (pDDSHeader->uFormatFlags & GS_DDS_ALPHA) ?
+                         GL_COMPRESSED_RGBA_S3TC_DXT1_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        }
+        else if (memcmp(&pDDSHeader->uFourCC, "DXT3", 4) == 0)
+        {
+            *pglFormat = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+        }
+        else if (memcmp(&pDDSHeader->uFourCC, "DXT5", 4) == 0)
+        {
+            *pglFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        }
+
+        *pnWidth  = pDDSHeader->uWidth;
+        *pnHeight = pDDSHeader->uHeight;
+
+        if ((pDDSHeader->uFlags & GS_DDS_MIPMAPS) && (pDDSHeader->uMipMapCount > 1))
+        {
+            *pnNumLevels = pDDSHeader->uMipMapCount;
+        }
+
+        *ppData = pData + 4 + sizeof(GS_DDSHeader);
+        *plSize = lSize - (4 + sizeof(GS_DDSHeader));
+    }
+    else
+    {
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_OGLTexture::GetBlockSize():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Determines the size of the 4x4 pixel blocks of a compressed format and if it has
+//          alpha.
+// ---------------------------------------------------------------------------------------------
+// Returns: The size of a block in bytes, or 0 if the format is not supported.
+//==============================================================================================
+
+int GS_OGLTexture::GetBlockSize(GLenum glFormat, BOOL* pbHasAlpha)
+{
+
+    *pbHasAlpha = TRUE;
+
+    switch (glFormat)
+    {
+    case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_RGB8_ETC2:
+        *pbHasAlpha = FALSE;
+        return 8;
+    case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+        return 8;
+    case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+    case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+    case GL_COMPRESSED_RGBA8_ETC2_EAC:
+        return 16;
+    default:
+        return 0;
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_OGLTexture::CanUploadCompressed():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Checks if the driver can upload a compressed image of the given format and size as
+//          it is. Only reads what InitTextureSupport() found out, so it can be called from any
+//          thread once that has been called on the main thread.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if the image can be uploaded, FALSE if not.
+//==============================================================================================
+
+BOOL GS_OGLTexture::CanUploadCompressed(GLenum glFormat, int nWidth, int nHeight)
+{
+
+    BOOL bHasAlpha = TRUE;
+
+    BOOL bIsS3TC = (glFormat >= GL_COMPRESSED_RGB_S3TC_DXT1_EXT) &&
+                   (glFormat <= GL_COMPRESSED_RGBA_S3TC_DXT5_EXT);
+
+    BOOL bPowerOfTwo = (((nWidth & (nWidth - 1)) == 0) && ((nHeight & (nHeight - 1)) == 0));
+
+    return ((g_glCompressedTexImage2D) && (GS_OGLTexture::GetBlockSize(glFormat, &bHasAlpha)) &&
+            ((bIsS3TC) ? (g_bS3TC) : (g_bETC2)) && (nWidth > 0) && (nHeight > 0) &&
+            (nWidth <= g_glMaxTextureSize) && (nHeight <= g_glMaxTextureSize) &&
+            ((bPowerOfTwo) || (g_bNonPowerOfTwo)));
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Texture Cache Methods ///////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_OGLTexture::SetCacheDirectory():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Sets the directory the texture cache files are kept in (created when the first
+//          file is saved). The directory should end with a path separator, NULL or an empty
+//          string disables the texture cache.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_OGLTexture::SetCacheDirectory(const char* pszDirectory)
+{
+
+    if ((!pszDirectory) || (strlen(pszDirectory) >= _MAX_PATH))
+    {
+        g_szCacheDirectory[0] = '\0';
+        return;
+    }
+
+    strcpy(g_szCacheDirectory, pszDirectory);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_OGLTexture::IsCached():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Checks if there is an up to date texture cache file for an image, in which case the
+//          image doesn't need to be decoded. Can be called from any thread.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if the image is cached, FALSE if not.
+//==============================================================================================
+
+BOOL GS_OGLTexture::IsCached(const char* pszFilename)
+{
+
+    GS_File gsCacheFile;
+
+    return (GS_OGLTexture::OpenCache(&gsCacheFile, pszFilename, FALSE) != NULL);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_OGLTexture::GetCacheName():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Determines the name of the texture cache file of an image, which is the filename
+//          of the image with all path separators replaced by underscores.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if the texture cache is disabled or the name is too long.
+//==============================================================================================
+
+BOOL GS_OGLTexture::GetCacheName(const char* pszFilename, char* pszCacheName)
+{
+
+    size_t nLength = strlen(g_szCacheDirectory);
+
+    if ((nLength == 0) || (!pszFilename) || (strlen(pszFilename) >= GS_TEXCACHE_MAX_NAME) ||
+        (nLength + strlen(pszFilename) + strlen(GS_TEXCACHE_EXTENSION) >= _MAX_PATH))
+    {
+        return FALSE;
+    }
+
+    strcpy(pszCacheName, g_szCacheDirectory);
+
+    // Flatten the filename of the image so all cache files are in the same directory.
+    for (const char* pszChar = pszFilename; *pszChar; pszChar++)
+    {
+        BOOL bIsSeparator = (*pszChar == '/') || (*pszChar == '\\') || (*pszChar == ':');
+        pszCacheName[nLength++] = bIsSeparator ? '_' : *pszChar;
+    }
+
+    strcpy(pszCacheName + nLength, GS_TEXCACHE_EXTENSION);
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_OGLTexture::GetSourceStamp():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Gets the size and the modification time of an image file, or the size and the hash
+//          of the image if it is in the pack. A cache file is out of date when either changes.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if the image file doesn't exist.
+//==============================================================================================
+
+BOOL GS_OGLTexture::GetSourceStamp(const char* pszFilename, unsigned int* puSize,
+                                   unsigned int* puStamp)
+{
+
+    // Images in the pack are used before the ones in the file system.
+    const GS_PackEntry* pEntry = g_gsPack.GetEntry(pszFilename);
+
+    if (pEntry != NULL)
+    {
+        *puSize  = pEntry->uSize;
+        *puStamp = pEntry->uHash;
+        return TRUE;
+    }
+
+    GS_File gsFile;
+
+    if (!gsFile.Open(pszFilename, FILE_READ))
+    {
+        return FALSE;
+    }
+
+    *puSize  = (unsigned int) gsFile.GetLength();
+    *puStamp = (unsigned int) gsFile.GetModifiedTime();
+
+    gsFile.Close();
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_OGLTexture::OpenCache():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Maps the texture cache file of an image into memory and checks that it belongs to
+//          the current version of the image and that all its levels are complete. The file
+//          stays mapped until the file object is closed.
+// ---------------------------------------------------------------------------------------------
+// Returns: A pointer to the header of the cache file or NULL if there is no valid cache file.
+//==============================================================================================
+
+const GS_TexCacheHeader* GS_OGLTexture::OpenCache(GS_File* pgsCacheFile, const char* pszFilename,
+                                                  BOOL bNeedMipmaps)
+{
+
+    char szCacheName[_MAX_PATH];
+    unsigned int uSourceSize  = 0;
+    unsigned int uSourceStamp = 0;
+
+    if ((!GS_OGLTexture::GetCacheName(pszFilename, szCacheName)) ||
+        (!GS_OGLTexture::GetSourceStamp(pszFilename, &uSourceSize, &uSourceStamp)) ||
+        (!pgsCacheFile->Open(szCacheName, FILE_MAP)))
+    {
+        return NULL;
+    }
+
+    const BYTE*   pData = pgsCacheFile->GetData();
+    unsigned long lSize = pgsCacheFile->GetLength();
+
+    const GS_TexCacheHeader* pHeader = (const GS_TexCacheHeader*) pData;
+
+    // Is this a cache file of the current version of the image?
+    if ((lSize < sizeof(GS_TexCacheHeader)) ||
+        (memcmp(pHeader->szMagic, GS_TEXCACHE_MAGIC, 4) != 0) ||
+        (pHeader->uVersion != GS_TEXCACHE_VERSION) ||
+        (strncmp(pHeader->szSource, pszFilename, GS_TEXCACHE_MAX_NAME) != 0) ||
+        (pHeader->uSourceSize != uSourceSize) || (pHeader->uSourceStamp != uSourceStamp) ||
+        ((bNeedMipmaps) && (pHeader->uType != GS_MIPMAP)) ||
+        (pHeader->uNumLevels == 0) || (pHeader->uNumLevels > GS_TEXCACHE_MAX_LEVELS))
+    {
+        pgsCacheFile->Close();
+        return NULL;
+    }
+
+    unsigned long lOffset = sizeof(GS_TexCacheHeader);
+
+    // Make sure every level lies within the file (it may have been cut short).
+    for (unsigned int uLevel = 0; uLevel < pHeader->uNumLevels; uLevel++)
+    {
+        const GS_TexCacheLevel* pLevel = (const GS_TexCacheLevel*) (pData + lOffset);
+
+        if ((lSize - lOffset < sizeof(GS_TexCacheLevel)) ||
+            (pLevel->uSize != pLevel->uWidth * pLevel->uHeight * pHeader->uBpp) ||
+            (lSize - lOffset - sizeof(GS_TexCacheLevel) < ((pLevel->uSize + 3) & ~3)))
+        {
+            pgsCacheFile->Close();
+            return NULL;
+        }
+
+        lOffset += sizeof(GS_TexCacheLevel) + ((pLevel->uSize + 3) & ~3);
+    }
+
+    return pHeader;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_OGLTexture::LoadCache():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Creates the texture from the texture cache file of an image, uploading the levels
+//          straight from the mapped file without decoding the image or building mipmaps.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if there is no up to date cache file.
+//==============================================================================================
+
+BOOL GS_OGLTexture::LoadCache(const char* pszFilename, GS_TextureType gsTextureType)
+{
+
+    GS_File gsCacheFile;
+
+    const GS_TexCacheHeader* pHeader = GS_OGLTexture::OpenCache(&gsCacheFile, pszFilename,
+                                                                gsTextureType == GS_MIPMAP);
+
+    if (!pHeader)
+    {
+        return FALSE;
+    }
+
+    // Save the texture image attributes.
+    m_gsTextureInfo.nWidth    = pHeader->uWidth;
+    m_gsTextureInfo.nHeight   = pHeader->uHeight;
+    m_gsTextureInfo.nBpp      = pHeader->uBpp;
+    m_gsTextureInfo.glFormat  = pHeader->uFormat;
+    m_gsTextureInfo.bHasAlpha = (pHeader->uFormat == GL_RGBA);
+
+    // Generate an OpenGL texture ID and bind the texture ID to the texture.
+    glGenTextures(1, &m_gsTextureInfo.glID);
+    glBindTexture(GL_TEXTURE_2D, m_gsTextureInfo.glID);
+
+    // The rows of the levels are not padded.
+    GLint glAlignment = 4;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &glAlignment);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    // A 2D texture only uses the first level.
+    unsigned int uNumLevels = (gsTextureType == GS_MIPMAP) ? pHeader->uNumLevels : 1;
+
+    const BYTE* pData = (const BYTE*) (pHeader + 1);
+
+    for (unsigned int uLevel = 0; uLevel < uNumLevels; uLevel++)
+    {
+        const GS_TexCacheLevel* pLevel = (const GS_TexCacheLevel*) pData;
+
+        glTexImage2D(GL_TEXTURE_2D, uLevel, pHeader->uBpp, pLevel->uWidth, pLevel->uHeight, 0,
+                     pHeader->uFormat, GL_UNSIGNED_BYTE, pLevel + 1);
+
+        pData += sizeof(GS_TexCacheLevel) + ((pLevel->uSize + 3) & ~3);
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, glAlignment);
+
+    gsCacheFile.Close();
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_OGLTexture::SaveCache():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Reads back every level of the texture just created (bound) and saves them in the
+//          texture cache file of the image. Failing to save is not an error, the image will
+//          just be decoded again next time.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_OGLTexture::SaveCache(const char* pszFilename, GS_TextureType gsTextureType)
+{
+
+    char szCacheName[_MAX_PATH];
+    GS_TexCacheHeader CacheHeader;
+
+    memset(&CacheHeader, 0, sizeof(GS_TexCacheHeader));
+
+    if ((!GS_OGLTexture::GetCacheName(pszFilename, szCacheName)) ||
+        (!GS_OGLTexture::GetSourceStamp(pszFilename, &CacheHeader.uSourceSize,
+                                        &CacheHeader.uSourceStamp)))
+    {
+        return;
+    }
+
+    memcpy(CacheHeader.szMagic, GS_TEXCACHE_MAGIC, 4);
+    CacheHeader.uVersion = GS_TEXCACHE_VERSION;
+    strcpy(CacheHeader.szSource, pszFilename);
+    CacheHeader.uType   = gsTextureType;
+    CacheHeader.uWidth  = m_gsTextureInfo.nWidth;
+    CacheHeader.uHeight = m_gsTextureInfo.nHeight;
+    CacheHeader.uBpp    = m_gsTextureInfo.nBpp;
+    CacheHeader.uFormat = m_gsTextureInfo.glFormat;
+
+    GS_TexCacheLevel CacheLevels[GS_TEXCACHE_MAX_LEVELS];
+
+    // Find the levels of the texture (the texture may have been rescaled, so the first level
+    // isn't necessarily the size of the image).
+    while (CacheHeader.uNumLevels < ((gsTextureType == GS_MIPMAP) ? GS_TEXCACHE_MAX_LEVELS : 1))
+    {
+        GLint glWidth  = 0;
+        GLint glHeight = 0;
+
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, CacheHeader.uNumLevels, GL_TEXTURE_WIDTH,
+                                 &glWidth);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, CacheHeader.uNumLevels, GL_TEXTURE_HEIGHT,
+                                 &glHeight);
+
+        if ((glWidth <= 0) || (glHeight <= 0))
+        {
+            break;
+        }
+
+        CacheLevels[CacheHeader.uNumLevels].uWidth  = glWidth;
+        CacheLevels[CacheHeader.uNumLevels].uHeight = glHeight;
+        CacheLevels[CacheHeader.uNumLevels].uSize   = glWidth * glHeight * m_gsTextureInfo.nBpp;
+        CacheHeader.uNumLevels++;
+    }
+
+    if (CacheHeader.uNumLevels == 0)
+    {
+        return;
+    }
+
+    // Make sure the cache directory exists (fails quietly if it does).
+    CreateDirectory(g_szCacheDirectory, NULL);
+
+    GS_File gsCacheFile;
+
+    if (!gsCacheFile.Open(szCacheName, FILE_WRITE))
+    {
+        return;
+    }
+
+    BOOL bResult = (gsCacheFile.Write(&CacheHeader, sizeof(GS_TexCacheHeader)) ==
+                    sizeof(GS_TexCacheHeader));
+
+    // Read the levels back without padding the rows.
+    GLint glAlignment = 4;
+    glGetIntegerv(GL_PACK_ALIGNMENT, &glAlignment);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+    for (unsigned int uLevel = 0; (bResult) && (uLevel < CacheHeader.uNumLevels); uLevel++)
+    {
+        unsigned long lPaddedSize = (CacheLevels[uLevel].uSize + 3) & ~3;
+        BYTE* pPixels = new BYTE [lPaddedSize];
+
+        memset(pPixels, 0, lPaddedSize);
+
+        glGetTexImage(GL_TEXTURE_2D, uLevel, m_gsTextureInfo.glFormat, GL_UNSIGNED_BYTE,
+                      pPixels);
+
+        bResult = (gsCacheFile.Write(&CacheLevels[uLevel], sizeof(GS_TexCacheLevel)) ==
+                   sizeof(GS_TexCacheLevel)) &&
+                  (gsCacheFile.Write(pPixels, lPaddedSize) == lPaddedSize);
+
+        delete [] pPixels;
+    }
+
+    glPixelStorei(GL_PACK_ALIGNMENT, glAlignment);
+
+    gsCacheFile.Close();
+
+    if (!bResult)
+    {
+        GS_Error::Report("GS_OGL_TEXTURE.CPP", 737, "Failed to save texture cache file!");
+    }
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////////////////////
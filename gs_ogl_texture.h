@@ -39,10 +39,72 @@
 // ---------------------------------------------------------------------------------------------
 #include "gs_error.h"
 #include "gs_object.h"
+#include "gs_file.h"
+#include "gs_pack.h"
 #include "gs_ogl_image.h"
 //==============================================================================================
 
 
+//==============================================================================================
+// Texture cache defines.
+// ---------------------------------------------------------------------------------------------
+#define GS_TEXCACHE_MAGIC      "GSTC"   // Identifies a texture cache file.
+#define GS_TEXCACHE_VERSION    1        // Version of the texture cache format.
+#define GS_TEXCACHE_DIRECTORY  "cache/" // Default directory of the texture cache files.
+#define GS_TEXCACHE_EXTENSION  ".gtc"   // Extension added to the flattened source filename.
+#define GS_TEXCACHE_MAX_NAME   128      // Maximum length of the source filename (incl. zero).
+#define GS_TEXCACHE_MAX_LEVELS 16       // Maximum number of mipmap levels in a cache file.
+//==============================================================================================
+
+
+//==============================================================================================
+// Mipmap generation defines.
+// ---------------------------------------------------------------------------------------------
+#define GS_MIPMAP_GLU       0 // Levels are built (and rescaled) in software by GLU.
+#define GS_MIPMAP_PARAMETER 1 // Levels are built by the driver (GL_GENERATE_MIPMAP, GL 1.4).
+#define GS_MIPMAP_FUNCTION  2 // Levels are built by the driver (glGenerateMipmap, GL 3.0).
+// ---------------------------------------------------------------------------------------------
+#ifndef GL_GENERATE_MIPMAP
+#define GL_GENERATE_MIPMAP 0x8191
+#endif
+// ---------------------------------------------------------------------------------------------
+typedef void (APIENTRY* GS_PFNGLGENERATEMIPMAPPROC)(GLenum target);
+//==============================================================================================
+
+
+//==============================================================================================
+// Compressed texture defines. A compressed image (KTX or DDS) found next to an image with the
+// same name is used instead of the image when the driver supports its format.
+// ---------------------------------------------------------------------------------------------
+#define GS_KTX_EXTENSION  ".ktx"  // Extension of a compressed image in a KTX (1.1) file.
+#define GS_DDS_EXTENSION  ".dds"  // Extension of a compressed image in a DDS file.
+#define GS_DDS_MAGIC      "DDS "  // Identifies a DDS file.
+#define GS_DDS_ALPHA      0x0001  // DDS pixel format flag, DXT1 image has 1-bit alpha.
+#define GS_DDS_FOURCC     0x0004  // DDS pixel format flag, the format is in uFourCC.
+#define GS_DDS_MIPMAPS    0x20000 // DDS header flag, uMipMapCount is valid.
+// ---------------------------------------------------------------------------------------------
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT  0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#define GL_COMPRESSED_RGBA_S3TC_DXT3_EXT 0x83F2
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_RGB8_ETC2
+#define GL_COMPRESSED_RGB8_ETC2                     0x9274
+#define GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2 0x9276
+#define GL_COMPRESSED_RGBA8_ETC2_EAC                0x9278
+#endif
+#ifndef GL_TEXTURE_MAX_LEVEL
+#define GL_TEXTURE_MAX_LEVEL 0x813D
+#endif
+// ---------------------------------------------------------------------------------------------
+typedef void (APIENTRY* GS_PFNGLCOMPRESSEDTEXIMAGE2DPROC)(GLenum target, GLint level,
+                                                         GLenum internalformat, GLsizei width,
+                                                         GLsizei height, GLint border,
+                                                         GLsizei imageSize, const void* data);
+//==============================================================================================
+
+
 //==============================================================================================
 // Texture type enumeration.
 // ---------------------------------------------------------------------------------------------
@@ -59,17 +121,93 @@ typedef enum GS_TEXTURE_TYPE
 // ---------------------------------------------------------------------------------------------
 typedef struct GS_TEXTURE_INFO
 {
-    GLuint glID;     // The OpenGL texture ID.
-    GLenum glFormat; // The color format of the OpenGL texture (RGB, RGBA etc.).
-    int nWidth;      // Texture width in pixels.
-    int nHeight;     // Texture height in pixels.
-    int nBpp;        // Texture color size in bytes.
-    BOOL bHasAlpha;  // Whether the texture has an alpha component.
-    BOOL bIsReady;   // Wether the texture has been created or not.
+    GLuint glID;        // The OpenGL texture ID.
+    GLenum glFormat;    // The color format of the OpenGL texture (RGB, RGBA etc.).
+    int nWidth;         // Texture width in pixels.
+    int nHeight;        // Texture height in pixels.
+    int nBpp;           // Texture color size in bytes.
+    BOOL bHasAlpha;     // Whether the texture has an alpha component.
+    BOOL bIsCompressed; // Whether the texture was created from a compressed image.
+    BOOL bIsReady;      // Wether the texture has been created or not.
 } GS_TextureInfo;
 //==============================================================================================
 
 
+//==============================================================================================
+// Texture cache structures (native byte order, cache files are not meant to be shared). The
+// header is followed by every mipmap level, each stored as a level header followed by the
+// pixels of the level (rows not padded) padded to a multiple of 4 bytes.
+// ---------------------------------------------------------------------------------------------
+typedef struct GS_TEXCACHE_HEADER
+{
+    char         szMagic[4];    // GS_TEXCACHE_MAGIC (not zero terminated).
+    unsigned int uVersion;      // GS_TEXCACHE_VERSION.
+    unsigned int uSourceSize;   // Size of the source image file in bytes.
+    unsigned int uSourceStamp;  // Modification time of the source image file (its hash if the
+                                // image is in the pack).
+    unsigned int uType;         // GS_IMAGE2D or GS_MIPMAP.
+    unsigned int uWidth;        // Width of the source image in pixels.
+    unsigned int uHeight;       // Height of the source image in pixels.
+    unsigned int uBpp;          // Color size in bytes.
+    unsigned int uFormat;       // GL_RGB or GL_RGBA.
+    unsigned int uNumLevels;    // Number of mipmap levels stored.
+    char         szSource[GS_TEXCACHE_MAX_NAME]; // Filename of the source image.
+} GS_TexCacheHeader;
+// ---------------------------------------------------------------------------------------------
+typedef struct GS_TEXCACHE_LEVEL
+{
+    unsigned int uWidth;  // Width of the level in pixels.
+    unsigned int uHeight; // Height of the level in pixels.
+    unsigned int uSize;   // Size of the pixels of the level in bytes.
+} GS_TexCacheLevel;
+//==============================================================================================
+
+
+//==============================================================================================
+// Compressed image file structures (little endian, as written by the usual tools). A DDS file
+// starts with GS_DDS_MAGIC and the DDS header, followed by the levels (largest first) without
+// any padding. A KTX file starts with the KTX header and the key/value data, followed by the
+// levels, each stored as its size in bytes followed by the level padded to 4 bytes.
+// ---------------------------------------------------------------------------------------------
+typedef struct GS_DDS_HEADER
+{
+    unsigned int uSize;              // Size of this header (124).
+    unsigned int uFlags;             // Which members are valid (GS_DDS_MIPMAPS etc.).
+    unsigned int uHeight;            // Height of the image in pixels.
+    unsigned int uWidth;             // Width of the image in pixels.
+    unsigned int uPitchOrLinearSize; // Size of the first level in bytes.
+    unsigned int uDepth;             // Depth of a volume texture (not supported).
+    unsigned int uMipMapCount;       // Number of levels.
+    unsigned int uReserved1[11];
+    unsigned int uFormatSize;        // Size of the pixel format (32).
+    unsigned int uFormatFlags;       // Pixel format flags (GS_DDS_FOURCC etc.).
+    unsigned int uFourCC;            // Compression format ("DXT1", "DXT3" or "DXT5").
+    unsigned int uRGBBitCount;       // Uncompressed formats only (not supported).
+    unsigned int uBitMasks[4];
+    unsigned int uCaps[4];           // Cube map and volume texture flags (not supported).
+    unsigned int uReserved2;
+} GS_DDSHeader;
+// ---------------------------------------------------------------------------------------------
+typedef struct GS_KTX_HEADER
+{
+    BYTE         Identifier[12];        // "\xABKTX 11\xBB\r\n\x1A\n".
+    unsigned int uEndianness;           // 0x04030201 when in native byte order.
+    unsigned int uGLType;               // 0 for compressed images.
+    unsigned int uGLTypeSize;
+    unsigned int uGLFormat;             // 0 for compressed images.
+    unsigned int uGLInternalFormat;     // The compressed format (S3TC or ETC2).
+    unsigned int uGLBaseInternalFormat; // GL_RGB or GL_RGBA.
+    unsigned int uPixelWidth;           // Width of the image in pixels.
+    unsigned int uPixelHeight;          // Height of the image in pixels.
+    unsigned int uPixelDepth;           // 0 for 2D images.
+    unsigned int uNumArrayElements;     // 0 for 2D images.
+    unsigned int uNumFaces;             // 1 for 2D images.
+    unsigned int uNumMipmapLevels;      // Number of levels (0 means only one).
+    unsigned int uBytesOfKeyValueData;  // Size of the key/value data following the header.
+} GS_KTXHeader;
+//==============================================================================================
+
+
 ////////////////////////////////////////////////////////////////////////////////////////////////
 // Class Definition. ///////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////
@@ -84,6 +222,26 @@ private:
 
     GS_TextureInfo m_gsTextureInfo; // Contains all the relevant texture information.
 
+    BOOL LoadCache(const char* pszFilename, GS_TextureType gsTextureType);
+    void SaveCache(const char* pszFilename, GS_TextureType gsTextureType);
+    void BuildMipmaps(const void* pData);
+
+    BOOL LoadCompressed(const char* pszFilename, GS_TextureType gsTextureType);
+
+    static const BYTE* FindCompressed(GS_File* pgsFile, const char* pszFilename,
+                                      unsigned long* plSize);
+    static BOOL ReadCompressedHeader(const BYTE** ppData, unsigned long* plSize,
+                                     GLenum* pglFormat, int* pnWidth, int* pnHeight,
+                                     int* pnNumLevels, BOOL* pbIsKTX);
+    static int  GetBlockSize(GLenum glFormat, BOOL* pbHasAlpha);
+    static BOOL CanUploadCompressed(GLenum glFormat, int nWidth, int nHeight);
+
+    static BOOL GetCacheName(const char* pszFilename, char* pszCacheName);
+    static BOOL GetSourceStamp(const char* pszFilename, unsigned int* puSize,
+                               unsigned int* puStamp);
+    static const GS_TexCacheHeader* OpenCache(GS_File* pgsCacheFile, const char* pszFilename,
+                                              BOOL bNeedMipmaps);
+
 protected:
 
     // No protected members.
@@ -100,6 +258,11 @@ public:
 
     void Destroy();
 
+    static void InitTextureSupport();
+    static void SetCacheDirectory(const char* pszDirectory);
+    static BOOL IsCached(const char* pszFilename);
+    static BOOL HasCompressed(const char* pszFilename);
+
     GLuint GetID()
     {
         return m_gsTextureInfo.glID;
@@ -120,6 +283,10 @@ public:
     {
         return m_gsTextureInfo.bHasAlpha;
     }
+    BOOL   IsCompressed()
+    {
+        return m_gsTextureInfo.bIsCompressed;
+    }
     BOOL   IsReady()
     {
         return m_gsTextureInfo.bIsReady;
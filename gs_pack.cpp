@@ -0,0 +1,596 @@
+/*============================================================================================+
+ | Game System (GS) Library                                                                   |
+ |--------------------------------------------------------------------------------------------|
+ | FILES: gs_pack.cpp, gs_pack.h                                                              |
+ |--------------------------------------------------------------------------------------------|
+ | CLASS: GS_Pack                                                                             |
+ |--------------------------------------------------------------------------------------------|
+ | ABOUT: Single file asset archive. A pack starts with a header and a table of contents      |
+ |        (name, offset, size and hash of every file, sorted by name) followed by the file    |
+ |        contents, each aligned to GS_PACK_ALIGNMENT bytes. The pack is memory mapped when   |
+ |        opened, so files are handed out as pointers into the mapping without any copying.   |
+ |--------------------------------------------------------------------------------------------|
+ |                                                                                    10/2026 |
+ +============================================================================================*/
+
+
+//==============================================================================================
+// Include Game System (GS) header files.
+// ---------------------------------------------------------------------------------------------
+#include "gs_pack.h"
+//==============================================================================================
+
+
+//==============================================================================================
+// Include standard C library header files.
+// ---------------------------------------------------------------------------------------------
+#include <ctype.h>
+//==============================================================================================
+
+
+//==============================================================================================
+// Global variables.
+// ---------------------------------------------------------------------------------------------
+GS_Pack g_gsPack;
+//==============================================================================================
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Constructor/Destructor Methods //////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Pack::GS_Pack():
+// ---------------------------------------------------------------------------------------------
+// Purpose: The constructor, initializes class data when class object is created.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+GS_Pack::GS_Pack()
+{
+
+    m_pEntries    = NULL;
+    m_nNumEntries = 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Pack::~GS_Pack():
+// ---------------------------------------------------------------------------------------------
+// Purpose: The destructor, de-initializes class data when class object is destroyed.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+GS_Pack::~GS_Pack()
+{
+
+    this->Close();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Open/Close Methods. /////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Pack::Open():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Maps the specified pack file into memory and checks the header and the table of
+//          contents. The pack must stay open for as long as any of its files are in use.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if failed.
+//==============================================================================================
+
+BOOL GS_Pack::Open(const char* pszFilename)
+{
+
+    // Close any previously opened pack.
+    this->Close();
+
+    // Map the pack file into memory (fails quietly if there is no pack).
+    if (!m_gsFile.Open(pszFilename, FILE_MAP))
+    {
+        return FALSE;
+    }
+
+    const BYTE*   pData = m_gsFile.GetData();
+    unsigned long lSize = m_gsFile.GetLength();
+
+    const GS_PackHeader* pHeader = (const GS_PackHeader*) pData;
+
+    // Is this a pack file of the version we know?
+    if ((lSize < sizeof(GS_PackHeader)) || (memcmp(pHeader->szMagic, GS_PACK_MAGIC, 4) != 0) ||
+        (pHeader->uVersion != GS_PACK_VERSION) || (pHeader->uNumEntries > GS_PACK_MAX_FILES) ||
+        (lSize < sizeof(GS_PackHeader) + pHeader->uNumEntries * sizeof(GS_PackEntry)))
+    {
+        GS_Error::Report("GS_PACK.CPP", 116, "Invalid or unsupported pack file!");
+        m_gsFile.Close();
+        return FALSE;
+    }
+
+    const GS_PackEntry* pEntries = (const GS_PackEntry*) (pData + sizeof(GS_PackHeader));
+
+    // Make sure every entry has a terminated name and lies within the pack.
+    for (unsigned int uIndex = 0; uIndex < pHeader->uNumEntries; uIndex++)
+    {
+        if ((memchr(pEntries[uIndex].szName, 0, GS_PACK_MAX_NAME) == NULL) ||
+            (pEntries[uIndex].uOffset > lSize) ||
+            (pEntries[uIndex].uSize > lSize - pEntries[uIndex].uOffset))
+        {
+            GS_Error::Report("GS_PACK.CPP", 130, "Corrupt pack table of contents!");
+            m_gsFile.Close();
+            return FALSE;
+        }
+    }
+
+    m_pEntries    = pEntries;
+    m_nNumEntries = pHeader->uNumEntries;
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Pack::Close():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Unmaps the pack, pointers returned by Find() become invalid.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_Pack::Close()
+{
+
+    m_gsFile.Close();
+
+    m_pEntries    = NULL;
+    m_nNumEntries = 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Lookup Methods. /////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Pack::FindEntry():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Finds a file in the table of contents using a binary search (entries are sorted).
+// ---------------------------------------------------------------------------------------------
+// Returns: A pointer to the entry or NULL if the file is not in the pack.
+//==============================================================================================
+
+const GS_PackEntry* GS_Pack::FindEntry(const char* pszFilename)
+{
+
+    if ((m_pEntries == NULL) || (!pszFilename))
+    {
+        return NULL;
+    }
+
+    char szName[_MAX_PATH];
+
+    // Names are stored normalized, so normalize the name we are looking for as well.
+    GS_Pack::NormalizeName(pszFilename, szName);
+
+    int nLow  = 0;
+    int nHigh = m_nNumEntries - 1;
+
+    while (nLow <= nHigh)
+    {
+        int nMiddle  = (nLow + nHigh) / 2;
+        int nCompare = strcmp(szName, m_pEntries[nMiddle].szName);
+
+        if (nCompare == 0)
+        {
+            return &m_pEntries[nMiddle];
+        }
+        if (nCompare < 0)
+        {
+            nHigh = nMiddle - 1;
+        }
+        else
+        {
+            nLow = nMiddle + 1;
+        }
+    }
+
+    return NULL;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Pack::GetEntry():
+// ---------------------------------------------------------------------------------------------
+// Purpose: ...
+// ---------------------------------------------------------------------------------------------
+// Returns: A pointer to the specified entry or NULL if the index is invalid.
+//==============================================================================================
+
+const GS_PackEntry* GS_Pack::GetEntry(int nIndex)
+{
+
+    if ((m_pEntries == NULL) || (nIndex < 0) || (nIndex >= m_nNumEntries))
+    {
+        return NULL;
+    }
+
+    return &m_pEntries[nIndex];
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Pack::GetEntry():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Looks up the entry of a file, to get its size and hash without touching its
+//          contents.
+// ---------------------------------------------------------------------------------------------
+// Returns: A pointer to the entry of the file or NULL if the file is not in the pack.
+//==============================================================================================
+
+const GS_PackEntry* GS_Pack::GetEntry(const char* pszFilename)
+{
+
+    return this->FindEntry(pszFilename);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Pack::Find():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Looks up a file in the pack and returns a pointer to its contents within the
+//          mapped pack together with its size. The contents are read only and stay valid
+//          until the pack is closed.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if the file is in the pack, FALSE if not.
+//==============================================================================================
+
+BOOL GS_Pack::Find(const char* pszFilename, const BYTE** ppData, unsigned long* plSize)
+{
+
+    const GS_PackEntry* pEntry = this->FindEntry(pszFilename);
+
+    if (pEntry == NULL)
+    {
+        return FALSE;
+    }
+
+    if (ppData != NULL)
+    {
+        *ppData = m_gsFile.GetData() + pEntry->uOffset;
+    }
+    if (plSize != NULL)
+    {
+        *plSize = pEntry->uSize;
+    }
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Pack::Verify():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Checks the contents of every file in the pack against its hash. This touches every
+//          page of the pack, so it is meant for tools and not for startup.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if all files are intact, FALSE if not.
+//==============================================================================================
+
+BOOL GS_Pack::Verify()
+{
+
+    if (m_pEntries == NULL)
+    {
+        return FALSE;
+    }
+
+    BOOL bResult = TRUE;
+
+    for (int nIndex = 0; nIndex < m_nNumEntries; nIndex++)
+    {
+        const GS_PackEntry* pEntry = &m_pEntries[nIndex];
+
+        if (GS_Pack::Hash(m_gsFile.GetData() + pEntry->uOffset, pEntry->uSize) != pEntry->uHash)
+        {
+            char szError[_MAX_PATH + 64];
+            sprintf(szError, "Pack file '%s' is corrupt!", pEntry->szName);
+            GS_Error::Report("GS_PACK.CPP", 308, szError);
+            bResult = FALSE;
+        }
+    }
+
+    return bResult;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Helper Methods. /////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Pack::NormalizeName():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Converts a filename to the form stored in the pack: lower case, '/' as separator
+//          and without a leading "./". The buffer must be able to hold _MAX_PATH characters.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_Pack::NormalizeName(const char* pszFilename, char* pszName)
+{
+
+    // Skip a leading "./" or ".\".
+    if ((pszFilename[0] == '.') && ((pszFilename[1] == '/') || (pszFilename[1] == '\\')))
+    {
+        pszFilename += 2;
+    }
+
+    int nIndex = 0;
+
+    while ((pszFilename[nIndex] != 0) && (nIndex < _MAX_PATH - 1))
+    {
+        char cChar = pszFilename[nIndex];
+        pszName[nIndex] = (cChar == '\\') ? '/' : (char) tolower((unsigned char) cChar);
+        nIndex++;
+    }
+
+    pszName[nIndex] = 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Pack::Hash():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Calculates the 32-bit FNV-1a hash of a block of data.
+// ---------------------------------------------------------------------------------------------
+// Returns: The hash value.
+//==============================================================================================
+
+unsigned int GS_Pack::Hash(const BYTE* pData, unsigned long lSize)
+{
+
+    unsigned int uHash = 2166136261u;
+
+    for (unsigned long lIndex = 0; lIndex < lSize; lIndex++)
+    {
+        uHash ^= pData[lIndex];
+        uHash *= 16777619u;
+    }
+
+    return uHash;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Build Methods. //////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Pack::Build():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Creates a pack file from the specified files. Each file is stored under its name
+//          as given (normalized), so it must be given the same way the game loads it, for
+//          example "data/image_01.pcx".
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if failed.
+//==============================================================================================
+
+BOOL GS_Pack::Build(const char* pszPackname, const char** ppszFilenames, int nNumFiles)
+{
+
+    if ((!pszPackname) || (!ppszFilenames) || (nNumFiles <= 0) ||
+        (nNumFiles > GS_PACK_MAX_FILES))
+    {
+        GS_Error::Report("GS_PACK.CPP", 406, "Invalid number of files for pack!");
+        return FALSE;
+    }
+
+    GS_PackEntry* pEntries  = new GS_PackEntry[nNumFiles];
+    BYTE**        ppContent = new BYTE*[nNumFiles];
+    int*          pnSorted  = new int[nNumFiles];
+
+    BOOL bResult = TRUE;
+    int  nIndex  = 0;
+
+    for (nIndex = 0; nIndex < nNumFiles; nIndex++)
+    {
+        ppContent[nIndex] = NULL;
+    }
+
+    // Read in all the files and fill in their entries.
+    for (nIndex = 0; (nIndex < nNumFiles) && (bResult); nIndex++)
+    {
+        char szName[_MAX_PATH];
+        char szError[_MAX_PATH + 64];
+
+        GS_Pack::NormalizeName(ppszFilenames[nIndex], szName);
+
+        memset(&pEntries[nIndex], 0, sizeof(GS_PackEntry));
+
+        if (strlen(szName) >= GS_PACK_MAX_NAME)
+        {
+            sprintf(szError, "Filename '%s' is too long for pack!", szName);
+            GS_Error::Report("GS_PACK.CPP", 435, szError);
+            bResult = FALSE;
+            break;
+        }
+
+        strcpy(pEntries[nIndex].szName, szName);
+
+        GS_File gsFile;
+
+        if (!gsFile.Open(ppszFilenames[nIndex], FILE_READ))
+        {
+            sprintf(szError, "Failed to open '%s' for pack!", ppszFilenames[nIndex]);
+            GS_Error::Report("GS_PACK.CPP", 447, szError);
+            bResult = FALSE;
+            break;
+        }
+
+        unsigned long lSize = gsFile.GetLength();
+
+        ppContent[nIndex] = new BYTE[lSize + 1];
+
+        if ((lSize > 0) && (gsFile.Read(ppContent[nIndex], lSize) != lSize))
+        {
+            sprintf(szError, "Failed to read '%s' for pack!", ppszFilenames[nIndex]);
+            GS_Error::Report("GS_PACK.CPP", 459, szError);
+            bResult = FALSE;
+            break;
+        }
+
+        pEntries[nIndex].uSize = lSize;
+        pEntries[nIndex].uHash = GS_Pack::Hash(ppContent[nIndex], lSize);
+    }
+
+    if (bResult)
+    {
+        // Sort the entries by name (insertion sort, packs hold few files).
+        for (nIndex = 0; nIndex < nNumFiles; nIndex++)
+        {
+            int nInsert = nIndex;
+            while ((nInsert > 0) &&
+                   (strcmp(pEntries[pnSorted[nInsert-1]].szName, pEntries[nIndex].szName) > 0))
+            {
+                pnSorted[nInsert] = pnSorted[nInsert-1];
+                nInsert--;
+            }
+            pnSorted[nInsert] = nIndex;
+        }
+
+        // The same file can only be stored once.
+        for (nIndex = 1; nIndex < nNumFiles; nIndex++)
+        {
+            if (strcmp(pEntries[pnSorted[nIndex-1]].szName, pEntries[pnSorted[nIndex]].szName) == 0)
+            {
+                char szError[_MAX_PATH + 64];
+                sprintf(szError, "File '%s' added to pack twice!", pEntries[pnSorted[nIndex]].szName);
+                GS_Error::Report("GS_PACK.CPP", 490, szError);
+                bResult = FALSE;
+                break;
+            }
+        }
+    }
+
+    if (bResult)
+    {
+        // Lay out the file contents after the table of contents.
+        unsigned long lOffset = sizeof(GS_PackHeader) + nNumFiles * sizeof(GS_PackEntry);
+
+        for (nIndex = 0; nIndex < nNumFiles; nIndex++)
+        {
+            lOffset = (lOffset + GS_PACK_ALIGNMENT - 1) & ~(unsigned long)(GS_PACK_ALIGNMENT - 1);
+            pEntries[pnSorted[nIndex]].uOffset = lOffset;
+            lOffset += pEntries[pnSorted[nIndex]].uSize;
+        }
+
+        GS_PackHeader gsHeader;
+        memset(&gsHeader, 0, sizeof(GS_PackHeader));
+        memcpy(gsHeader.szMagic, GS_PACK_MAGIC, 4);
+        gsHeader.uVersion    = GS_PACK_VERSION;
+        gsHeader.uNumEntries = nNumFiles;
+
+        GS_File gsPackFile;
+
+        if (!gsPackFile.Open(pszPackname, FILE_WRITE))
+        {
+            GS_Error::Report("GS_PACK.CPP", 519, "Failed to create pack file!");
+            bResult = FALSE;
+        }
+        else
+        {
+            BYTE Padding[GS_PACK_ALIGNMENT];
+            memset(Padding, 0, sizeof(Padding));
+
+            // Write the header and the table of contents in sorted order.
+            lOffset = sizeof(GS_PackHeader) + nNumFiles * sizeof(GS_PackEntry);
+            bResult = (gsPackFile.Write(&gsHeader, sizeof(GS_PackHeader)) == sizeof(GS_PackHeader));
+            for (nIndex = 0; (nIndex < nNumFiles) && (bResult); nIndex++)
+            {
+                bResult = (gsPackFile.Write(&pEntries[pnSorted[nIndex]], sizeof(GS_PackEntry)) ==
+                           sizeof(GS_PackEntry));
+            }
+
+            // Write the (aligned) file contents.
+            for (nIndex = 0; (nIndex < nNumFiles) && (bResult); nIndex++)
+            {
+                const GS_PackEntry* pEntry = &pEntries[pnSorted[nIndex]];
+
+                if (pEntry->uOffset > lOffset)
+                {
+                    bResult = (gsPackFile.Write(Padding, pEntry->uOffset - lOffset) ==
+                               pEntry->uOffset - lOffset);
+                }
+                if ((bResult) && (pEntry->uSize > 0))
+                {
+                    bResult = (gsPackFile.Write(ppContent[pnSorted[nIndex]], pEntry->uSize) ==
+                               pEntry->uSize);
+                }
+                lOffset = pEntry->uOffset + pEntry->uSize;
+            }
+
+            if (!bResult)
+            {
+                GS_Error::Report("GS_PACK.CPP", 556, "Failed to write pack file!");
+            }
+        }
+    }
+
+    // Clean up.
+    for (nIndex = 0; nIndex < nNumFiles; nIndex++)
+    {
+        if (ppContent[nIndex] != NULL)
+        {
+            delete [] ppContent[nIndex];
+        }
+    }
+    delete [] ppContent;
+    delete [] pEntries;
+    delete [] pnSorted;
+
+    return bResult;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,125 @@
+/*============================================================================================+
+ | Game System (GS) Library                                                                   |
+ |--------------------------------------------------------------------------------------------|
+ | FILES: gs_pack.cpp, gs_pack.h                                                              |
+ |--------------------------------------------------------------------------------------------|
+ | CLASS: GS_Pack                                                                             |
+ |--------------------------------------------------------------------------------------------|
+ | ABOUT: Single file asset archive. A pack starts with a header and a table of contents      |
+ |        (name, offset, size and hash of every file, sorted by name) followed by the file    |
+ |        contents, each aligned to GS_PACK_ALIGNMENT bytes. The pack is memory mapped when   |
+ |        opened, so files are handed out as pointers into the mapping without any copying.   |
+ |--------------------------------------------------------------------------------------------|
+ |                                                                                    10/2026 |
+ +============================================================================================*/
+
+#ifndef GS_PACK_H
+#define GS_PACK_H
+
+
+//==============================================================================================
+// Include platform abstraction header files.
+// ---------------------------------------------------------------------------------------------
+#include "gs_platform.h"
+//==============================================================================================
+
+//==============================================================================================
+// Include Game System (GS) header files.
+// ---------------------------------------------------------------------------------------------
+#include "gs_error.h"
+#include "gs_file.h"
+#include "gs_object.h"
+//==============================================================================================
+
+
+//==============================================================================================
+// Pack defines.
+// ---------------------------------------------------------------------------------------------
+#define GS_PACK_MAGIC     "GSPK" // Identifies a pack file.
+#define GS_PACK_VERSION   1      // Version of the pack format.
+#define GS_PACK_ALIGNMENT 16     // Alignment of the file contents within the pack.
+#define GS_PACK_MAX_NAME  52     // Maximum length of a filename (including terminator).
+#define GS_PACK_MAX_FILES 1024   // Maximum number of files in a pack.
+//==============================================================================================
+
+
+//==============================================================================================
+// Pack structures (all values are stored little endian).
+// ---------------------------------------------------------------------------------------------
+typedef struct GS_PACK_HEADER
+{
+    char         szMagic[4];  // GS_PACK_MAGIC (not zero terminated).
+    unsigned int uVersion;    // GS_PACK_VERSION.
+    unsigned int uNumEntries; // Number of entries in the table of contents.
+    unsigned int uReserved;   // Should be 0.
+} GS_PackHeader;
+// ---------------------------------------------------------------------------------------------
+typedef struct GS_PACK_ENTRY
+{
+    char         szName[GS_PACK_MAX_NAME]; // Normalized filename (lower case, '/' separated).
+    unsigned int uOffset;                  // Offset of the file contents from start of pack.
+    unsigned int uSize;                    // Size of the file contents in bytes.
+    unsigned int uHash;                    // FNV-1a hash of the file contents.
+} GS_PackEntry;
+//==============================================================================================
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Class Definition. ///////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+class GS_Pack : public GS_Object
+{
+
+private:
+
+    GS_File m_gsFile; // The mapped pack file.
+
+    const GS_PackEntry* m_pEntries; // The table of contents (points into the mapped file).
+    int m_nNumEntries;              // Number of entries in the table of contents.
+
+    const GS_PackEntry* FindEntry(const char* pszFilename);
+
+protected:
+
+    // No protected members.
+
+public:
+
+    GS_Pack();
+    ~GS_Pack();
+
+    BOOL Open(const char* pszFilename);
+    void Close();
+    BOOL IsOpen()
+    {
+        return (m_pEntries != NULL);
+    }
+
+    int GetNumEntries()
+    {
+        return m_nNumEntries;
+    }
+    const GS_PackEntry* GetEntry(int nIndex);
+    const GS_PackEntry* GetEntry(const char* pszFilename);
+
+    BOOL Find(const char* pszFilename, const BYTE** ppData, unsigned long* plSize);
+    BOOL Verify();
+
+    static void NormalizeName(const char* pszFilename, char* pszName);
+    static unsigned int Hash(const BYTE* pData, unsigned long lSize);
+    static BOOL Build(const char* pszPackname, const char** ppszFilenames, int nNumFiles);
+};
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// The global pack searched by the image loaders and the sound system before the file system.
+// ---------------------------------------------------------------------------------------------
+extern GS_Pack g_gsPack;
+//==============================================================================================
+
+#endif
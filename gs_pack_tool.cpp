@@ -0,0 +1,102 @@
+/*============================================================================================+
+ | Game System (GS) Library                                                                   |
+ |--------------------------------------------------------------------------------------------|
+ | FILES: gs_pack_tool.cpp                                                                    |
+ |--------------------------------------------------------------------------------------------|
+ | CLASS: None                                                                                |
+ |--------------------------------------------------------------------------------------------|
+ | ABOUT: Command line tool for building and checking pack files (see GS_Pack).               |
+ |        Usage: <pack> <file> [file...]   Builds a pack from the files.                      |
+ |               -v <pack>                  Lists the files in a pack and checks their hashes. |
+ |--------------------------------------------------------------------------------------------|
+ |                                                                                    10/2026 |
+ +============================================================================================*/
+
+
+//==============================================================================================
+// Let the tool provide its own main() instead of SDL.
+// ---------------------------------------------------------------------------------------------
+#define SDL_MAIN_HANDLED
+//==============================================================================================
+
+
+//==============================================================================================
+// Include Game System (GS) header files.
+// ---------------------------------------------------------------------------------------------
+#include "gs_pack.h"
+//==============================================================================================
+
+
+//==============================================================================================
+// VerifyPack():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Lists the contents of a pack and checks every file against its hash.
+// ---------------------------------------------------------------------------------------------
+// Returns: 0 if the pack is intact, 1 if not.
+//==============================================================================================
+
+static int VerifyPack(const char* pszPackname)
+{
+
+    if (!g_gsPack.Open(pszPackname))
+    {
+        printf("Failed to open pack '%s'.\n", pszPackname);
+        return 1;
+    }
+
+    for (int nIndex = 0; nIndex < g_gsPack.GetNumEntries(); nIndex++)
+    {
+        const GS_PackEntry* pEntry = g_gsPack.GetEntry(nIndex);
+        printf("%-52s %10u %10u  %08X\n", pEntry->szName, pEntry->uOffset, pEntry->uSize,
+               pEntry->uHash);
+    }
+
+    BOOL bResult = g_gsPack.Verify();
+
+    printf("%d files, %s.\n", g_gsPack.GetNumEntries(), bResult ? "OK" : "CORRUPT");
+
+    g_gsPack.Close();
+
+    return bResult ? 0 : 1;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// main():
+// ---------------------------------------------------------------------------------------------
+// Purpose: The entry point of the pack tool.
+// ---------------------------------------------------------------------------------------------
+// Returns: 0 if successful, 1 if not.
+//==============================================================================================
+
+int main(int argc, char* argv[])
+{
+
+    if ((argc == 3) && (strcmp(argv[1], "-v") == 0))
+    {
+        return VerifyPack(argv[2]);
+    }
+
+    if (argc < 3)
+    {
+        printf("Usage: %s <pack> <file> [file...]\n", argv[0]);
+        printf("       %s -v <pack>\n", argv[0]);
+        return 1;
+    }
+
+    // Build the pack from the files (stored under their names as given).
+    if (!GS_Pack::Build(argv[1], (const char**) &argv[2], argc - 2))
+    {
+        printf("Failed to build pack '%s'.\n", argv[1]);
+        return 1;
+    }
+
+    // Check the pack that was just written.
+    return VerifyPack(argv[1]);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
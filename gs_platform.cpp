@@ -26,6 +26,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <sys/stat.h>
+#include <sys/types.h>
 #include <iostream>
 //==============================================================================================
 
@@ -35,6 +37,7 @@
 // Undefine macros before implementing the functions
 #undef MessageBox
 #undef GetCurrentDirectory
+#undef CreateDirectory
 #undef SetRect
 #undef SetCursor
 #undef SwapBuffers
@@ -256,6 +259,30 @@ void GetCurrentDirectory(int buflen, char* buffer) {
 ////////////////////////////////////////////////////////////////////////////////////////////////
 
 
+//==============================================================================================
+// GS_Platform::CreateDirectory():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Creates a directory (the security attributes of the Windows API are ignored).
+// ---------------------------------------------------------------------------------------------
+// Returns: true if the directory was created, false if failed or if it already exists.
+//==============================================================================================
+
+bool CreateDirectory(const char* path, void* attributes) {
+    (void)attributes; // Unused parameter
+    if (!path) return false;
+
+    char normalized[_MAX_PATH];
+    strncpy(normalized, path, _MAX_PATH - 1);
+    normalized[_MAX_PATH - 1] = '\0';
+    NormalizePath(normalized);
+
+    return (mkdir(normalized, 0755) == 0);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
 //==============================================================================================
 // GS_Platform::NormalizePath():
 // ---------------------------------------------------------------------------------------------
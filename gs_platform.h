@@ -244,6 +244,7 @@ namespace GS_Platform {
     void OutputDebugString(const char* message);
     int MessageBox(void* hwnd, const char* text, const char* caption, unsigned int type);
     void GetCurrentDirectory(int buflen, char* buffer);
+    bool CreateDirectory(const char* path, void* attributes);
     
     // Path normalization for cross-platform compatibility
     void NormalizePath(char* path);
@@ -259,6 +260,7 @@ namespace GS_Platform {
     // Wrap Windows API calls to use GS_Platform namespace
     #define MessageBox(hwnd, text, caption, type) GS_Platform::MessageBox(hwnd, text, caption, type)
     #define GetCurrentDirectory(buflen, buffer) GS_Platform::GetCurrentDirectory(buflen, buffer)
+    #define CreateDirectory(path, attributes) GS_Platform::CreateDirectory(path, attributes)
     #define SetRect(rect, l, t, r, b) GS_Platform::SetRect(rect, l, t, r, b)
     #define SetCursor(cursor) SDL_ShowCursor((cursor) ? SDL_ENABLE : SDL_DISABLE)
     
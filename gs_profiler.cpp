@@ -0,0 +1,448 @@
+/*============================================================================================+
+ | Game System (GS) Library                                                                   |
+ |--------------------------------------------------------------------------------------------|
+ | FILES: gs_profiler.cpp, gs_profiler.h                                                      |
+ |--------------------------------------------------------------------------------------------|
+ | CLASS: GS_Profiler, GS_ProfileScope                                                        |
+ |--------------------------------------------------------------------------------------------|
+ | ABOUT: Lightweight hierarchical frame profiler. Named sections are recorded into a ring    |
+ |        buffer of frames so the time spent in each part of a frame can be shown on screen  |
+ |        or exported as a Chrome trace-event (about:tracing) JSON file.                      |
+ |--------------------------------------------------------------------------------------------|
+ |                                                                                    10/2026 |
+ +============================================================================================*/
+
+
+//==============================================================================================
+// Include Game System (GS) header files.
+// ---------------------------------------------------------------------------------------------
+#include "gs_profiler.h"
+//==============================================================================================
+
+
+//==============================================================================================
+// Global variables.
+// ---------------------------------------------------------------------------------------------
+GS_Profiler g_gsProfiler;
+//==============================================================================================
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Constructor/Destructor Methods //////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Profiler::GS_Profiler():
+// ---------------------------------------------------------------------------------------------
+// Purpose: The constructor, initializes class data when class object is created.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+GS_Profiler::GS_Profiler()
+{
+#ifdef GS_PLATFORM_WINDOWS
+    // Get the frequency and current count of the performance counter.
+    if (!QueryPerformanceFrequency((LARGE_INTEGER*) &m_n64PerfFreq))
+    {
+        m_n64PerfFreq = 0;
+    }
+    QueryPerformanceCounter((LARGE_INTEGER*) &m_n64StartCount);
+#else
+    // Get the frequency and current count of the performance counter.
+    m_n64PerfFreq   = SDL_GetPerformanceFrequency();
+    m_n64StartCount = SDL_GetPerformanceCounter();
+#endif
+
+    m_bIsEnabled = FALSE;
+
+    m_nCurrentFrame   = 0;
+    m_nFramesRecorded = 0;
+
+    m_nDepth = 0;
+
+    ZeroMemory(&m_Frames, sizeof(m_Frames));
+    ZeroMemory(&m_nOpenSections, sizeof(m_nOpenSections));
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Profiler::~GS_Profiler():
+// ---------------------------------------------------------------------------------------------
+// Purpose: The destructor, de-initializes class data when class object is destroyed.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+GS_Profiler::~GS_Profiler()
+{
+    // Does nothing.
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Enable/Time Methods /////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Profiler::Enable():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Starts or stops recording of profiling sections. Any frames recorded previously are
+//          discarded when recording is started, so the ring buffer only ever holds frames from
+//          a single continuous recording.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_Profiler::Enable(BOOL bEnable)
+{
+    // Are we starting a new recording?
+    if (bEnable && !m_bIsEnabled)
+    {
+        m_nCurrentFrame   = 0;
+        m_nFramesRecorded = 0;
+        this->BeginRecording();
+    }
+
+    // Forget about open sections, their matching EndSection() calls will be ignored.
+    m_nDepth = 0;
+
+    m_bIsEnabled = bEnable;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Profiler::GetTime():
+// ---------------------------------------------------------------------------------------------
+// Purpose: ...
+// ---------------------------------------------------------------------------------------------
+// Returns: The time in milliseconds since the profiler was created.
+//==============================================================================================
+
+double GS_Profiler::GetTime()
+{
+#ifdef GS_PLATFORM_WINDOWS
+    __int64 n64CurrentCount;
+
+    // Use the multi-media timer if there is no performance counter.
+    if (m_n64PerfFreq == 0)
+    {
+        return (double) timeGetTime();
+    }
+
+    QueryPerformanceCounter((LARGE_INTEGER*) &n64CurrentCount);
+#else
+    Uint64 n64CurrentCount = SDL_GetPerformanceCounter();
+#endif
+
+    // Calculate the time elapsed in milliseconds.
+    return (double(n64CurrentCount - m_n64StartCount) * 1000.0) / double(m_n64PerfFreq);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Recording Methods ///////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Profiler::BeginRecording():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Prepares the current slot of the ring buffer for recording a new frame.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_Profiler::BeginRecording()
+{
+    GS_ProfileFrame* pFrame = &m_Frames[m_nCurrentFrame];
+
+    pFrame->dStartTime   = this->GetTime();
+    pFrame->dDuration    = 0.0;
+    pFrame->nNumSections = 0;
+
+    m_nDepth = 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Profiler::MarkFrame():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Completes the frame currently being recorded and starts recording the next one.
+//          Should be called once at the start of every frame.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_Profiler::MarkFrame()
+{
+    if (!m_bIsEnabled)
+    {
+        return;
+    }
+
+    GS_ProfileFrame* pFrame = &m_Frames[m_nCurrentFrame];
+
+    // Complete the current frame.
+    pFrame->dDuration = this->GetTime() - pFrame->dStartTime;
+
+    // Move on to the next slot in the ring buffer, overwriting the oldest frame if full.
+    m_nCurrentFrame = (m_nCurrentFrame + 1) % GS_PROFILER_MAX_FRAMES;
+    if (m_nFramesRecorded < GS_PROFILER_MAX_FRAMES)
+    {
+        m_nFramesRecorded++;
+    }
+
+    this->BeginRecording();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Profiler::BeginSection():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Starts timing a named section. Sections may be nested and every call must be
+//          matched by a call to EndSection(), use GS_PROFILE_SCOPE() to do this automatically.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_Profiler::BeginSection(const char* pszName)
+{
+    if ((!m_bIsEnabled) || (m_nDepth >= GS_PROFILER_MAX_DEPTH))
+    {
+        return;
+    }
+
+    GS_ProfileFrame* pFrame = &m_Frames[m_nCurrentFrame];
+
+    // Is there still room in the frame for another section?
+    if (pFrame->nNumSections < GS_PROFILER_MAX_SECTIONS)
+    {
+        GS_ProfileSection* pSection = &pFrame->Sections[pFrame->nNumSections];
+        pSection->pszName    = pszName;
+        pSection->nDepth     = m_nDepth;
+        pSection->dStartTime = this->GetTime();
+        pSection->dDuration  = 0.0;
+        m_nOpenSections[m_nDepth] = pFrame->nNumSections;
+        pFrame->nNumSections++;
+    }
+    else
+    {
+        // Keep the nesting balanced even though the section is not recorded.
+        m_nOpenSections[m_nDepth] = -1;
+    }
+
+    m_nDepth++;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Profiler::EndSection():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Stops timing the most recently started section.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_Profiler::EndSection()
+{
+    if ((!m_bIsEnabled) || (m_nDepth <= 0))
+    {
+        return;
+    }
+
+    m_nDepth--;
+
+    int nSection = m_nOpenSections[m_nDepth];
+
+    if (nSection >= 0)
+    {
+        GS_ProfileSection* pSection = &m_Frames[m_nCurrentFrame].Sections[nSection];
+        pSection->dDuration = this->GetTime() - pSection->dStartTime;
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Query Methods ///////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Profiler::GetFrame():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Gets a completed frame from the ring buffer, 0 being the most recent one.
+// ---------------------------------------------------------------------------------------------
+// Returns: A pointer to the frame, or NULL if no such frame has been recorded.
+//==============================================================================================
+
+const GS_ProfileFrame* GS_Profiler::GetFrame(int nFramesAgo)
+{
+    if ((nFramesAgo < 0) || (nFramesAgo >= m_nFramesRecorded))
+    {
+        return NULL;
+    }
+
+    int nIndex = (m_nCurrentFrame - 1 - nFramesAgo + GS_PROFILER_MAX_FRAMES) %
+                 GS_PROFILER_MAX_FRAMES;
+
+    return &m_Frames[nIndex];
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Profiler::GetAverageFrameTime():
+// ---------------------------------------------------------------------------------------------
+// Purpose: ...
+// ---------------------------------------------------------------------------------------------
+// Returns: The average length in milliseconds of the frames in the ring buffer.
+//==============================================================================================
+
+double GS_Profiler::GetAverageFrameTime()
+{
+    if (m_nFramesRecorded <= 0)
+    {
+        return 0.0;
+    }
+
+    double dTotal = 0.0;
+
+    for (int nFrame = 0; nFrame < m_nFramesRecorded; nFrame++)
+    {
+        dTotal += this->GetFrame(nFrame)->dDuration;
+    }
+
+    return (dTotal / m_nFramesRecorded);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Profiler::GetAverageSectionTime():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Determines how much time per frame was spent in all sections with the given name.
+// ---------------------------------------------------------------------------------------------
+// Returns: The average time per frame in milliseconds over the frames in the ring buffer.
+//==============================================================================================
+
+double GS_Profiler::GetAverageSectionTime(const char* pszName)
+{
+    if ((m_nFramesRecorded <= 0) || (!pszName))
+    {
+        return 0.0;
+    }
+
+    double dTotal = 0.0;
+
+    for (int nFrame = 0; nFrame < m_nFramesRecorded; nFrame++)
+    {
+        const GS_ProfileFrame* pFrame = this->GetFrame(nFrame);
+
+        for (int nSection = 0; nSection < pFrame->nNumSections; nSection++)
+        {
+            const GS_ProfileSection* pSection = &pFrame->Sections[nSection];
+
+            if ((pSection->pszName == pszName) || (strcmp(pSection->pszName, pszName) == 0))
+            {
+                dTotal += pSection->dDuration;
+            }
+        }
+    }
+
+    return (dTotal / m_nFramesRecorded);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Export Methods //////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_Profiler::ExportTrace():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Writes the frames in the ring buffer, oldest first, to a file in the Chrome
+//          trace-event format. The file can be opened with chrome://tracing or Perfetto.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successfull, FALSE if not.
+//==============================================================================================
+
+BOOL GS_Profiler::ExportTrace(const char* pszFilename)
+{
+    GS_File gsFile;
+
+    if (!gsFile.Open(pszFilename, FILE_WRITE))
+    {
+        GS_Error::Report("GS_PROFILER.CPP", 410, "Failed to create trace file!");
+        return FALSE;
+    }
+
+    gsFile.WriteString("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+    BOOL bIsFirstEvent = TRUE;
+
+    // Timestamps and durations are written in microseconds as required by the format.
+    for (int nFrame = m_nFramesRecorded - 1; nFrame >= 0; nFrame--)
+    {
+        const GS_ProfileFrame* pFrame = this->GetFrame(nFrame);
+
+        gsFile.WriteString("%s{\"name\":\"FRAME\",\"cat\":\"frame\",\"ph\":\"X\","
+                           "\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":1}",
+                           bIsFirstEvent ? "" : ",\n",
+                           pFrame->dStartTime * 1000.0, pFrame->dDuration * 1000.0);
+        bIsFirstEvent = FALSE;
+
+        for (int nSection = 0; nSection < pFrame->nNumSections; nSection++)
+        {
+            const GS_ProfileSection* pSection = &pFrame->Sections[nSection];
+
+            gsFile.WriteString(",\n{\"name\":\"%s\",\"cat\":\"section\",\"ph\":\"X\","
+                               "\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":1}",
+                               pSection->pszName, pSection->dStartTime * 1000.0,
+                               pSection->dDuration * 1000.0);
+        }
+    }
+
+    gsFile.WriteString("\n]}\n");
+
+    gsFile.Close();
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
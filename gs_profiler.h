@@ -0,0 +1,177 @@
+/*============================================================================================+
+ | Game System (GS) Library                                                                   |
+ |--------------------------------------------------------------------------------------------|
+ | FILES: gs_profiler.cpp, gs_profiler.h                                                      |
+ |--------------------------------------------------------------------------------------------|
+ | CLASS: GS_Profiler, GS_ProfileScope                                                        |
+ |--------------------------------------------------------------------------------------------|
+ | ABOUT: Lightweight hierarchical frame profiler. Named sections are recorded into a ring    |
+ |        buffer of frames so the time spent in each part of a frame can be shown on screen  |
+ |        or exported as a Chrome trace-event (about:tracing) JSON file.                      |
+ |--------------------------------------------------------------------------------------------|
+ |                                                                                    10/2026 |
+ +============================================================================================*/
+
+#ifndef GS_PROFILER_H
+#define GS_PROFILER_H
+
+
+//==============================================================================================
+// Include platform abstraction header files.
+// ---------------------------------------------------------------------------------------------
+#include "gs_platform.h"
+//==============================================================================================
+
+#ifdef GS_PLATFORM_WINDOWS
+//==============================================================================================
+// Include Windows header files.
+// ---------------------------------------------------------------------------------------------
+#include <mmsystem.h>
+//==============================================================================================
+#endif
+
+//==============================================================================================
+// Include Game System (GS) header files.
+// ---------------------------------------------------------------------------------------------
+#include "gs_error.h"
+#include "gs_file.h"
+#include "gs_object.h"
+//==============================================================================================
+
+
+//==============================================================================================
+// Profiler defines.
+// ---------------------------------------------------------------------------------------------
+#define GS_PROFILER_MAX_FRAMES   120 // Number of completed frames kept in the ring buffer.
+#define GS_PROFILER_MAX_SECTIONS 64  // Maximum number of sections recorded per frame.
+#define GS_PROFILER_MAX_DEPTH    16  // Maximum nesting depth of sections.
+//==============================================================================================
+
+
+//==============================================================================================
+// Profiler structures.
+// ---------------------------------------------------------------------------------------------
+typedef struct GS_PROFILE_SECTION
+{
+    const char* pszName;    // Name of the section (must point to a string that stays valid).
+    int         nDepth;     // Nesting depth of the section (0 is top level).
+    double      dStartTime; // Start time in milliseconds since the profiler was created.
+    double      dDuration;  // Time spent in the section in milliseconds.
+} GS_ProfileSection;
+// ---------------------------------------------------------------------------------------------
+typedef struct GS_PROFILE_FRAME
+{
+    double dStartTime;  // Start time in milliseconds since the profiler was created.
+    double dDuration;   // Length of the frame in milliseconds.
+    int    nNumSections; // Number of sections recorded during the frame.
+    GS_ProfileSection Sections[GS_PROFILER_MAX_SECTIONS];
+} GS_ProfileFrame;
+//==============================================================================================
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Class Definition. ///////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+class GS_Profiler : public GS_Object
+{
+
+private:
+
+#ifdef GS_PLATFORM_WINDOWS
+    __int64 m_n64PerfFreq;   // The frequency (counts per second) of the performance counter.
+    __int64 m_n64StartCount; // The count of the performance counter when the profiler started.
+#else
+    Uint64  m_n64PerfFreq;   // The frequency (counts per second) of the performance counter.
+    Uint64  m_n64StartCount; // The count of the performance counter when the profiler started.
+#endif
+
+    BOOL m_bIsEnabled; // Wether sections are being recorded or not.
+
+    GS_ProfileFrame m_Frames[GS_PROFILER_MAX_FRAMES]; // Ring buffer of recorded frames.
+    int m_nCurrentFrame;   // Index of the frame currently being recorded.
+    int m_nFramesRecorded; // Number of completed frames in the ring buffer.
+
+    int m_nOpenSections[GS_PROFILER_MAX_DEPTH]; // Indices of the sections not yet ended.
+    int m_nDepth;                               // Current nesting depth.
+
+    void BeginRecording();
+
+protected:
+
+    // No protected members.
+
+public:
+
+    GS_Profiler();
+    ~GS_Profiler();
+
+    void Enable(BOOL bEnable = TRUE);
+    BOOL IsEnabled()
+    {
+        return m_bIsEnabled;
+    }
+
+    double GetTime();
+
+    void MarkFrame();
+    void BeginSection(const char* pszName);
+    void EndSection();
+
+    int GetFrameCount()
+    {
+        return m_nFramesRecorded;
+    }
+    const GS_ProfileFrame* GetFrame(int nFramesAgo = 0);
+
+    double GetAverageFrameTime();
+    double GetAverageSectionTime(const char* pszName);
+
+    BOOL ExportTrace(const char* pszFilename);
+};
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// The global profiler used by the profiling macros below.
+// ---------------------------------------------------------------------------------------------
+extern GS_Profiler g_gsProfiler;
+//==============================================================================================
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Class Definition. ///////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+class GS_ProfileScope
+{
+
+public:
+
+    GS_ProfileScope(const char* pszName)
+    {
+        g_gsProfiler.BeginSection(pszName);
+    }
+    ~GS_ProfileScope()
+    {
+        g_gsProfiler.EndSection();
+    }
+};
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// Macro for profiling the remainder of the current scope as a named section.
+// ---------------------------------------------------------------------------------------------
+#define GS_PROFILE_JOIN2(a, b) a##b
+#define GS_PROFILE_JOIN(a, b)  GS_PROFILE_JOIN2(a, b)
+#define GS_PROFILE_SCOPE(name) GS_ProfileScope GS_PROFILE_JOIN(gsProfileScope, __LINE__)(name)
+//==============================================================================================
+
+#endif
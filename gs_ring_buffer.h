@@ -0,0 +1,285 @@
+/*============================================================================================+
+ | Game System (GS) Library                                                                   |
+ |--------------------------------------------------------------------------------------------|
+ | FILES: gs_ring_buffer.h                                                                    |
+ |--------------------------------------------------------------------------------------------|
+ | CLASS: GS_RingBuffer                                                                       |
+ |--------------------------------------------------------------------------------------------|
+ | ABOUT: A lock-free ring buffer class template for handing items of just about any data     |
+ |        type from one thread to another. Exactly one thread may push items and exactly one  |
+ |        (other) thread may pop them, neither of them ever waits for the other.              |
+ |--------------------------------------------------------------------------------------------|
+ |                                                                                    10/2026 |
+ +============================================================================================*/
+
+
+#ifndef GS_RING_BUFFER_H
+#define GS_RING_BUFFER_H
+
+
+//==============================================================================================
+// Include platform abstraction header files.
+// ---------------------------------------------------------------------------------------------
+#include "gs_platform.h"
+//==============================================================================================
+
+
+//==============================================================================================
+// Include SDL2 header files.
+// ---------------------------------------------------------------------------------------------
+#include <SDL2/SDL.h>
+//==============================================================================================
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Class Definition ////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+template<class type>
+class GS_RingBuffer
+{
+
+private:
+
+    type* m_ptArray; // The items, the number of them is a power of two.
+    int   m_nMask;   // Number of items in the array minus one.
+
+    SDL_atomic_t m_nWrite;       // Number of items pushed so far (changed by the pushing
+                                 // thread only).
+    char         m_cPadding[60]; // Keeps the two positions on separate cache lines.
+    SDL_atomic_t m_nRead;        // Number of items popped so far (changed by the popping
+                                 // thread only).
+
+public:
+
+    GS_RingBuffer(int nSize);
+    virtual ~GS_RingBuffer();
+
+    BOOL Push(const type& tData);
+    BOOL Pop(type* ptData);
+
+    inline int GetNumItems();
+    inline int GetSize();
+    inline BOOL IsEmpty();
+
+    void Clear();
+};
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Constructor/Destructor Methods. /////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_RingBuffer::GS_RingBuffer():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Allocates room for at least the given number of items (rounded up to a power of
+//          two, so positions wrap around with a mask).
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+template<class type>
+GS_RingBuffer<type>::GS_RingBuffer(int nSize)
+{
+
+    int nNumToAllocate = 2;
+
+    while (nNumToAllocate < nSize)
+    {
+        nNumToAllocate *= 2;
+    }
+
+    m_ptArray = new type[nNumToAllocate];
+    m_nMask   = nNumToAllocate - 1;
+
+    SDL_AtomicSet(&m_nWrite, 0);
+    SDL_AtomicSet(&m_nRead, 0);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_RingBuffer::~GS_RingBuffer():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Frees the items.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+template<class type>
+GS_RingBuffer<type>::~GS_RingBuffer()
+{
+
+    delete [] m_ptArray;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Push/Pop Methods. ///////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_RingBuffer::Push():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Adds an item to the end of the buffer, may only be called by the pushing thread.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if the buffer is full.
+//==============================================================================================
+
+template<class type>
+BOOL GS_RingBuffer<type>::Push(const type& tData)
+{
+
+    int nWrite = SDL_AtomicGet(&m_nWrite);
+    int nRead  = SDL_AtomicGet(&m_nRead);
+
+    // Is there room for another item?
+    if ((Uint32) nWrite - (Uint32) nRead > (Uint32) m_nMask)
+    {
+        return FALSE;
+    }
+
+    m_ptArray[nWrite & m_nMask] = tData;
+
+    // Publish the item only once it has been written.
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicSet(&m_nWrite, (int) ((Uint32) nWrite + 1));
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_RingBuffer::Pop():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Removes the item at the front of the buffer, may only be called by the popping
+//          thread.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if an item was removed, FALSE if the buffer is empty.
+//==============================================================================================
+
+template<class type>
+BOOL GS_RingBuffer<type>::Pop(type* ptData)
+{
+
+    int nRead  = SDL_AtomicGet(&m_nRead);
+    int nWrite = SDL_AtomicGet(&m_nWrite);
+
+    if (nRead == nWrite)
+    {
+        return FALSE;
+    }
+
+    // Don't read the item before it has been published.
+    SDL_MemoryBarrierAcquire();
+    *ptData = m_ptArray[nRead & m_nMask];
+
+    // Hand the room back to the pushing thread once the item has been read.
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicSet(&m_nRead, (int) ((Uint32) nRead + 1));
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Status Methods. /////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_RingBuffer::GetNumItems():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Counts the items in the buffer (exact for the popping thread, a lower bound of the
+//          room left for the pushing thread).
+// ---------------------------------------------------------------------------------------------
+// Returns: The number of items in the buffer.
+//==============================================================================================
+
+template<class type>
+inline int GS_RingBuffer<type>::GetNumItems()
+{
+
+    return (int) ((Uint32) SDL_AtomicGet(&m_nWrite) - (Uint32) SDL_AtomicGet(&m_nRead));
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_RingBuffer::GetSize():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Gets how many items the buffer holds at most.
+// ---------------------------------------------------------------------------------------------
+// Returns: The size of the buffer in items.
+//==============================================================================================
+
+template<class type>
+inline int GS_RingBuffer<type>::GetSize()
+{
+
+    return m_nMask + 1;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_RingBuffer::IsEmpty():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Checks if there are no items in the buffer.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if buffer is empty, FALSE if not.
+//==============================================================================================
+
+template<class type>
+inline BOOL GS_RingBuffer<type>::IsEmpty()
+{
+
+    return (SDL_AtomicGet(&m_nWrite) == SDL_AtomicGet(&m_nRead));
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_RingBuffer::Clear():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Removes all items, may only be called while neither thread is using the buffer.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+template<class type>
+void GS_RingBuffer<type>::Clear()
+{
+
+    SDL_AtomicSet(&m_nWrite, 0);
+    SDL_AtomicSet(&m_nRead, 0);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+#endif
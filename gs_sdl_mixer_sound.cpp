@@ -20,6 +20,26 @@
 // Include Game System (GS) header files.
 // ---------------------------------------------------------------------------------------------
 #include "gs_sdl_mixer_sound.h"
+#include "gs_asset_loader.h"
+#include "gs_math.h"
+//==============================================================================================
+
+
+//==============================================================================================
+// Include standard C library header files.
+// ---------------------------------------------------------------------------------------------
+#include <stdio.h>
+//==============================================================================================
+
+
+//==============================================================================================
+// Global variables.
+// ---------------------------------------------------------------------------------------------
+static char g_szCacheDirectory[_MAX_PATH] = GS_SAMPLECACHE_DIRECTORY; // Empty if cache disabled.
+
+static GS_SDLMixerSound* g_pMixerSound = NULL; // The sound object the device is open for (the
+                                               // channel and music finished callbacks of
+                                               // SDL_mixer have no user data).
 //==============================================================================================
 
 
@@ -36,15 +56,49 @@
 // Returns: Nothing.
 //==============================================================================================
 
-GS_SDLMixerSound::GS_SDLMixerSound() {
+GS_SDLMixerSound::GS_SDLMixerSound() : m_gsDecodeQueue(GS_MUSIC_QUEUE_SIZE),
+                                       m_gsCommands(GS_AUDIO_QUEUE_SIZE),
+                                       m_gsVoices(GS_AUDIO_MAX_VOICES, GS_AUDIO_MAX_VOICES) {
 
     m_bIsReady  = FALSE;
     m_bIsPaused = FALSE;
 
+    m_pDecoderThread = NULL;
+    m_pDecoderSignal = NULL;
+    m_pDecoderLock   = NULL;
+    SDL_AtomicSet(&m_nDecoderQuit, 0);
+
+    m_nPendingLoads = 0;
+    m_nReopenFrames = 0;
+
     m_nMasterVolume = 128;
 
-    m_nCurrentMusic  = -1;
-    m_nCurrentStream = -1;
+    m_nCurrentMusic   = -1;
+    m_nCurrentStream  = -1;
+    m_bMusicLoop      = FALSE;
+    m_nMusicVolume    = 255;
+    m_nMusicCrossfade = 0;
+
+    m_uMusicSerial = 0;
+    SDL_AtomicSet(&m_nMusicActive, 0);
+
+    for (int nLoop = 0; nLoop <= GS_MUSIC_CHANNELS; nLoop++) {
+        m_uMixMusicSerial[nLoop] = 0;
+    }
+    m_nMixMusicChannel = GS_MUSIC_CHANNEL;
+    m_nMixCrossfade    = 0;
+
+    for (int nLoop = 0; nLoop < GS_AUDIO_MAX_VOICES; nLoop++) {
+        m_Voices[nLoop].uMixSerial = 0;
+        SDL_AtomicSet(&m_Voices[nLoop].nPanGains, 0);
+        SDL_AtomicSet(&m_Voices[nLoop].nPanned, 0);
+    }
+    m_nSampleMaster = 255;
+
+    m_nBufferFrames = GS_AUDIO_DEFAULT_FRAMES;
+    m_nFrequency    = 0;
+    m_uFormat       = MIX_DEFAULT_FORMAT;
+    m_nChannels     = 2;
 }
 
 
@@ -79,8 +133,9 @@ GS_SDLMixerSound::~GS_SDLMixerSound() {
 //==============================================================================================
 // GS_SDLMixerSound::Initialize():
 // ---------------------------------------------------------------------------------------------
-// Purpose: Initializes the SDL_mixer audio system with default settings (44.1kHz, stereo,
-//          2048 byte buffer). Allocates 64 mixing channels for simultaneous sound effects.
+// Purpose: Initializes the SDL_mixer audio system at the native sample rate of the device
+//          (so nothing is resampled while mixing), in stereo and with the buffer size set with
+//          SetBufferSize(). Allocates 64 mixing channels for simultaneous sound effects.
 // ---------------------------------------------------------------------------------------------
 // Returns: TRUE if successful, FALSE if not.
 //==============================================================================================
@@ -109,14 +164,15 @@ BOOL GS_SDLMixerSound::Initialize(HWND hWnd, BOOL bNoSound) {
         }
     }
     
-    // Open the audio device with CD quality (44.1kHz, stereo, 2048 byte chunks).
-    if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) < 0) {
+    // Open the audio device, letting it pick its own sample rate (44.1kHz is only a hint).
+    if (!this->OpenDevice(MIX_DEFAULT_FREQUENCY, MIX_DEFAULT_FORMAT, 2, m_nBufferFrames,
+                          SDL_AUDIO_ALLOW_FREQUENCY_CHANGE)) {
         GS_Error::Report("GS_SDL_MIXER_SOUND.CPP", 95, "Failed to initialize SDL_mixer!");
         return FALSE;
     }
-    
-    // Allocate 64 mixing channels for simultaneous sound effect playback.
-    Mix_AllocateChannels(64);
+
+    // Music is decoded in the background (it streams until then).
+    this->StartDecoder();
 
     m_bIsReady = TRUE;
 
@@ -143,30 +199,45 @@ BOOL GS_SDLMixerSound::Shutdown() {
         return FALSE;
     }
     
-    // Stop all playback.
-    this->StopAllMusic();
-    this->StopStream();
-    
+    // Stop decoding music.
+    this->StopDecoder();
+
+    // Close the audio device (if sound was enabled) first, commands still queued may refer to
+    // the music and samples.
+    if (m_nFrequency > 0) {
+        Mix_SetPostMix(NULL, NULL);
+        Mix_ChannelFinished(NULL);
+        Mix_HookMusicFinished(NULL);
+        Mix_CloseAudio();
+        g_pMixerSound = NULL;
+    }
+
+    m_gsCommands.Clear();
+
     // Free all loaded music tracks.
     for (int nLoop = 0; nLoop < m_gsMusicList.GetNumItems(); nLoop++) {
-        Mix_FreeMusic(m_gsMusicList[nLoop]);
+        FreeTrack(m_gsMusicList[nLoop]);
     }
     m_gsMusicList.RemoveAllItems();
-    
+
     // Free all loaded audio streams.
     for (int nLoop = 0; nLoop < m_gsStreamList.GetNumItems(); nLoop++) {
-        Mix_FreeMusic(m_gsStreamList[nLoop]);
+        FreeTrack(m_gsStreamList[nLoop]);
     }
     m_gsStreamList.RemoveAllItems();
     
     // Free all loaded sound samples.
     for (int nLoop = 0; nLoop < m_gsSampleList.GetNumItems(); nLoop++) {
-        Mix_FreeChunk(m_gsSampleList[nLoop]);
+        Mix_FreeChunk(m_gsSampleList[nLoop].pChunk);
+        SDL_free(m_gsSampleList[nLoop].pszLoad);
     }
     m_gsSampleList.RemoveAllItems();
-    
-    // Close the audio device.
-    Mix_CloseAudio();
+
+    m_gsNewTracks.RemoveAllItems();
+    m_nPendingLoads = 0;
+    m_nReopenFrames = 0;
+
+    m_nFrequency = 0;
 
     m_bIsReady  = FALSE;
     m_bIsPaused = FALSE;
@@ -174,6 +245,9 @@ BOOL GS_SDLMixerSound::Shutdown() {
     m_nCurrentMusic  = -1;
     m_nCurrentStream = -1;
 
+    SDL_AtomicSet(&m_nMusicActive, 0);
+    m_gsVoices.Reset();
+
     return TRUE;
 }
 
@@ -201,18 +275,9 @@ void GS_SDLMixerSound::Pause(BOOL bPause) {
         return;
     }
     
-    // Should audio be paused?
-    if (bPause) {
-        // Pause music playback.
-        Mix_PauseMusic();
-        // Pause all sound effect channels.
-        Mix_Pause(-1);
-    }
-    else {
-        // Resume music playback.
-        Mix_ResumeMusic();
-        // Resume all sound effect channels.
-        Mix_Resume(-1);
+    // The audio thread pauses or resumes the music and all sound effect channels.
+    if ((m_nFrequency > 0) && !this->SendCommand(GS_SOUND_PAUSE, -1, bPause)) {
+        return;
     }
 
     m_bIsPaused = bPause;
@@ -263,55 +328,89 @@ void GS_SDLMixerSound::SetMasterVolume(int nVolume) {
 
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
-// Music Methods ///////////////////////////////////////////////////////////////////////////////
+// Latency Methods /////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////
 
 
 //==============================================================================================
-// GS_SDLMixerSound::AddMusic():
-// ---------------------------------------------------------------------------------------------
-// Purpose: Loads a music file and adds it to the music list. Supports MP3, OGG, WAV, FLAC,
-//          MOD, XM, IT, and other formats supported by SDL_mixer.
+// GS_SDLMixerSound::SetBufferSize():
 // ---------------------------------------------------------------------------------------------
-// Notes: MIDI files may not be supported on Apple platforms due to missing native support
-//        in SDL_mixer. Consider converting MIDI files to OGG or MP3 for better compatibility.
+// Purpose: Sets the size of the device buffer in sample frames (GS_AUDIO_MIN_FRAMES to
+//          GS_AUDIO_MAX_FRAMES, 0 for GS_AUDIO_DEFAULT_FRAMES). Smaller buffers are heard
+//          sooner, GS_AUDIO_LOW_FRAMES is about 12 ms. If sound is already initialized the
+//          device is reopened with the new size.
 // ---------------------------------------------------------------------------------------------
-// Returns: TRUE if successful, FALSE if not.
+// Returns: Nothing.
 //==============================================================================================
 
-BOOL GS_SDLMixerSound::AddMusic(const char* pszFilename) {
+void GS_SDLMixerSound::SetBufferSize(int nFrames) {
 
-    // Exit if sound not initialized.
-    if (!m_bIsReady) {
-        return FALSE;
+    if (nFrames <= 0) {
+        nFrames = GS_AUDIO_DEFAULT_FRAMES;
     }
 
-    // Check if file is a MIDI file on Apple platforms.
-#if defined(__APPLE__)
-    const char* pExt = strrchr(pszFilename, '.');
-    if (pExt && (strcasecmp(pExt, ".mid") == 0 || strcasecmp(pExt, ".midi") == 0)) {
-        GS_Error::Report("GS_SDL_MIXER_SOUND.CPP", 267, "MIDI files are not supported on Apple platforms. Please convert to OGG or MP3.");
-        return FALSE;
+    // Make sure the size is within range.
+    if (nFrames < GS_AUDIO_MIN_FRAMES) {
+        nFrames = GS_AUDIO_MIN_FRAMES;
+    }
+    if (nFrames > GS_AUDIO_MAX_FRAMES) {
+        nFrames = GS_AUDIO_MAX_FRAMES;
     }
-#endif
 
-    Mix_Music* pMusic;
+    // Reopen the device if sound is already playing with another size (by the next Update()
+    // if the decoder thread is busy).
+    if ((m_nFrequency > 0) && (nFrames != m_nBufferFrames)) {
+        m_nReopenFrames = nFrames;
+        this->LoadPending();
+        return;
+    }
 
-    // Load the specified music file.
-    pMusic = Mix_LoadMUS(pszFilename);
+    m_nBufferFrames = nFrames;
+}
 
-    // Was the music loaded successfully?
-    if (!pMusic) {
-        char szError[512];
-        sprintf(szError, "Failed to load music file '%s': %s", pszFilename, Mix_GetError());
-        GS_Error::Report("GS_SDL_MIXER_SOUND.CPP", 267, szError);
-        return FALSE;
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLMixerSound::Update():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Checks for underruns, should be called once every frame. When the audio thread
+//          has not been able to keep up with the device AUDIO_MAX_UNDERRUNS times within
+//          AUDIO_UNDERRUN_WINDOW milliseconds, the device is reopened with a buffer twice the
+//          size (up to GS_AUDIO_MAX_FRAMES). Also hands the tracks added since the last frame
+//          to the decoder thread, so all tracks added in one frame are opened before it starts
+//          decoding and none of them waits for it.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_SDLMixerSound::Update() {
+
+    // Exit if sound not initialized or disabled.
+    if (!m_bIsReady || m_nFrequency == 0) {
+        return;
     }
 
-    // Add the music to the list.
-    m_gsMusicList.AddItem(pMusic);
+    if ((m_nReopenFrames == 0) && m_gsStats.HasUnderrunBurst() &&
+        (m_nBufferFrames < GS_AUDIO_MAX_FRAMES)) {
+        char szMessage[128];
+        sprintf(szMessage, "Audio underruns with %d frame buffers, switching to %d frames\n",
+                m_nBufferFrames, m_nBufferFrames * 2);
+        GS_Platform::OutputDebugString(szMessage);
 
-    return TRUE;
+        m_nReopenFrames = m_nBufferFrames * 2;
+    }
+
+    this->LoadPending();
+
+    // A track streams if there is no room to queue it.
+    for (int nLoop = 0; nLoop < m_gsNewTracks.GetNumItems(); nLoop++) {
+        if (m_gsDecodeQueue.Push(m_gsNewTracks[nLoop])) {
+            SDL_SemPost(m_pDecoderSignal);
+        }
+    }
+    m_gsNewTracks.RemoveAllItems();
 }
 
 
@@ -319,46 +418,56 @@ BOOL GS_SDLMixerSound::AddMusic(const char* pszFilename) {
 
 
 //==============================================================================================
-// GS_SDLMixerSound::PlayMusic():
+// GS_SDLMixerSound::OpenDevice():
 // ---------------------------------------------------------------------------------------------
-// Purpose: Plays a loaded music track with optional volume and loop settings.
-// ---------------------------------------------------------------------------------------------
-// Notes: The fSpeed parameter is ignored as SDL_mixer doesn't support playback speed changes
-//        without additional processing.
+// Purpose: Opens the audio device, remembers the format it was actually opened with and
+//          starts watching the mixing for underruns.
 // ---------------------------------------------------------------------------------------------
 // Returns: TRUE if successful, FALSE if not.
 //==============================================================================================
 
-BOOL GS_SDLMixerSound::PlayMusic(int nIndex, int nVolume, float fSpeed, BOOL bLoop) {
+BOOL GS_SDLMixerSound::OpenDevice(int nFrequency, Uint16 uFormat, int nChannels, int nFrames,
+                                  int nAllowedChanges) {
 
-    // Speed parameter not supported by SDL_mixer.
-    (void)fSpeed;
-    
-    // Exit if sound not initialized or paused.
-    if (!m_bIsReady || m_bIsPaused) {
+    if (Mix_OpenAudioDevice(nFrequency, uFormat, nChannels, nFrames, NULL, nAllowedChanges) < 0) {
         return FALSE;
     }
 
-    // Is index within bounds?
-    if ((nIndex >= 0) && (nIndex < m_gsMusicList.GetNumItems())) {
-        // Have the user specified a valid volume?
-        if (nVolume >= 0) {
-            // Set the music volume (convert 0-255 range to SDL_mixer's 0-128 range).
-            this->SetMusicVolume(nVolume);
-        }
+    Mix_QuerySpec(&m_nFrequency, &m_uFormat, &m_nChannels);
 
-        // Play the music (-1 for infinite loop, 0 for play once).
-        if (Mix_PlayMusic(m_gsMusicList[nIndex], bLoop ? -1 : 0) == -1) {
-            GS_Error::Report("GS_SDL_MIXER_SOUND.CPP", 318, "Failed to play music!");
-            return FALSE;
-        }
+    m_nBufferFrames = nFrames;
 
-        // Remember which music is playing.
-        m_nCurrentMusic = nIndex;
-        return TRUE;
+    // Allocate a fixed number of voices, samples steal them from each other when they run out.
+    // Decoded music plays on the channels after them.
+    Mix_AllocateChannels(GS_AUDIO_MAX_VOICES + GS_MUSIC_CHANNELS);
+
+    m_gsVoices.Reset();
+
+    for (int nLoop = 0; nLoop < GS_AUDIO_MAX_VOICES; nLoop++) {
+        m_Voices[nLoop].uMixSerial = 0;
+        SDL_AtomicSet(&m_Voices[nLoop].nPanned, 0);
     }
 
-    return FALSE;
+    for (int nLoop = 0; nLoop <= GS_MUSIC_CHANNELS; nLoop++) {
+        m_uMixMusicSerial[nLoop] = 0;
+    }
+    m_nMixMusicChannel = GS_MUSIC_CHANNEL;
+    m_nMixCrossfade    = m_nMusicCrossfade;
+    SDL_AtomicSet(&m_nMusicActive, 0);
+
+    // Nothing queued for the last device is carried out on this one.
+    m_gsCommands.Clear();
+
+    // Start counting the underruns of the new device.
+    m_gsStats.SetDevice(m_nBufferFrames, m_nFrequency);
+
+    g_pMixerSound = this;
+
+    Mix_ChannelFinished(ChannelDone);
+    Mix_HookMusicFinished(MusicDone);
+    Mix_SetPostMix(MixDone, this);
+
+    return TRUE;
 }
 
 
@@ -366,28 +475,67 @@ BOOL GS_SDLMixerSound::PlayMusic(int nIndex, int nVolume, float fSpeed, BOOL bLo
 
 
 //==============================================================================================
-// GS_SDLMixerSound::StopMusic():
+// GS_SDLMixerSound::ReopenDevice():
 // ---------------------------------------------------------------------------------------------
-// Purpose: Stops music playback. Note that in SDL_mixer, only one music track can play at
-//          a time, so the nIndex parameter is ignored.
+// Purpose: Reopens the audio device with another buffer size, keeping the sample rate and
+//          format so the loaded samples and decoded music can still be used. The music is
+//          reloaded (from memory) and the music that was playing is started again, sound
+//          effects that were playing are stopped. The decoder lock must be held, tracks are
+//          decoded for the device (see LoadPending()).
 // ---------------------------------------------------------------------------------------------
-// Returns: TRUE if successful, FALSE if not.
+// Returns: TRUE if successful, FALSE if not (sound is then disabled).
 //==============================================================================================
 
-BOOL GS_SDLMixerSound::StopMusic(int nIndex) {
+BOOL GS_SDLMixerSound::ReopenDevice(int nFrames) {
 
-    // Index parameter not used in SDL_mixer (only one music track plays at a time).
-    (void)nIndex;
+    BOOL bWasPlaying = (SDL_AtomicGet(&m_nMusicActive) != 0);
 
-    // Exit if sound not initialized.
-    if (!m_bIsReady) {
+    // Close the device first, commands still queued may refer to the music.
+    Mix_SetPostMix(NULL, NULL);
+    Mix_ChannelFinished(NULL);
+    Mix_HookMusicFinished(NULL);
+    Mix_CloseAudio();
+    g_pMixerSound = NULL;
+
+    // Music is bound to the device it was loaded for.
+    for (int nLoop = 0; nLoop < m_gsMusicList.GetNumItems(); nLoop++) {
+        Mix_FreeMusic(m_gsMusicList[nLoop]->pMusic);
+        m_gsMusicList[nLoop]->pMusic = NULL;
+    }
+    for (int nLoop = 0; nLoop < m_gsStreamList.GetNumItems(); nLoop++) {
+        Mix_FreeMusic(m_gsStreamList[nLoop]->pMusic);
+        m_gsStreamList[nLoop]->pMusic = NULL;
+    }
+
+    // Try the old size again if the new one doesn't work.
+    if ((!this->OpenDevice(m_nFrequency, m_uFormat, m_nChannels, nFrames, 0)) &&
+        (!this->OpenDevice(m_nFrequency, m_uFormat, m_nChannels, m_nBufferFrames, 0))) {
+        GS_Error::Report("GS_SDL_MIXER_SOUND.CPP", 431, "Failed to reopen the audio device!");
+        m_nFrequency = 0;
+        m_gsVoices.Reset();
         return FALSE;
     }
 
-    // Stop music playback.
-    Mix_HaltMusic();
+    for (int nLoop = 0; nLoop < m_gsMusicList.GetNumItems(); nLoop++) {
+        m_gsMusicList[nLoop]->pMusic = LoadMusic(m_gsMusicList[nLoop]);
+    }
+    for (int nLoop = 0; nLoop < m_gsStreamList.GetNumItems(); nLoop++) {
+        m_gsStreamList[nLoop]->pMusic = LoadMusic(m_gsStreamList[nLoop]);
+    }
 
-    m_nCurrentMusic = -1;
+    // Start the music that was playing again (the audio thread runs the commands in order).
+    this->SendCommand(GS_SOUND_MUSIC_VOLUME, -1, m_nMusicVolume * MIX_MAX_VOLUME / 255);
+
+    if (bWasPlaying && (m_nCurrentMusic >= 0)) {
+        this->StartMusic(m_gsMusicList[m_nCurrentMusic], m_bMusicLoop);
+    }
+    else if (bWasPlaying && (m_nCurrentStream >= 0)) {
+        this->StartMusic(m_gsStreamList[m_nCurrentStream], TRUE);
+    }
+
+    if (m_bIsPaused) {
+        this->SendCommand(GS_SOUND_PAUSE, -1, TRUE);
+    }
 
     return TRUE;
 }
@@ -397,24 +545,63 @@ BOOL GS_SDLMixerSound::StopMusic(int nIndex) {
 
 
 //==============================================================================================
-// GS_SDLMixerSound::StopAllMusic():
+// GS_SDLMixerSound::LoadPending():
 // ---------------------------------------------------------------------------------------------
-// Purpose: Stops all music playback (same as StopMusic in SDL_mixer).
+// Purpose: Reopens the device with the buffer size asked for and loads the tracks and samples
+//          that were added while the decoder thread was busy. Nothing is done while it is
+//          decoding a track, the next frame tries again (the game thread never waits for a
+//          track to be decoded).
 // ---------------------------------------------------------------------------------------------
 // Returns: Nothing.
 //==============================================================================================
 
-void GS_SDLMixerSound::StopAllMusic() {
+void GS_SDLMixerSound::LoadPending() {
 
-    // Exit if sound not initialized.
-    if (!m_bIsReady) {
+    if (((m_nReopenFrames == 0) && (m_nPendingLoads == 0)) || !this->TryLockDecoder()) {
         return;
     }
 
-    // Stop music playback.
-    Mix_HaltMusic();
+    if (m_nReopenFrames > 0) {
+        int nFrames = m_nReopenFrames;
+        m_nReopenFrames = 0;
+        this->ReopenDevice(nFrames);
+    }
 
-    m_nCurrentMusic = -1;
+    // Tracks that haven't been opened have no music yet.
+    if ((m_nPendingLoads > 0) && (m_nFrequency > 0)) {
+        for (int nLoop = 0; nLoop < m_gsMusicList.GetNumItems(); nLoop++) {
+            if (!m_gsMusicList[nLoop]->pMusic) {
+                m_gsMusicList[nLoop]->pMusic = LoadMusic(m_gsMusicList[nLoop]);
+            }
+        }
+        for (int nLoop = 0; nLoop < m_gsStreamList.GetNumItems(); nLoop++) {
+            if (!m_gsStreamList[nLoop]->pMusic) {
+                m_gsStreamList[nLoop]->pMusic = LoadMusic(m_gsStreamList[nLoop]);
+            }
+        }
+
+        for (int nLoop = 0; nLoop < m_gsSampleList.GetNumItems(); nLoop++) {
+            GS_Sample Sample = m_gsSampleList[nLoop];
+
+            if (!Sample.pszLoad) {
+                continue;
+            }
+
+            Sample.pChunk = LoadChunk(Sample.pszLoad);
+            if (!Sample.pChunk) {
+                GS_Error::Report("GS_SDL_MIXER_SOUND.CPP", 592, "Failed to load sample file!");
+            }
+
+            SDL_free(Sample.pszLoad);
+            Sample.pszLoad = NULL;
+
+            m_gsSampleList.SetItem(nLoop, Sample);
+        }
+
+        m_nPendingLoads = 0;
+    }
+
+    this->UnlockDecoder();
 }
 
 
@@ -422,25 +609,17 @@ void GS_SDLMixerSound::StopAllMusic() {
 
 
 //==============================================================================================
-// GS_SDLMixerSound::IsMusicPlaying():
+// GS_SDLMixerSound::TryLockDecoder():
 // ---------------------------------------------------------------------------------------------
-// Purpose: Checks if any music is currently playing or paused.
+// Purpose: Takes the decoder lock if the decoder thread isn't decoding a track, so SDL_mixer
+//          can be used to load or free something (or to reopen the device).
 // ---------------------------------------------------------------------------------------------
-// Returns: TRUE if music is playing or paused, FALSE if stopped.
+// Returns: TRUE if the lock was taken (or there is no decoder thread), FALSE if not.
 //==============================================================================================
 
-BOOL GS_SDLMixerSound::IsMusicPlaying(int nIndex) {
-
-    // Index parameter not used in SDL_mixer.
-    (void)nIndex;
-
-    // Exit if sound not initialized.
-    if (!m_bIsReady) {
-        return FALSE;
-    }
+BOOL GS_SDLMixerSound::TryLockDecoder() {
 
-    // Is music playing or paused?
-    return Mix_PlayingMusic();
+    return (m_pDecoderLock == NULL) || (SDL_TryLockMutex(m_pDecoderLock) == 0);
 }
 
 
@@ -448,32 +627,18 @@ BOOL GS_SDLMixerSound::IsMusicPlaying(int nIndex) {
 
 
 //==============================================================================================
-// GS_SDLMixerSound::SetMusicVolume():
-// ---------------------------------------------------------------------------------------------
-// Purpose: Sets the music volume level.
+// GS_SDLMixerSound::UnlockDecoder():
 // ---------------------------------------------------------------------------------------------
-// Notes: SDL_mixer uses a 0-128 volume range, so we convert from GS's 0-255 range.
+// Purpose: Releases the decoder lock taken with TryLockDecoder().
 // ---------------------------------------------------------------------------------------------
 // Returns: Nothing.
 //==============================================================================================
 
-void GS_SDLMixerSound::SetMusicVolume(int nVolume) {
-
-    // Exit if sound not initialized.
-    if (!m_bIsReady) {
-        return;
-    }
+void GS_SDLMixerSound::UnlockDecoder() {
 
-    // Make sure volume is within range (0 - 255).
-    if (nVolume < 0) {
-        nVolume = 0;
-    }
-    if (nVolume > 255) {
-        nVolume = 255;
+    if (m_pDecoderLock) {
+        SDL_UnlockMutex(m_pDecoderLock);
     }
-
-    // Set music volume (convert 0-255 to SDL_mixer's 0-128 range).
-    Mix_VolumeMusic(nVolume * 128 / 255);
 }
 
 
@@ -481,77 +646,89 @@ void GS_SDLMixerSound::SetMusicVolume(int nVolume) {
 
 
 //==============================================================================================
-// GS_SDLMixerSound::GetMusicVolume():
+// GS_SDLMixerSound::MixDone():
 // ---------------------------------------------------------------------------------------------
-// Purpose: Gets the current music volume level.
+// Purpose: Called by SDL_mixer on the audio thread after every buffer has been mixed. Counts
+//          an underrun when the buffer is mixed too late, meaning the device has played all
+//          it had and the audio thread was not given the time to mix the next buffer, then
+//          carries out the commands the game thread has queued for the next buffer. SDL_mixer
+//          doesn't call back before it mixes, so the time counted is that of the post mix work
+//          only, along with the channels left playing.
 // ---------------------------------------------------------------------------------------------
-// Returns: The current music volume (0-255).
+// Returns: Nothing.
 //==============================================================================================
 
-int GS_SDLMixerSound::GetMusicVolume() {
+void GS_SDLMixerSound::MixDone(void* pUserData, Uint8* pStream, int nLength) {
 
-    // Exit if sound not initialized.
-    if (!m_bIsReady) {
-        return 0;
-    }
+    (void)pStream;
+    (void)nLength;
+
+    GS_SDLMixerSound* pSound = (GS_SDLMixerSound*) pUserData;
+
+    Uint64 n64Now = SDL_GetPerformanceCounter();
+
+    pSound->m_gsStats.CheckUnderrun(n64Now);
 
-    // Get music volume (convert SDL_mixer's 0-128 range to 0-255).
-    return Mix_VolumeMusic(-1) * 255 / 128;
+    pSound->MixCommands();
+
+    pSound->m_gsStats.AddCallback(SDL_GetPerformanceCounter() - n64Now,
+                                  Mix_Playing(-1) + Mix_PlayingMusic());
 }
 
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
 
 
-////////////////////////////////////////////////////////////////////////////////////////////////
-// Stream Methods //////////////////////////////////////////////////////////////////////////////
+//==============================================================================================
+// GS_SDLMixerSound::SendCommand():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Queues a command for the audio thread, the game thread never calls into SDL_mixer
+//          (and so never waits for the audio device lock) while sound is playing.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if the queue is full.
+//==============================================================================================
+
+BOOL GS_SDLMixerSound::SendCommand(int nType, int nChannel, int nValue, void* pData,
+                                   Uint32 uSerial) {
+
+    GS_SoundCommand Command;
+
+    Command.nType    = nType;
+    Command.nChannel = nChannel;
+    Command.pData    = pData;
+    Command.nValue   = nValue;
+    Command.uSerial  = uSerial;
+
+    return m_gsCommands.Push(Command);
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////////////////////
 
 
 //==============================================================================================
-// GS_SDLMixerSound::AddStream():
-// ---------------------------------------------------------------------------------------------
-// Purpose: Loads an audio stream file and adds it to the stream list.
+// GS_SDLMixerSound::StartMusic():
 // ---------------------------------------------------------------------------------------------
-// Notes: In SDL_mixer, streams and music both use Mix_Music* internally. The distinction is
-//        maintained for API compatibility with GS_FmodSound.
-//        MIDI files may not be supported on Apple platforms.
+// Purpose: Starts a new playback of a music track or stream, replacing the music playing.
 // ---------------------------------------------------------------------------------------------
-// Returns: TRUE if successful, FALSE if not.
+// Returns: TRUE if successful, FALSE if the queue is full.
 //==============================================================================================
 
-BOOL GS_SDLMixerSound::AddStream(const char* pszFilename) {
-
-    // Exit if sound not initialized.
-    if (!m_bIsReady) {
-        return FALSE;
-    }
+BOOL GS_SDLMixerSound::StartMusic(GS_MusicTrack* pTrack, BOOL bLoop) {
 
-    // Check if file is a MIDI file on Apple platforms.
-#if defined(__APPLE__)
-    const char* pExt = strrchr(pszFilename, '.');
-    if (pExt && (strcasecmp(pExt, ".mid") == 0 || strcasecmp(pExt, ".midi") == 0)) {
-        GS_Error::Report("GS_SDL_MIXER_SOUND.CPP", 511, "MIDI files are not supported on Apple platforms. Please convert to OGG or MP3.");
-        return FALSE;
+    m_uMusicSerial++;
+    if (m_uMusicSerial == 0) {
+        m_uMusicSerial = 1;
     }
-#endif
 
-    Mix_Music* pStream;
+    // The music counts as playing from now on, until the audio thread has played it.
+    SDL_AtomicSet(&m_nMusicActive, (int) m_uMusicSerial);
 
-    // Load the specified stream file.
-    pStream = Mix_LoadMUS(pszFilename);
-
-    // Was the stream loaded successfully?
-    if (!pStream) {
-        char szError[512];
-        sprintf(szError, "Failed to load stream file '%s': %s", pszFilename, Mix_GetError());
-        GS_Error::Report("GS_SDL_MIXER_SOUND.CPP", 511, szError);
+    if (!this->SendCommand(GS_SOUND_PLAY_MUSIC, -1, bLoop, pTrack, m_uMusicSerial)) {
+        SDL_AtomicSet(&m_nMusicActive, 0);
         return FALSE;
     }
 
-    // Add the stream to the list.
-    m_gsStreamList.AddItem(pStream);
-
     return TRUE;
 }
 
@@ -560,22 +737,1206 @@ BOOL GS_SDLMixerSound::AddStream(const char* pszFilename) {
 
 
 //==============================================================================================
-// GS_SDLMixerSound::PlayStream():
+// GS_SDLMixerSound::MixCommands():
 // ---------------------------------------------------------------------------------------------
-// Purpose: Plays a loaded audio stream with optional volume setting. Streams always loop
-//          infinitely in this implementation.
+// Purpose: Carries out the commands the game thread has queued, in the order they were sent.
+//          SDL_mixer is called with the audio device lock already held by the audio thread.
+//          Commands for a playback that has already ended are dropped, so nothing is left on
+//          the channel for the next one.
 // ---------------------------------------------------------------------------------------------
-// Returns: 0 on success, -1 on failure.
+// Returns: Nothing.
 //==============================================================================================
 
-int GS_SDLMixerSound::PlayStream(int nIndex, int nVolume) {
-
-    // Exit if sound not initialized or paused.
-    if (!m_bIsReady || m_bIsPaused) {
-        return -1;
+void GS_SDLMixerSound::MixCommands() {
+
+    GS_SoundCommand Command;
+
+    while (m_gsCommands.Pop(&Command)) {
+        GS_Voice* pVoice = (Command.nChannel >= 0) ? &m_Voices[Command.nChannel] : NULL;
+
+        switch (Command.nType) {
+            case GS_SOUND_PLAY:
+                // Halting the channel ends the playback on it (see ChannelDone()).
+                Mix_HaltChannel(Command.nChannel);
+                pVoice->uMixSerial = Command.uSerial;
+                Mix_Volume(Command.nChannel, Command.nValue);
+                if (Mix_PlayChannel(Command.nChannel, (Mix_Chunk*) Command.pData, 0) < 0) {
+                    m_gsVoices.Finish(Command.nChannel, Command.uSerial);
+                }
+                break;
+            case GS_SOUND_STOP:
+            case GS_SOUND_VOLUME:
+            case GS_SOUND_PANNING:
+                if ((pVoice->uMixSerial != Command.uSerial) || !Mix_Playing(Command.nChannel)) {
+                    break;
+                }
+                if (Command.nType == GS_SOUND_STOP) {
+                    Mix_HaltChannel(Command.nChannel);
+                }
+                else if (Command.nType == GS_SOUND_VOLUME) {
+                    Mix_Volume(Command.nChannel, Command.nValue);
+                }
+                else {
+                    SDL_AtomicSet(&pVoice->nPanGains, Command.nValue);
+                    // The effect is only registered once the voice is panned off center.
+                    if ((Command.nValue != ((16384 << 16) | 16384)) &&
+                        !SDL_AtomicGet(&pVoice->nPanned)) {
+                        SDL_AtomicSet(&pVoice->nPanned, 1);
+                        if (!Mix_RegisterEffect(Command.nChannel, PanEffect, PanDone, pVoice)) {
+                            SDL_AtomicSet(&pVoice->nPanned, 0);
+                        }
+                    }
+                }
+                break;
+            case GS_SOUND_PAUSE:
+                if (Command.nValue) {
+                    Mix_PauseMusic();
+                    Mix_Pause(-1);
+                }
+                else {
+                    Mix_ResumeMusic();
+                    Mix_Resume(-1);
+                }
+                break;
+            case GS_SOUND_PLAY_MUSIC:
+                if (!this->PlayTrack((GS_MusicTrack*) Command.pData, Command.nValue ? -1 : 0,
+                                     Command.uSerial)) {
+                    SDL_AtomicCAS(&m_nMusicActive, (int) Command.uSerial, 0);
+                }
+                break;
+            case GS_SOUND_STOP_MUSIC:
+                this->FadeOutMusic(m_nMixCrossfade, FALSE);
+                break;
+            case GS_SOUND_MUSIC_VOLUME:
+                Mix_Volume(GS_MUSIC_CHANNEL, Command.nValue);
+                Mix_Volume(GS_MUSIC_CHANNEL + 1, Command.nValue);
+                Mix_VolumeMusic(Command.nValue);
+                break;
+            case GS_SOUND_PAUSE_MUSIC:
+                for (int nChannel = GS_MUSIC_CHANNEL;
+                     nChannel < GS_MUSIC_CHANNEL + GS_MUSIC_CHANNELS; nChannel++) {
+                    if (Command.nValue) {
+                        Mix_Pause(nChannel);
+                    }
+                    else {
+                        Mix_Resume(nChannel);
+                    }
+                }
+                if (Command.nValue) {
+                    Mix_PauseMusic();
+                }
+                else {
+                    Mix_ResumeMusic();
+                }
+                break;
+            case GS_SOUND_MUSIC_FADE:
+                m_nMixCrossfade = Command.nValue;
+                break;
+        }
     }
+}
 
-    // Is index within bounds?
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLMixerSound::ChannelDone():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Called by SDL_mixer when a channel stops playing (on the audio thread, unless the
+//          device is being closed), the voice is free again unless the game thread has
+//          already started a new playback on it.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_SDLMixerSound::ChannelDone(int nChannel) {
+
+    if (g_pMixerSound == NULL) {
+        return;
+    }
+
+    // Decoded music has ended (or faded out, which only ends the music if nothing else has
+    // been started since).
+    if ((nChannel >= GS_MUSIC_CHANNEL) && (nChannel < GS_MUSIC_CHANNEL + GS_MUSIC_CHANNELS)) {
+        SDL_AtomicCAS(&g_pMixerSound->m_nMusicActive,
+                      (int) g_pMixerSound->m_uMixMusicSerial[nChannel - GS_MUSIC_CHANNEL], 0);
+        return;
+    }
+
+    if ((nChannel >= 0) && (nChannel < GS_AUDIO_MAX_VOICES)) {
+        g_pMixerSound->m_gsVoices.Finish(nChannel, g_pMixerSound->m_Voices[nChannel].uMixSerial);
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLMixerSound::MusicDone():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Called by SDL_mixer when the streamed music stops playing, the music is not
+//          playing anymore unless the game thread has already started another track.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_SDLMixerSound::MusicDone() {
+
+    if (g_pMixerSound != NULL) {
+        SDL_AtomicCAS(&g_pMixerSound->m_nMusicActive,
+                      (int) g_pMixerSound->m_uMixMusicSerial[GS_MUSIC_CHANNELS], 0);
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Helper Methods //////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLMixerSound::OpenPackFile():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Looks up a sound file in the global pack and opens its contents as a read only
+//          memory stream. Music keeps streaming from this memory, so the pack must stay open
+//          for as long as the music is loaded.
+// ---------------------------------------------------------------------------------------------
+// Returns: The memory stream or NULL if the file is not in the pack.
+//==============================================================================================
+
+SDL_RWops* GS_SDLMixerSound::OpenPackFile(const char* pszFilename) {
+
+    const BYTE*   pData = NULL;
+    unsigned long lSize = 0;
+
+    // Is the file in the pack?
+    if (!g_gsPack.Find(pszFilename, &pData, &lSize)) {
+        return NULL;
+    }
+
+    return SDL_RWFromConstMem(pData, (int) lSize);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLMixerSound::LoadTrack():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Loads a music track or audio stream. Its contents are taken from the pack if it is
+//          in there, otherwise the file is mapped into memory, so the track is never read from
+//          a file while it plays (or when the device reopens). The track is only opened for
+//          streaming if bOpen is set (the decoder lock must then be held).
+// ---------------------------------------------------------------------------------------------
+// Returns: The track (to be freed with FreeTrack()) or NULL if failed.
+//==============================================================================================
+
+GS_MusicTrack* GS_SDLMixerSound::LoadTrack(const char* pszFilename, BOOL bOpen) {
+
+    GS_MusicTrack* pTrack = new GS_MusicTrack;
+
+    pTrack->pFile  = NULL;
+    pTrack->pData  = NULL;
+    pTrack->lSize  = 0;
+    pTrack->pMusic = NULL;
+    pTrack->pChunk = NULL;
+
+    // Is the track in the pack?
+    if (!g_gsPack.Find(pszFilename, &pTrack->pData, &pTrack->lSize)) {
+        pTrack->pFile = new GS_File;
+        if (pTrack->pFile->Open(pszFilename, FILE_MAP)) {
+            pTrack->pData = pTrack->pFile->GetData();
+            pTrack->lSize = pTrack->pFile->GetLength();
+        }
+    }
+
+    if (pTrack->pData && bOpen) {
+        pTrack->pMusic = LoadMusic(pTrack);
+    }
+
+    if (!pTrack->pData || (bOpen && !pTrack->pMusic)) {
+        FreeTrack(pTrack);
+        return NULL;
+    }
+
+    return pTrack;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLMixerSound::LoadMusic():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Opens the contents of a music track for streaming from memory.
+// ---------------------------------------------------------------------------------------------
+// Returns: The music or NULL if failed.
+//==============================================================================================
+
+Mix_Music* GS_SDLMixerSound::LoadMusic(const GS_MusicTrack* pTrack) {
+
+    return Mix_LoadMUS_RW(SDL_RWFromConstMem(pTrack->pData, (int) pTrack->lSize), 1);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLMixerSound::LoadChunk():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Loads a sample in any format SDL_mixer supports, from the pack if it is in there.
+// ---------------------------------------------------------------------------------------------
+// Returns: The sample or NULL if failed.
+//==============================================================================================
+
+Mix_Chunk* GS_SDLMixerSound::LoadChunk(const char* pszFilename) {
+
+    SDL_RWops* pPackFile = OpenPackFile(pszFilename);
+
+    return pPackFile ? Mix_LoadWAV_RW(pPackFile, 1) : Mix_LoadWAV(pszFilename);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLMixerSound::FreeTrack():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Frees a music track loaded with LoadTrack() (the decoder thread must be stopped or
+//          the decoder lock held).
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_SDLMixerSound::FreeTrack(GS_MusicTrack* pTrack) {
+
+    if (pTrack->pMusic) {
+        Mix_FreeMusic(pTrack->pMusic);
+    }
+    if (pTrack->pChunk) {
+        Mix_FreeChunk((Mix_Chunk*) pTrack->pChunk);
+    }
+
+    // Unmaps the file.
+    delete pTrack->pFile;
+    delete pTrack;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLMixerSound::PlayTrack():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Plays a music track on the audio thread, replacing the music playing. The decoded
+//          track is played if the decoder thread is done with it (which starts at once),
+//          otherwise it is streamed. If music is playing and a crossfade is set, the new track
+//          fades in while the old one fades out. Decoded tracks crossfade without a gap, on
+//          the music channel the old track isn't using; SDL_mixer streams one track at a
+//          time, so a streamed track always cuts the streamed track before it.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if not.
+//==============================================================================================
+
+BOOL GS_SDLMixerSound::PlayTrack(GS_MusicTrack* pTrack, int nLoops, Uint32 uSerial) {
+
+    Mix_Chunk* pChunk = (Mix_Chunk*) SDL_AtomicGetPtr(&pTrack->pChunk);
+
+    // Only fade in when there is something to fade from.
+    int nFade = (Mix_PlayingMusic() || Mix_Playing(GS_MUSIC_CHANNEL) ||
+                 Mix_Playing(GS_MUSIC_CHANNEL + 1)) ? m_nMixCrossfade : 0;
+
+    this->FadeOutMusic(nFade, pChunk == NULL);
+
+    if (pChunk) {
+        int nChannel = (m_nMixMusicChannel == GS_MUSIC_CHANNEL) ? GS_MUSIC_CHANNEL + 1 :
+                                                                  GS_MUSIC_CHANNEL;
+
+        // A track still fading out on the channel is cut short (see ChannelDone()).
+        Mix_HaltChannel(nChannel);
+
+        m_uMixMusicSerial[nChannel - GS_MUSIC_CHANNEL] = uSerial;
+        m_nMixMusicChannel = nChannel;
+
+        if (nFade > 0) {
+            return (Mix_FadeInChannel(nChannel, pChunk, nLoops, nFade) >= 0);
+        }
+        return (Mix_PlayChannel(nChannel, pChunk, nLoops) >= 0);
+    }
+
+    m_uMixMusicSerial[GS_MUSIC_CHANNELS] = uSerial;
+
+    return (pTrack->pMusic != NULL) && (Mix_FadeInMusic(pTrack->pMusic, nLoops, nFade) >= 0);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLMixerSound::FadeOutMusic():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Fades out the music playing on the audio thread over nFade milliseconds, or halts
+//          it if nFade is 0. Streamed music is always halted if bHaltStream is set, since
+//          SDL_mixer waits for streamed music fading out before it streams the next track.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_SDLMixerSound::FadeOutMusic(int nFade, BOOL bHaltStream) {
+
+    for (int nChannel = GS_MUSIC_CHANNEL; nChannel < GS_MUSIC_CHANNEL + GS_MUSIC_CHANNELS;
+         nChannel++) {
+        if ((nFade > 0) && (Mix_FadingChannel(nChannel) == MIX_FADING_OUT)) {
+            continue;
+        }
+        // Channels at zero volume can't fade out.
+        if ((nFade == 0) || (Mix_FadeOutChannel(nChannel, nFade) == 0)) {
+            Mix_HaltChannel(nChannel);
+        }
+    }
+
+    if ((nFade > 0) && !bHaltStream) {
+        if (Mix_FadingMusic() != MIX_FADING_OUT) {
+            Mix_FadeOutMusic(nFade);
+        }
+    }
+    else {
+        Mix_HaltMusic();
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLMixerSound::AddTrack():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Loads a music track or audio stream, adds it to a list and hands it to the decoder
+//          thread with the next Update(). SDL_mixer's loaders aren't thread-safe, so if the
+//          decoder thread is decoding a track, the track is opened by the next Update() that
+//          finds it idle instead (it can't be played until then).
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if not.
+//==============================================================================================
+
+BOOL GS_SDLMixerSound::AddTrack(GS_List<GS_MusicTrack*>* pList, const char* pszFilename) {
+
+    BOOL bOpen = this->TryLockDecoder();
+
+    GS_MusicTrack* pTrack = LoadTrack(pszFilename, bOpen);
+
+    if (bOpen) {
+        this->UnlockDecoder();
+    }
+
+    if (!pTrack) {
+        return FALSE;
+    }
+
+    if (!bOpen) {
+        m_nPendingLoads++;
+    }
+
+    pList->AddItem(pTrack);
+
+    if (m_pDecoderThread) {
+        m_gsNewTracks.AddItem(pTrack);
+    }
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLMixerSound::StartDecoder():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Starts the thread that decodes the music tracks in the background. Without it the
+//          tracks are streamed.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_SDLMixerSound::StartDecoder() {
+
+    m_gsDecodeQueue.Clear();
+    SDL_AtomicSet(&m_nDecoderQuit, 0);
+
+    m_pDecoderSignal = SDL_CreateSemaphore(0);
+    m_pDecoderLock   = SDL_CreateMutex();
+
+    if (m_pDecoderSignal && m_pDecoderLock) {
+        m_pDecoderThread = SDL_CreateThread(DecodeMusicThread, "GS_MusicDecoder", this);
+    }
+
+    if (!m_pDecoderThread) {
+        this->StopDecoder();
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLMixerSound::StopDecoder():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Stops the decoder thread after the track it is decoding. Tracks that have not been
+//          decoded keep streaming.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_SDLMixerSound::StopDecoder() {
+
+    if (m_pDecoderThread) {
+        SDL_AtomicSet(&m_nDecoderQuit, 1);
+        SDL_SemPost(m_pDecoderSignal);
+        SDL_WaitThread(m_pDecoderThread, NULL);
+        m_pDecoderThread = NULL;
+    }
+
+    if (m_pDecoderSignal) {
+        SDL_DestroySemaphore(m_pDecoderSignal);
+        m_pDecoderSignal = NULL;
+    }
+    if (m_pDecoderLock) {
+        SDL_DestroyMutex(m_pDecoderLock);
+        m_pDecoderLock = NULL;
+    }
+
+    m_gsDecodeQueue.Clear();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLMixerSound::DecodeMusicThread():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Decodes the queued music tracks from memory into the format of the device, one at
+//          a time, until GS_MUSIC_DECODE_LIMIT bytes have been decoded. Tracks SDL_mixer can't
+//          decode into a chunk (or that don't fit) keep streaming.
+// ---------------------------------------------------------------------------------------------
+// Returns: 0.
+//==============================================================================================
+
+int GS_SDLMixerSound::DecodeMusicThread(void* pParam) {
+
+    GS_SDLMixerSound* pSound = (GS_SDLMixerSound*) pParam;
+    GS_MusicTrack*    pTrack;
+
+    Uint32 uDecoded = 0;
+
+    for (;;) {
+        SDL_SemWait(pSound->m_pDecoderSignal);
+
+        if (SDL_AtomicGet(&pSound->m_nDecoderQuit)) {
+            break;
+        }
+
+        if (!pSound->m_gsDecodeQueue.Pop(&pTrack)) {
+            continue;
+        }
+
+        Mix_Chunk* pChunk = NULL;
+
+        // The device doesn't reopen while the track is decoded for it, nor does the game
+        // thread load or free anything through SDL_mixer.
+        SDL_LockMutex(pSound->m_pDecoderLock);
+        if (pSound->m_nFrequency > 0) {
+            pChunk = Mix_LoadWAV_RW(SDL_RWFromConstMem(pTrack->pData, (int) pTrack->lSize), 1);
+        }
+        if (pChunk && (uDecoded + pChunk->alen > GS_MUSIC_DECODE_LIMIT)) {
+            Mix_FreeChunk(pChunk);
+            pChunk = NULL;
+        }
+        SDL_UnlockMutex(pSound->m_pDecoderLock);
+
+        if (!pChunk) {
+            continue;
+        }
+
+        uDecoded += pChunk->alen;
+
+        // The audio thread plays the decoded track from now on.
+        SDL_AtomicSetPtr(&pTrack->pChunk, pChunk);
+    }
+
+    return 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLMixerSound::DecodeSample():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Decodes a WAV file (from the pack if it is in there) and converts it to the format
+//          of the opened audio device, ready to be handed to AddSample(). The converted sample
+//          is saved in the sample cache, so next time it is read from there without decoding
+//          or converting it. Doesn't touch any class data, so it may be called from any thread
+//          once the device is open.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful (the buffer must be freed with SDL_free() if not added as a
+//          sample), FALSE if not.
+//==============================================================================================
+
+BOOL GS_SDLMixerSound::DecodeSample(const char* pszFilename, Uint8** ppBuffer, Uint32* puLength) {
+
+    int    nFrequency;
+    Uint16 uFormat;
+    int    nChannels;
+
+    // Exit if the audio device has not been opened.
+    if (!Mix_QuerySpec(&nFrequency, &uFormat, &nChannels)) {
+        return FALSE;
+    }
+
+    // Use the sample cache file if it is up to date.
+    if (LoadCache(pszFilename, nFrequency, uFormat, nChannels, ppBuffer, puLength)) {
+        return TRUE;
+    }
+
+    SDL_RWops* pFile = OpenPackFile(pszFilename);
+    if (!pFile) {
+        pFile = SDL_RWFromFile(pszFilename, "rb");
+    }
+    if (!pFile) {
+        return FALSE;
+    }
+
+    SDL_AudioSpec WaveSpec;
+    Uint8* pWave = NULL;
+    Uint32 uWaveLength = 0;
+
+    // Decode the wave file.
+    if (!SDL_LoadWAV_RW(pFile, 1, &WaveSpec, &pWave, &uWaveLength)) {
+        return FALSE;
+    }
+
+    SDL_AudioCVT WaveCVT;
+    int nResult = SDL_BuildAudioCVT(&WaveCVT, WaveSpec.format, WaveSpec.channels, WaveSpec.freq,
+                                    uFormat, (Uint8) nChannels, nFrequency);
+    if (nResult < 0) {
+        SDL_FreeWAV(pWave);
+        return FALSE;
+    }
+
+    // Hand out the wave data as it is if it already matches the device.
+    if (nResult == 0) {
+        SaveCache(pszFilename, nFrequency, uFormat, nChannels, pWave, uWaveLength);
+        *ppBuffer = pWave;
+        *puLength = uWaveLength;
+        return TRUE;
+    }
+
+    // Convert the wave data to the format of the device.
+    WaveCVT.len = (int) uWaveLength;
+    WaveCVT.buf = (Uint8*) SDL_malloc(WaveCVT.len * WaveCVT.len_mult);
+    if (!WaveCVT.buf) {
+        SDL_FreeWAV(pWave);
+        return FALSE;
+    }
+
+    SDL_memcpy(WaveCVT.buf, pWave, uWaveLength);
+    SDL_FreeWAV(pWave);
+
+    if (SDL_ConvertAudio(&WaveCVT) < 0) {
+        SDL_free(WaveCVT.buf);
+        return FALSE;
+    }
+
+    SaveCache(pszFilename, nFrequency, uFormat, nChannels, WaveCVT.buf, (Uint32) WaveCVT.len_cvt);
+
+    *ppBuffer = WaveCVT.buf;
+    *puLength = (Uint32) WaveCVT.len_cvt;
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Sample Cache Methods ////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLMixerSound::SetCacheDirectory():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Sets the directory the sample cache files are kept in (created when the first file
+//          is saved). The directory should end with a path separator, NULL or an empty string
+//          disables the sample cache.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_SDLMixerSound::SetCacheDirectory(const char* pszDirectory) {
+
+    if (!pszDirectory || strlen(pszDirectory) >= _MAX_PATH) {
+        g_szCacheDirectory[0] = '\0';
+        return;
+    }
+
+    strcpy(g_szCacheDirectory, pszDirectory);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLMixerSound::GetCacheName():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Determines the name of the sample cache file of a sample for a device format, which
+//          is the filename of the sample with all path separators replaced by underscores,
+//          followed by the sample rate, sample format and number of channels.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if the sample cache is disabled or the name is too long.
+//==============================================================================================
+
+BOOL GS_SDLMixerSound::GetCacheName(const char* pszFilename, int nFrequency, Uint16 uFormat,
+                                    int nChannels, char* pszCacheName) {
+
+    char szFormat[32];
+    sprintf(szFormat, "_%d_%04x_%d", nFrequency, (unsigned int) uFormat, nChannels);
+
+    size_t nLength = strlen(g_szCacheDirectory);
+
+    if (nLength == 0 || !pszFilename || strlen(pszFilename) >= GS_SAMPLECACHE_MAX_NAME ||
+        nLength + strlen(pszFilename) + strlen(szFormat) + strlen(GS_SAMPLECACHE_EXTENSION) >=
+        _MAX_PATH) {
+        return FALSE;
+    }
+
+    strcpy(pszCacheName, g_szCacheDirectory);
+
+    // Flatten the filename of the sample so all cache files are in the same directory.
+    for (const char* pszChar = pszFilename; *pszChar; pszChar++) {
+        BOOL bIsSeparator = (*pszChar == '/') || (*pszChar == '\\') || (*pszChar == ':');
+        pszCacheName[nLength++] = bIsSeparator ? '_' : *pszChar;
+    }
+
+    strcpy(pszCacheName + nLength, szFormat);
+    strcat(pszCacheName, GS_SAMPLECACHE_EXTENSION);
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLMixerSound::GetSourceStamp():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Gets the size and the modification time of a sample file, or the size and the hash
+//          of the sample if it is in the pack. A cache file is out of date when either changes.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if the sample file doesn't exist.
+//==============================================================================================
+
+BOOL GS_SDLMixerSound::GetSourceStamp(const char* pszFilename, unsigned int* puSize,
+                                      unsigned int* puStamp) {
+
+    // Samples in the pack are used before the ones in the file system.
+    const GS_PackEntry* pEntry = g_gsPack.GetEntry(pszFilename);
+
+    if (pEntry) {
+        *puSize  = pEntry->uSize;
+        *puStamp = pEntry->uHash;
+        return TRUE;
+    }
+
+    GS_File gsFile;
+
+    if (!gsFile.Open(pszFilename, FILE_READ)) {
+        return FALSE;
+    }
+
+    *puSize  = (unsigned int) gsFile.GetLength();
+    *puStamp = (unsigned int) gsFile.GetModifiedTime();
+
+    gsFile.Close();
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLMixerSound::LoadCache():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Reads a sample from its cache file for the device format, if there is one for the
+//          current version of the sample. A cache file in the pack is used before the one in
+//          the cache directory. The sample data is copied as it is, nothing is converted.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful (the buffer is allocated with SDL_malloc()), FALSE if there is
+//          no up to date cache file.
+//==============================================================================================
+
+BOOL GS_SDLMixerSound::LoadCache(const char* pszFilename, int nFrequency, Uint16 uFormat,
+                                 int nChannels, Uint8** ppBuffer, Uint32* puLength) {
+
+    char szCacheName[_MAX_PATH];
+    unsigned int uSourceSize  = 0;
+    unsigned int uSourceStamp = 0;
+
+    if (!GetCacheName(pszFilename, nFrequency, uFormat, nChannels, szCacheName) ||
+        !GetSourceStamp(pszFilename, &uSourceSize, &uSourceStamp)) {
+        return FALSE;
+    }
+
+    GS_File       gsCacheFile;
+    const BYTE*   pData = NULL;
+    unsigned long lSize = 0;
+
+    if (!g_gsPack.Find(szCacheName, &pData, &lSize)) {
+        if (!gsCacheFile.Open(szCacheName, FILE_MAP)) {
+            return FALSE;
+        }
+        pData = gsCacheFile.GetData();
+        lSize = gsCacheFile.GetLength();
+    }
+
+    const GS_SampleCacheHeader* pHeader = (const GS_SampleCacheHeader*) pData;
+
+    // Is this a complete cache file of the current version of the sample in this format?
+    if (!pData || lSize < sizeof(GS_SampleCacheHeader) ||
+        memcmp(pHeader->szMagic, GS_SAMPLECACHE_MAGIC, 4) != 0 ||
+        pHeader->uVersion != GS_SAMPLECACHE_VERSION ||
+        strncmp(pHeader->szSource, pszFilename, GS_SAMPLECACHE_MAX_NAME) != 0 ||
+        pHeader->uSourceSize != uSourceSize || pHeader->uSourceStamp != uSourceStamp ||
+        pHeader->uFrequency != (unsigned int) nFrequency ||
+        pHeader->uFormat != (unsigned int) uFormat ||
+        pHeader->uChannels != (unsigned int) nChannels ||
+        pHeader->uLength == 0 || lSize - sizeof(GS_SampleCacheHeader) < pHeader->uLength) {
+        return FALSE;
+    }
+
+    Uint8* pBuffer = (Uint8*) SDL_malloc(pHeader->uLength);
+    if (!pBuffer) {
+        return FALSE;
+    }
+
+    SDL_memcpy(pBuffer, pHeader + 1, pHeader->uLength);
+
+    *ppBuffer = pBuffer;
+    *puLength = pHeader->uLength;
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLMixerSound::SaveCache():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Saves a sample converted to the device format in its cache file. Failing to save is
+//          not an error, the sample will just be decoded again next time.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_SDLMixerSound::SaveCache(const char* pszFilename, int nFrequency, Uint16 uFormat,
+                                 int nChannels, const Uint8* pBuffer, Uint32 uLength) {
+
+    char szCacheName[_MAX_PATH];
+    GS_SampleCacheHeader CacheHeader;
+
+    memset(&CacheHeader, 0, sizeof(GS_SampleCacheHeader));
+
+    if (!GetCacheName(pszFilename, nFrequency, uFormat, nChannels, szCacheName) ||
+        !GetSourceStamp(pszFilename, &CacheHeader.uSourceSize, &CacheHeader.uSourceStamp)) {
+        return;
+    }
+
+    memcpy(CacheHeader.szMagic, GS_SAMPLECACHE_MAGIC, 4);
+    CacheHeader.uVersion   = GS_SAMPLECACHE_VERSION;
+    CacheHeader.uFrequency = nFrequency;
+    CacheHeader.uFormat    = uFormat;
+    CacheHeader.uChannels  = nChannels;
+    CacheHeader.uLength    = uLength;
+    strcpy(CacheHeader.szSource, pszFilename);
+
+    // Make sure the cache directory exists (fails quietly if it does).
+    CreateDirectory(g_szCacheDirectory, NULL);
+
+    GS_File gsCacheFile;
+
+    if (!gsCacheFile.Open(szCacheName, FILE_WRITE)) {
+        return;
+    }
+
+    BOOL bResult = (gsCacheFile.Write(&CacheHeader, sizeof(GS_SampleCacheHeader)) ==
+                    sizeof(GS_SampleCacheHeader)) &&
+                   (gsCacheFile.Write((void*) pBuffer, uLength) == uLength);
+
+    gsCacheFile.Close();
+
+    if (!bResult) {
+        GS_Error::Report("GS_SDL_MIXER_SOUND.CPP", 873, "Failed to save sample cache file!");
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Music Methods ///////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLMixerSound::AddMusic():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Loads a music file and adds it to the music list. Supports MP3, OGG, WAV, FLAC,
+//          MOD, XM, IT, and other formats supported by SDL_mixer.
+// ---------------------------------------------------------------------------------------------
+// Notes: MIDI files may not be supported on Apple platforms due to missing native support
+//        in SDL_mixer. Consider converting MIDI files to OGG or MP3 for better compatibility.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if not.
+//==============================================================================================
+
+BOOL GS_SDLMixerSound::AddMusic(const char* pszFilename) {
+
+    // Exit if sound not initialized.
+    if (!m_bIsReady) {
+        return FALSE;
+    }
+
+    // Check if file is a MIDI file on Apple platforms.
+#if defined(__APPLE__)
+    const char* pExt = strrchr(pszFilename, '.');
+    if (pExt && (strcasecmp(pExt, ".mid") == 0 || strcasecmp(pExt, ".midi") == 0)) {
+        GS_Error::Report("GS_SDL_MIXER_SOUND.CPP", 267, "MIDI files are not supported on Apple platforms. Please convert to OGG or MP3.");
+        return FALSE;
+    }
+#endif
+
+    // Load the specified music (from the pack if it is in there) and add it to the list.
+    if (!this->AddTrack(&m_gsMusicList, pszFilename)) {
+        char szError[512];
+        sprintf(szError, "Failed to load music file '%s': %s", pszFilename, Mix_GetError());
+        GS_Error::Report("GS_SDL_MIXER_SOUND.CPP", 267, szError);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLMixerSound::PlayMusic():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Plays a loaded music track with optional volume and loop settings.
+// ---------------------------------------------------------------------------------------------
+// Notes: The fSpeed parameter is ignored as SDL_mixer doesn't support playback speed changes
+//        without additional processing.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if not.
+//==============================================================================================
+
+BOOL GS_SDLMixerSound::PlayMusic(int nIndex, int nVolume, float fSpeed, BOOL bLoop) {
+
+    // Speed parameter not supported by SDL_mixer.
+    (void)fSpeed;
+    
+    // Exit if sound not initialized or paused.
+    if (!m_bIsReady || m_bIsPaused) {
+        return FALSE;
+    }
+
+    // Is index within bounds?
+    if ((nIndex >= 0) && (nIndex < m_gsMusicList.GetNumItems())) {
+        // Have the user specified a valid volume?
+        if (nVolume >= 0) {
+            // Set the music volume (convert 0-255 range to SDL_mixer's 0-128 range).
+            this->SetMusicVolume(nVolume);
+        }
+
+        // Play the music (looped or once).
+        if ((m_nFrequency > 0) && !this->StartMusic(m_gsMusicList[nIndex], bLoop)) {
+            return FALSE;
+        }
+
+        // Remember which music is playing.
+        m_nCurrentMusic  = nIndex;
+        m_nCurrentStream = -1;
+        m_bMusicLoop     = bLoop;
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLMixerSound::StopMusic():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Stops music playback. Note that in SDL_mixer, only one music track can play at
+//          a time, so the nIndex parameter is ignored.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if not.
+//==============================================================================================
+
+BOOL GS_SDLMixerSound::StopMusic(int nIndex) {
+
+    // Index parameter not used in SDL_mixer (only one music track plays at a time).
+    (void)nIndex;
+
+    // Exit if sound not initialized.
+    if (!m_bIsReady) {
+        return FALSE;
+    }
+
+    // Stop music playback.
+    if (m_nFrequency > 0) {
+        SDL_AtomicSet(&m_nMusicActive, 0);
+        this->SendCommand(GS_SOUND_STOP_MUSIC);
+    }
+
+    m_nCurrentMusic = -1;
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLMixerSound::StopAllMusic():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Stops all music playback (same as StopMusic in SDL_mixer).
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_SDLMixerSound::StopAllMusic() {
+
+    // Exit if sound not initialized.
+    if (!m_bIsReady) {
+        return;
+    }
+
+    // Stop music playback.
+    if (m_nFrequency > 0) {
+        SDL_AtomicSet(&m_nMusicActive, 0);
+        this->SendCommand(GS_SOUND_STOP_MUSIC);
+    }
+
+    m_nCurrentMusic = -1;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLMixerSound::IsMusicPlaying():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Checks if any music is currently playing or paused.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if music is playing or paused, FALSE if stopped.
+//==============================================================================================
+
+BOOL GS_SDLMixerSound::IsMusicPlaying(int nIndex) {
+
+    // Index parameter not used in SDL_mixer.
+    (void)nIndex;
+
+    // Exit if sound not initialized.
+    if (!m_bIsReady) {
+        return FALSE;
+    }
+
+    // Is music playing or paused?
+    return (SDL_AtomicGet(&m_nMusicActive) != 0);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLMixerSound::SetMusicVolume():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Sets the music volume level.
+// ---------------------------------------------------------------------------------------------
+// Notes: SDL_mixer uses a 0-128 volume range, so we convert from GS's 0-255 range.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_SDLMixerSound::SetMusicVolume(int nVolume) {
+
+    // Exit if sound not initialized.
+    if (!m_bIsReady) {
+        return;
+    }
+
+    // Make sure volume is within range (0 - 255).
+    if (nVolume < 0) {
+        nVolume = 0;
+    }
+    if (nVolume > 255) {
+        nVolume = 255;
+    }
+
+    m_nMusicVolume = nVolume;
+
+    // Set music volume (convert 0-255 to SDL_mixer's 0-128 range).
+    if (m_nFrequency > 0) {
+        this->SendCommand(GS_SOUND_MUSIC_VOLUME, -1, nVolume * MIX_MAX_VOLUME / 255);
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLMixerSound::GetMusicVolume():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Gets the current music volume level.
+// ---------------------------------------------------------------------------------------------
+// Returns: The current music volume (0-255).
+//==============================================================================================
+
+int GS_SDLMixerSound::GetMusicVolume() {
+
+    // Exit if sound not initialized.
+    if (!m_bIsReady) {
+        return 0;
+    }
+
+    return m_nMusicVolume;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLMixerSound::SetMusicCrossfade():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Sets the time music and streams crossfade over when one is played while another is
+//          playing, and fade out over when stopped (0 to GS_MUSIC_MAX_CROSSFADE milliseconds,
+//          0 switches at once). May be called before or after initializing.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_SDLMixerSound::SetMusicCrossfade(int nMilliseconds) {
+
+    m_nMusicCrossfade = SDL_max(0, SDL_min(nMilliseconds, GS_MUSIC_MAX_CROSSFADE));
+
+    if (m_nFrequency > 0) {
+        this->SendCommand(GS_SOUND_MUSIC_FADE, -1, m_nMusicCrossfade);
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Stream Methods //////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLMixerSound::AddStream():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Loads an audio stream file and adds it to the stream list.
+// ---------------------------------------------------------------------------------------------
+// Notes: In SDL_mixer, streams and music both use Mix_Music* internally. The distinction is
+//        maintained for API compatibility with GS_FmodSound.
+//        MIDI files may not be supported on Apple platforms.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if not.
+//==============================================================================================
+
+BOOL GS_SDLMixerSound::AddStream(const char* pszFilename) {
+
+    // Exit if sound not initialized.
+    if (!m_bIsReady) {
+        return FALSE;
+    }
+
+    // Check if file is a MIDI file on Apple platforms.
+#if defined(__APPLE__)
+    const char* pExt = strrchr(pszFilename, '.');
+    if (pExt && (strcasecmp(pExt, ".mid") == 0 || strcasecmp(pExt, ".midi") == 0)) {
+        GS_Error::Report("GS_SDL_MIXER_SOUND.CPP", 511, "MIDI files are not supported on Apple platforms. Please convert to OGG or MP3.");
+        return FALSE;
+    }
+#endif
+
+    // Load the specified stream (from the pack if it is in there) and add it to the list.
+    if (!this->AddTrack(&m_gsStreamList, pszFilename)) {
+        char szError[512];
+        sprintf(szError, "Failed to load stream file '%s': %s", pszFilename, Mix_GetError());
+        GS_Error::Report("GS_SDL_MIXER_SOUND.CPP", 511, szError);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLMixerSound::PlayStream():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Plays a loaded audio stream with optional volume setting. Streams always loop
+//          infinitely in this implementation.
+// ---------------------------------------------------------------------------------------------
+// Returns: 0 on success, -1 on failure.
+//==============================================================================================
+
+int GS_SDLMixerSound::PlayStream(int nIndex, int nVolume) {
+
+    // Exit if sound not initialized or paused.
+    if (!m_bIsReady || m_bIsPaused) {
+        return -1;
+    }
+
+    // Is index within bounds?
     if ((nIndex >= 0) && (nIndex < m_gsStreamList.GetNumItems())) {
         // Have the user specified a valid volume?
         if (nVolume >= 0) {
@@ -583,18 +1944,394 @@ int GS_SDLMixerSound::PlayStream(int nIndex, int nVolume) {
             this->SetStreamVolume(nVolume);
         }
 
-        // Play the stream with infinite looping.
-        if (Mix_PlayMusic(m_gsStreamList[nIndex], -1) == -1) {
-            GS_Error::Report("GS_SDL_MIXER_SOUND.CPP", 557, "Failed to play stream!");
-            return -1;
+        // Play the stream with infinite looping.
+        if ((m_nFrequency > 0) && !this->StartMusic(m_gsStreamList[nIndex], TRUE)) {
+            return -1;
+        }
+
+        // Remember which stream is playing.
+        m_nCurrentStream = nIndex;
+        m_nCurrentMusic  = -1;
+        return 0;
+    }
+
+    return -1;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLMixerSound::StopStream():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Stops stream playback.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if not.
+//==============================================================================================
+
+BOOL GS_SDLMixerSound::StopStream() {
+
+    // Exit if sound not initialized.
+    if (!m_bIsReady) {
+        return FALSE;
+    }
+
+    // Stop stream playback.
+    if (m_nFrequency > 0) {
+        SDL_AtomicSet(&m_nMusicActive, 0);
+        this->SendCommand(GS_SOUND_STOP_MUSIC);
+    }
+
+    m_nCurrentStream = -1;
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLMixerSound::IsStreamPlaying():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Checks if a stream is currently playing or paused.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if stream is playing or paused, FALSE if stopped.
+//==============================================================================================
+
+BOOL GS_SDLMixerSound::IsStreamPlaying() {
+
+    // Exit if sound not initialized.
+    if (!m_bIsReady) {
+        return FALSE;
+    }
+
+    // Is stream playing or paused?
+    return (SDL_AtomicGet(&m_nMusicActive) != 0);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLMixerSound::SetStreamVolume():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Sets the stream volume level.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if not.
+//==============================================================================================
+
+BOOL GS_SDLMixerSound::SetStreamVolume(int nVolume) {
+
+    // Exit if sound not initialized.
+    if (!m_bIsReady) {
+        return FALSE;
+    }
+
+    // Streams and music share the volume.
+    this->SetMusicVolume(nVolume);
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLMixerSound::GetStreamVolume():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Gets the current stream volume level.
+// ---------------------------------------------------------------------------------------------
+// Returns: The current stream volume (0-255).
+//==============================================================================================
+
+int GS_SDLMixerSound::GetStreamVolume() {
+
+    // Exit if sound not initialized.
+    if (!m_bIsReady) {
+        return 0;
+    }
+
+    return m_nMusicVolume;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLMixerSound::PauseStream():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Pauses or resumes stream playback.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if not.
+//==============================================================================================
+
+BOOL GS_SDLMixerSound::PauseStream(BOOL bPause) {
+
+    // Exit if sound not initialized.
+    if (!m_bIsReady) {
+        return FALSE;
+    }
+
+    if (m_nFrequency == 0) {
+        return FALSE;
+    }
+
+    return this->SendCommand(GS_SOUND_PAUSE_MUSIC, -1, bPause);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Sample Methods //////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLMixerSound::AddSample():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Loads a sound sample file and adds it to the sample list. WAV files are
+//          recommended for best compatibility, they are read from the sample cache already
+//          converted to the format of the audio device (see DecodeSample()).
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if not.
+//==============================================================================================
+
+BOOL GS_SDLMixerSound::AddSample(const char* pszFilename) {
+
+    // Exit if sound not initialized.
+    if (!m_bIsReady) {
+        return FALSE;
+    }
+
+    BYTE*         pBuffer;
+    unsigned long lLength;
+
+    // Use the sample if it has already been decoded by the asset loader.
+    if (g_gsAssetLoader.TakeSample(pszFilename, &pBuffer, &lLength)) {
+        return this->AddSample((Uint8*) pBuffer, (Uint32) lLength);
+    }
+
+    Uint8* pWave;
+    Uint32 uWaveLength;
+
+    // Decode the sample (or read it from the sample cache).
+    if (this->DecodeSample(pszFilename, &pWave, &uWaveLength)) {
+        return this->AddSample(pWave, uWaveLength);
+    }
+
+    GS_Sample Sample;
+
+    Sample.pChunk  = NULL;
+    Sample.pszLoad = NULL;
+
+    // Load the specified sample some other way SDL_mixer supports. SDL_mixer's loaders aren't
+    // thread-safe, so if the decoder thread is decoding a track the sample is loaded by the
+    // next Update() that finds it idle instead (it can't be played until then).
+    if (this->TryLockDecoder()) {
+        Sample.pChunk = LoadChunk(pszFilename);
+        this->UnlockDecoder();
+
+        // Was the sample loaded successfully?
+        if (!Sample.pChunk) {
+            GS_Error::Report("GS_SDL_MIXER_SOUND.CPP", 745, "Failed to load sample file!");
+            return FALSE;
+        }
+    }
+    else {
+        Sample.pszLoad = SDL_strdup(pszFilename);
+        m_nPendingLoads++;
+    }
+
+    // Add the sample to the list.
+    Sample.nVolume    = 255;
+    Sample.nPanning   = 128;
+    Sample.nMaxVoices = GS_SAMPLE_DEFAULT_VOICES;
+    Sample.nPriority  = GS_SAMPLE_DEFAULT_PRIORITY;
+
+    m_gsSampleList.AddItem(Sample);
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLMixerSound::AddSample():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Adds a sample that has already been decoded and converted to the format of the
+//          audio device (see DecodeSample()). The sample takes over the buffer, which must
+//          have been allocated with SDL_malloc().
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if not.
+//==============================================================================================
+
+BOOL GS_SDLMixerSound::AddSample(Uint8* pBuffer, Uint32 uLength) {
+
+    // Exit if sound not initialized.
+    if (!m_bIsReady || !pBuffer) {
+        SDL_free(pBuffer);
+        return FALSE;
+    }
+
+    // Create a chunk around the buffer (Mix_FreeChunk() frees both).
+    Mix_Chunk* pSample = (Mix_Chunk*) SDL_malloc(sizeof(Mix_Chunk));
+    if (!pSample) {
+        SDL_free(pBuffer);
+        GS_Error::Report("GS_SDL_MIXER_SOUND.CPP", 745, "Failed to load sample file!");
+        return FALSE;
+    }
+
+    pSample->allocated = 1;
+    pSample->abuf      = pBuffer;
+    pSample->alen      = uLength;
+    pSample->volume    = MIX_MAX_VOLUME;
+
+    // Add the sample to the list.
+    GS_Sample Sample;
+
+    Sample.pChunk     = pSample;
+    Sample.pszLoad    = NULL;
+    Sample.nVolume    = 255;
+    Sample.nPanning   = 128;
+    Sample.nMaxVoices = GS_SAMPLE_DEFAULT_VOICES;
+    Sample.nPriority  = GS_SAMPLE_DEFAULT_PRIORITY;
+
+    m_gsSampleList.AddItem(Sample);
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLMixerSound::AddSamples():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Loads a number of sound sample files in parallel and adds them to the sample list
+//          in the order they are given. Samples already decoded by the asset loader are taken
+//          from it, the others are loaded on up to GS_SAMPLE_MAX_THREADS threads (the calling
+//          thread being one of them).
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if all samples were added, FALSE if not.
+//==============================================================================================
+
+BOOL GS_SDLMixerSound::AddSamples(const char** ppszFilenames, int nNumFiles) {
+
+    // Exit if sound not initialized.
+    if (!m_bIsReady || !ppszFilenames || nNumFiles <= 0) {
+        return FALSE;
+    }
+
+    GS_SampleBatch Batch;
+
+    Batch.ppszFilenames = ppszFilenames;
+    Batch.ppBuffers     = new Uint8* [nNumFiles];
+    Batch.puLengths     = new Uint32 [nNumFiles];
+    Batch.nNumFiles     = nNumFiles;
+    SDL_AtomicSet(&Batch.nNextFile, 0);
+
+    int nNumLeft = 0;
+
+    // Take the samples that have already been decoded by the asset loader.
+    for (int nLoop = 0; nLoop < nNumFiles; nLoop++) {
+        BYTE*         pBuffer = NULL;
+        unsigned long lLength = 0;
+
+        if (!g_gsAssetLoader.TakeSample(ppszFilenames[nLoop], &pBuffer, &lLength)) {
+            pBuffer = NULL;
+            lLength = 0;
+            nNumLeft++;
+        }
+
+        Batch.ppBuffers[nLoop] = (Uint8*) pBuffer;
+        Batch.puLengths[nLoop] = (Uint32) lLength;
+    }
+
+    // Load the others in parallel (only possible with the device open).
+    if (nNumLeft > 0 && m_nFrequency > 0) {
+        SDL_Thread* pThreads[GS_SAMPLE_MAX_THREADS];
+        int nNumThreads = SDL_GetCPUCount();
+
+        if (nNumThreads > nNumLeft) {
+            nNumThreads = nNumLeft;
+        }
+        if (nNumThreads > GS_SAMPLE_MAX_THREADS) {
+            nNumThreads = GS_SAMPLE_MAX_THREADS;
+        }
+
+        for (int nThread = 1; nThread < nNumThreads; nThread++) {
+            pThreads[nThread] = SDL_CreateThread(LoadSamplesThread, "GS_SampleLoader", &Batch);
+        }
+
+        LoadSamplesThread(&Batch);
+
+        for (int nThread = 1; nThread < nNumThreads; nThread++) {
+            if (pThreads[nThread]) {
+                SDL_WaitThread(pThreads[nThread], NULL);
+            }
+        }
+    }
+
+    BOOL bResult = TRUE;
+
+    // Add the samples in order, samples that could not be loaded are loaded the normal way.
+    for (int nLoop = 0; nLoop < nNumFiles; nLoop++) {
+        if (Batch.ppBuffers[nLoop]) {
+            bResult = this->AddSample(Batch.ppBuffers[nLoop], Batch.puLengths[nLoop]) && bResult;
+        }
+        else {
+            bResult = this->AddSample(ppszFilenames[nLoop]) && bResult;
+        }
+    }
+
+    delete [] Batch.ppBuffers;
+    delete [] Batch.puLengths;
+
+    return bResult;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLMixerSound::LoadSamplesThread():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Claims the samples of a batch one at a time and decodes them (or reads them from
+//          the sample cache) until all samples have been claimed.
+// ---------------------------------------------------------------------------------------------
+// Returns: Zero.
+//==============================================================================================
+
+int GS_SDLMixerSound::LoadSamplesThread(void* pParam) {
+
+    GS_SampleBatch* pBatch = (GS_SampleBatch*) pParam;
+
+    for (;;) {
+        int nIndex = SDL_AtomicAdd(&pBatch->nNextFile, 1);
+
+        if (nIndex >= pBatch->nNumFiles) {
+            break;
         }
 
-        // Remember which stream is playing.
-        m_nCurrentStream = nIndex;
-        return 0;
+        // Skip the samples taken from the asset loader.
+        if (!pBatch->ppBuffers[nIndex]) {
+            DecodeSample(pBatch->ppszFilenames[nIndex], &pBatch->ppBuffers[nIndex],
+                         &pBatch->puLengths[nIndex]);
+        }
     }
 
-    return -1;
+    return 0;
 }
 
 
@@ -602,26 +2339,102 @@ int GS_SDLMixerSound::PlayStream(int nIndex, int nVolume) {
 
 
 //==============================================================================================
-// GS_SDLMixerSound::StopStream():
+// GS_SDLMixerSound::PlaySample():
 // ---------------------------------------------------------------------------------------------
-// Purpose: Stops stream playback.
+// Purpose: Plays a loaded sound sample on a voice of its own with optional volume and panning
+//          (the ones set with SetSampleVolume() and SetSamplePanning() if not given).
 // ---------------------------------------------------------------------------------------------
-// Returns: TRUE if successful, FALSE if not.
+// Notes: When the sample is already playing on as many voices as it may (see
+//        SetSampleVoices()) its oldest voice is started again. When all voices are playing,
+//        the oldest voice of the lowest priority is stolen, unless its priority is higher than
+//        the priority of the sample, in which case the sample is not played.
+// ---------------------------------------------------------------------------------------------
+// Returns: The voice playing the sample, or -1 if the sample was not played.
 //==============================================================================================
 
-BOOL GS_SDLMixerSound::StopStream() {
+int GS_SDLMixerSound::PlaySample(int nIndex, int nVolume, int nPanning) {
+
+    // Exit if sound not initialized or paused.
+    if (!m_bIsReady || m_bIsPaused || m_nFrequency == 0) {
+        return -1;
+    }
+
+    // Is index within bounds?
+    if ((nIndex < 0) || (nIndex >= m_gsSampleList.GetNumItems())) {
+        return -1;
+    }
+
+    GS_Sample Sample = m_gsSampleList[nIndex];
+
+    // Samples that are still to be loaded (see LoadPending()) aren't played.
+    if (!Sample.pChunk) {
+        return -1;
+    }
+
+    int nChannel = m_gsVoices.Allocate(nIndex, Sample.nMaxVoices, Sample.nPriority);
+    if (nChannel < 0) {
+        return -1;
+    }
+
+    GS_Voice* pVoice = &m_Voices[nChannel];
+
+    pVoice->nVolume  = (nVolume >= 0) ? SDL_min(nVolume, 255) : Sample.nVolume;
+    pVoice->nPanning = (nPanning >= 0) ? SDL_min(nPanning, 255) : Sample.nPanning;
+
+    // The voice counts as playing from now on, until the audio thread has played it (the
+    // audio thread stops whatever was playing on it before).
+    Uint32 uSerial = m_gsVoices.Start(nChannel, nIndex, Sample.nPriority);
+
+    if (!this->SendCommand(GS_SOUND_PLAY, nChannel, this->GetChannelVolume(nChannel),
+                           Sample.pChunk, uSerial)) {
+        m_gsVoices.Stop(nChannel);
+        return -1;
+    }
+
+    // Voices play in the center until they are panned.
+    if (pVoice->nPanning != 128) {
+        this->SetChannelPanning(nChannel);
+    }
+
+    // The handle of the voice is only valid for this playback.
+    return m_gsVoices.GetHandle(nChannel);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLMixerSound::SetSampleMaster():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Sets the master volume for all sound effects, including the ones playing.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_SDLMixerSound::SetSampleMaster(int nVolume) {
 
     // Exit if sound not initialized.
     if (!m_bIsReady) {
-        return FALSE;
+        return;
     }
 
-    // Stop stream playback.
-    Mix_HaltMusic();
+    // Make sure volume is within range (0 - 255).
+    if (nVolume < 0) {
+        nVolume = 0;
+    }
+    if (nVolume > 255) {
+        nVolume = 255;
+    }
 
-    m_nCurrentStream = -1;
+    m_nSampleMaster = nVolume;
 
-    return TRUE;
+    // The master volume is part of the volume of every voice.
+    for (int nChannel = 0; nChannel < GS_AUDIO_MAX_VOICES; nChannel++) {
+        if (m_gsVoices.IsPlaying(nChannel)) {
+            this->SetChannelVolume(nChannel);
+        }
+    }
 }
 
 
@@ -629,22 +2442,21 @@ BOOL GS_SDLMixerSound::StopStream() {
 
 
 //==============================================================================================
-// GS_SDLMixerSound::IsStreamPlaying():
+// GS_SDLMixerSound::GetSampleMaster():
 // ---------------------------------------------------------------------------------------------
-// Purpose: Checks if a stream is currently playing or paused.
+// Purpose: Gets the master volume for all sound effects.
 // ---------------------------------------------------------------------------------------------
-// Returns: TRUE if stream is playing or paused, FALSE if stopped.
+// Returns: The master sample volume (0-255).
 //==============================================================================================
 
-BOOL GS_SDLMixerSound::IsStreamPlaying() {
+int GS_SDLMixerSound::GetSampleMaster() {
 
     // Exit if sound not initialized.
     if (!m_bIsReady) {
-        return FALSE;
+        return 0;
     }
 
-    // Is stream playing or paused?
-    return Mix_PlayingMusic();
+    return m_nSampleMaster;
 }
 
 
@@ -652,14 +2464,15 @@ BOOL GS_SDLMixerSound::IsStreamPlaying() {
 
 
 //==============================================================================================
-// GS_SDLMixerSound::SetStreamVolume():
+// GS_SDLMixerSound::SetSampleVolume():
 // ---------------------------------------------------------------------------------------------
-// Purpose: Sets the stream volume level.
+// Purpose: Sets the volume new voices of a specific sample are played with when PlaySample()
+//          is not given a volume. Voices already playing keep their volume.
 // ---------------------------------------------------------------------------------------------
 // Returns: TRUE if successful, FALSE if not.
 //==============================================================================================
 
-BOOL GS_SDLMixerSound::SetStreamVolume(int nVolume) {
+BOOL GS_SDLMixerSound::SetSampleVolume(int nIndex, int nVolume) {
 
     // Exit if sound not initialized.
     if (!m_bIsReady) {
@@ -674,10 +2487,15 @@ BOOL GS_SDLMixerSound::SetStreamVolume(int nVolume) {
         nVolume = 255;
     }
 
-    // Set stream volume (convert 0-255 to SDL_mixer's 0-128 range).
-    Mix_VolumeMusic(nVolume * 128 / 255);
+    // Is index within bounds?
+    if ((nIndex >= 0) && (nIndex < m_gsSampleList.GetNumItems())) {
+        GS_Sample Sample = m_gsSampleList[nIndex];
+        Sample.nVolume = nVolume;
+        m_gsSampleList.SetItem(nIndex, Sample);
+        return TRUE;
+    }
 
-    return TRUE;
+    return FALSE;
 }
 
 
@@ -685,22 +2503,31 @@ BOOL GS_SDLMixerSound::SetStreamVolume(int nVolume) {
 
 
 //==============================================================================================
-// GS_SDLMixerSound::GetStreamVolume():
+// GS_SDLMixerSound::SetSamplePanning():
 // ---------------------------------------------------------------------------------------------
-// Purpose: Gets the current stream volume level.
+// Purpose: Sets the panning new voices of a specific sample are played with when PlaySample()
+//          is not given a panning (0 = left, 128 = center, 255 = right, -1 for center, like
+//          FSOUND_STEREOPAN). Voices already playing keep their panning.
 // ---------------------------------------------------------------------------------------------
-// Returns: The current stream volume (0-255).
+// Returns: TRUE if successful, FALSE if not.
 //==============================================================================================
 
-int GS_SDLMixerSound::GetStreamVolume() {
+BOOL GS_SDLMixerSound::SetSamplePanning(int nIndex, int nPanning) {
 
     // Exit if sound not initialized.
     if (!m_bIsReady) {
-        return 0;
+        return FALSE;
+    }
+
+    // Is index within bounds?
+    if ((nIndex >= 0) && (nIndex < m_gsSampleList.GetNumItems())) {
+        GS_Sample Sample = m_gsSampleList[nIndex];
+        Sample.nPanning = (nPanning < 0) ? 128 : SDL_min(nPanning, 255);
+        m_gsSampleList.SetItem(nIndex, Sample);
+        return TRUE;
     }
 
-    // Get stream volume (convert SDL_mixer's 0-128 range to 0-255).
-    return Mix_VolumeMusic(-1) * 255 / 128;
+    return FALSE;
 }
 
 
@@ -708,29 +2535,28 @@ int GS_SDLMixerSound::GetStreamVolume() {
 
 
 //==============================================================================================
-// GS_SDLMixerSound::PauseStream():
+// GS_SDLMixerSound::SetSampleVoices():
 // ---------------------------------------------------------------------------------------------
-// Purpose: Pauses or resumes stream playback.
+// Purpose: Sets how many voices a sample may play on at once (1 to GS_AUDIO_MAX_VOICES) and
+//          the priority of its voices (0-255, the higher the more important). Short sounds
+//          that are played over and over, like moves, should get few voices and a low priority.
 // ---------------------------------------------------------------------------------------------
 // Returns: TRUE if successful, FALSE if not.
 //==============================================================================================
 
-BOOL GS_SDLMixerSound::PauseStream(BOOL bPause) {
+BOOL GS_SDLMixerSound::SetSampleVoices(int nIndex, int nMaxVoices, int nPriority) {
 
-    // Exit if sound not initialized.
-    if (!m_bIsReady) {
+    // Is index within bounds?
+    if ((nIndex < 0) || (nIndex >= m_gsSampleList.GetNumItems())) {
         return FALSE;
     }
 
-    // Should stream be paused?
-    if (bPause) {
-        // Pause stream playback.
-        Mix_PauseMusic();
-    }
-    else {
-        // Resume stream playback.
-        Mix_ResumeMusic();
-    }
+    GS_Sample Sample = m_gsSampleList[nIndex];
+
+    Sample.nMaxVoices = SDL_max(1, SDL_min(nMaxVoices, GS_AUDIO_MAX_VOICES));
+    Sample.nPriority  = SDL_max(0, SDL_min(nPriority, 255));
+
+    m_gsSampleList.SetItem(nIndex, Sample);
 
     return TRUE;
 }
@@ -740,39 +2566,73 @@ BOOL GS_SDLMixerSound::PauseStream(BOOL bPause) {
 
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
-// Sample Methods //////////////////////////////////////////////////////////////////////////////
+// Voice Methods ///////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////
 
 
 //==============================================================================================
-// GS_SDLMixerSound::AddSample():
+// GS_SDLMixerSound::IsVoicePlaying():
 // ---------------------------------------------------------------------------------------------
-// Purpose: Loads a sound sample file and adds it to the sample list. WAV files are
-//          recommended for best compatibility.
+// Purpose: Checks if a voice returned by PlaySample() is still playing its sample.
 // ---------------------------------------------------------------------------------------------
-// Returns: TRUE if successful, FALSE if not.
+// Returns: TRUE if the voice is playing (or paused), FALSE if it has finished or was stolen.
 //==============================================================================================
 
-BOOL GS_SDLMixerSound::AddSample(const char* pszFilename) {
+BOOL GS_SDLMixerSound::IsVoicePlaying(int nVoice) {
 
-    // Exit if sound not initialized.
-    if (!m_bIsReady) {
+    return (m_gsVoices.FindHandle(nVoice) >= 0);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLMixerSound::StopVoice():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Stops a voice returned by PlaySample().
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if the voice was stopped, FALSE if it was not playing anymore.
+//==============================================================================================
+
+BOOL GS_SDLMixerSound::StopVoice(int nVoice) {
+
+    int nChannel = m_gsVoices.FindHandle(nVoice);
+    if (nChannel < 0) {
         return FALSE;
     }
 
-    Mix_Chunk* pSample;
+    // The voice is free at once, the audio thread halts the channel before it plays anything
+    // else on it.
+    m_gsVoices.Stop(nChannel);
 
-    // Load the specified sample file.
-    pSample = Mix_LoadWAV(pszFilename);
+    this->SendCommand(GS_SOUND_STOP, nChannel, 0, NULL, m_gsVoices.GetSerial(nChannel));
 
-    // Was the sample loaded successfully?
-    if (!pSample) {
-        GS_Error::Report("GS_SDL_MIXER_SOUND.CPP", 745, "Failed to load sample file!");
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLMixerSound::SetVoiceVolume():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Changes the volume of a voice returned by PlaySample() while it is playing, other
+//          voices of the same sample are not affected.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if the voice was not playing anymore.
+//==============================================================================================
+
+BOOL GS_SDLMixerSound::SetVoiceVolume(int nVoice, int nVolume) {
+
+    int nChannel = m_gsVoices.FindHandle(nVoice);
+    if (nChannel < 0) {
         return FALSE;
     }
 
-    // Add the sample to the list.
-    m_gsSampleList.AddItem(pSample);
+    m_Voices[nChannel].nVolume = SDL_max(0, SDL_min(nVolume, 255));
+    this->SetChannelVolume(nChannel);
 
     return TRUE;
 }
@@ -782,39 +2642,47 @@ BOOL GS_SDLMixerSound::AddSample(const char* pszFilename) {
 
 
 //==============================================================================================
-// GS_SDLMixerSound::PlaySample():
-// ---------------------------------------------------------------------------------------------
-// Purpose: Plays a loaded sound sample with optional volume and panning.
+// GS_SDLMixerSound::SetVoicePanning():
 // ---------------------------------------------------------------------------------------------
-// Notes: The panning parameter is currently ignored as SDL_mixer's panning requires a more
-//        complex channel-based approach.
+// Purpose: Changes the panning of a voice returned by PlaySample() while it is playing (0 is
+//          left, 128 center and 255 right), other voices of the same sample are not affected.
 // ---------------------------------------------------------------------------------------------
-// Returns: The channel number playing the sample, or -1 on error.
+// Returns: TRUE if successful, FALSE if the voice was not playing anymore.
 //==============================================================================================
 
-int GS_SDLMixerSound::PlaySample(int nIndex, int nVolume, int nPanning) {
+BOOL GS_SDLMixerSound::SetVoicePanning(int nVoice, int nPanning) {
 
-    // Panning parameter not currently implemented.
-    (void)nPanning;
-    
-    // Exit if sound not initialized or paused.
-    if (!m_bIsReady || m_bIsPaused) {
-        return -1;
+    int nChannel = m_gsVoices.FindHandle(nVoice);
+    if (nChannel < 0) {
+        return FALSE;
     }
 
-    // Is index within bounds?
-    if ((nIndex >= 0) && (nIndex < m_gsSampleList.GetNumItems())) {
-        // Have the user specified a valid volume?
-        if (nVolume >= 0) {
-            // Set the sample volume.
-            this->SetSampleVolume(nIndex, nVolume);
-        }
+    m_Voices[nChannel].nPanning = SDL_max(0, SDL_min(nPanning, 255));
+    this->SetChannelPanning(nChannel);
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLMixerSound::GetNumVoices():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Counts the voices that are playing (or paused).
+// ---------------------------------------------------------------------------------------------
+// Returns: The number of voices playing.
+//==============================================================================================
+
+int GS_SDLMixerSound::GetNumVoices() {
 
-        // Play the sample on the first available channel.
-        return Mix_PlayChannel(-1, m_gsSampleList[nIndex], 0);
+    // Exit if the audio device has not been opened.
+    if (m_nFrequency == 0) {
+        return 0;
     }
 
-    return -1;
+    return m_gsVoices.GetNumPlaying();
 }
 
 
@@ -822,30 +2690,35 @@ int GS_SDLMixerSound::PlaySample(int nIndex, int nVolume, int nPanning) {
 
 
 //==============================================================================================
-// GS_SDLMixerSound::SetSampleMaster():
+// GS_SDLMixerSound::SetChannelVolume():
 // ---------------------------------------------------------------------------------------------
-// Purpose: Sets the master volume for all sound effects.
+// Purpose: Sets the volume of a mixing channel to the volume of its voice scaled by the sample
+//          master volume (the volume of the sample data itself is never changed).
 // ---------------------------------------------------------------------------------------------
 // Returns: Nothing.
 //==============================================================================================
 
-void GS_SDLMixerSound::SetSampleMaster(int nVolume) {
+void GS_SDLMixerSound::SetChannelVolume(int nChannel) {
 
-    // Exit if sound not initialized.
-    if (!m_bIsReady) {
-        return;
-    }
+    this->SendCommand(GS_SOUND_VOLUME, nChannel, this->GetChannelVolume(nChannel), NULL,
+                      m_gsVoices.GetSerial(nChannel));
+}
 
-    // Make sure volume is within range (0 - 255).
-    if (nVolume < 0) {
-        nVolume = 0;
-    }
-    if (nVolume > 255) {
-        nVolume = 255;
-    }
 
-    // Set master volume for all channels (convert 0-255 to SDL_mixer's 0-128 range).
-    Mix_Volume(-1, nVolume * 128 / 255);
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLMixerSound::GetChannelVolume():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Works out the SDL_mixer volume of a mixing channel (see SetChannelVolume()).
+// ---------------------------------------------------------------------------------------------
+// Returns: The volume of the channel (0 - MIX_MAX_VOLUME).
+//==============================================================================================
+
+int GS_SDLMixerSound::GetChannelVolume(int nChannel) {
+
+    return m_Voices[nChannel].nVolume * m_nSampleMaster * MIX_MAX_VOLUME / (255 * 255);
 }
 
 
@@ -853,22 +2726,33 @@ void GS_SDLMixerSound::SetSampleMaster(int nVolume) {
 
 
 //==============================================================================================
-// GS_SDLMixerSound::GetSampleMaster():
+// GS_SDLMixerSound::SetChannelPanning():
 // ---------------------------------------------------------------------------------------------
-// Purpose: Gets the master volume for all sound effects.
+// Purpose: Pans a mixing channel to the panning of its voice with a constant power pan law
+//          that plays both sides at full volume in the center. The audio thread hands the
+//          gains to the panning effect, which is only registered on the channel (by SDL_mixer,
+//          for the rest of the playback) once the voice is panned off center.
 // ---------------------------------------------------------------------------------------------
-// Returns: The master sample volume (0-255).
+// Returns: Nothing.
 //==============================================================================================
 
-int GS_SDLMixerSound::GetSampleMaster() {
+void GS_SDLMixerSound::SetChannelPanning(int nChannel) {
 
-    // Exit if sound not initialized.
-    if (!m_bIsReady) {
-        return 0;
+    GS_Voice* pVoice = &m_Voices[nChannel];
+
+    // The effect pans 16 bit stereo (the format the device is opened with).
+    if ((m_nChannels != 2) || (m_uFormat != AUDIO_S16SYS)) {
+        return;
     }
 
-    // Get master volume for all channels (convert SDL_mixer's 0-128 range to 0-255).
-    return Mix_Volume(-1, -1) * 255 / 128;
+    // Map 0, 128 and 255 to exactly left, center and right.
+    int   nPanning = (pVoice->nPanning <= 128) ? pVoice->nPanning : pVoice->nPanning + 1;
+    float fAngle   = nPanning * GS_PI / (2.0f * 256.0f);
+    int   nLeft    = (int) (SDL_min(1.0f, 1.41421356f * cosf(fAngle)) * 16384.0f + 0.5f);
+    int   nRight   = (int) (SDL_min(1.0f, 1.41421356f * sinf(fAngle)) * 16384.0f + 0.5f);
+
+    this->SendCommand(GS_SOUND_PANNING, nChannel, (nLeft << 16) | nRight, NULL,
+                      m_gsVoices.GetSerial(nChannel));
 }
 
 
@@ -876,36 +2760,29 @@ int GS_SDLMixerSound::GetSampleMaster() {
 
 
 //==============================================================================================
-// GS_SDLMixerSound::SetSampleVolume():
+// GS_SDLMixerSound::PanEffect():
 // ---------------------------------------------------------------------------------------------
-// Purpose: Sets the volume for a specific sample.
+// Purpose: Called by SDL_mixer on the audio thread for every buffer a panned channel plays,
+//          scales the left and right side of the channel by the gains of its voice.
 // ---------------------------------------------------------------------------------------------
-// Returns: TRUE if successful, FALSE if not.
+// Returns: Nothing.
 //==============================================================================================
 
-BOOL GS_SDLMixerSound::SetSampleVolume(int nIndex, int nVolume) {
+void GS_SDLMixerSound::PanEffect(int nChannel, void* pStream, int nLength, void* pUserData) {
 
-    // Exit if sound not initialized.
-    if (!m_bIsReady) {
-        return FALSE;
-    }
+    (void)nChannel;
 
-    // Make sure volume is within range (0 - 255).
-    if (nVolume < 0) {
-        nVolume = 0;
-    }
-    if (nVolume > 255) {
-        nVolume = 255;
-    }
+    int nGains = SDL_AtomicGet(&((GS_Voice*) pUserData)->nPanGains);
+    int nLeft  = nGains >> 16;
+    int nRight = nGains & 0xFFFF;
 
-    // Is index within bounds?
-    if ((nIndex >= 0) && (nIndex < m_gsSampleList.GetNumItems())) {
-        // Set sample volume (convert 0-255 to SDL_mixer's 0-128 range).
-        Mix_VolumeChunk(m_gsSampleList[nIndex], nVolume * 128 / 255);
-        return TRUE;
-    }
+    Sint16* pSamples = (Sint16*) pStream;
 
-    return FALSE;
+    for (int nFrame = nLength / 4; nFrame > 0; nFrame--) {
+        pSamples[0] = (Sint16) ((pSamples[0] * nLeft) >> 14);
+        pSamples[1] = (Sint16) ((pSamples[1] * nRight) >> 14);
+        pSamples += 2;
+    }
 }
 
 
@@ -913,26 +2790,19 @@ BOOL GS_SDLMixerSound::SetSampleVolume(int nIndex, int nVolume) {
 
 
 //==============================================================================================
-// GS_SDLMixerSound::SetSamplePanning():
+// GS_SDLMixerSound::PanDone():
 // ---------------------------------------------------------------------------------------------
-// Purpose: Sets the panning for a specific sample.
+// Purpose: Called by SDL_mixer when a channel stops playing and its effects are removed, so
+//          the panning effect is registered again the next time the voice is panned.
 // ---------------------------------------------------------------------------------------------
-// Notes: Currently not fully implemented as SDL_mixer requires a channel-based approach for
-//        panning, which is more complex than the sample-based approach used by FMOD.
-// ---------------------------------------------------------------------------------------------
-// Returns: TRUE (placeholder).
+// Returns: Nothing.
 //==============================================================================================
 
-BOOL GS_SDLMixerSound::SetSamplePanning(int nIndex, int nPanning) {
+void GS_SDLMixerSound::PanDone(int nChannel, void* pUserData) {
 
-    // Panning not currently implemented.
-    (void)nIndex;
-    (void)nPanning;
+    (void)nChannel;
 
-    // SDL_mixer panning requires channel-based approach.
-    // This would need to be implemented using Mix_SetPanning() on active channels.
-    
-    return TRUE;
+    SDL_AtomicSet(&((GS_Voice*) pUserData)->nPanned, 0);
 }
 
 
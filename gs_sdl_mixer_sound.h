@@ -25,8 +25,12 @@
 // ---------------------------------------------------------------------------------------------
 #include "gs_object.h"
 #include "gs_list.h"
+#include "gs_ring_buffer.h"
+#include "gs_audio_stats.h"
+#include "gs_voice_allocator.h"
 #include "gs_error.h"
 #include "gs_platform.h"
+#include "gs_pack.h"
 //==============================================================================================
 
 
@@ -37,6 +41,140 @@
 //==============================================================================================
 
 
+//==============================================================================================
+// Audio device defines (buffer sizes are in sample frames).
+// ---------------------------------------------------------------------------------------------
+#define GS_AUDIO_DEFAULT_FRAMES 2048 // Standard buffer size (about 46 ms at 44.1kHz).
+#define GS_AUDIO_LOW_FRAMES     512  // Low latency buffer size (about 12 ms at 44.1kHz).
+#define GS_AUDIO_MIN_FRAMES     256  // Smallest buffer size accepted.
+#define GS_AUDIO_MAX_FRAMES     4096 // Largest buffer size the underrun fallback grows to.
+// ---------------------------------------------------------------------------------------------
+#define GS_AUDIO_QUEUE_SIZE 256 // Commands the game thread may queue between two mixes.
+//==============================================================================================
+
+
+//==============================================================================================
+// Voice defines (a voice is a mixing channel playing a sample).
+// ---------------------------------------------------------------------------------------------
+#define GS_AUDIO_MAX_VOICES 32 // Number of voices, which bounds the cost of mixing.
+// ---------------------------------------------------------------------------------------------
+#define GS_SAMPLE_DEFAULT_VOICES   4   // Voices a sample may play on at once unless changed.
+#define GS_SAMPLE_DEFAULT_PRIORITY 128 // Priority of a sample unless changed (0-255, highest).
+//==============================================================================================
+
+
+//==============================================================================================
+// Music defines.
+// ---------------------------------------------------------------------------------------------
+#define GS_MUSIC_CHANNEL       GS_AUDIO_MAX_VOICES // First mixing channel decoded music plays on.
+#define GS_MUSIC_CHANNELS      2                   // One fades out while the next fades in.
+#define GS_MUSIC_QUEUE_SIZE    64                  // Tracks waiting to be decoded at most.
+#define GS_MUSIC_DECODE_LIMIT  (64 * 1024 * 1024)  // Bytes of decoded music kept at most.
+#define GS_MUSIC_MAX_CROSSFADE 10000               // Longest crossfade between tracks (ms).
+//==============================================================================================
+
+
+//==============================================================================================
+// Commands the game thread sends the audio thread (carried out after the next buffer is mixed).
+// ---------------------------------------------------------------------------------------------
+#define GS_SOUND_PLAY         1 // Play a sample on a channel.
+#define GS_SOUND_STOP         2 // Halt a channel.
+#define GS_SOUND_VOLUME       3 // Set the volume of a channel.
+#define GS_SOUND_PANNING      4 // Set the panning gains of a channel.
+#define GS_SOUND_PAUSE        5 // Pause or resume all channels and the music.
+#define GS_SOUND_PLAY_MUSIC   6 // Play a music track or stream.
+#define GS_SOUND_STOP_MUSIC   7 // Halt the music.
+#define GS_SOUND_MUSIC_VOLUME 8 // Set the music volume.
+#define GS_SOUND_PAUSE_MUSIC  9 // Pause or resume the music.
+#define GS_SOUND_MUSIC_FADE   10 // Set the time music crossfades over.
+//==============================================================================================
+
+
+//==============================================================================================
+// Sample cache defines.
+// ---------------------------------------------------------------------------------------------
+#define GS_SAMPLECACHE_MAGIC     "GSSC"   // Identifies a sample cache file.
+#define GS_SAMPLECACHE_VERSION   1        // Version of the sample cache format.
+#define GS_SAMPLECACHE_DIRECTORY "cache/" // Default directory of the sample cache files.
+#define GS_SAMPLECACHE_EXTENSION ".gsc"   // Extension of the sample cache files.
+#define GS_SAMPLECACHE_MAX_NAME  128      // Maximum length of the source filename (incl. zero).
+// ---------------------------------------------------------------------------------------------
+#define GS_SAMPLE_MAX_THREADS 8 // Maximum number of threads AddSamples() loads samples on.
+//==============================================================================================
+
+
+//==============================================================================================
+// Sample cache structures (native byte order, cache files are not meant to be shared). The
+// header is followed by the sample data in the format of the audio device it was saved for,
+// there is a cache file for every device format a sample has been played with.
+// ---------------------------------------------------------------------------------------------
+typedef struct GS_SAMPLECACHE_HEADER
+{
+    char         szMagic[4];   // GS_SAMPLECACHE_MAGIC (not zero terminated).
+    unsigned int uVersion;     // GS_SAMPLECACHE_VERSION.
+    unsigned int uSourceSize;  // Size of the source sample file in bytes.
+    unsigned int uSourceStamp; // Modification time of the source sample file (its hash if the
+                               // sample is in the pack).
+    unsigned int uFrequency;   // Sample rate of the sample data.
+    unsigned int uFormat;      // Sample format of the sample data (AUDIO_S16SYS etc).
+    unsigned int uChannels;    // Number of channels of the sample data.
+    unsigned int uLength;      // Length of the sample data in bytes.
+    char         szSource[GS_SAMPLECACHE_MAX_NAME]; // Filename of the source sample.
+} GS_SampleCacheHeader;
+// ---------------------------------------------------------------------------------------------
+typedef struct GS_SAMPLE
+{
+    Mix_Chunk* pChunk;     // The sample data (in the format of the audio device, NULL until
+                           // loaded).
+    char*      pszLoad;    // Filename of the sample if Update() is still to load it, else NULL.
+    int        nVolume;    // Volume new voices of the sample are played with (0-255).
+    int        nPanning;   // Panning new voices of the sample are played with (0-255).
+    int        nMaxVoices; // Voices the sample may play on at once.
+    int        nPriority;  // Priority of the voices of the sample when voices are stolen.
+} GS_Sample;
+// ---------------------------------------------------------------------------------------------
+typedef struct GS_MUSIC_TRACK
+{
+    GS_File*      pFile;  // The mapped music file (NULL if the track is in the pack).
+    const BYTE*   pData;  // The contents of the music file (in the pack or the mapped file).
+    unsigned long lSize;  // Size of the contents in bytes.
+    Mix_Music*    pMusic; // Streams the track from memory until it has been decoded.
+    void*         pChunk; // The whole track in the format of the device (a Mix_Chunk, set by
+                          // the decoder thread, NULL until decoded).
+} GS_MusicTrack;
+// ---------------------------------------------------------------------------------------------
+typedef struct GS_VOICE
+{
+    int nVolume;  // Volume of the voice (0-255).
+    int nPanning; // Panning of the voice (0 = left, 128 = center, 255 = right).
+
+    Uint32       uMixSerial; // Serial of the playback started on the channel (audio thread).
+    SDL_atomic_t nPanGains;  // Left (high 16 bits) and right gain of the voice (1.0 = 16384),
+                             // read by the panning effect on the audio thread.
+    SDL_atomic_t nPanned;    // Whether the panning effect is registered on the channel (it is
+                             // removed by SDL_mixer when the channel stops playing).
+} GS_Voice;
+// ---------------------------------------------------------------------------------------------
+typedef struct GS_SOUND_COMMAND
+{
+    int    nType;    // GS_SOUND_PLAY etc.
+    int    nChannel; // The channel the command is for.
+    void*  pData;    // GS_SOUND_PLAY: the Mix_Chunk, GS_SOUND_PLAY_MUSIC: the Mix_Music.
+    int    nValue;   // The volume, the panning gains, whether to pause or to loop.
+    Uint32 uSerial;  // GS_SOUND_PLAY, GS_SOUND_PLAY_MUSIC: the number of the playback.
+} GS_SoundCommand;
+// ---------------------------------------------------------------------------------------------
+typedef struct GS_SAMPLE_BATCH
+{
+    const char** ppszFilenames; // Filenames of the samples to load.
+    Uint8**      ppBuffers;     // Loaded sample data (NULL if not loaded).
+    Uint32*      puLengths;     // Length of the loaded sample data in bytes.
+    int          nNumFiles;     // Number of samples to load.
+    SDL_atomic_t nNextFile;     // Index of the next sample to be claimed by a thread.
+} GS_SampleBatch;
+//==============================================================================================
+
+
 ////////////////////////////////////////////////////////////////////////////////////////////////
 // Class Definition. ///////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////
@@ -50,13 +188,95 @@ private:
     BOOL m_bIsReady;        // Whether sound system has been initialized.
     BOOL m_bIsPaused;       // Whether sound system is paused or not.
     
-    GS_List<Mix_Music*> m_gsMusicList;  // List of loaded music tracks (MP3, OGG, WAV, etc.).
-    GS_List<Mix_Music*> m_gsStreamList; // List of loaded audio streams (same as music in SDL_mixer).
-    GS_List<Mix_Chunk*> m_gsSampleList; // List of loaded sound samples (WAV files).
-    
-    int m_nMasterVolume;  // Master volume for all music, streams and samples (0-255).
-    int m_nCurrentMusic;  // Index of currently playing music track (-1 if none).
-    int m_nCurrentStream; // Index of currently playing stream (-1 if none).
+    GS_List<GS_MusicTrack*> m_gsMusicList;  // List of loaded music tracks (MP3, OGG, WAV, etc.).
+    GS_List<GS_MusicTrack*> m_gsStreamList; // List of loaded audio streams (same as music).
+    GS_List<GS_Sample>      m_gsSampleList; // List of loaded sound samples (WAV files).
+
+    SDL_Thread*  m_pDecoderThread;  // Decodes the music tracks ahead of playing them.
+    SDL_sem*     m_pDecoderSignal;  // Posted for every track queued and to stop the thread.
+    SDL_mutex*   m_pDecoderLock;    // Held around every SDL_mixer load and free (its decoders
+                                    // aren't thread-safe), the game thread only tries it.
+    SDL_atomic_t m_nDecoderQuit;    // Tells the decoder thread to stop.
+    GS_RingBuffer<GS_MusicTrack*> m_gsDecodeQueue; // Tracks waiting to be decoded.
+    GS_List<GS_MusicTrack*>       m_gsNewTracks;   // Tracks added since the last Update().
+
+    int m_nPendingLoads; // Tracks and samples added while the decoder thread was busy.
+    int m_nReopenFrames; // Buffer size to reopen the device with (0 if it isn't to be).
+
+    int m_nMasterVolume;   // Master volume for all music, streams and samples (0-255).
+    int m_nCurrentMusic;   // Index of currently playing music track (-1 if none).
+    int m_nCurrentStream;  // Index of currently playing stream (-1 if none).
+    BOOL m_bMusicLoop;     // Whether the current music track loops.
+    int m_nMusicVolume;    // Volume of the music and streams (0-255).
+    int m_nMusicCrossfade; // Time music tracks crossfade over (milliseconds, 0 for none).
+
+    Uint32       m_uMusicSerial; // Number of the last music playback started.
+    SDL_atomic_t m_nMusicActive; // Serial of the music playing (set by the game thread when it
+                                 // starts, cleared by the audio thread when it ends).
+
+    Uint32 m_uMixMusicSerial[GS_MUSIC_CHANNELS + 1]; // Serial of the music started by the audio
+                                                     // thread on each music channel (the last
+                                                     // one for streamed music).
+    int    m_nMixMusicChannel; // Music channel decoded music was last started on (audio thread).
+    int    m_nMixCrossfade;    // Time music crossfades over (audio thread).
+
+    GS_RingBuffer<GS_SoundCommand> m_gsCommands; // Commands waiting for the audio thread.
+
+    GS_VoiceAllocator m_gsVoices;                    // Which sample plays on which channel.
+    GS_Voice          m_Voices[GS_AUDIO_MAX_VOICES]; // Volume and panning of each channel.
+    int               m_nSampleMaster;               // Master volume for all samples (0-255).
+
+    int    m_nBufferFrames; // Size of the device buffer in sample frames.
+    int    m_nFrequency;    // Sample rate of the opened device (0 if not opened).
+    Uint16 m_uFormat;       // Sample format of the opened device.
+    int    m_nChannels;     // Number of output channels of the opened device.
+
+    GS_AudioStats m_gsStats; // Voices, post mix times and underruns counted by the audio thread.
+
+    BOOL OpenDevice(int nFrequency, Uint16 uFormat, int nChannels, int nFrames,
+                    int nAllowedChanges);
+    BOOL ReopenDevice(int nFrames);
+    void LoadPending();
+    BOOL TryLockDecoder();
+    void UnlockDecoder();
+
+    void SetChannelVolume(int nChannel);
+    int  GetChannelVolume(int nChannel);
+    void SetChannelPanning(int nChannel);
+
+    BOOL SendCommand(int nType, int nChannel = -1, int nValue = 0, void* pData = NULL,
+                     Uint32 uSerial = 0);
+    BOOL StartMusic(GS_MusicTrack* pTrack, BOOL bLoop);
+    void MixCommands();
+
+    static SDL_RWops* OpenPackFile(const char* pszFilename);
+    static GS_MusicTrack* LoadTrack(const char* pszFilename, BOOL bOpen);
+    static Mix_Music* LoadMusic(const GS_MusicTrack* pTrack);
+    static Mix_Chunk* LoadChunk(const char* pszFilename);
+    static void FreeTrack(GS_MusicTrack* pTrack);
+    BOOL PlayTrack(GS_MusicTrack* pTrack, int nLoops, Uint32 uSerial);
+    void FadeOutMusic(int nFade, BOOL bHaltStream);
+
+    BOOL AddTrack(GS_List<GS_MusicTrack*>* pList, const char* pszFilename);
+    void StartDecoder();
+    void StopDecoder();
+    static int DecodeMusicThread(void* pParam);
+    static void MixDone(void* pUserData, Uint8* pStream, int nLength);
+    static void ChannelDone(int nChannel);
+    static void MusicDone();
+
+    static BOOL GetCacheName(const char* pszFilename, int nFrequency, Uint16 uFormat,
+                             int nChannels, char* pszCacheName);
+    static BOOL GetSourceStamp(const char* pszFilename, unsigned int* puSize,
+                               unsigned int* puStamp);
+    static BOOL LoadCache(const char* pszFilename, int nFrequency, Uint16 uFormat, int nChannels,
+                          Uint8** ppBuffer, Uint32* puLength);
+    static void SaveCache(const char* pszFilename, int nFrequency, Uint16 uFormat, int nChannels,
+                          const Uint8* pBuffer, Uint32 uLength);
+    static int  LoadSamplesThread(void* pParam);
+
+    static void PanEffect(int nChannel, void* pStream, int nLength, void* pUserData);
+    static void PanDone(int nChannel, void* pUserData);
 
 protected:
 
@@ -80,12 +300,30 @@ public:
     void Pause(BOOL bPause);
     void SetMasterVolume(int nVolume);
     int  GetMasterVolume() { return m_nMasterVolume; }
+
+    // Latency methods (the buffer size may be changed before or after initializing).
+    void SetBufferSize(int nFrames);
+    int  GetBufferSize() { return m_nBufferFrames; }
+    int  GetFrequency()  { return m_nFrequency; }
+    int  GetUnderruns()  { return m_gsStats.GetDeviceUnderruns(); }
+    void Update();
+
+    // Statistics methods (counted by the audio thread, GetMixTime() in milliseconds).
+    int   GetActiveVoices()          { return m_gsStats.GetActiveVoices(); }
+    int   GetPeakVoices()            { return m_gsStats.GetPeakVoices(); }
+    int   GetTotalUnderruns()        { return m_gsStats.GetUnderruns(); }
+    float GetMixTime(float fPercent) { return m_gsStats.GetPercentile(fPercent); }
+    BOOL  WriteStats(const char* pszFilename) {
+        return m_gsStats.WriteStats(pszFilename, "GS_SDLMixerSound (SDL_mixer, post mix only)");
+    }
     
     // Utility methods.
     static BOOL IsMIDIFile(const char* pszFilename) {
         const char* pExt = strrchr(pszFilename, '.');
         return pExt && (strcasecmp(pExt, ".mid") == 0 || strcasecmp(pExt, ".midi") == 0);
     }
+    static BOOL DecodeSample(const char* pszFilename, Uint8** ppBuffer, Uint32* puLength);
+    static void SetCacheDirectory(const char* pszDirectory);
     
     // Music methods (MOD, MP3, OGG, WAV files for background music).
     // Note: MIDI files not supported on Apple platforms.
@@ -96,6 +334,8 @@ public:
     BOOL  IsMusicPlaying(int nIndex);
     void  SetMusicVolume(int nVolume);
     int   GetMusicVolume();
+    void  SetMusicCrossfade(int nMilliseconds);
+    int   GetMusicCrossfade() { return m_nMusicCrossfade; }
     
     // Stream methods (MP3, OGG, WAV files for streaming audio).
     // Note: In SDL_mixer, streams and music both use Mix_Music*.
@@ -109,11 +349,21 @@ public:
     
     // Sample methods (WAV files for sound effects).
     BOOL AddSample(const char* pszFilename);
+    BOOL AddSample(Uint8* pBuffer, Uint32 uLength);
+    BOOL AddSamples(const char** ppszFilenames, int nNumFiles);
     int  PlaySample(int nIndex, int nVolume = -1, int nPanning = -1);
     void SetSampleMaster(int nVolume);
     int  GetSampleMaster();
     BOOL SetSampleVolume(int nIndex, int nVolume);
     BOOL SetSamplePanning(int nIndex, int nPanning);
+    BOOL SetSampleVoices(int nIndex, int nMaxVoices, int nPriority = GS_SAMPLE_DEFAULT_PRIORITY);
+
+    // Voice methods (a voice is one playback of a sample, as returned by PlaySample()).
+    BOOL IsVoicePlaying(int nVoice);
+    BOOL StopVoice(int nVoice);
+    BOOL SetVoiceVolume(int nVoice, int nVolume);
+    BOOL SetVoicePanning(int nVoice, int nPanning);
+    int  GetNumVoices();
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,1961 @@
+/*============================================================================================+
+ | Game System (GS) Library                                                                   |
+ |--------------------------------------------------------------------------------------------|
+ | FILES: gs_sdl_sound.cpp, gs_sdl_sound.h                                                    |
+ |--------------------------------------------------------------------------------------------|
+ | CLASS: GS_SDLSound                                                                         |
+ |--------------------------------------------------------------------------------------------|
+ | ABOUT: Software mixer implementation of the GS audio system. Opens the SDL audio device    |
+ |        directly and mixes the voices itself on the audio thread (with SSE2 or NEON where   |
+ |        available), so it needs nothing but SDL2. The game thread never takes the audio     |
+ |        device lock, it hands its commands to the audio thread through a lock-free queue.   |
+ |        A drop-in replacement for GS_SDLMixerSound on builds without SDL_mixer, but it only |
+ |        plays WAV files.                                                                    |
+ |--------------------------------------------------------------------------------------------|
+ |                                                                                    10/2026 |
+ +============================================================================================*/
+
+
+#ifdef GS_USE_SDL_SOUND
+
+
+//==============================================================================================
+// Include Game System (GS) header files.
+// ---------------------------------------------------------------------------------------------
+#include "gs_sdl_sound.h"
+#include "gs_asset_loader.h"
+#include "gs_math.h"
+//==============================================================================================
+
+
+//==============================================================================================
+// Include standard C library header files.
+// ---------------------------------------------------------------------------------------------
+#include <stdio.h>
+#include <math.h>
+//==============================================================================================
+
+
+//==============================================================================================
+// Include SIMD header files (SSE2 on x86, NEON on ARM, plain C everywhere else).
+// ---------------------------------------------------------------------------------------------
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define GS_SOUND_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define GS_SOUND_NEON
+#include <arm_neon.h>
+#endif
+//==============================================================================================
+
+
+//==============================================================================================
+// Global variables.
+// ---------------------------------------------------------------------------------------------
+static SDL_atomic_t g_nDeviceFrequency; // Sample rate of the opened device (0 if not opened).
+//==============================================================================================
+
+
+//==============================================================================================
+// AddFrames():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Converts 16 bit stereo frames to floats, scales them by the gains of the left and
+//          right side and adds them to the mix, eight samples at a time where SIMD is there.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+static void AddFrames(float* pfMix, const Sint16* pData, int nFrames, float fLeft, float fRight) {
+
+    int nCount = nFrames * 2;
+    int nLoop  = 0;
+
+#if defined(GS_SOUND_SSE2)
+    __m128 vGains = _mm_setr_ps(fLeft, fRight, fLeft, fRight);
+
+    for (; nLoop + 8 <= nCount; nLoop += 8) {
+        __m128i vData = _mm_loadu_si128((const __m128i*) (pData + nLoop));
+
+        // Sign extend the samples to 32 bits (by shifting them down from the top half).
+        __m128 vLow  = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(vData, vData), 16));
+        __m128 vHigh = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(vData, vData), 16));
+
+        _mm_storeu_ps(pfMix + nLoop,
+                      _mm_add_ps(_mm_loadu_ps(pfMix + nLoop), _mm_mul_ps(vLow, vGains)));
+        _mm_storeu_ps(pfMix + nLoop + 4,
+                      _mm_add_ps(_mm_loadu_ps(pfMix + nLoop + 4), _mm_mul_ps(vHigh, vGains)));
+    }
+#elif defined(GS_SOUND_NEON)
+    const float fGains[4] = { fLeft, fRight, fLeft, fRight };
+    float32x4_t vGains    = vld1q_f32(fGains);
+
+    for (; nLoop + 8 <= nCount; nLoop += 8) {
+        int16x8_t vData = vld1q_s16(pData + nLoop);
+
+        float32x4_t vLow  = vcvtq_f32_s32(vmovl_s16(vget_low_s16(vData)));
+        float32x4_t vHigh = vcvtq_f32_s32(vmovl_s16(vget_high_s16(vData)));
+
+        vst1q_f32(pfMix + nLoop, vmlaq_f32(vld1q_f32(pfMix + nLoop), vLow, vGains));
+        vst1q_f32(pfMix + nLoop + 4, vmlaq_f32(vld1q_f32(pfMix + nLoop + 4), vHigh, vGains));
+    }
+#endif
+
+    // The frames left over (all of them without SIMD).
+    for (; nLoop < nCount; nLoop += 2) {
+        pfMix[nLoop]     += pData[nLoop] * fLeft;
+        pfMix[nLoop + 1] += pData[nLoop + 1] * fRight;
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// StoreFrames():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Clips the mix to -1.0 to 1.0 and converts it to 16 bit stereo frames for the
+//          device, rounding to the nearest value the same way with and without SIMD (so the
+//          output doesn't depend on the buffer length). 32 bit ARM has no rounding conversion
+//          and converts without SIMD.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+static void StoreFrames(Sint16* pOutput, const float* pfMix, int nFrames) {
+
+    int nCount = nFrames * 2;
+    int nLoop  = 0;
+
+#if defined(GS_SOUND_SSE2)
+    __m128 vMin   = _mm_set1_ps(-1.0f);
+    __m128 vMax   = _mm_set1_ps(1.0f);
+    __m128 vScale = _mm_set1_ps(32767.0f);
+
+    for (; nLoop + 8 <= nCount; nLoop += 8) {
+        __m128 vLow  = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(pfMix + nLoop), vMin), vMax);
+        __m128 vHigh = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(pfMix + nLoop + 4), vMin), vMax);
+
+        __m128i vData = _mm_packs_epi32(_mm_cvtps_epi32(_mm_mul_ps(vLow, vScale)),
+                                        _mm_cvtps_epi32(_mm_mul_ps(vHigh, vScale)));
+
+        _mm_storeu_si128((__m128i*) (pOutput + nLoop), vData);
+    }
+#elif defined(GS_SOUND_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+    float32x4_t vMin   = vdupq_n_f32(-1.0f);
+    float32x4_t vMax   = vdupq_n_f32(1.0f);
+    float32x4_t vScale = vdupq_n_f32(32767.0f);
+
+    for (; nLoop + 8 <= nCount; nLoop += 8) {
+        float32x4_t vLow  = vminq_f32(vmaxq_f32(vld1q_f32(pfMix + nLoop), vMin), vMax);
+        float32x4_t vHigh = vminq_f32(vmaxq_f32(vld1q_f32(pfMix + nLoop + 4), vMin), vMax);
+
+        int16x8_t vData = vcombine_s16(vqmovn_s32(vcvtnq_s32_f32(vmulq_f32(vLow, vScale))),
+                                       vqmovn_s32(vcvtnq_s32_f32(vmulq_f32(vHigh, vScale))));
+
+        vst1q_s16(pOutput + nLoop, vData);
+    }
+#endif
+
+    // The samples left over (all of them without SIMD).
+    for (; nLoop < nCount; nLoop++) {
+        float fSample = SDL_max(-1.0f, SDL_min(pfMix[nLoop], 1.0f));
+        pOutput[nLoop] = (Sint16) lrintf(fSample * 32767.0f);
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Constructor/Destructor Methods. /////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::GS_SDLSound():
+// ---------------------------------------------------------------------------------------------
+// Purpose: The constructor, initializes class data to defaults when class object is created.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+GS_SDLSound::GS_SDLSound() : m_gsVoices(GS_AUDIO_NUM_VOICES, GS_AUDIO_MAX_VOICES),
+                             m_gsCommands(GS_AUDIO_QUEUE_SIZE) {
+
+    m_bIsReady  = FALSE;
+    m_bIsPaused = FALSE;
+
+    m_nMasterVolume = 128;
+    m_nMusicVolume  = 128;
+
+    m_nCurrentMusic   = -1;
+    m_nCurrentStream  = -1;
+    m_nMusicVoice     = GS_AUDIO_MUSIC_VOICE;
+    m_nMusicCrossfade = 0;
+
+    for (int nLoop = 0; nLoop < GS_AUDIO_NUM_VOICES; nLoop++) {
+        m_MixVoices[nLoop].pData = NULL;
+    }
+    m_nSampleMaster = 255;
+    m_bMixPaused    = FALSE;
+
+    m_DeviceID      = 0;
+    m_nBufferFrames = GS_AUDIO_DEFAULT_FRAMES;
+    m_nFrequency    = 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::~GS_SDLSound():
+// ---------------------------------------------------------------------------------------------
+// Purpose: The destructor, de-initializes class data when class object is destroyed and frees
+//          all memory used by it.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+GS_SDLSound::~GS_SDLSound() {
+
+    if (m_bIsReady) {
+        this->Shutdown();
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Initialize/Shutdown Methods /////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::Initialize():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Opens the audio device at its native sample rate (so nothing is resampled while
+//          mixing), in 16 bit stereo and with the buffer size set with SetBufferSize().
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if not.
+//==============================================================================================
+
+BOOL GS_SDLSound::Initialize(HWND hWnd, BOOL bNoSound) {
+
+    // Window handle not used by SDL.
+    (void)hWnd;
+
+    // Shutdown sound if already initialized.
+    if (m_bIsReady) {
+        this->Shutdown();
+    }
+
+    // Should we enable sound?
+    if (bNoSound) {
+        m_bIsReady = TRUE;
+        return TRUE;
+    }
+
+    // Initialize SDL audio subsystem if not already initialized.
+    if (SDL_WasInit(SDL_INIT_AUDIO) == 0) {
+        if (SDL_InitSubSystem(SDL_INIT_AUDIO) < 0) {
+            GS_Error::Report("GS_SDL_SOUND.CPP", 268, "Failed to initialize SDL audio!");
+            return FALSE;
+        }
+    }
+
+    // Open the audio device, letting it pick its own sample rate (44.1kHz is only a hint).
+    if (!this->OpenDevice(44100, m_nBufferFrames, SDL_AUDIO_ALLOW_FREQUENCY_CHANGE)) {
+        GS_Error::Report("GS_SDL_SOUND.CPP", 275, "Failed to open the audio device!");
+        return FALSE;
+    }
+
+    m_bIsReady = TRUE;
+
+    return m_bIsReady;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::Shutdown():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Closes the audio device and frees all loaded music, streams, and samples.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if not.
+//==============================================================================================
+
+BOOL GS_SDLSound::Shutdown() {
+
+    // Can't shutdown if sound not initialized.
+    if (!m_bIsReady) {
+        return FALSE;
+    }
+
+    // Close the audio device first, the audio thread may still be playing the data freed below.
+    if (m_DeviceID != 0) {
+        SDL_CloseAudioDevice(m_DeviceID);
+        m_DeviceID = 0;
+    }
+
+    m_nFrequency = 0;
+    SDL_AtomicSet(&g_nDeviceFrequency, 0);
+
+    // Forget everything that was playing or about to.
+    m_gsCommands.Clear();
+
+    m_gsVoices.Reset();
+
+    for (int nLoop = 0; nLoop < GS_AUDIO_NUM_VOICES; nLoop++) {
+        m_MixVoices[nLoop].pData = NULL;
+    }
+    m_bMixPaused = FALSE;
+
+    // Free all loaded music tracks and audio streams.
+    FreeWaves(&m_gsMusicList);
+    FreeWaves(&m_gsStreamList);
+
+    // Free all loaded sound samples.
+    for (int nLoop = 0; nLoop < m_gsSampleList.GetNumItems(); nLoop++) {
+        SDL_free(m_gsSampleList[nLoop].Wave.pData);
+    }
+    m_gsSampleList.RemoveAllItems();
+
+    m_bIsReady  = FALSE;
+    m_bIsPaused = FALSE;
+
+    m_nCurrentMusic  = -1;
+    m_nCurrentStream = -1;
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Global Sound Methods ////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::Pause():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Pauses or resumes all audio playback (music, streams, and sound effects).
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_SDLSound::Pause(BOOL bPause) {
+
+    // Exit if sound not initialized or already in requested state.
+    if (!m_bIsReady || m_bIsPaused == bPause) {
+        return;
+    }
+
+    // The audio thread keeps the voices where they are and plays silence while paused.
+    if ((m_nFrequency > 0) && !this->SendCommand(GS_SOUND_PAUSE, -1, bPause)) {
+        return;
+    }
+
+    m_bIsPaused = bPause;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::SetMasterVolume():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Sets the master volume for both music and sound effects.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_SDLSound::SetMasterVolume(int nVolume) {
+
+    // Exit if sound not initialized.
+    if (!m_bIsReady) {
+        return;
+    }
+
+    // Make sure volume is within range (0 - 255).
+    if (nVolume < 0) {
+        nVolume = 0;
+    }
+    if (nVolume > 255) {
+        nVolume = 255;
+    }
+
+    // Assign master volume.
+    m_nMasterVolume = nVolume;
+
+    // Set music volume.
+    this->SetMusicVolume(nVolume);
+
+    // Set sample volume.
+    this->SetSampleMaster(nVolume);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Latency Methods /////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::SetBufferSize():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Sets the size of the device buffer in sample frames (GS_AUDIO_MIN_FRAMES to
+//          GS_AUDIO_MAX_FRAMES, 0 for GS_AUDIO_DEFAULT_FRAMES). Smaller buffers are heard
+//          sooner, GS_AUDIO_LOW_FRAMES is about 12 ms. If sound is already initialized the
+//          device is reopened with the new size.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_SDLSound::SetBufferSize(int nFrames) {
+
+    if (nFrames <= 0) {
+        nFrames = GS_AUDIO_DEFAULT_FRAMES;
+    }
+
+    // Make sure the size is within range.
+    if (nFrames < GS_AUDIO_MIN_FRAMES) {
+        nFrames = GS_AUDIO_MIN_FRAMES;
+    }
+    if (nFrames > GS_AUDIO_MAX_FRAMES) {
+        nFrames = GS_AUDIO_MAX_FRAMES;
+    }
+
+    // Reopen the device if sound is already playing with another size.
+    if ((m_nFrequency > 0) && (nFrames != m_nBufferFrames)) {
+        this->ReopenDevice(nFrames);
+        return;
+    }
+
+    m_nBufferFrames = nFrames;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::Update():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Checks for underruns, should be called once every frame. When the audio thread
+//          has not been able to keep up with the device AUDIO_MAX_UNDERRUNS times within
+//          AUDIO_UNDERRUN_WINDOW milliseconds, the device is reopened with a buffer twice the
+//          size (up to GS_AUDIO_MAX_FRAMES).
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_SDLSound::Update() {
+
+    // Exit if sound not initialized or disabled.
+    if (!m_bIsReady || m_nFrequency == 0) {
+        return;
+    }
+
+    if (m_gsStats.HasUnderrunBurst() &&
+        (m_nBufferFrames < GS_AUDIO_MAX_FRAMES)) {
+        char szMessage[128];
+        sprintf(szMessage, "Audio underruns with %d frame buffers, switching to %d frames\n",
+                m_nBufferFrames, m_nBufferFrames * 2);
+        GS_Platform::OutputDebugString(szMessage);
+
+        this->ReopenDevice(m_nBufferFrames * 2);
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::OpenDevice():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Opens the audio device for 16 bit stereo (SDL converts if the hardware wants
+//          something else), remembers the sample rate it was actually opened with and starts
+//          mixing.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if not.
+//==============================================================================================
+
+BOOL GS_SDLSound::OpenDevice(int nFrequency, int nFrames, int nAllowedChanges) {
+
+    SDL_AudioSpec Wanted;
+    SDL_AudioSpec Obtained;
+
+    SDL_memset(&Wanted, 0, sizeof(Wanted));
+
+    Wanted.freq     = nFrequency;
+    Wanted.format   = AUDIO_S16SYS;
+    Wanted.channels = 2;
+    Wanted.samples  = (Uint16) nFrames;
+    Wanted.callback = MixAudio;
+    Wanted.userdata = this;
+
+    m_DeviceID = SDL_OpenAudioDevice(NULL, 0, &Wanted, &Obtained, nAllowedChanges);
+    if (m_DeviceID == 0) {
+        return FALSE;
+    }
+
+    m_nFrequency    = Obtained.freq;
+    m_nBufferFrames = nFrames;
+
+    SDL_AtomicSet(&g_nDeviceFrequency, m_nFrequency);
+
+    // Start counting the underruns of the new device.
+    m_gsStats.SetDevice(m_nBufferFrames, m_nFrequency);
+
+    // Devices are opened paused.
+    SDL_PauseAudioDevice(m_DeviceID, 0);
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::ReopenDevice():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Reopens the audio device with another buffer size, keeping the sample rate so the
+//          loaded samples can still be used. The voices are kept by the class rather than the
+//          device, so whatever was playing carries on where it was.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if not (sound is then disabled).
+//==============================================================================================
+
+BOOL GS_SDLSound::ReopenDevice(int nFrames) {
+
+    SDL_CloseAudioDevice(m_DeviceID);
+    m_DeviceID = 0;
+
+    // Try the old size again if the new one doesn't work.
+    if ((!this->OpenDevice(m_nFrequency, nFrames, 0)) &&
+        (!this->OpenDevice(m_nFrequency, m_nBufferFrames, 0))) {
+        GS_Error::Report("GS_SDL_SOUND.CPP", 557, "Failed to reopen the audio device!");
+        m_nFrequency = 0;
+        m_gsVoices.Reset();
+        SDL_AtomicSet(&g_nDeviceFrequency, 0);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Mixing Methods (Audio Thread) ///////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::MixAudio():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Called by SDL on the audio thread whenever the device needs another buffer. Carries
+//          out the commands sent since the last buffer, mixes the voices into the buffer and
+//          counts an underrun when the buffer is asked for too late, meaning the device has
+//          played all it had and the audio thread was not given the time to mix the next one.
+//          The time the callback took and the voices left playing are counted as well.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_SDLSound::MixAudio(void* pUserData, Uint8* pStream, int nLength) {
+
+    GS_SDLSound* pSound = (GS_SDLSound*) pUserData;
+
+    Uint64 n64Start = SDL_GetPerformanceCounter();
+
+    pSound->MixCommands();
+
+    if (pSound->m_bMixPaused) {
+        SDL_memset(pStream, 0, nLength);
+    }
+    else {
+        Sint16* pOutput = (Sint16*) pStream;
+        int     nFrames = nLength / 4;
+
+        // Mix the buffer in parts that fit the mixing buffer.
+        while (nFrames > 0) {
+            int nPart = SDL_min(nFrames, GS_AUDIO_MIX_FRAMES);
+
+            pSound->MixVoices(nPart);
+            StoreFrames(pOutput, pSound->m_fMixBuffer, nPart);
+
+            pOutput += nPart * 2;
+            nFrames -= nPart;
+        }
+    }
+
+    Uint64 n64Now = SDL_GetPerformanceCounter();
+
+    pSound->m_gsStats.CheckUnderrun(n64Now);
+
+    int nVoices = 0;
+
+    for (int nLoop = 0; (nLoop < GS_AUDIO_NUM_VOICES) && !pSound->m_bMixPaused; nLoop++) {
+        if (pSound->m_MixVoices[nLoop].pData && !pSound->m_MixVoices[nLoop].bPaused) {
+            nVoices++;
+        }
+    }
+
+    pSound->m_gsStats.AddCallback(n64Now - n64Start, nVoices);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::MixCommands():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Carries out the commands the game thread has queued, in the order they were sent.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_SDLSound::MixCommands() {
+
+    GS_SoundCommand Command;
+
+    while (m_gsCommands.Pop(&Command)) {
+        // Pausing everything has no voice.
+        if (Command.nVoice < 0) {
+            if (Command.nType == GS_SOUND_PAUSE) {
+                m_bMixPaused = Command.bFlag;
+            }
+            continue;
+        }
+
+        GS_MixVoice* pVoice = &m_MixVoices[Command.nVoice];
+
+        switch (Command.nType) {
+            case GS_SOUND_PLAY:
+                pVoice->pData     = Command.pData;
+                pVoice->uFrames   = Command.uFrames;
+                pVoice->uPosition = 0;
+                pVoice->uSerial   = Command.uSerial;
+                pVoice->fLeft     = Command.fLeft;
+                pVoice->fRight    = Command.fRight;
+                pVoice->bLoop     = Command.bFlag;
+                pVoice->bPaused   = FALSE;
+                pVoice->fFade     = (Command.nFade > 0) ? 0.0f : 1.0f;
+                pVoice->fFadeStep = (Command.nFade > 0) ? 1.0f / Command.nFade : 0.0f;
+                break;
+            case GS_SOUND_STOP:
+                pVoice->pData = NULL;
+                break;
+            case GS_SOUND_FADE:
+                pVoice->fFadeStep = -1.0f / SDL_max(Command.nFade, 1);
+                break;
+            case GS_SOUND_GAINS:
+                pVoice->fLeft  = Command.fLeft;
+                pVoice->fRight = Command.fRight;
+                break;
+            case GS_SOUND_PAUSE:
+                pVoice->bPaused = Command.bFlag;
+                break;
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::MixVoices():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Adds up a number of frames (GS_AUDIO_MIX_FRAMES at most) of all voices playing in
+//          the mixing buffer, starting looped voices over and stopping the others when their
+//          sample data ends or they have faded out.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_SDLSound::MixVoices(int nFrames) {
+
+    SDL_memset(m_fMixBuffer, 0, nFrames * 2 * sizeof(float));
+
+    for (int nLoop = 0; nLoop < GS_AUDIO_NUM_VOICES; nLoop++) {
+        GS_MixVoice* pVoice = &m_MixVoices[nLoop];
+
+        if (!pVoice->pData || pVoice->bPaused) {
+            continue;
+        }
+
+        float fFade = pVoice->fFade;
+
+        // Fades change the gain once per part (a few milliseconds), to the gain halfway through.
+        if (pVoice->fFadeStep != 0.0f) {
+            float fEnd = SDL_max(0.0f, SDL_min(fFade + pVoice->fFadeStep * nFrames, 1.0f));
+
+            fFade         = (fFade + fEnd) * 0.5f;
+            pVoice->fFade = fEnd;
+
+            if (fEnd >= 1.0f) {
+                pVoice->fFadeStep = 0.0f;
+            }
+        }
+
+        float fLeft  = pVoice->fLeft * fFade;
+        float fRight = pVoice->fRight * fFade;
+        int   nDone  = 0;
+
+        while ((nDone < nFrames) && pVoice->pData) {
+            int nPart = (int) SDL_min((Uint32) (nFrames - nDone),
+                                      pVoice->uFrames - pVoice->uPosition);
+
+            AddFrames(m_fMixBuffer + nDone * 2, pVoice->pData + pVoice->uPosition * 2, nPart,
+                      fLeft, fRight);
+
+            pVoice->uPosition += nPart;
+            nDone             += nPart;
+
+            if (pVoice->uPosition >= pVoice->uFrames) {
+                if (pVoice->bLoop && (pVoice->uFrames > 0)) {
+                    pVoice->uPosition = 0;
+                }
+                else {
+                    // Tell the game thread, unless it has already started something else.
+                    pVoice->pData = NULL;
+                    m_gsVoices.Finish(nLoop, pVoice->uSerial);
+                }
+            }
+        }
+
+        // A voice that has faded out is stopped like one that has ended.
+        if (pVoice->pData && (pVoice->fFadeStep < 0.0f) && (pVoice->fFade <= 0.0f)) {
+            pVoice->pData = NULL;
+            m_gsVoices.Finish(nLoop, pVoice->uSerial);
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Helper Methods //////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::SendCommand():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Queues a command (other than GS_SOUND_PLAY, see StartVoice()) for the audio thread.
+//          GS_SOUND_GAINS sends the gains the voice currently has.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if the queue is full.
+//==============================================================================================
+
+BOOL GS_SDLSound::SendCommand(int nType, int nVoice, BOOL bFlag, int nFade) {
+
+    GS_SoundCommand Command;
+
+    Command.nType   = nType;
+    Command.nVoice  = nVoice;
+    Command.pData   = NULL;
+    Command.uFrames = 0;
+    Command.uSerial = 0;
+    Command.fLeft   = 0.0f;
+    Command.fRight  = 0.0f;
+    Command.bFlag   = bFlag;
+    Command.nFade   = nFade;
+
+    if (nType == GS_SOUND_GAINS) {
+        this->GetVoiceGains(nVoice, &Command.fLeft, &Command.fRight);
+    }
+
+    return m_gsCommands.Push(Command);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::StartVoice():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Starts a new playback of a wave on a voice (replacing whatever the voice was
+//          playing), with the volume and panning already set in the voice, fading it in over
+//          nFade frames if not zero. The playback must already have been given its serial by
+//          m_gsVoices.Start(), which marks the voice as playing before the audio thread can
+//          see the command, so it can't end before it is marked.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if the queue is full (the voice is then free again).
+//==============================================================================================
+
+BOOL GS_SDLSound::StartVoice(int nVoice, Uint32 uSerial, const GS_Wave* pWave, BOOL bLoop,
+                             int nFade) {
+
+    GS_SoundCommand Command;
+
+    Command.nType   = GS_SOUND_PLAY;
+    Command.nVoice  = nVoice;
+    Command.pData   = pWave->pData;
+    Command.uFrames = pWave->uFrames;
+    Command.uSerial = uSerial;
+    Command.bFlag   = bLoop;
+    Command.nFade   = nFade;
+
+    this->GetVoiceGains(nVoice, &Command.fLeft, &Command.fRight);
+
+    if (!m_gsCommands.Push(Command)) {
+        m_gsVoices.Stop(nVoice);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::GetVoiceGains():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Works out the gains of the left and right side of a voice from its volume, the
+//          master volume and its panning (with a constant power pan law that plays both sides
+//          at full volume in the center), scaled so the mix is in the -1.0 to 1.0 range.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_SDLSound::GetVoiceGains(int nVoice, float* pfLeft, float* pfRight) {
+
+    // The music voices are not panned.
+    if (nVoice >= GS_AUDIO_MUSIC_VOICE) {
+        *pfLeft  = m_nMusicVolume / (255.0f * 32768.0f);
+        *pfRight = *pfLeft;
+        return;
+    }
+
+    GS_Voice* pVoice = &m_Voices[nVoice];
+
+    float fVolume = pVoice->nVolume * m_nSampleMaster / (255.0f * 255.0f * 32768.0f);
+
+    // Map 0, 128 and 255 to exactly left, center and right.
+    int   nPanning = (pVoice->nPanning <= 128) ? pVoice->nPanning : pVoice->nPanning + 1;
+    float fAngle   = nPanning * GS_PI / (2.0f * 256.0f);
+
+    *pfLeft  = fVolume * SDL_min(1.0f, 1.41421356f * cosf(fAngle));
+    *pfRight = fVolume * SDL_min(1.0f, 1.41421356f * sinf(fAngle));
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::StartMusic():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Starts music or a stream. If other music is playing and a crossfade is set, the
+//          music playing fades out on its voice while the new one fades in on the other music
+//          voice, both mixed from memory so there is no gap between them.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if the queue is full.
+//==============================================================================================
+
+BOOL GS_SDLSound::StartMusic(const GS_Wave* pWave, BOOL bLoop) {
+
+    int nFade = (int) ((Sint64) m_nFrequency * m_nMusicCrossfade / 1000);
+
+    if ((nFade == 0) || !m_gsVoices.IsPlaying(m_nMusicVoice)) {
+        return this->StartVoice(m_nMusicVoice, m_gsVoices.Start(m_nMusicVoice), pWave, bLoop);
+    }
+
+    this->StopMusicVoice();
+
+    m_nMusicVoice = (m_nMusicVoice == GS_AUDIO_MUSIC_VOICE) ? GS_AUDIO_MUSIC_VOICE + 1 :
+                                                              GS_AUDIO_MUSIC_VOICE;
+
+    return this->StartVoice(m_nMusicVoice, m_gsVoices.Start(m_nMusicVoice), pWave, bLoop,
+                            nFade);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::StopMusicVoice():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Stops the current music or stream, fading it out over the crossfade time if one is
+//          set. It no longer counts as playing right away.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_SDLSound::StopMusicVoice() {
+
+    int nFade = (int) ((Sint64) m_nFrequency * m_nMusicCrossfade / 1000);
+
+    m_gsVoices.Stop(m_nMusicVoice);
+
+    if (nFade > 0) {
+        this->SendCommand(GS_SOUND_FADE, m_nMusicVoice, FALSE, nFade);
+    }
+    else {
+        this->SendCommand(GS_SOUND_STOP, m_nMusicVoice);
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::OpenPackFile():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Looks up a sound file in the global pack and opens its contents as a read only
+//          memory stream.
+// ---------------------------------------------------------------------------------------------
+// Returns: The memory stream or NULL if the file is not in the pack.
+//==============================================================================================
+
+SDL_RWops* GS_SDLSound::OpenPackFile(const char* pszFilename) {
+
+    const BYTE*   pData = NULL;
+    unsigned long lSize = 0;
+
+    // Is the file in the pack?
+    if (!g_gsPack.Find(pszFilename, &pData, &lSize)) {
+        return NULL;
+    }
+
+    return SDL_RWFromConstMem(pData, (int) lSize);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::DecodeSample():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Decodes a WAV file (from the pack if it is in there) and converts it to 16 bit
+//          stereo at the sample rate of the opened audio device, the format the mixer plays,
+//          ready to be handed to AddSample(). Doesn't touch any class data, so it may be called
+//          from any thread once the device is open.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful (the buffer must be freed with SDL_free() if not added as a
+//          sample), FALSE if not.
+//==============================================================================================
+
+BOOL GS_SDLSound::DecodeSample(const char* pszFilename, Uint8** ppBuffer, Uint32* puLength) {
+
+    int nFrequency = SDL_AtomicGet(&g_nDeviceFrequency);
+
+    // Exit if the audio device has not been opened.
+    if (nFrequency == 0) {
+        return FALSE;
+    }
+
+    SDL_RWops* pFile = OpenPackFile(pszFilename);
+    if (!pFile) {
+        pFile = SDL_RWFromFile(pszFilename, "rb");
+    }
+    if (!pFile) {
+        return FALSE;
+    }
+
+    SDL_AudioSpec WaveSpec;
+    Uint8* pWave = NULL;
+    Uint32 uWaveLength = 0;
+
+    // Decode the wave file.
+    if (!SDL_LoadWAV_RW(pFile, 1, &WaveSpec, &pWave, &uWaveLength)) {
+        return FALSE;
+    }
+
+    SDL_AudioCVT WaveCVT;
+    int nResult = SDL_BuildAudioCVT(&WaveCVT, WaveSpec.format, WaveSpec.channels, WaveSpec.freq,
+                                    AUDIO_S16SYS, 2, nFrequency);
+    if (nResult < 0) {
+        SDL_FreeWAV(pWave);
+        return FALSE;
+    }
+
+    // Convert the wave data to the format of the mixer (into a buffer of our own, so it can be
+    // freed with SDL_free() like the rest).
+    WaveCVT.len = (int) uWaveLength;
+    WaveCVT.buf = (Uint8*) SDL_malloc(WaveCVT.len * SDL_max(WaveCVT.len_mult, 1));
+    if (!WaveCVT.buf) {
+        SDL_FreeWAV(pWave);
+        return FALSE;
+    }
+
+    SDL_memcpy(WaveCVT.buf, pWave, uWaveLength);
+    SDL_FreeWAV(pWave);
+
+    if (nResult == 0) {
+        WaveCVT.len_cvt = WaveCVT.len;
+    }
+    else if (SDL_ConvertAudio(&WaveCVT) < 0) {
+        SDL_free(WaveCVT.buf);
+        return FALSE;
+    }
+
+    *ppBuffer = WaveCVT.buf;
+    *puLength = (Uint32) WaveCVT.len_cvt;
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::LoadWave():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Decodes a music track or audio stream into memory. As there is no MP3 or OGG
+//          decoder without SDL_mixer, a WAV file with the same name is tried when the file
+//          itself is not a WAV file.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if not (the wave is then empty).
+//==============================================================================================
+
+BOOL GS_SDLSound::LoadWave(const char* pszFilename, GS_Wave* pWave) {
+
+    Uint8* pBuffer = NULL;
+    Uint32 uLength = 0;
+
+    pWave->pData   = NULL;
+    pWave->uFrames = 0;
+
+    if (!DecodeSample(pszFilename, &pBuffer, &uLength)) {
+        char szWaveName[_MAX_PATH];
+
+        const char* pExt = strrchr(pszFilename, '.');
+        if (!pExt || (strcasecmp(pExt, ".wav") == 0) ||
+            ((size_t) (pExt - pszFilename) + 5 > sizeof(szWaveName))) {
+            return FALSE;
+        }
+
+        sprintf(szWaveName, "%.*s.wav", (int) (pExt - pszFilename), pszFilename);
+
+        if (!DecodeSample(szWaveName, &pBuffer, &uLength)) {
+            return FALSE;
+        }
+    }
+
+    pWave->pData   = (Sint16*) pBuffer;
+    pWave->uFrames = uLength / 4;
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::FreeWaves():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Frees the waves of a music or stream list and empties the list.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_SDLSound::FreeWaves(GS_List<GS_Wave>* pgsList) {
+
+    for (int nLoop = 0; nLoop < pgsList->GetNumItems(); nLoop++) {
+        SDL_free((*pgsList)[nLoop].pData);
+    }
+
+    pgsList->RemoveAllItems();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Music Methods ///////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::AddMusic():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Loads a music file into memory and adds it to the music list. Only WAV files can
+//          be played, for other files a WAV file with the same name is loaded instead.
+// ---------------------------------------------------------------------------------------------
+// Notes: Music that can't be loaded is still added (and won't play), so the music added after
+//        it keeps its index.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if not.
+//==============================================================================================
+
+BOOL GS_SDLSound::AddMusic(const char* pszFilename) {
+
+    // Exit if sound not initialized.
+    if (!m_bIsReady) {
+        return FALSE;
+    }
+
+    GS_Wave Music;
+
+    BOOL bResult = LoadWave(pszFilename, &Music);
+
+    // Was the music loaded successfully? Music that is not a WAV file (and has no WAV file to
+    // stand in for it) is expected to be silent, this mixer plays sound effects only then.
+    if (!bResult && (m_nFrequency > 0)) {
+        const char* pExt = strrchr(pszFilename, '.');
+        char        szError[512];
+
+        if (pExt && (strcasecmp(pExt, ".wav") != 0)) {
+            sprintf(szError, "No WAV file for music '%s', it will not be played\n", pszFilename);
+            GS_Platform::OutputDebugString(szError);
+        }
+        else {
+            sprintf(szError, "Failed to load music file '%s'!", pszFilename);
+            GS_Error::Report("GS_SDL_SOUND.CPP", 1145, szError);
+        }
+    }
+
+    m_gsMusicList.AddItem(Music);
+
+    return bResult;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::PlayMusic():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Plays a loaded music track with optional volume and loop settings.
+// ---------------------------------------------------------------------------------------------
+// Notes: The fSpeed parameter is ignored, the mixer doesn't resample.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if not.
+//==============================================================================================
+
+BOOL GS_SDLSound::PlayMusic(int nIndex, int nVolume, float fSpeed, BOOL bLoop) {
+
+    // Speed parameter not supported.
+    (void)fSpeed;
+
+    // Exit if sound not initialized or paused.
+    if (!m_bIsReady || m_bIsPaused || m_nFrequency == 0) {
+        return FALSE;
+    }
+
+    // Is index within bounds and has the music been loaded?
+    if ((nIndex < 0) || (nIndex >= m_gsMusicList.GetNumItems()) ||
+        (!m_gsMusicList[nIndex].pData)) {
+        return FALSE;
+    }
+
+    // Have the user specified a valid volume?
+    if (nVolume >= 0) {
+        m_nMusicVolume = SDL_min(nVolume, 255);
+    }
+
+    GS_Wave Music = m_gsMusicList[nIndex];
+
+    if (!this->StartMusic(&Music, bLoop)) {
+        return FALSE;
+    }
+
+    // Remember which music is playing.
+    m_nCurrentMusic  = nIndex;
+    m_nCurrentStream = -1;
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::StopMusic():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Stops music playback. Only one music track can play at a time, so the nIndex
+//          parameter is ignored.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if not.
+//==============================================================================================
+
+BOOL GS_SDLSound::StopMusic(int nIndex) {
+
+    // Index parameter not used (only one music track plays at a time).
+    (void)nIndex;
+
+    // Exit if sound not initialized.
+    if (!m_bIsReady) {
+        return FALSE;
+    }
+
+    this->StopAllMusic();
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::StopAllMusic():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Stops all music playback (same as StopMusic()).
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_SDLSound::StopAllMusic() {
+
+    // Exit if sound not initialized.
+    if (!m_bIsReady) {
+        return;
+    }
+
+    if (m_nFrequency > 0) {
+        this->StopMusicVoice();
+    }
+
+    m_nCurrentMusic = -1;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::IsMusicPlaying():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Checks if any music (or stream) is currently playing or paused.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if music is playing or paused, FALSE if stopped.
+//==============================================================================================
+
+BOOL GS_SDLSound::IsMusicPlaying(int nIndex) {
+
+    // Index parameter not used (only one music track plays at a time).
+    (void)nIndex;
+
+    // Exit if sound not initialized.
+    if (!m_bIsReady || m_nFrequency == 0) {
+        return FALSE;
+    }
+
+    return m_gsVoices.IsPlaying(m_nMusicVoice);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::SetMusicVolume():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Sets the music volume level, including the music playing.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_SDLSound::SetMusicVolume(int nVolume) {
+
+    // Exit if sound not initialized.
+    if (!m_bIsReady) {
+        return;
+    }
+
+    // Make sure volume is within range (0 - 255).
+    m_nMusicVolume = SDL_max(0, SDL_min(nVolume, 255));
+
+    if (m_nFrequency > 0) {
+        // Music fading out changes volume too.
+        for (int nVoice = GS_AUDIO_MUSIC_VOICE; nVoice < GS_AUDIO_NUM_VOICES; nVoice++) {
+            this->SendCommand(GS_SOUND_GAINS, nVoice);
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::GetMusicVolume():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Gets the current music volume level.
+// ---------------------------------------------------------------------------------------------
+// Returns: The current music volume (0-255).
+//==============================================================================================
+
+int GS_SDLSound::GetMusicVolume() {
+
+    // Exit if sound not initialized.
+    if (!m_bIsReady) {
+        return 0;
+    }
+
+    return m_nMusicVolume;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::SetMusicCrossfade():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Sets the time music and streams crossfade over when one is played while another is
+//          playing, and fade out over when stopped (0 to GS_MUSIC_MAX_CROSSFADE milliseconds,
+//          0 switches at once). May be called before or after initializing.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_SDLSound::SetMusicCrossfade(int nMilliseconds) {
+
+    m_nMusicCrossfade = SDL_max(0, SDL_min(nMilliseconds, GS_MUSIC_MAX_CROSSFADE));
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Stream Methods //////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::AddStream():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Loads an audio stream file into memory and adds it to the stream list (see
+//          AddMusic()).
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if not.
+//==============================================================================================
+
+BOOL GS_SDLSound::AddStream(const char* pszFilename) {
+
+    // Exit if sound not initialized.
+    if (!m_bIsReady) {
+        return FALSE;
+    }
+
+    GS_Wave Stream;
+
+    BOOL bResult = LoadWave(pszFilename, &Stream);
+
+    // Was the stream loaded successfully?
+    if (!bResult && (m_nFrequency > 0)) {
+        char szError[512];
+        sprintf(szError, "Failed to load stream file '%s' (only WAV files are supported)!",
+                pszFilename);
+        GS_Error::Report("GS_SDL_SOUND.CPP", 1265, szError);
+    }
+
+    m_gsStreamList.AddItem(Stream);
+
+    return bResult;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::PlayStream():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Plays a loaded audio stream with optional volume setting. Streams always loop
+//          infinitely and replace the music that is playing.
+// ---------------------------------------------------------------------------------------------
+// Returns: 0 on success, -1 on failure.
+//==============================================================================================
+
+int GS_SDLSound::PlayStream(int nIndex, int nVolume) {
+
+    // Exit if sound not initialized or paused.
+    if (!m_bIsReady || m_bIsPaused || m_nFrequency == 0) {
+        return -1;
+    }
+
+    // Is index within bounds and has the stream been loaded?
+    if ((nIndex < 0) || (nIndex >= m_gsStreamList.GetNumItems()) ||
+        (!m_gsStreamList[nIndex].pData)) {
+        return -1;
+    }
+
+    // Have the user specified a valid volume?
+    if (nVolume >= 0) {
+        m_nMusicVolume = SDL_min(nVolume, 255);
+    }
+
+    GS_Wave Stream = m_gsStreamList[nIndex];
+
+    if (!this->StartMusic(&Stream, TRUE)) {
+        return -1;
+    }
+
+    // Remember which stream is playing.
+    m_nCurrentStream = nIndex;
+    m_nCurrentMusic  = -1;
+
+    return 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::StopStream():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Stops stream playback.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if not.
+//==============================================================================================
+
+BOOL GS_SDLSound::StopStream() {
+
+    // Exit if sound not initialized.
+    if (!m_bIsReady) {
+        return FALSE;
+    }
+
+    if (m_nFrequency > 0) {
+        this->StopMusicVoice();
+    }
+
+    m_nCurrentStream = -1;
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::IsStreamPlaying():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Checks if a stream (or music) is currently playing or paused.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if stream is playing or paused, FALSE if stopped.
+//==============================================================================================
+
+BOOL GS_SDLSound::IsStreamPlaying() {
+
+    return this->IsMusicPlaying(-1);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::SetStreamVolume():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Sets the stream volume level (the volume of the music voice).
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if not.
+//==============================================================================================
+
+BOOL GS_SDLSound::SetStreamVolume(int nVolume) {
+
+    // Exit if sound not initialized.
+    if (!m_bIsReady) {
+        return FALSE;
+    }
+
+    this->SetMusicVolume(nVolume);
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::GetStreamVolume():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Gets the current stream volume level.
+// ---------------------------------------------------------------------------------------------
+// Returns: The current stream volume (0-255).
+//==============================================================================================
+
+int GS_SDLSound::GetStreamVolume() {
+
+    return this->GetMusicVolume();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::PauseStream():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Pauses or resumes stream playback.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if not.
+//==============================================================================================
+
+BOOL GS_SDLSound::PauseStream(BOOL bPause) {
+
+    // Exit if sound not initialized.
+    if (!m_bIsReady || m_nFrequency == 0) {
+        return FALSE;
+    }
+
+    // Music fading out is paused too.
+    return (this->SendCommand(GS_SOUND_PAUSE, GS_AUDIO_MUSIC_VOICE, bPause) &&
+            this->SendCommand(GS_SOUND_PAUSE, GS_AUDIO_MUSIC_VOICE + 1, bPause));
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Sample Methods //////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::AddSample():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Loads a WAV file and adds it to the sample list (converted to the format of the
+//          mixer, see DecodeSample()).
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if not.
+//==============================================================================================
+
+BOOL GS_SDLSound::AddSample(const char* pszFilename) {
+
+    // Exit if sound not initialized.
+    if (!m_bIsReady) {
+        return FALSE;
+    }
+
+    BYTE*         pBuffer;
+    unsigned long lLength;
+
+    // Use the sample if it has already been decoded by the asset loader.
+    if (g_gsAssetLoader.TakeSample(pszFilename, &pBuffer, &lLength)) {
+        return this->AddSample((Uint8*) pBuffer, (Uint32) lLength);
+    }
+
+    Uint8* pWave;
+    Uint32 uWaveLength;
+
+    if (!this->DecodeSample(pszFilename, &pWave, &uWaveLength)) {
+        GS_Error::Report("GS_SDL_SOUND.CPP", 1463, "Failed to load sample file!");
+        return FALSE;
+    }
+
+    return this->AddSample(pWave, uWaveLength);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::AddSample():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Adds a sample that has already been decoded and converted to the format of the
+//          mixer (see DecodeSample()). The sample takes over the buffer, which must have been
+//          allocated with SDL_malloc().
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if not.
+//==============================================================================================
+
+BOOL GS_SDLSound::AddSample(Uint8* pBuffer, Uint32 uLength) {
+
+    // Exit if sound not initialized.
+    if (!m_bIsReady || !pBuffer) {
+        SDL_free(pBuffer);
+        return FALSE;
+    }
+
+    // Add the sample to the list.
+    GS_Sample Sample;
+
+    Sample.Wave.pData   = (Sint16*) pBuffer;
+    Sample.Wave.uFrames = uLength / 4;
+    Sample.nVolume      = 255;
+    Sample.nPanning     = 128;
+    Sample.nMaxVoices   = GS_SAMPLE_DEFAULT_VOICES;
+    Sample.nPriority    = GS_SAMPLE_DEFAULT_PRIORITY;
+
+    m_gsSampleList.AddItem(Sample);
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::AddSamples():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Loads a number of sound sample files and adds them to the sample list in the order
+//          they are given.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if all samples were added, FALSE if not.
+//==============================================================================================
+
+BOOL GS_SDLSound::AddSamples(const char** ppszFilenames, int nNumFiles) {
+
+    BOOL bResult = (nNumFiles > 0);
+
+    for (int nLoop = 0; nLoop < nNumFiles; nLoop++) {
+        bResult = this->AddSample(ppszFilenames[nLoop]) && bResult;
+    }
+
+    return bResult;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::PlaySample():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Plays a loaded sound sample on a voice of its own with optional volume and panning
+//          (the ones set with SetSampleVolume() and SetSamplePanning() if not given). Only
+//          queues the sample for the audio thread, it never waits for it.
+// ---------------------------------------------------------------------------------------------
+// Notes: When the sample is already playing on as many voices as it may (see
+//        SetSampleVoices()) its oldest voice is started again. When all voices are playing,
+//        the oldest voice of the lowest priority is stolen, unless its priority is higher than
+//        the priority of the sample, in which case the sample is not played.
+// ---------------------------------------------------------------------------------------------
+// Returns: The voice playing the sample, or -1 if the sample was not played.
+//==============================================================================================
+
+int GS_SDLSound::PlaySample(int nIndex, int nVolume, int nPanning) {
+
+    // Exit if sound not initialized or paused.
+    if (!m_bIsReady || m_bIsPaused || m_nFrequency == 0) {
+        return -1;
+    }
+
+    // Is index within bounds?
+    if ((nIndex < 0) || (nIndex >= m_gsSampleList.GetNumItems())) {
+        return -1;
+    }
+
+    GS_Sample Sample = m_gsSampleList[nIndex];
+
+    int nChannel = m_gsVoices.Allocate(nIndex, Sample.nMaxVoices, Sample.nPriority);
+    if (nChannel < 0) {
+        return -1;
+    }
+
+    GS_Voice* pVoice = &m_Voices[nChannel];
+
+    pVoice->nVolume  = (nVolume >= 0) ? SDL_min(nVolume, 255) : Sample.nVolume;
+    pVoice->nPanning = (nPanning >= 0) ? SDL_min(nPanning, 255) : Sample.nPanning;
+
+    Uint32 uSerial = m_gsVoices.Start(nChannel, nIndex, Sample.nPriority);
+
+    if (!this->StartVoice(nChannel, uSerial, &Sample.Wave, FALSE)) {
+        return -1;
+    }
+
+    // The handle of the voice is only valid for this playback.
+    return m_gsVoices.GetHandle(nChannel);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::SetSampleMaster():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Sets the master volume for all sound effects, including the ones playing.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_SDLSound::SetSampleMaster(int nVolume) {
+
+    // Exit if sound not initialized.
+    if (!m_bIsReady) {
+        return;
+    }
+
+    // Make sure volume is within range (0 - 255).
+    m_nSampleMaster = SDL_max(0, SDL_min(nVolume, 255));
+
+    // The master volume is part of the gains of every voice.
+    for (int nChannel = 0; nChannel < GS_AUDIO_MAX_VOICES; nChannel++) {
+        if (m_gsVoices.IsPlaying(nChannel)) {
+            this->SendCommand(GS_SOUND_GAINS, nChannel);
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::GetSampleMaster():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Gets the master volume for all sound effects.
+// ---------------------------------------------------------------------------------------------
+// Returns: The master sample volume (0-255).
+//==============================================================================================
+
+int GS_SDLSound::GetSampleMaster() {
+
+    // Exit if sound not initialized.
+    if (!m_bIsReady) {
+        return 0;
+    }
+
+    return m_nSampleMaster;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::SetSampleVolume():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Sets the volume new voices of a specific sample are played with when PlaySample()
+//          is not given a volume. Voices already playing keep their volume.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if not.
+//==============================================================================================
+
+BOOL GS_SDLSound::SetSampleVolume(int nIndex, int nVolume) {
+
+    // Exit if sound not initialized.
+    if (!m_bIsReady) {
+        return FALSE;
+    }
+
+    // Is index within bounds?
+    if ((nIndex >= 0) && (nIndex < m_gsSampleList.GetNumItems())) {
+        GS_Sample Sample = m_gsSampleList[nIndex];
+        Sample.nVolume = SDL_max(0, SDL_min(nVolume, 255));
+        m_gsSampleList.SetItem(nIndex, Sample);
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::SetSamplePanning():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Sets the panning new voices of a specific sample are played with when PlaySample()
+//          is not given a panning (0 = left, 128 = center, 255 = right, -1 for center). Voices
+//          already playing keep their panning.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if not.
+//==============================================================================================
+
+BOOL GS_SDLSound::SetSamplePanning(int nIndex, int nPanning) {
+
+    // Exit if sound not initialized.
+    if (!m_bIsReady) {
+        return FALSE;
+    }
+
+    // Is index within bounds?
+    if ((nIndex >= 0) && (nIndex < m_gsSampleList.GetNumItems())) {
+        GS_Sample Sample = m_gsSampleList[nIndex];
+        Sample.nPanning = (nPanning < 0) ? 128 : SDL_min(nPanning, 255);
+        m_gsSampleList.SetItem(nIndex, Sample);
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::SetSampleVoices():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Sets how many voices a sample may play on at once (1 to GS_AUDIO_MAX_VOICES) and
+//          the priority of its voices (0-255, the higher the more important).
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if not.
+//==============================================================================================
+
+BOOL GS_SDLSound::SetSampleVoices(int nIndex, int nMaxVoices, int nPriority) {
+
+    // Is index within bounds?
+    if ((nIndex < 0) || (nIndex >= m_gsSampleList.GetNumItems())) {
+        return FALSE;
+    }
+
+    GS_Sample Sample = m_gsSampleList[nIndex];
+
+    Sample.nMaxVoices = SDL_max(1, SDL_min(nMaxVoices, GS_AUDIO_MAX_VOICES));
+    Sample.nPriority  = SDL_max(0, SDL_min(nPriority, 255));
+
+    m_gsSampleList.SetItem(nIndex, Sample);
+
+    return TRUE;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Voice Methods ///////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::IsVoicePlaying():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Checks if a voice returned by PlaySample() is still playing its sample.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if the voice is playing (or paused), FALSE if it has finished or was stolen.
+//==============================================================================================
+
+BOOL GS_SDLSound::IsVoicePlaying(int nVoice) {
+
+    return (m_gsVoices.FindHandle(nVoice) >= 0);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::StopVoice():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Stops a voice returned by PlaySample().
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if the voice was stopped, FALSE if it was not playing anymore.
+//==============================================================================================
+
+BOOL GS_SDLSound::StopVoice(int nVoice) {
+
+    int nChannel = m_gsVoices.FindHandle(nVoice);
+    if (nChannel < 0) {
+        return FALSE;
+    }
+
+    m_gsVoices.Stop(nChannel);
+
+    return this->SendCommand(GS_SOUND_STOP, nChannel);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::SetVoiceVolume():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Changes the volume of a voice returned by PlaySample() while it is playing, other
+//          voices of the same sample are not affected.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if the voice was not playing anymore.
+//==============================================================================================
+
+BOOL GS_SDLSound::SetVoiceVolume(int nVoice, int nVolume) {
+
+    int nChannel = m_gsVoices.FindHandle(nVoice);
+    if (nChannel < 0) {
+        return FALSE;
+    }
+
+    m_Voices[nChannel].nVolume = SDL_max(0, SDL_min(nVolume, 255));
+
+    return this->SendCommand(GS_SOUND_GAINS, nChannel);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::SetVoicePanning():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Changes the panning of a voice returned by PlaySample() while it is playing (0 is
+//          left, 128 center and 255 right), other voices of the same sample are not affected.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if the voice was not playing anymore.
+//==============================================================================================
+
+BOOL GS_SDLSound::SetVoicePanning(int nVoice, int nPanning) {
+
+    int nChannel = m_gsVoices.FindHandle(nVoice);
+    if (nChannel < 0) {
+        return FALSE;
+    }
+
+    m_Voices[nChannel].nPanning = SDL_max(0, SDL_min(nPanning, 255));
+
+    return this->SendCommand(GS_SOUND_GAINS, nChannel);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_SDLSound::GetNumVoices():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Counts the sample voices that are playing (or paused).
+// ---------------------------------------------------------------------------------------------
+// Returns: The number of voices playing.
+//==============================================================================================
+
+int GS_SDLSound::GetNumVoices() {
+
+    return m_gsVoices.GetNumPlaying();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+#endif // GS_USE_SDL_SOUND
@@ -0,0 +1,292 @@
+/*============================================================================================+
+ | Game System (GS) Library                                                                   |
+ |--------------------------------------------------------------------------------------------|
+ | FILES: gs_sdl_sound.cpp, gs_sdl_sound.h                                                    |
+ |--------------------------------------------------------------------------------------------|
+ | CLASS: GS_SDLSound                                                                         |
+ |--------------------------------------------------------------------------------------------|
+ | ABOUT: Software mixer implementation of the GS audio system. Opens the SDL audio device    |
+ |        directly and mixes the voices itself on the audio thread (with SSE2 or NEON where   |
+ |        available), so it needs nothing but SDL2. The game thread never takes the audio     |
+ |        device lock, it hands its commands to the audio thread through a lock-free queue.   |
+ |        A drop-in replacement for GS_SDLMixerSound on builds without SDL_mixer, but it only |
+ |        plays WAV files.                                                                    |
+ |--------------------------------------------------------------------------------------------|
+ |                                                                                    10/2026 |
+ +============================================================================================*/
+
+
+#ifndef GS_SDL_SOUND_H
+#define GS_SDL_SOUND_H
+
+
+#ifdef GS_USE_SDL_SOUND
+
+
+//==============================================================================================
+// Include Game System (GS) header files.
+// ---------------------------------------------------------------------------------------------
+#include "gs_object.h"
+#include "gs_list.h"
+#include "gs_ring_buffer.h"
+#include "gs_audio_stats.h"
+#include "gs_voice_allocator.h"
+#include "gs_error.h"
+#include "gs_platform.h"
+#include "gs_pack.h"
+//==============================================================================================
+
+
+//==============================================================================================
+// Include SDL2 header files.
+// ---------------------------------------------------------------------------------------------
+#include <SDL2/SDL.h>
+//==============================================================================================
+
+
+//==============================================================================================
+// Audio device defines (buffer sizes are in sample frames).
+// ---------------------------------------------------------------------------------------------
+#define GS_AUDIO_DEFAULT_FRAMES 2048 // Standard buffer size (about 46 ms at 44.1kHz).
+#define GS_AUDIO_LOW_FRAMES     512  // Low latency buffer size (about 12 ms at 44.1kHz).
+#define GS_AUDIO_MIN_FRAMES     256  // Smallest buffer size accepted.
+#define GS_AUDIO_MAX_FRAMES     4096 // Largest buffer size the underrun fallback grows to.
+// ---------------------------------------------------------------------------------------------
+#define GS_AUDIO_MIX_FRAMES 256 // Frames mixed at a time (the device buffer is mixed in parts).
+#define GS_AUDIO_QUEUE_SIZE 256 // Commands the game thread may queue between two mixes.
+//==============================================================================================
+
+
+//==============================================================================================
+// Voice defines (a voice is a mixing channel playing a sample).
+// ---------------------------------------------------------------------------------------------
+#define GS_AUDIO_MAX_VOICES   32                  // Number of sample voices.
+#define GS_AUDIO_MUSIC_VOICE  GS_AUDIO_MAX_VOICES // First of the voices music and streams play on.
+#define GS_AUDIO_MUSIC_VOICES 2                   // One fades out while the next fades in.
+#define GS_AUDIO_NUM_VOICES   (GS_AUDIO_MAX_VOICES + GS_AUDIO_MUSIC_VOICES)
+// ---------------------------------------------------------------------------------------------
+#define GS_MUSIC_MAX_CROSSFADE 10000 // Longest crossfade between music tracks (milliseconds).
+// ---------------------------------------------------------------------------------------------
+#define GS_SAMPLE_DEFAULT_VOICES   4   // Voices a sample may play on at once unless changed.
+#define GS_SAMPLE_DEFAULT_PRIORITY 128 // Priority of a sample unless changed (0-255, highest).
+//==============================================================================================
+
+
+//==============================================================================================
+// Commands the game thread sends the audio thread.
+// ---------------------------------------------------------------------------------------------
+#define GS_SOUND_PLAY  1 // Start playing a wave on a voice.
+#define GS_SOUND_STOP  2 // Stop a voice.
+#define GS_SOUND_GAINS 3 // Change the gains of a voice.
+#define GS_SOUND_PAUSE 4 // Pause or resume a voice (or everything if the voice is -1).
+#define GS_SOUND_FADE  5 // Fade a voice out and stop it.
+//==============================================================================================
+
+
+//==============================================================================================
+// Software mixer structures.
+// ---------------------------------------------------------------------------------------------
+typedef struct GS_WAVE
+{
+    Sint16* pData;   // 16 bit stereo sample data at the rate of the device (NULL if none).
+    Uint32  uFrames; // Length of the sample data in frames.
+} GS_Wave;
+// ---------------------------------------------------------------------------------------------
+typedef struct GS_SAMPLE
+{
+    GS_Wave Wave;       // The sample data.
+    int     nVolume;    // Volume new voices of the sample are played with (0-255).
+    int     nPanning;   // Panning new voices of the sample are played with (0-255).
+    int     nMaxVoices; // Voices the sample may play on at once.
+    int     nPriority;  // Priority of the voices of the sample when voices are stolen.
+} GS_Sample;
+// ---------------------------------------------------------------------------------------------
+typedef struct GS_VOICE
+{
+    int nVolume;  // Volume of the voice (0-255).
+    int nPanning; // Panning of the voice (0 = left, 128 = center, 255 = right).
+} GS_Voice;
+// ---------------------------------------------------------------------------------------------
+typedef struct GS_MIX_VOICE
+{
+    const Sint16* pData;     // Sample data being played (NULL if the voice is silent).
+    Uint32        uFrames;   // Length of the sample data in frames.
+    Uint32        uPosition; // Next frame to be mixed.
+    Uint32        uSerial;   // Number of the playback.
+    float         fLeft;     // Gain of the left side (the volume, panning and 1/32768).
+    float         fRight;    // Gain of the right side.
+    BOOL          bLoop;     // Whether the sample data starts over when it ends.
+    BOOL          bPaused;   // Whether the voice is paused.
+    float         fFade;     // Gain of the fade in or out (1.0 when not fading).
+    float         fFadeStep; // Change of the fade gain per frame (0.0 when not fading).
+} GS_MixVoice;
+// ---------------------------------------------------------------------------------------------
+typedef struct GS_SOUND_COMMAND
+{
+    int           nType;    // GS_SOUND_PLAY etc.
+    int           nVoice;   // The voice the command is for.
+    const Sint16* pData;    // GS_SOUND_PLAY: the sample data.
+    Uint32        uFrames;  // GS_SOUND_PLAY: the length of the sample data in frames.
+    Uint32        uSerial;  // GS_SOUND_PLAY: the number of the playback.
+    float         fLeft;    // GS_SOUND_PLAY, GS_SOUND_GAINS: the gain of the left side.
+    float         fRight;   // GS_SOUND_PLAY, GS_SOUND_GAINS: the gain of the right side.
+    BOOL          bFlag;    // GS_SOUND_PLAY: loop, GS_SOUND_PAUSE: pause (or resume).
+    int           nFade;    // GS_SOUND_PLAY: frames to fade in over (0 for none),
+                            // GS_SOUND_FADE: frames to fade out over.
+} GS_SoundCommand;
+//==============================================================================================
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Class Definition. ///////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+class GS_SDLSound : public GS_Object
+{
+
+private:
+
+    BOOL m_bIsReady;  // Whether sound system has been initialized.
+    BOOL m_bIsPaused; // Whether sound system is paused or not.
+
+    GS_List<GS_Wave>   m_gsMusicList;  // List of loaded music tracks (WAV files).
+    GS_List<GS_Wave>   m_gsStreamList; // List of loaded audio streams (WAV files).
+    GS_List<GS_Sample> m_gsSampleList; // List of loaded sound samples (WAV files).
+
+    int m_nMasterVolume;   // Master volume for all music, streams and samples (0-255).
+    int m_nMusicVolume;    // Volume of the music voices (0-255).
+    int m_nCurrentMusic;   // Index of currently playing music track (-1 if none).
+    int m_nCurrentStream;  // Index of currently playing stream (-1 if none).
+    int m_nMusicVoice;     // The music voice the current music or stream plays on.
+    int m_nMusicCrossfade; // Time music tracks crossfade over (milliseconds, 0 for none).
+
+    GS_VoiceAllocator m_gsVoices;                    // What is playing on each voice.
+    GS_Voice          m_Voices[GS_AUDIO_NUM_VOICES]; // Volume and panning of each voice.
+    int               m_nSampleMaster;               // Master volume for all samples (0-255).
+
+    GS_RingBuffer<GS_SoundCommand> m_gsCommands; // Commands waiting for the audio thread.
+
+    GS_MixVoice m_MixVoices[GS_AUDIO_NUM_VOICES];     // The voices (audio thread).
+    BOOL        m_bMixPaused;                         // Whether all voices are paused (audio
+                                                      // thread).
+    float       m_fMixBuffer[GS_AUDIO_MIX_FRAMES * 2]; // Voices are added up in here (audio
+                                                       // thread).
+
+    SDL_AudioDeviceID m_DeviceID;      // The opened audio device (0 if not opened).
+    int               m_nBufferFrames; // Size of the device buffer in sample frames.
+    int               m_nFrequency;    // Sample rate of the opened device (0 if not opened).
+
+    GS_AudioStats m_gsStats; // Voices, mixing times and underruns counted by the audio thread.
+
+    BOOL OpenDevice(int nFrequency, int nFrames, int nAllowedChanges);
+    BOOL ReopenDevice(int nFrames);
+
+    BOOL SendCommand(int nType, int nVoice, BOOL bFlag = FALSE, int nFade = 0);
+    BOOL StartVoice(int nVoice, Uint32 uSerial, const GS_Wave* pWave, BOOL bLoop, int nFade = 0);
+    BOOL StartMusic(const GS_Wave* pWave, BOOL bLoop);
+    void StopMusicVoice();
+    void SendVoiceGains(int nVoice);
+    void GetVoiceGains(int nVoice, float* pfLeft, float* pfRight);
+
+    static SDL_RWops* OpenPackFile(const char* pszFilename);
+    static BOOL LoadWave(const char* pszFilename, GS_Wave* pWave);
+    static void FreeWaves(GS_List<GS_Wave>* pgsList);
+
+    static void MixAudio(void* pUserData, Uint8* pStream, int nLength);
+    void MixCommands();
+    void MixVoices(int nFrames);
+
+protected:
+
+    // ...
+
+public:
+
+    // Constructor & destructor.
+    GS_SDLSound();
+    ~GS_SDLSound();
+
+    // Status methods.
+    BOOL IsReady()  { return m_bIsReady; }
+    BOOL IsPaused() { return m_bIsPaused; }
+
+    // Initialize & shutdown methods.
+    BOOL Initialize(HWND hWnd, BOOL bNoSound = FALSE);
+    BOOL Shutdown();
+
+    // Global control methods.
+    void Pause(BOOL bPause);
+    void SetMasterVolume(int nVolume);
+    int  GetMasterVolume() { return m_nMasterVolume; }
+
+    // Latency methods (the buffer size may be changed before or after initializing).
+    void SetBufferSize(int nFrames);
+    int  GetBufferSize() { return m_nBufferFrames; }
+    int  GetFrequency()  { return m_nFrequency; }
+    int  GetUnderruns()  { return m_gsStats.GetDeviceUnderruns(); }
+    void Update();
+
+    // Statistics methods (counted by the audio thread, GetMixTime() in milliseconds).
+    int   GetActiveVoices()          { return m_gsStats.GetActiveVoices(); }
+    int   GetPeakVoices()            { return m_gsStats.GetPeakVoices(); }
+    int   GetTotalUnderruns()        { return m_gsStats.GetUnderruns(); }
+    float GetMixTime(float fPercent) { return m_gsStats.GetPercentile(fPercent); }
+    BOOL  WriteStats(const char* pszFilename) {
+        return m_gsStats.WriteStats(pszFilename, "GS_SDLSound (software mixer)");
+    }
+
+    // Utility methods.
+    static BOOL DecodeSample(const char* pszFilename, Uint8** ppBuffer, Uint32* puLength);
+
+    // Music methods (WAV files for background music, played from memory).
+    BOOL  AddMusic(const char* pszFilename);
+    BOOL  PlayMusic(int nIndex, int nVolume = -1, float fSpeed = -1.0f, BOOL bLoop = FALSE);
+    BOOL  StopMusic(int nIndex);
+    void  StopAllMusic();
+    BOOL  IsMusicPlaying(int nIndex);
+    void  SetMusicVolume(int nVolume);
+    int   GetMusicVolume();
+    void  SetMusicCrossfade(int nMilliseconds);
+    int   GetMusicCrossfade() { return m_nMusicCrossfade; }
+
+    // Stream methods (WAV files, played on the music voice like in GS_SDLMixerSound).
+    BOOL AddStream(const char* pszFilename);
+    int  PlayStream(int nIndex, int nVolume = -1);
+    BOOL StopStream();
+    BOOL IsStreamPlaying();
+    BOOL SetStreamVolume(int nVolume);
+    int  GetStreamVolume();
+    BOOL PauseStream(BOOL bPause);
+
+    // Sample methods (WAV files for sound effects).
+    BOOL AddSample(const char* pszFilename);
+    BOOL AddSample(Uint8* pBuffer, Uint32 uLength);
+    BOOL AddSamples(const char** ppszFilenames, int nNumFiles);
+    int  PlaySample(int nIndex, int nVolume = -1, int nPanning = -1);
+    void SetSampleMaster(int nVolume);
+    int  GetSampleMaster();
+    BOOL SetSampleVolume(int nIndex, int nVolume);
+    BOOL SetSamplePanning(int nIndex, int nPanning);
+    BOOL SetSampleVoices(int nIndex, int nMaxVoices, int nPriority = GS_SAMPLE_DEFAULT_PRIORITY);
+
+    // Voice methods (a voice is one playback of a sample, as returned by PlaySample()).
+    BOOL IsVoicePlaying(int nVoice);
+    BOOL StopVoice(int nVoice);
+    BOOL SetVoiceVolume(int nVoice, int nVolume);
+    BOOL SetVoicePanning(int nVoice, int nPanning);
+    int  GetNumVoices();
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// Type alias for compatibility with existing GS_FmodSound code.
+// ---------------------------------------------------------------------------------------------
+typedef GS_SDLSound GS_FmodSound;
+//==============================================================================================
+
+
+#endif // GS_USE_SDL_SOUND
+#endif // GS_SDL_SOUND_H
@@ -51,7 +51,9 @@ GS_Timer::GS_Timer()
         m_dwStartTime = timeGetTime();
     }
 #else
-    m_lStartTime = GS_Platform::GetTickCount();
+    // Get the frequency of SDL's high resolution counter and the current number of counts.
+    m_n64PerfFreq   = SDL_GetPerformanceFrequency();
+    m_n64StartCount = SDL_GetPerformanceCounter();
 #endif
 }
 
@@ -104,7 +106,8 @@ void GS_Timer::Reset()
         m_dwStartTime = timeGetTime();
     }
 #else
-    m_lStartTime = GS_Platform::GetTickCount();
+    // Determine a new start count.
+    m_n64StartCount = SDL_GetPerformanceCounter();
 #endif
 }
 
@@ -146,8 +149,9 @@ float GS_Timer::GetTime()
         return (float(timeGetTime() - m_dwStartTime));
     }
 #else
-    unsigned long lCurrentTime = GS_Platform::GetTickCount();
-    return (float)(lCurrentTime - m_lStartTime);
+    // Calculate the time elapsed in milliseconds.
+    Uint64 n64CurrentCount = SDL_GetPerformanceCounter() - m_n64StartCount;
+    return float((double(n64CurrentCount) / double(m_n64PerfFreq)) * 1000.0);
 #endif
 }
 
@@ -196,11 +200,14 @@ void GS_Timer::Wait(float fWaitTime)
 // Returns: Nothing.
 //==============================================================================================
 
-GS_FrameTimer::GS_FrameTimer() : GS_Timer()
+GS_FrameTimer::GS_FrameTimer() : GS_Timer(), m_gsHistogram(FRAME_HISTOGRAM_MIN_TIME)
 {
     m_nFramesTotal     = 0;
     m_fFrameTimesTotal = 0.0f;
     m_fFrameRate       = 0.0f;
+    m_fTargetFrameTime = DEFAULT_TARGET_FRAME_TIME;
+
+    this->ResetStats();
 }
 
 
@@ -264,6 +271,9 @@ void GS_FrameTimer::MarkFrame()
     // Reset the timer to start measuring new frame.
     GS_Timer::Reset();
 
+    // Count the frame time in the histogram.
+    this->AddFrameTime(fFrameTime);
+
     // Prevent a divide by 0 error.
     if (fFrameTime <= 0.0f)
     {
@@ -296,4 +306,110 @@ void GS_FrameTimer::MarkFrame()
 }
 
 
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_FrameTimer::ResetStats():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Clears the frame time histogram, the longest frame time and the number of missed
+//          deadlines.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_FrameTimer::ResetStats()
+{
+    m_gsHistogram.Reset();
+
+    m_ulMissedDeadlines = 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_FrameTimer::AddFrameTime():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Counts a frame time (in milliseconds) in the histogram and the frame statistics.
+//          Called by MarkFrame(), but can also be used to collect statistics for frames that
+//          were timed elsewhere.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_FrameTimer::AddFrameTime(float fFrameTime)
+{
+    m_gsHistogram.Add(fFrameTime);
+
+    // Did the frame take long enough to miss one or more vsync deadlines? Frames are allowed
+    // half an interval of jitter before they are counted as having missed a deadline.
+    if ((m_fTargetFrameTime > 0.0f) && (fFrameTime > m_fTargetFrameTime * 1.5f))
+    {
+        m_ulMissedDeadlines += (unsigned long) (fFrameTime / m_fTargetFrameTime + 0.5f) - 1;
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_FrameTimer::SetTargetFrameTime():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Sets the time (in milliseconds) a frame should take, normally the length of one
+//          vsync interval. Frames that take longer are counted as missed deadlines.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_FrameTimer::SetTargetFrameTime(float fTargetFrameTime)
+{
+    m_fTargetFrameTime = fTargetFrameTime;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_FrameTimer::WriteStats():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Writes the frame time percentiles, the number of missed deadlines and the non-empty
+//          histogram buckets to a text file.
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if successful, FALSE if not.
+//==============================================================================================
+
+BOOL GS_FrameTimer::WriteStats(const char* pszFilename)
+{
+
+    GS_File gsFile;
+
+    // Open the file for writing.
+    if (!gsFile.Open(pszFilename, FILE_WRITE))
+    {
+        GS_Error::Report("GS_TIMER.CPP", 393, "Failed to open frame statistics file!");
+        return FALSE;
+    }
+
+    gsFile.WriteString("Frames:           %lu\n", this->GetFramesRecorded());
+    gsFile.WriteString("Target frame:     %0.2f ms\n", m_fTargetFrameTime);
+    gsFile.WriteString("Missed deadlines: %lu\n", m_ulMissedDeadlines);
+    gsFile.WriteString("p50:              %0.2f ms\n", this->GetPercentile(50.0f));
+    gsFile.WriteString("p95:              %0.2f ms\n", this->GetPercentile(95.0f));
+    gsFile.WriteString("p99:              %0.2f ms\n", this->GetPercentile(99.0f));
+    gsFile.WriteString("Max:              %0.2f ms\n", this->GetMaxFrameTime());
+    gsFile.WriteString("\nHistogram (frames up to each limit):\n");
+
+    // Write the non-empty buckets.
+    m_gsHistogram.WriteBuckets(&gsFile, 2);
+
+    gsFile.Close();
+
+    return TRUE;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////////////////////
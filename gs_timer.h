@@ -37,6 +37,9 @@
 //==============================================================================================
 // Include Game System (GS) header files.
 // ---------------------------------------------------------------------------------------------
+#include "gs_error.h"
+#include "gs_file.h"
+#include "gs_histogram.h"
 #include "gs_object.h"
 //==============================================================================================
 
@@ -57,7 +60,8 @@ private:
     __int64 m_n64StartCount; // The initial number of counts of the performance counter.
     DWORD   m_dwStartTime;   // The initial start time of the multi-media counter.
 #else
-    unsigned long m_lStartTime; // Start time in milliseconds (SDL)
+    Uint64  m_n64PerfFreq;   // The frequency (counts per second) of the performance counter.
+    Uint64  m_n64StartCount; // The initial number of counts of the performance counter.
 #endif
 
 protected:
@@ -87,6 +91,17 @@ public:
 //==============================================================================================
 
 
+//==============================================================================================
+// Every frame time is also counted in a histogram so that percentiles can be reported (see
+// gs_histogram.h). Bucket 0 holds frames shorter than FRAME_HISTOGRAM_MIN_TIME milliseconds,
+// the histogram covers frames of up to 2 seconds, anything longer goes into the last bucket.
+// ---------------------------------------------------------------------------------------------
+#define FRAME_HISTOGRAM_MIN_TIME 0.125f
+// ---------------------------------------------------------------------------------------------
+#define DEFAULT_TARGET_FRAME_TIME (1000.0f / 60.0f)
+//==============================================================================================
+
+
 ////////////////////////////////////////////////////////////////////////////////////////////////
 // Class Definition. ///////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////
@@ -101,6 +116,10 @@ private:
     float m_fFrameTimesTotal; // The total time it took to complete m_nFramesCompleted.
     float m_fFrameRate;       // The current frame rate in frames per second.
 
+    GS_Histogram  m_gsHistogram;       // Frame times recorded.
+    unsigned long m_ulMissedDeadlines; // Number of vsync deadlines missed.
+    float m_fTargetFrameTime; // The time (in milliseconds) a frame should take.
+
 protected:
 
     // No protected members.
@@ -116,6 +135,33 @@ public:
     {
         return m_fFrameRate;
     };
+
+    void ResetStats();
+    void AddFrameTime(float fFrameTime);
+    void SetTargetFrameTime(float fTargetFrameTime);
+    float GetTargetFrameTime()
+    {
+        return m_fTargetFrameTime;
+    };
+
+    unsigned long GetFramesRecorded()
+    {
+        return (unsigned long) m_gsHistogram.GetCount();
+    };
+    unsigned long GetMissedDeadlines()
+    {
+        return m_ulMissedDeadlines;
+    };
+    float GetMaxFrameTime()
+    {
+        return m_gsHistogram.GetMaxTime();
+    };
+    float GetPercentile(float fPercent)
+    {
+        return m_gsHistogram.GetPercentile(fPercent);
+    };
+
+    BOOL WriteStats(const char* pszFilename);
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,346 @@
+/*============================================================================================+
+ | Game System (GS) Library                                                                   |
+ |--------------------------------------------------------------------------------------------|
+ | FILES: gs_voice_allocator.cpp, gs_voice_allocator.h                                        |
+ |--------------------------------------------------------------------------------------------|
+ | CLASS: GS_VoiceAllocator                                                                   |
+ |--------------------------------------------------------------------------------------------|
+ | ABOUT: Voice allocation and voice handles of a sound backend.                              |
+ |--------------------------------------------------------------------------------------------|
+ |                                                                                    10/2026 |
+ +============================================================================================*/
+
+
+//==============================================================================================
+// Include Game System (GS) header files.
+// ---------------------------------------------------------------------------------------------
+#include "gs_voice_allocator.h"
+//==============================================================================================
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Constructor/Destructor Methods //////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_VoiceAllocator::GS_VoiceAllocator():
+// ---------------------------------------------------------------------------------------------
+// Purpose: The constructor, creates the voices. Samples are only played on the first
+//          nSampleVoices voices, the others (for music) are started and stopped the same way
+//          but never allocated to a sample.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+GS_VoiceAllocator::GS_VoiceAllocator(int nNumVoices, int nSampleVoices)
+{
+
+    m_pSlots        = new GS_VoiceSlot[nNumVoices];
+    m_nNumVoices    = nNumVoices;
+    m_nSampleVoices = SDL_min(nSampleVoices, nNumVoices);
+    m_uNextSerial   = 1;
+
+    this->Reset();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_VoiceAllocator::~GS_VoiceAllocator():
+// ---------------------------------------------------------------------------------------------
+// Purpose: The destructor, frees the voices.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+GS_VoiceAllocator::~GS_VoiceAllocator()
+{
+
+    delete[] m_pSlots;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Game Thread Methods /////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_VoiceAllocator::Reset():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Forgets everything that was playing. Only to be called while the audio thread is
+//          not running (before the device is opened or after it has been closed).
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_VoiceAllocator::Reset()
+{
+
+    for (int nVoice = 0; nVoice < m_nNumVoices; nVoice++)
+    {
+        m_pSlots[nVoice].nSample   = -1;
+        m_pSlots[nVoice].nPriority = 0;
+        m_pSlots[nVoice].uSerial   = 0;
+        SDL_AtomicSet(&m_pSlots[nVoice].nActive, 0);
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_VoiceAllocator::Allocate():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Picks the voice to play a sample on: the oldest voice of the sample if it already
+//          plays on nMaxVoices voices, otherwise a free voice, otherwise the oldest voice of
+//          the lowest priority (if that priority is not higher than nPriority).
+// ---------------------------------------------------------------------------------------------
+// Returns: The voice, or -1 if there is none for the sample.
+//==============================================================================================
+
+int GS_VoiceAllocator::Allocate(int nSample, int nMaxVoices, int nPriority)
+{
+
+    int nFree       = -1;
+    int nOldest     = -1;
+    int nVictim     = -1;
+    int nNumPlaying = 0;
+
+    for (int nVoice = 0; nVoice < m_nSampleVoices; nVoice++)
+    {
+        GS_VoiceSlot* pSlot = &m_pSlots[nVoice];
+
+        // Forget voices that have finished playing.
+        if (!this->IsPlaying(nVoice))
+        {
+            pSlot->nSample = -1;
+            if (nFree < 0)
+            {
+                nFree = nVoice;
+            }
+            continue;
+        }
+
+        if (pSlot->nSample == nSample)
+        {
+            nNumPlaying++;
+            if ((nOldest < 0) || ((Sint32) (pSlot->uSerial - m_pSlots[nOldest].uSerial) < 0))
+            {
+                nOldest = nVoice;
+            }
+        }
+
+        if ((nVictim < 0) || (pSlot->nPriority < m_pSlots[nVictim].nPriority) ||
+            ((pSlot->nPriority == m_pSlots[nVictim].nPriority) &&
+             ((Sint32) (pSlot->uSerial - m_pSlots[nVictim].uSerial) < 0)))
+        {
+            nVictim = nVoice;
+        }
+    }
+
+    if (nNumPlaying >= nMaxVoices)
+    {
+        return nOldest;
+    }
+
+    if (nFree >= 0)
+    {
+        return nFree;
+    }
+
+    if ((nVictim >= 0) && (m_pSlots[nVictim].nPriority <= nPriority))
+    {
+        return nVictim;
+    }
+
+    return -1;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_VoiceAllocator::Start():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Gives a new playback on a voice (replacing whatever the voice was playing) the next
+//          serial and marks the voice as playing. This must be done before the audio thread
+//          can see the playback, so it can't end before it is marked (the audio thread only
+//          marks it finished if the serial still matches).
+// ---------------------------------------------------------------------------------------------
+// Returns: The serial of the playback (never zero).
+//==============================================================================================
+
+Uint32 GS_VoiceAllocator::Start(int nVoice, int nSample, int nPriority)
+{
+
+    GS_VoiceSlot* pSlot = &m_pSlots[nVoice];
+
+    pSlot->nSample   = nSample;
+    pSlot->nPriority = nPriority;
+    pSlot->uSerial   = m_uNextSerial++;
+
+    if (m_uNextSerial == 0)
+    {
+        m_uNextSerial = 1;
+    }
+
+    SDL_AtomicSet(&pSlot->nActive, (int) pSlot->uSerial);
+
+    return pSlot->uSerial;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_VoiceAllocator::Stop():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Marks a voice as free at once, before the audio thread has stopped it (or when the
+//          playback could not be handed to the audio thread).
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_VoiceAllocator::Stop(int nVoice)
+{
+
+    SDL_AtomicSet(&m_pSlots[nVoice].nActive, 0);
+    m_pSlots[nVoice].nSample = -1;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_VoiceAllocator::GetHandle():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Makes the handle of the playback on a voice, returned by PlaySample(). The low 8
+//          bits are the voice, the others the low 23 bits of the serial, so the handle is only
+//          valid for this playback.
+// ---------------------------------------------------------------------------------------------
+// Returns: The handle of the voice.
+//==============================================================================================
+
+int GS_VoiceAllocator::GetHandle(int nVoice)
+{
+
+    return (int) ((m_pSlots[nVoice].uSerial & 0x7FFFFF) << 8) | nVoice;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_VoiceAllocator::FindHandle():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Finds the sample voice a handle made by GetHandle() refers to.
+// ---------------------------------------------------------------------------------------------
+// Returns: The voice, or -1 if the playback has finished or the voice was stolen.
+//==============================================================================================
+
+int GS_VoiceAllocator::FindHandle(int nHandle)
+{
+
+    int nVoice = nHandle & 0xFF;
+
+    if ((nHandle < 0) || (nVoice >= m_nSampleVoices))
+    {
+        return -1;
+    }
+
+    GS_VoiceSlot* pSlot = &m_pSlots[nVoice];
+
+    if ((pSlot->nSample < 0) || ((int) (pSlot->uSerial & 0x7FFFFF) != (nHandle >> 8)) ||
+        (SDL_AtomicGet(&pSlot->nActive) != (int) pSlot->uSerial))
+    {
+        return -1;
+    }
+
+    return nVoice;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_VoiceAllocator::IsPlaying():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Checks whether the last playback started on a voice is still playing (or paused).
+// ---------------------------------------------------------------------------------------------
+// Returns: TRUE if it is, FALSE if not.
+//==============================================================================================
+
+BOOL GS_VoiceAllocator::IsPlaying(int nVoice)
+{
+
+    return (SDL_AtomicGet(&m_pSlots[nVoice].nActive) == (int) m_pSlots[nVoice].uSerial) &&
+           (m_pSlots[nVoice].uSerial != 0);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_VoiceAllocator::GetNumPlaying():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Counts the sample voices that are playing (or paused).
+// ---------------------------------------------------------------------------------------------
+// Returns: The number of sample voices playing.
+//==============================================================================================
+
+int GS_VoiceAllocator::GetNumPlaying()
+{
+
+    int nNumPlaying = 0;
+
+    for (int nVoice = 0; nVoice < m_nSampleVoices; nVoice++)
+    {
+        if (SDL_AtomicGet(&m_pSlots[nVoice].nActive) != 0)
+        {
+            nNumPlaying++;
+        }
+    }
+
+    return nNumPlaying;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Audio Thread Methods ////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+//==============================================================================================
+// GS_VoiceAllocator::Finish():
+// ---------------------------------------------------------------------------------------------
+// Purpose: Marks the playback with the given serial as finished, unless the game thread has
+//          already started another one on the voice. May only be called by the audio thread.
+// ---------------------------------------------------------------------------------------------
+// Returns: Nothing.
+//==============================================================================================
+
+void GS_VoiceAllocator::Finish(int nVoice, Uint32 uSerial)
+{
+
+    SDL_AtomicCAS(&m_pSlots[nVoice].nActive, (int) uSerial, 0);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,91 @@
+/*============================================================================================+
+ | Game System (GS) Library                                                                   |
+ |--------------------------------------------------------------------------------------------|
+ | FILES: gs_voice_allocator.cpp, gs_voice_allocator.h                                        |
+ |--------------------------------------------------------------------------------------------|
+ | CLASS: GS_VoiceAllocator                                                                   |
+ |--------------------------------------------------------------------------------------------|
+ | ABOUT: Keeps track of which sample plays on which voice (mixing channel) of a sound        |
+ |        backend, picks the voice for a new playback, stealing one if need be, and hands     |
+ |        out the voice handles returned by PlaySample(). The game thread starts and stops    |
+ |        playbacks, the audio thread only marks them finished, neither waits for the other.  |
+ |--------------------------------------------------------------------------------------------|
+ |                                                                                    10/2026 |
+ +============================================================================================*/
+
+
+#ifndef GS_VOICE_ALLOCATOR_H
+#define GS_VOICE_ALLOCATOR_H
+
+
+//==============================================================================================
+// Include platform abstraction header files.
+// ---------------------------------------------------------------------------------------------
+#include "gs_platform.h"
+//==============================================================================================
+
+
+//==============================================================================================
+// Include SDL2 header files.
+// ---------------------------------------------------------------------------------------------
+#include <SDL2/SDL.h>
+//==============================================================================================
+
+
+//==============================================================================================
+// Voice allocator structures.
+// ---------------------------------------------------------------------------------------------
+typedef struct GS_VOICE_SLOT
+{
+    int    nSample;   // Index of the sample playing on the voice (-1 if none).
+    int    nPriority; // Priority of the sample playing on the voice.
+    Uint32 uSerial;   // Number of the playback (the higher the newer), part of the voice handle.
+
+    SDL_atomic_t nActive; // Serial of the playback sounding on the voice (set by the game
+                          // thread when it starts, cleared by the audio thread when it ends).
+} GS_VoiceSlot;
+//==============================================================================================
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+// Class Definition. ///////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+class GS_VoiceAllocator
+{
+
+private:
+
+    GS_VoiceSlot* m_pSlots;        // The voices.
+    int           m_nNumVoices;    // Number of voices.
+    int           m_nSampleVoices; // Number of voices samples are played on (the first ones).
+    Uint32        m_uNextSerial;   // Number of the next playback (never zero).
+
+public:
+
+    GS_VoiceAllocator(int nNumVoices, int nSampleVoices);
+    virtual ~GS_VoiceAllocator();
+
+    // Game thread methods.
+    void Reset();
+
+    int    Allocate(int nSample, int nMaxVoices, int nPriority);
+    Uint32 Start(int nVoice, int nSample = -1, int nPriority = 0);
+    void   Stop(int nVoice);
+
+    int  GetHandle(int nVoice);
+    int  FindHandle(int nHandle);
+    BOOL IsPlaying(int nVoice);
+    int  GetNumPlaying();
+
+    Uint32 GetSerial(int nVoice) { return m_pSlots[nVoice].uSerial; }
+
+    // Audio thread methods.
+    void Finish(int nVoice, Uint32 uSerial);
+};
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+
+#endif